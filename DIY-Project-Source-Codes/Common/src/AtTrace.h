@@ -0,0 +1,395 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+Capture of the Wio E5 AT traffic as a compact binary trace: every byte the sketch writes to the
+module and reads from it, with its time. The native build replays a trace into the sketch's own
+parsing and state machine code (Native-HAL, program --replay), Host-Tools/at_trace prints and
+converts them.
+
+A tap sits between the sketch and the module's UART, received bytes are timed when the sketch reads
+them. Bytes in one direction less than AT_TRACE_GAP ms apart go into one record (little endian):
+
+    header   "M2AT", u8 version (1), u8 node ('S', 'G', 'E'), u8 flags (bit 0 = starts at boot), u8 0,
+             u32 clock (ms) the first record's time counts from                             - 12 bytes
+    record   u8 tag - bit 7 = sketch -> module, bits 0..6 = byte count - 1 (1 .. 127 bytes),
+             ms since the previous record as a LEB128 varint, the bytes             - 2 bytes + data
+    gap      u8 0xFF, ms since the previous record as a varint - records were lost here, the next
+             record's time counts from the gap
+
+The RAM ring keeps the boot conversation (module configuration, up to a third of it) for good
+and the newest records in the rest, so a dump always replays from power-up. The file sink buffers
+in RAM and only writes in poll(), never from inside a UART read.
+
+USAGE:
+
+    AtTraceRing<1536> atTrace(AT_TRACE_SENSOR);     // or AtTraceFile<File> atTrace(AT_TRACE_END);
+    AtTap<HardwareSerial> e5(Serial1, atTrace);     // talk to the module through e5
+    atTrace.serve(Serial);                          // in loop(): a "TRACE" line prints the ring as TRACE,... lines
+
+    atTrace.begin(SD.open("/trace/AT000.BIN", FILE_WRITE));     // AtTraceFile
+    atTrace.poll();                                 // in loop(), writes out what was captured
+ */
+
+#define AT_TRACE_SENSOR  'S'
+#define AT_TRACE_GATEWAY 'G'
+#define AT_TRACE_END     'E'
+
+#define AT_TRACE_TX      0x80
+#define AT_TRACE_RX      0x00
+#define AT_TRACE_GAP_TAG 0xFF
+#define AT_TRACE_MAX     127        // bytes per record
+#define AT_TRACE_HEADER  12
+#define AT_TRACE_FROM_BOOT 0x01
+
+// RAM for the ring or the file buffer, bytes
+#ifndef AT_TRACE_SIZE
+#if defined(__AVR__)
+#define AT_TRACE_SIZE 1536
+#else
+#define AT_TRACE_SIZE 8192
+#endif
+#endif
+
+// Bytes further apart than this start a new record, ms
+#ifndef AT_TRACE_GAP
+#define AT_TRACE_GAP 5
+#endif
+
+// How often the file sink writes out what it has, ms
+#ifndef AT_TRACE_FLUSH
+#define AT_TRACE_FLUSH 5000
+#endif
+
+// Clock of the record times, a sketch that sleeps with millis() stopped sets its own
+#ifndef AT_TRACE_CLOCK
+#define AT_TRACE_CLOCK millis
+#endif
+
+// Gathers the bytes into records, the sinks below keep them
+class AtTrace {
+public:
+    AtTrace(uint8_t nodeId) : node(nodeId) {}
+
+    // Function to log a byte going one way
+    void add(uint8_t dir, uint8_t c){
+        unsigned long now = AT_TRACE_CLOCK();
+        if (count && (dir != openDir || now - lastByte > AT_TRACE_GAP || count == AT_TRACE_MAX)){
+            close();
+        }
+        if (count == 0){
+            openDir = dir;
+            openTime = now;
+        }
+        data[count++] = c;
+        lastByte = now;
+    }
+
+    // Function to hand the open record to the sink, once no byte came for AT_TRACE_GAP ms
+    void closeIdle(){
+        if (count && AT_TRACE_CLOCK() - lastByte > AT_TRACE_GAP){
+            close();
+        }
+    }
+
+    // Records the sink had no room for
+    unsigned long dropped() const { return lost; }
+
+protected:
+    uint8_t node;
+    unsigned long last = 0;     // time of the last record stored, the next one's delta counts from it
+
+    // Function to keep an encoded record (head = tag and delta, maybe after a gap marker), false if no room
+    virtual bool store(const uint8_t * head, uint8_t headLen, const uint8_t * bytes, uint8_t len) = 0;
+
+    // Function to put a varint at p, returns its length
+    static uint8_t varint(uint8_t * p, unsigned long v){
+        uint8_t n = 0;
+        do {
+            p[n] = v & 0x7F;
+            v >>= 7;
+            p[n++] |= v ? 0x80 : 0;
+        } while (v);
+        return n;
+    }
+
+    // Function to fill in a 12 byte header
+    void header(uint8_t * h, uint8_t flags, unsigned long clock){
+        memcpy(h, "M2AT", 4);
+        h[4] = 1;
+        h[5] = node;
+        h[6] = flags;
+        h[7] = 0;
+        for (uint8_t i = 0; i < 4; i++){
+            h[8 + i] = clock >> (8 * i);
+        }
+    }
+
+    void close(){
+        uint8_t head[2 + 5 + 1 + 5];
+        uint8_t len = 0;
+        unsigned long delta = openTime - last;
+        if (gap){
+            head[len++] = AT_TRACE_GAP_TAG;
+            len += varint(head + len, delta);
+            delta = 0;
+        }
+        head[len++] = openDir | (count - 1);
+        len += varint(head + len, delta);
+        if (store(head, len, data, count)){
+            last = openTime;
+            gap = false;
+        } else {
+            gap = true;
+            lost++;
+        }
+        count = 0;
+    }
+
+private:
+    uint8_t data[AT_TRACE_MAX];
+    uint8_t count = 0;
+    uint8_t openDir = 0;
+    unsigned long openTime = 0;
+    unsigned long lastByte = 0;
+    unsigned long lost = 0;
+    bool gap = false;
+};
+
+// The newest records in RAM, after the boot conversation
+template<size_t N>
+class AtTraceRing : public AtTrace {
+public:
+    AtTraceRing(uint8_t nodeId) : AtTrace(nodeId) {}
+
+    // Function to print the trace as "TRACE,BEGIN,<bytes>", "TRACE,<hex>" ..., "TRACE,END" lines
+    void dump(Print & port){
+        closeIdle();
+        uint8_t h[AT_TRACE_HEADER];
+        uint8_t gap[1 + 5];
+        uint8_t gapLen = 0;
+        header(h, AT_TRACE_FROM_BOOT, 0);
+        if (wrapped){
+            // between the boot conversation and the oldest record the ring still has
+            gap[gapLen++] = AT_TRACE_GAP_TAG;
+            gapLen += varint(gap + gapLen, tailTime - bootLast);
+        }
+        port.print(F("TRACE,BEGIN,"));
+        port.print((unsigned long)(sizeof(h) + gapLen + (bootOpen ? used : bootEnd + used)));
+        port.print(F("\r\n"));
+        lineLen = 0;
+        hex(port, h, sizeof(h));
+        hex(port, buf, bootOpen ? used : bootEnd);
+        hex(port, gap, gapLen);
+        if (!bootOpen){
+            size_t tail = (head + ringSize() - used) % ringSize();
+            for (size_t i = 0; i < used; i++){
+                hex(port, &buf[bootEnd + (tail + i) % ringSize()], 1);
+            }
+        }
+        if (lineLen){
+            port.print(F("\r\n"));
+        }
+        port.print(F("TRACE,END\r\n"));
+    }
+
+    // Function to dump the ring when a "TRACE" line comes in on port
+    void serve(Stream & port){
+        while (port.available() > 0){
+            char c = port.read();
+            if (c == '\r' || c == '\n'){
+                if (cmdLen == 5 && memcmp(cmd, "TRACE", 5) == 0){
+                    dump(port);
+                }
+                cmdLen = 0;
+            } else if (cmdLen < sizeof(cmd)){
+                cmd[cmdLen++] = c;
+            }
+        }
+    }
+
+protected:
+    bool store(const uint8_t * h, uint8_t headLen, const uint8_t * bytes, uint8_t len) override {
+        if (bootOpen){
+            if (used + headLen + len <= N / 3){
+                memcpy(buf + used, h, headLen);
+                memcpy(buf + used + headLen, bytes, len);
+                used += headLen + len;
+                return true;
+            }
+            // boot conversation over, the rest of the buffer is the ring
+            bootOpen = false;
+            bootEnd = used;
+            bootLast = tailTime = last;
+            used = 0;
+            head = 0;
+        }
+        size_t size = headLen + len;
+        if (size > ringSize()){
+            return false;
+        }
+        while (ringSize() - used < size){
+            dropOldest();
+        }
+        for (uint8_t i = 0; i < headLen; i++){
+            put(h[i]);
+        }
+        for (uint8_t i = 0; i < len; i++){
+            put(bytes[i]);
+        }
+        return true;
+    }
+
+private:
+    uint8_t buf[N];
+    size_t used = 0;            // bytes in the boot area, then in the ring
+    size_t head = 0;            // next ring byte written
+    size_t bootEnd = 0;
+    bool bootOpen = true;
+    bool wrapped = false;       // the ring dropped records
+    unsigned long bootLast = 0; // time of the last boot record
+    unsigned long tailTime = 0; // the time the oldest ring record's delta counts from
+    uint8_t lineLen = 0;
+    char cmd[8];
+    uint8_t cmdLen = 0;
+
+    size_t ringSize() const { return N - bootEnd; }
+
+    uint8_t at(size_t i) const { return buf[bootEnd + i % ringSize()]; }
+
+    void put(uint8_t b){
+        buf[bootEnd + head] = b;
+        head = (head + 1) % ringSize();
+        used++;
+    }
+
+    // Function to drop the oldest ring record, its time becomes the base of the next one
+    void dropOldest(){
+        size_t tail = head + ringSize() - used;
+        uint8_t tag = at(tail);
+        size_t n = 1;
+        unsigned long delta = 0;
+        uint8_t shift = 0, b;
+        do {
+            b = at(tail + n++);
+            delta |= (unsigned long)(b & 0x7F) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        if (tag != AT_TRACE_GAP_TAG){
+            n += (tag & 0x7F) + 1;
+        }
+        tailTime += delta;
+        used -= n;
+        wrapped = true;
+    }
+
+    void hex(Print & port, const uint8_t * p, size_t n){
+        static const char digits[] = "0123456789ABCDEF";
+        for (size_t i = 0; i < n; i++){
+            if (lineLen == 0){
+                port.print(F("TRACE,"));
+            }
+            port.write(digits[p[i] >> 4]);
+            port.write(digits[p[i] & 0x0F]);
+            if (++lineLen == 32){
+                port.print(F("\r\n"));
+                lineLen = 0;
+            }
+        }
+    }
+};
+
+// Records buffered in RAM and written to a file from poll()
+template<class F>
+class AtTraceFile : public AtTrace {
+public:
+    AtTraceFile(uint8_t nodeId) : AtTrace(nodeId) {}
+
+    // Function to start writing to an open file, what was captured before goes in first
+    bool begin(F f){
+        file = f;
+        if (!file){
+            return false;
+        }
+        uint8_t h[AT_TRACE_HEADER];
+        header(h, dropped() ? 0 : AT_TRACE_FROM_BOOT, 0);
+        file.write(h, sizeof(h));
+        return true;
+    }
+
+    // Function to write out the buffer, when it is half full or every AT_TRACE_FLUSH ms
+    void poll(){
+        closeIdle();
+        if (!file || used == 0){
+            return;
+        }
+        unsigned long now = millis();
+        if (used >= sizeof(buf) / 2 || now - lastWrite >= AT_TRACE_FLUSH){
+            file.write(buf, used);
+            file.flush();
+            used = 0;
+            lastWrite = now;
+        }
+    }
+
+protected:
+    bool store(const uint8_t * h, uint8_t headLen, const uint8_t * bytes, uint8_t len) override {
+        if (used + headLen + len > sizeof(buf)){
+            return false;
+        }
+        memcpy(buf + used, h, headLen);
+        memcpy(buf + used + headLen, bytes, len);
+        used += headLen + len;
+        return true;
+    }
+
+private:
+    F file;
+    uint8_t buf[AT_TRACE_SIZE];
+    size_t used = 0;
+    unsigned long lastWrite = 0;
+};
+
+// Stands in for the module's UART and logs what goes through it
+template<class Port>
+class AtTap : public Stream {
+public:
+    AtTap(Port & uart, AtTrace & log) : port(uart), trace(log) {}
+
+    void begin(unsigned long baud){ port.begin(baud); }
+    void end(){ port.end(); }
+    void flush(){ port.flush(); }
+
+    int available() override {
+        return port.available();
+    }
+
+    int read() override {
+        int c = port.read();
+        if (c >= 0){
+            trace.add(AT_TRACE_RX, c);
+        }
+        return c;
+    }
+
+    int peek() override {
+        return port.peek();
+    }
+
+    size_t write(uint8_t c) override {
+        trace.add(AT_TRACE_TX, c);
+        return port.write(c);
+    }
+
+    size_t write(const uint8_t * buffer, size_t size) override {
+        for (size_t i = 0; i < size; i++){
+            trace.add(AT_TRACE_TX, buffer[i]);
+        }
+        return port.write(buffer, size);
+    }
+    using Print::write;
+
+private:
+    Port & port;
+    AtTrace & trace;
+};
@@ -0,0 +1,302 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+Micro-benchmarks of the sketch's hot paths (bench/bench.cpp), on the board or on the PC (Native-HAL).
+Every case is called a number of times and printed as one line:
+
+    BENCH,<case>,<calls>,<ns/op>,<cycles/op>,<alloc bytes/op>,<allocs/op>,<stack bytes>
+
+Cycles come from the CPU's own counter - Timer1 at F_CPU on the AVR, CCOUNT on the ESP8266, DWT->CYCCNT
+on the SAMD51, the TSC on an x86 PC (0 elsewhere). Allocations are counted by wrapping malloc() and
+realloc() at link time: build with -D BENCH_WRAP_MALLOC -Wl,--wrap=malloc -Wl,--wrap=realloc (the bench
+envs in platformio.ini do), else they read 0. Stack is the deepest byte one call changed below the
+caller, found by painting the stack before it.
+
+The Wio E5 is replaced by a BenchModem that answers from RAM, so the numbers are the CPU cost of the
+code without the UART's wire time.
+
+USAGE:
+
+    BenchModem modem;
+    modem.answer("+TEST: TX DONE\r\n");         // read back after every command line the sketch writes
+    modem.feed(urc);                            // read back right away, like a URC
+    benchBegin(Serial);                         // header line, starts the cycle counter
+    benchRun("unHex", unHexOp, 1000);           // void unHexOp(), 1000 calls (x BENCH_HOST_FACTOR on the PC)
+ */
+
+#ifndef BENCH_STACK_AREA
+#if defined(__AVR__)
+#define BENCH_STACK_AREA 768
+#elif defined(ESP8266)
+#define BENCH_STACK_AREA 1536      // 4 kB cont stack
+#elif defined(ARDUINO_ARCH_NATIVE)
+#define BENCH_STACK_AREA 16384
+#else
+#define BENCH_STACK_AREA 4096
+#endif
+#endif
+
+#ifndef BENCH_HOST_FACTOR
+#define BENCH_HOST_FACTOR 100     // the PC runs every case this many times more
+#endif
+
+// Calls timed in one go, the ESP8266 gets a yield() in between
+#define BENCH_BATCH 16
+
+#ifdef ARDUINO_ARCH_NATIVE
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#endif
+
+static Print * benchPort = nullptr;
+static volatile uint32_t benchAllocs = 0;
+static volatile uint32_t benchAllocBytes = 0;
+static uint8_t benchInAlloc = 0;
+
+// Ops store a result here so the compiler can't drop them
+volatile uint32_t benchSink = 0;
+
+#ifdef BENCH_WRAP_MALLOC
+extern "C" {
+void * __real_malloc(size_t size);
+void * __real_realloc(void * ptr, size_t size);
+
+void * __wrap_malloc(size_t size){
+    if (!benchInAlloc){
+        benchAllocs++;
+        benchAllocBytes += size;
+    }
+    return __real_malloc(size);
+}
+
+// A realloc() that moves the block calls malloc() itself on some libcs, that's still one allocation
+void * __wrap_realloc(void * ptr, size_t size){
+    benchAllocs++;
+    benchAllocBytes += size;
+    benchInAlloc++;
+    void * p = __real_realloc(ptr, size);
+    benchInAlloc--;
+    return p;
+}
+}
+#endif
+
+// ---- cycle counter
+
+#if defined(__AVR__)
+static volatile uint16_t benchOverflows = 0;
+
+ISR(TIMER1_OVF_vect){
+    benchOverflows++;
+}
+
+void benchCounterBegin(){
+    TCCR1A = 0;
+    TCCR1B = _BV(CS10);         // F_CPU, no prescaler
+    TCNT1 = 0;
+    TIFR1 = _BV(TOV1);
+    TIMSK1 = _BV(TOIE1);
+}
+
+uint32_t benchCycles(){
+    uint8_t sreg = SREG;
+    cli();
+    uint16_t lo = TCNT1;
+    uint16_t hi = benchOverflows;
+    if ((TIFR1 & _BV(TOV1)) && lo < 0x8000){
+        hi++;                   // wrapped, the ISR hasn't run yet
+    }
+    SREG = sreg;
+    return ((uint32_t)hi << 16) | lo;
+}
+
+uint32_t benchMHz(){
+    return F_CPU / 1000000UL;
+}
+#elif defined(ESP8266)
+void benchCounterBegin(){
+}
+
+uint32_t benchCycles(){
+    return ESP.getCycleCount();
+}
+
+uint32_t benchMHz(){
+    return ESP.getCpuFreqMHz();
+}
+#elif defined(__SAMD51__)
+void benchCounterBegin(){
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t benchCycles(){
+    return DWT->CYCCNT;
+}
+
+uint32_t benchMHz(){
+    return SystemCoreClock / 1000000UL;
+}
+#else
+// PC - the time comes from steady_clock, cycles are TSC ticks
+void benchCounterBegin(){
+}
+
+uint32_t benchCycles(){
+#if defined(__x86_64__) || defined(__i386__)
+    return (uint32_t)__rdtsc();
+#else
+    return 0;
+#endif
+}
+
+uint32_t benchMHz(){
+    return 0;
+}
+#endif
+
+// ---- stack use
+
+// Function to fill the stack below the caller with a pattern
+void __attribute__((noinline)) benchPaint(){
+    volatile uint8_t area[BENCH_STACK_AREA];
+    for (size_t i = 0; i < sizeof(area); i++){
+        area[i] = 0xA5;
+    }
+}
+
+// Function to find how far down the pattern was overwritten since benchPaint(), from the same caller.
+// Reading what the last call left in the area is the point, hence the uninitialized array
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+size_t __attribute__((noinline)) benchScan(){
+    volatile uint8_t area[BENCH_STACK_AREA];
+    size_t i = 0;
+    while (i < sizeof(area) && area[i] == 0xA5){
+        i++;
+    }
+    return sizeof(area) - i;
+}
+#pragma GCC diagnostic pop
+
+// ---- modem
+
+// Stands in for the Wio E5's UART: what the sketch writes is dropped, and after every command line
+// (up to its \n) the answer text is there to read back
+class BenchModem : public Stream {
+public:
+    BenchModem() {}
+    BenchModem(uint8_t, uint8_t, bool = false) {}     // SoftwareSerial's
+
+    void begin(unsigned long) {}
+    void end() {}
+    void flush() {}
+
+    // Function to set the text read back after every command, nullptr for none
+    void answer(const char * text){
+        answerText = text;
+    }
+
+    // Function to queue text to read back now
+    void feed(const char * text){
+        rx = text;
+        rxLen = strlen(text);
+    }
+
+    int available() override {
+        return rxLen;
+    }
+
+    int read() override {
+        if (rxLen == 0){
+            return -1;
+        }
+        rxLen--;
+        return (uint8_t)*rx++;
+    }
+
+    int peek() override {
+        return rxLen ? (uint8_t)*rx : -1;
+    }
+
+    size_t write(uint8_t c) override {
+        if (c == '\n' && answerText != nullptr){
+            feed(answerText);
+        }
+        return 1;
+    }
+    using Print::write;
+
+private:
+    const char * answerText = nullptr;
+    const char * rx = nullptr;
+    int rxLen = 0;
+};
+
+// ---- running
+
+// Function to print the header line and start the cycle counter
+void benchBegin(Print & port){
+    benchPort = &port;
+    benchCounterBegin();
+    port.print(F("BENCH,case,calls,ns_per_op,cycles_per_op,alloc_bytes_per_op,allocs_per_op,stack_bytes\r\n"));
+}
+
+// Function to time calls of op and print its BENCH line
+void benchRun(const char * name, void (*op)(), uint32_t calls){
+#ifdef ARDUINO_ARCH_NATIVE
+    calls *= BENCH_HOST_FACTOR;
+#endif
+    op();                       // warm up, first call allocations
+    benchPaint();
+    op();
+    size_t stack = benchScan();
+
+    uint32_t allocs = benchAllocs, bytes = benchAllocBytes;
+    uint64_t cycles = 0, nanos = 0;
+    for (uint32_t done = 0; done < calls; ){
+        uint32_t n = calls - done < BENCH_BATCH ? calls - done : BENCH_BATCH;
+#ifdef ARDUINO_ARCH_NATIVE
+        auto start = std::chrono::steady_clock::now();
+#endif
+        uint32_t c0 = benchCycles();
+        for (uint32_t i = 0; i < n; i++){
+            op();
+        }
+        cycles += (uint32_t)(benchCycles() - c0);
+#ifdef ARDUINO_ARCH_NATIVE
+        nanos += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+#endif
+        done += n;
+        yield();
+    }
+    allocs = benchAllocs - allocs;
+    bytes = benchAllocBytes - bytes;
+    if (benchMHz()){
+        nanos = cycles * 1000 / benchMHz();
+    }
+
+    if (benchPort == nullptr){
+        return;
+    }
+    benchPort->print(F("BENCH,"));
+    benchPort->print(name);
+    benchPort->print(',');
+    benchPort->print(calls);
+    benchPort->print(',');
+    benchPort->print((float)nanos / calls, 1);
+    benchPort->print(',');
+    benchPort->print((float)cycles / calls, 1);
+    benchPort->print(',');
+    benchPort->print((float)bytes / calls, 1);
+    benchPort->print(',');
+    benchPort->print((float)allocs / calls, 2);
+    benchPort->print(',');
+    benchPort->print((unsigned long)stack);
+    benchPort->print(F("\r\n"));
+}
@@ -0,0 +1,150 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+Wio-E5 UART link helpers - baud rate negotiation and link self test.
+
+The Wio-E5 boots at 9600 baud. AT+UART=BR stores a new rate in the module,
+it takes effect after AT+RESET and is kept across power cycles, so after the
+first boot the module already answers at the fast rate.
+
+USAGE:
+
+    unsigned long baud = e5Begin(e5, 115200);      // 0 when no module answers
+    e5LinkTest(e5, Serial, baud, 50);              // one LINK,... line for the current baud
+    e5LinkSweep(e5, Serial, baud, 50, 115200);     // LINK,... lines for every rate, then back to 115200
+ */
+
+// Rates the module supports, fastest first - also the order e5Begin() probes them in
+static const unsigned long e5Bauds[] = { 230400, 115200, 76800, 57600, 38400, 19200, 14400, 9600 };
+
+// Function to read the module's answer until ack shows up or timeout, returns bytes read (0 = no ack)
+template<class Port>
+int e5Expect(Port & port, const char * ack, unsigned long timeout_ms, char * buf = nullptr, int len = 0){
+    char local[64];
+    if (buf == nullptr){
+        buf = local;
+        len = sizeof(local);
+    }
+    int index = 0;
+    buf[0] = 0;
+    unsigned long start = millis();
+    do {
+        while (port.available() > 0){
+            char ch = port.read();
+            if (index < len - 1){
+                buf[index++] = ch;
+                buf[index] = 0;
+            }
+        }
+        if (strstr(buf, ack) != NULL){
+            return index;
+        }
+        yield();
+    } while (millis() - start < timeout_ms);
+    return 0;
+}
+
+// Function to check the module answers at the given baud
+template<class Port>
+bool e5Probe(Port & port, unsigned long baud){
+    port.begin(baud);
+    while (port.available() > 0){
+        port.read();
+    }
+    // leading CR/LF flushes anything half received at the wrong rate
+    port.print("\r\nAT\r\n");
+    return e5Expect(port, "+AT: OK", 200) > 0;
+}
+
+// Function to move the module from baud "from" to baud "to" (module reboots)
+template<class Port>
+bool e5SetBaud(Port & port, unsigned long from, unsigned long to){
+    if (from == to){
+        return true;
+    }
+    port.print("AT+UART=BR, ");
+    port.print(to);
+    port.print("\r\n");
+    if (!e5Expect(port, "BR", 500)){
+        return false;
+    }
+    port.print("AT+RESET\r\n");
+    e5Expect(port, "+RESET: OK", 500);
+    delay(1000);    // module boot time
+    return e5Probe(port, to);
+}
+
+// Function to find the module's current baud and switch it to the wanted one.
+// Returns the baud the link ended up at, 0 when no module answers at any rate
+template<class Port>
+unsigned long e5Begin(Port & port, unsigned long wanted){
+    if (e5Probe(port, wanted)){
+        return wanted;
+    }
+    for (uint8_t i = 0; i < sizeof(e5Bauds) / sizeof(e5Bauds[0]); i++){
+        if (e5Bauds[i] != wanted && e5Probe(port, e5Bauds[i])){
+            return e5SetBaud(port, e5Bauds[i], wanted) ? wanted : (e5Probe(port, e5Bauds[i]) ? e5Bauds[i] : 0);
+        }
+    }
+    return 0;
+}
+
+// Function to measure command latency and byte loss at the current baud.
+// Sends AT+VER n times - every answer must be the same "+VER: x.y.z\r\n" line, so the first answer is
+// the reference and later ones are checked against it byte for byte.
+// Prints LINK,<baud>,<n>,<mean us>,<max us>,<bytes received>,<bytes expected>,<bad answers>
+template<class Port>
+void e5LinkTest(Port & port, Print & out, unsigned long baud, uint16_t n){
+    char ref[48], buf[48];
+    while (port.available() > 0){
+        port.read();
+    }
+    port.print("AT+VER\r\n");
+    int refLen = e5Expect(port, "\n", 500, ref, sizeof(ref));
+
+    unsigned long total = 0, worst = 0, got = 0;
+    uint16_t bad = 0;
+    for (uint16_t i = 0; i < n; i++){
+        unsigned long t0 = micros();
+        port.print("AT+VER\r\n");
+        int len = e5Expect(port, "\n", 500, buf, sizeof(buf));
+        unsigned long dt = micros() - t0;
+        total += dt;
+        if (dt > worst) worst = dt;
+        got += len;
+        if (len != refLen || memcmp(buf, ref, len) != 0){
+            bad++;
+        }
+    }
+    out.print("LINK,");
+    out.print(baud);
+    out.print(',');
+    out.print(n);
+    out.print(',');
+    out.print(n ? total / n : 0);
+    out.print(',');
+    out.print(worst);
+    out.print(',');
+    out.print(got);
+    out.print(',');
+    out.print((unsigned long)refLen * n);
+    out.print(',');
+    out.println(bad);
+}
+
+// Function to run e5LinkTest() at every supported baud, leaving the link at "finalBaud"
+template<class Port>
+void e5LinkSweep(Port & port, Print & out, unsigned long current, uint16_t n, unsigned long finalBaud){
+    for (int8_t i = sizeof(e5Bauds) / sizeof(e5Bauds[0]) - 1; i >= 0; i--){
+        if (!e5SetBaud(port, current, e5Bauds[i])){
+            out.print("LINK,");
+            out.print(e5Bauds[i]);
+            out.println(",switch failed");
+            continue;
+        }
+        current = e5Bauds[i];
+        e5LinkTest(port, out, current, n);
+    }
+    e5SetBaud(port, current, finalBaud);
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Sensor Node history record - shared by the Sensor Node's EEPROM log (Sensor-Node/include/
+HistoryLog.h), the End Node and the host tools (Host-Tools/include/UrcDecode.h, loadgen). Little
+endian, packed. The records go on air unchanged in the backfill frame, a binary LoRa payload:
+
+    "HB," <count> <count x HistoryRecord>
+
+The check byte is a CRC-8 over the rest of the record, historyCheck().
+
+The Sensor Node takes a new seq every SENSOR_SEND_INTERVAL, the End Node places backfilled
+records in time by their seq distance to the last live frame.
+ */
+
+// Sensor Node send interval, ms - one live frame and one seq each
+#define SENSOR_SEND_INTERVAL 20000UL
+
+// One encoded sample - 11 bytes
+struct HistoryRecord {
+    uint16_t seq;
+    uint8_t  m1, m2, rain, humi;
+    int8_t   temp;
+    int16_t  disp;      // m/s^2 x 100
+    uint8_t  flags;
+    uint8_t  check;
+} __attribute__((packed));
+
+// HistoryRecord flags
+#define HISTORY_VIB     0x01
+#define HISTORY_ALERT   0x02
+#define HISTORY_SENT    0x80    // EEPROM only, the gateway acknowledged the record
+
+static_assert(sizeof(HistoryRecord) == 11, "HistoryRecord must stay 11 bytes");
+
+// Function to work out a record's check byte: CRC-8 (poly 0x07) over everything but the check byte.
+// The non-zero seed makes both erased (all 0xFF) and zeroed EEPROM slots fail the check
+static inline uint8_t historyCheck(const HistoryRecord & rec){
+    const uint8_t * p = (const uint8_t *)&rec;
+    uint8_t crc = 0x5A;
+    for (uint8_t i = 0; i < sizeof(HistoryRecord) - 1; i++){
+        crc ^= p[i];
+        for (uint8_t b = 0; b < 8; b++){
+            crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,159 @@
+#pragma once
+#include <Arduino.h>
+#include <stdarg.h>
+
+/*
+Logging facade with compile-time levels and a non-blocking TX ring buffer.
+
+Messages below LOG_LEVEL compile to nothing (their arguments aren't evaluated, but still
+count as used), set it with -D LOG_LEVEL=... in build_flags
+(LOG_LEVEL_NONE for release builds removes logging and the ring buffer entirely).
+Format strings stay in flash. Output is queued in a ring buffer and handed to the serial
+port only as fast as its TX buffer has room, a full ring drops the message instead of
+stalling the radio loop; the number of dropped bytes is reported once there is room again.
+
+USAGE:
+
+    logBegin(Serial);                       // once in setup(), after Serial.begin()
+    LOG_INFO("Sent %d records", n);         // printf style, adds \r\n
+    LOG_DEBUG_STR(cmd);                     // a RAM string as is, no newline
+    LOG_TRACE_CHAR(ch);                     // single characters (modem byte echo)
+    logPump();                              // in loop() and busy-wait loops
+    logFlush();                             // blocking, e.g. before sleeping
+ */
+
+#define LOG_LEVEL_NONE  0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_INFO  3
+#define LOG_LEVEL_DEBUG 4   // + every AT command sent to the modem
+#define LOG_LEVEL_TRACE 5   // + every byte received from the modem
+
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE 256     // power of two
+#endif
+
+#if LOG_LEVEL > LOG_LEVEL_NONE
+
+static char     logRing[LOG_RING_SIZE];
+static uint16_t logHead = 0;      // next byte written
+static uint16_t logTail = 0;      // next byte sent
+static uint16_t logDropped = 0;
+static Print *  logPort = nullptr;
+
+static inline void logBegin(Print & port){
+    logPort = &port;
+}
+
+// Function to move queued bytes to the port, only as many as fit without blocking
+static inline void logPump(){
+    if (logPort == nullptr){
+        return;
+    }
+    int room = logPort->availableForWrite();
+    while (room > 0 && logTail != logHead){
+        logPort->write((uint8_t)logRing[logTail]);
+        logTail = (logTail + 1) & (LOG_RING_SIZE - 1);
+        room--;
+    }
+    if (logDropped && logTail == logHead && room > 16){
+        logPort->print(F("[log dropped "));
+        logPort->print(logDropped);
+        logPort->print(F("]\r\n"));
+        logDropped = 0;
+    }
+}
+
+// Function to queue len bytes, all or nothing
+static inline void logWrite(const char * s, uint16_t len){
+    uint16_t used = (logHead - logTail) & (LOG_RING_SIZE - 1);
+    if (len > LOG_RING_SIZE - 1 - used){
+        logDropped += len;
+        return;
+    }
+    for (uint16_t i = 0; i < len; i++){
+        logRing[logHead] = s[i];
+        logHead = (logHead + 1) & (LOG_RING_SIZE - 1);
+    }
+    logPump();
+}
+
+// Function to format a message with a format string in flash and queue it with \r\n
+static inline void logPrintf_P(PGM_P fmt, ...){
+    char buf[96];
+    va_list args;
+    va_start(args, fmt);
+#if defined(__AVR__) || defined(ESP8266)
+    int len = vsnprintf_P(buf, sizeof(buf) - 2, fmt, args);
+#else
+    int len = vsnprintf(buf, sizeof(buf) - 2, fmt, args);
+#endif
+    va_end(args);
+    if (len < 0){
+        return;
+    }
+    if (len > (int)sizeof(buf) - 3){
+        len = sizeof(buf) - 3;
+    }
+    buf[len++] = '\r';
+    buf[len++] = '\n';
+    logWrite(buf, len);
+}
+
+// Function to send everything queued, blocking
+static inline void logFlush(){
+    while (logPort != nullptr && logTail != logHead){
+        logPump();
+    }
+    if (logPort != nullptr){
+        logPort->flush();
+    }
+}
+
+#else
+
+#define logBegin(port)
+#define logPump()
+#define logFlush()
+
+#endif
+
+// Function to take the arguments of a message that is compiled out, they count as used but are never evaluated
+template <typename... Args> static inline void logUnused(const Args &...){}
+#define LOG_UNUSED(...) do { if (0) logUnused(__VA_ARGS__); } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...) logPrintf_P(PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...) LOG_UNUSED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...) logPrintf_P(PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...) LOG_UNUSED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...) logPrintf_P(PSTR(fmt), ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...) LOG_UNUSED(fmt, ##__VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...) logPrintf_P(PSTR(fmt), ##__VA_ARGS__)
+#define LOG_DEBUG_STR(s) logWrite((s), strlen(s))
+#else
+#define LOG_DEBUG(fmt, ...) LOG_UNUSED(fmt, ##__VA_ARGS__)
+#define LOG_DEBUG_STR(s) LOG_UNUSED(s)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_TRACE
+#define LOG_TRACE_CHAR(ch) do { char c_ = (ch); logWrite(&c_, 1); } while (0)
+#else
+#define LOG_TRACE_CHAR(ch) LOG_UNUSED(ch)
+#endif
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdint.h>
+
+/*
+RGB332 -> RGB565 pixel expansion - shared by the End Node (RawImage.h) and the host tools
+(bmp2raw, pixel_bench), so both sides produce the same pixels.
+
+RGB565 comes out high byte first in memory, the order pushImage() sends 16-bit pixels with
+swap bytes off. The colours are the ones TFT_eSPI's own 8-bit pushImage uses: red and green
+repeat their top bits into the low bits, blue maps 0..3 to 0, 11, 21, 31.
+
+USAGE:
+
+    uint16_t c = rgb332To565be(0xE0);           // one pixel
+    expandRgb332(in, out, count);               // a run of pixels through the 256 entry table
+ */
+
+// Function to expand an RGB332 pixel to RGB565, high byte first in memory
+static inline uint16_t rgb332To565be(uint8_t c){
+    static const uint8_t blue[] = { 0, 11, 21, 31 };
+    uint8_t msb = (c & 0xE0) | ((c & 0xC0) >> 3) | ((c & 0x1C) >> 2);
+    uint8_t lsb = ((c & 0x1C) << 3) | blue[c & 0x03];
+    return (lsb << 8) | msb;
+}
+
+// Function to get the 256 entry expansion table (512 bytes of RAM, filled on first use)
+static inline const uint16_t * rgb332Lut(){
+    static uint16_t lut[256];
+    static bool ready = false;
+    if (!ready){
+        for (int i = 0; i < 256; i++){
+            lut[i] = rgb332To565be(i);
+        }
+        ready = true;
+    }
+    return lut;
+}
+
+// Function to expand count RGB332 pixels to RGB565. in may be the upper half of out (in == out + count
+// bytes), every pixel is read before it is overwritten
+static inline void expandRgb332(const uint8_t * in, uint16_t * out, int32_t count){
+    const uint16_t * lut = rgb332Lut();
+    int32_t i = 0;
+    for (; i + 4 <= count; i += 4){
+        uint8_t a = in[i], b = in[i + 1], c = in[i + 2], d = in[i + 3];
+        out[i]     = lut[a];
+        out[i + 1] = lut[b];
+        out[i + 2] = lut[c];
+        out[i + 3] = lut[d];
+    }
+    for (; i < count; i++){
+        out[i] = lut[in[i]];
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+
+/*
+Image container for the sd card screens - shared by the End Node (RawImage.h) and the host converter
+(Host-Tools/src/bmp2raw.cpp).
+
+    RawImageHeader      16 bytes, little endian
+    palette             paletteSize RGB565 entries, RAW_PAL8 only
+    rows                height rows, each stride bytes (uncompressed) or an RLE row (RAW_RLE)
+
+Pixels:
+    RAW_RGB332          1 byte  rrrgggbb
+    RAW_RGB565          2 bytes RGB565, high byte first (the order pushImage() sends with swap bytes off)
+    RAW_PAL8            1 byte  index into the palette
+
+RLE rows are PackBits style in whole pixels, runs never cross rows:
+    n = 0..127          n + 1 literal pixels follow
+    n = 128..255        the next pixel repeats n - 126 times (2..129)
+
+Files without the magic are the older bare format, int16 width, int16 height, then pixels.
+ */
+
+#define RAW_IMAGE_MAGIC   "M2EI"
+#define RAW_IMAGE_VERSION 1
+
+enum RawPixelFormat : uint8_t {
+    RAW_LEGACY = 0,         // no header, pixel size given by the caller
+    RAW_RGB332 = 1,
+    RAW_RGB565 = 2,
+    RAW_PAL8   = 3,
+};
+
+enum RawCompression : uint8_t {
+    RAW_NONE = 0,
+    RAW_RLE  = 1,
+};
+
+struct RawImageHeader {
+    char     magic[4];          // RAW_IMAGE_MAGIC
+    uint8_t  version;
+    uint8_t  format;            // RawPixelFormat
+    uint8_t  compression;       // RawCompression
+    uint8_t  reserved;
+    uint16_t width;
+    uint16_t height;
+    uint16_t stride;            // bytes per uncompressed row in the file, >= width * pixel size
+    uint16_t paletteSize;       // RAW_PAL8: 1..256
+} __attribute__((packed));
+
+static inline uint8_t rawPixelSize(uint8_t format){
+    return format == RAW_RGB565 ? 2 : 1;
+}
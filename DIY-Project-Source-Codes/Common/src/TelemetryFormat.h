@@ -0,0 +1,163 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+Telemetry log format - shared by the End Node (TelemetryLog.h, TelemetryExport.h) and the host
+receiver (Host-Tools/src/telemetry_export.cpp). Little endian, packed.
+
+The log is a row of 512 byte blocks, one sd card sector each, every block a 32 byte
+header and up to 15 fixed size 32 byte records:
+
+    TelemetryBlock      magic, kind, count, first seq, first and last time, CRC-16 of the block
+    TelemetryRecord     raw blocks - seq, time, Sensor Node seq, RSSI/SNR, readings
+    TelemetryRollup     hourly blocks - min/max/mean of rain, moisture 1/2 and displacement
+
+Times are End Node log seconds (unix time once a host has set the clock). Rollups of
+the same hour can appear twice, in two blocks, readers merge them.
+
+A record's time is when it was logged, the index the blocks are searched by. Backfill
+records (Sensor Node history sent after a gap) arrive late, they carry the time their
+readings were taken in place of the Gateway readings they don't have: the End Node
+works it out from the Sensor Node seq gap to the last live frame, 0 if it couldn't.
+telemetryTaken() gives it for any record.
+
+Export over USB serial: the host sends a text line, the End Node answers with frames,
+each a TelemetryFrame header and length bytes of payload:
+
+    EXPORT RAW|HOURLY <from> <to> [offset]\n
+        TELEMETRY_FRAME_DATA    one block of the export per frame, offset = its number in the
+                                export. A damaged block is sent with no payload so the numbers
+                                stay put. Sending the same command with offset n resumes at block n
+        TELEMETRY_FRAME_END     offset = blocks in the export
+        TELEMETRY_FRAME_ERROR   payload = message text
+    CLOCK <unix time>\n        moves the log clock forward (TelemetryLog::setClock())
+    ABORT\n                    stops an export
+
+Blocks are sent whole, so the first and last can hold records outside from..to, and a
+resumed export resends the block that was partial when it stopped - receivers filter on
+time and drop records they already have by seq.
+ */
+
+#define TELEMETRY_BLOCK_SIZE    512
+#define TELEMETRY_RECORDS       15              // per block
+#define TELEMETRY_MAGIC         0x4C45324DUL    // "M2EL"
+#define TELEMETRY_VERSION       2
+#define TELEMETRY_NO_SEQ        0xFFFF          // snSeq of frames without a Sensor Node seq
+
+// TelemetryRecord flags
+#define TELEMETRY_VIB       0x01
+#define TELEMETRY_ALERT     0x02
+#define TELEMETRY_BACKFILL  0x04    // from a Sensor Node history frame, time is when it arrived, see taken
+
+// Segment / block kinds
+#define TELEMETRY_RAW       0
+#define TELEMETRY_HOURLY    1
+
+struct TelemetryRecord {
+    uint32_t seq;               // End Node log sequence, set by append()
+    uint32_t time;              // log seconds, set by append()
+    uint16_t snSeq;             // Sensor Node seq, TELEMETRY_NO_SEQ if the frame has none
+    uint8_t  flags;
+    int8_t   snr;
+    int16_t  rssi;
+    int16_t  m1, m2, rain, humi, temp;      // x 10
+    int16_t  disp;                          // x 100
+    union {
+        struct __attribute__((packed)) {
+            int16_t gwRain, gwHumi, gwTemp;     // x 10
+        };
+        struct __attribute__((packed)) {
+            uint32_t taken;                     // TELEMETRY_BACKFILL records, log seconds, 0 = unknown
+            int16_t  spare;
+        };
+    };
+} __attribute__((packed));
+
+// One hour of raw records. Fields in order rain, m1, m2, disp, scaled as in TelemetryRecord
+#define TELEMETRY_ROLLUP_FIELDS 4
+struct TelemetryRollup {
+    uint32_t time;              // start of the hour, log seconds
+    uint16_t count;             // records in the hour
+    uint8_t  alerts;            // records flagged alert, 255 = 255 or more
+    uint8_t  vibs;              // records flagged vibration
+    int16_t  lo[TELEMETRY_ROLLUP_FIELDS];
+    int16_t  hi[TELEMETRY_ROLLUP_FIELDS];
+    int16_t  mean[TELEMETRY_ROLLUP_FIELDS];
+} __attribute__((packed));
+
+struct TelemetryBlock {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;             // records used, 1..TELEMETRY_RECORDS
+    uint32_t firstSeq;          // raw blocks
+    uint32_t firstTime;
+    uint32_t lastTime;
+    uint32_t index;             // block number in the segment
+    uint16_t crc;               // CRC-16/CCITT of the whole block with crc = 0
+    uint8_t  kind;
+    uint8_t  reserved[5];
+    union {
+        TelemetryRecord records[TELEMETRY_RECORDS];
+        TelemetryRollup rollups[TELEMETRY_RECORDS];
+    };
+
+    uint32_t timeOf(uint8_t i) const {
+        return kind == TELEMETRY_HOURLY ? rollups[i].time : records[i].time;
+    }
+} __attribute__((packed));
+
+// Export frames
+#define TELEMETRY_FRAME_SYNC    0x5845324DUL    // "M2EX"
+#define TELEMETRY_FRAME_DATA    1
+#define TELEMETRY_FRAME_END     2
+#define TELEMETRY_FRAME_ERROR   3
+
+struct TelemetryFrame {
+    uint32_t sync;
+    uint8_t  type;
+    uint8_t  kind;              // of the exported blocks
+    uint16_t length;            // payload bytes, at most TELEMETRY_BLOCK_SIZE
+    uint32_t offset;
+    uint16_t crc;               // CRC-16/CCITT of the header with crc = 0, then the payload
+    uint16_t reserved;
+} __attribute__((packed));
+
+static_assert(sizeof(TelemetryRecord) == 32, "TelemetryRecord must stay 32 bytes");
+static_assert(sizeof(TelemetryRollup) == 32, "TelemetryRollup must stay 32 bytes");
+static_assert(sizeof(TelemetryBlock) == TELEMETRY_BLOCK_SIZE, "TelemetryBlock must be one sector");
+static_assert(sizeof(TelemetryFrame) == 16, "TelemetryFrame must stay 16 bytes");
+
+// Function to work out a CRC-16/CCITT, pass the previous result as crc to carry on over more data
+static inline uint16_t telemetryCrc16(const void * data, size_t size, uint16_t crc = 0xFFFF){
+    const uint8_t * p = (const uint8_t *)data;
+    for (size_t i = 0; i < size; i++){
+        crc ^= (uint16_t)p[i] << 8;
+        for (uint8_t k = 0; k < 8; k++){
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+        }
+    }
+    return crc;
+}
+
+// Function to get the log time a record's readings were taken, 0 for a backfill record that couldn't be placed
+static inline uint32_t telemetryTaken(const TelemetryRecord & r){
+    return (r.flags & TELEMETRY_BACKFILL) ? r.taken : r.time;
+}
+
+// Function to check a block read from block number index of a segment
+static inline bool telemetryBlockValid(TelemetryBlock & b, uint32_t index){
+    uint16_t crc = b.crc;
+    b.crc = 0;
+    bool ok = b.magic == TELEMETRY_MAGIC && b.version == TELEMETRY_VERSION && b.index == index &&
+              b.count >= 1 && b.count <= TELEMETRY_RECORDS && telemetryCrc16(&b, sizeof(b)) == crc;
+    b.crc = crc;
+    return ok;
+}
+
+// Function to work out a frame's CRC, header and payload
+static inline uint16_t telemetryFrameCrc(const TelemetryFrame & f, const void * payload){
+    TelemetryFrame h = f;
+    h.crc = 0;
+    return telemetryCrc16(payload, f.length, telemetryCrc16(&h, sizeof(h)));
+}
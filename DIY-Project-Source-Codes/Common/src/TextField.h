@@ -0,0 +1,76 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+Retained on-screen text field - remembers what it last drew and only touches the display
+when the text (or its colours) change.
+
+Text is drawn in the classic 6x8 font with a background colour, so the new text paints over
+the old one and only the part of a longer old text sticking out past the new one is cleared.
+Works with any Adafruit GFX or TFT_eSPI style display (setCursor/setTextColor/print/fillRect).
+
+USAGE:
+
+    TextField m1Field(70, 28);                              // x, y, text size (default 1)
+    m1Field.drawNumber(tft, m1, ST7735_CYAN, ST7735_BLACK); // no SPI traffic if m1 didn't change
+    dispField.drawFloat(tft, disp, 2, ST7735_CYAN, ST7735_BLACK);
+    statusField.draw(tft, "Alert", ST7735_WHITE, ST7735_RED);
+    m1Field.invalidate();                                   // repaint on the next draw (screen was cleared)
+ */
+
+#define TEXT_FIELD_LEN 12       // longest text kept, including the terminating 0
+
+class TextField {
+public:
+    TextField(int16_t x, int16_t y, uint8_t size = 1) : x(x), y(y), size(size) {}
+
+    // Function to draw text if it differs from what is on screen. Returns true if it drew
+    template<class Display>
+    bool draw(Display & d, const char * text, uint16_t fg, uint16_t bg){
+        if (valid && fg == lastFg && bg == lastBg && strncmp(text, last, TEXT_FIELD_LEN - 1) == 0){
+            return false;
+        }
+        uint8_t n = 0;
+        while (n < TEXT_FIELD_LEN - 1 && text[n]){         // longer text is cut to fit
+            last[n] = text[n];
+            n++;
+        }
+        last[n] = 0;
+        int16_t w = n * 6 * size;
+
+        d.setTextSize(size);
+        d.setTextColor(fg, bg);
+        d.setCursor(x, y);
+        d.print(last);
+        if (valid && lastWidth > w){
+            d.fillRect(x + w, y, lastWidth - w, 8 * size, bg);
+        }
+        lastWidth = w;
+        lastFg = fg;
+        lastBg = bg;
+        valid = true;
+        return true;
+    }
+
+    template<class Display>
+    bool drawNumber(Display & d, long value, uint16_t fg, uint16_t bg){
+        char buf[TEXT_FIELD_LEN];
+        return draw(d, ltoa(value, buf, 10), fg, bg);
+    }
+
+    template<class Display>
+    bool drawFloat(Display & d, float value, uint8_t dp, uint16_t fg, uint16_t bg){
+        char buf[TEXT_FIELD_LEN + 8];
+        return draw(d, dtostrf(value, 0, dp, buf), fg, bg);
+    }
+
+    void invalidate(){ valid = false; }
+
+private:
+    int16_t  x, y;
+    uint8_t  size;
+    bool     valid = false;
+    char     last[TEXT_FIELD_LEN] = "";
+    int16_t  lastWidth = 0;
+    uint16_t lastFg = 0, lastBg = 0;
+};
@@ -0,0 +1,96 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Program           - End Node hot path micro-benchmarks
+// Software          - C/C++, PlatformIO IDE - pio run -e bench -t upload (board), pio run -e native_bench (PC)
+// -----------------------------------------------------------------------------------------------------------//
+// Builds the End Node sketch with its Wio E5 link (SoftwareSerial e5) replaced by a BenchModem, then times the
+// code every received packet runs: the URC parsing and its helpers, and the AT command ack matching. One
+// BENCH,... line per case on the serial monitor (see ../Common/src/Bench.h).
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "Bench.h"
+
+#ifdef E5_HW_UART
+#error "The benchmarks replace the SoftwareSerial Wio E5 link, build them without E5_HW_UART"
+#endif
+
+// The sketch, with its own setup() / loop() renamed out of the way
+#define SoftwareSerial BenchModem
+#define setup sketchSetup
+#define loop sketchLoop
+#include "../src/main.cpp"
+#undef setup
+#undef loop
+#undef SoftwareSerial
+
+#ifdef ARDUINO_ARCH_NATIVE
+#include "Hal.h"
+#endif
+
+// A Gateway live frame and a relayed 4 record history backfill frame, as the Wio E5 reports them
+static const char liveUrc[] = "+TEST: LEN:39, RSSI:-70, SNR:9\r\n"
+                              "+TEST: RX \"454E2C3232302C3134382C3235342C36302C32352C302E35372C302C302C3235342C"
+                              "36302C3235\"\r\n";
+static const char backfillUrc[] = "+TEST: LEN:48, RSSI:-70, SNR:9\r\n"
+                                  "+TEST: RX \"48422C040D00DC94143C19390000000E00DC94153C19390000000F00DC94163C1939"
+                                  "0000001000DC94173C1939000000\"\r\n";
+static const char rxAnswer[] = "+TEST: RXLRPKT\r\n";
+
+static char rxCmd[] = "AT+TEST=RXLRPKT\r\n";
+static const char payloadHex[] = "3232302C3134382C3235342C36302C32352C302E35372C302C302C3235342C36302C3235";
+static const char payloadText[] = "220,148,254,60,25,0.57,0,0,254,60,25";
+
+static void atAckOp(){
+    benchSink += at_send_check_response("+TEST: RXLRPKT", 1500, rxCmd);
+}
+
+static void recvLiveOp(){
+    e5.feed(liveUrc);
+    int frame = FRAME_NONE;
+    for (uint8_t i = 0; i < 4 && frame == FRAME_NONE; i++){
+        frame = recv_parse();
+    }
+    benchSink += frame;
+}
+
+static void recvBackfillOp(){
+    e5.feed(backfillUrc);
+    int frame = FRAME_NONE;
+    for (uint8_t i = 0; i < 4 && frame == FRAME_NONE; i++){
+        frame = recv_parse();
+    }
+    benchSink += frame;
+}
+
+// The eleven fields recv_parse() takes from a live frame
+static void getValueOp(){
+    for (int i = 0; i < 11; i++){
+        benchSink += getValue(payloadText, ',', i).length();
+    }
+}
+
+static void unHexOp(){
+    char output[128];
+    benchSink += unHex(payloadHex, output, sizeof(output))[0];
+}
+
+void setup(){
+    Serial.begin(9600);
+
+    benchBegin(Serial);
+    e5.answer(nullptr);
+    benchRun("recv_parse_live", recvLiveOp, 500);
+    benchRun("recv_parse_backfill", recvBackfillOp, 500);
+    benchRun("getValue_x11", getValueOp, 500);
+    benchRun("unHex", unHexOp, 1000);
+    e5.answer(rxAnswer);
+    benchRun("at_send_check_response", atAckOp, 500);
+}
+
+void loop(){
+#ifdef ARDUINO_ARCH_NATIVE
+    halStop();
+#endif
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+Wio Terminal buttons on pin change interrupts.
+
+Every button shares one interrupt handler, which samples all of them and latches
+a press (HIGH -> LOW edge) once the button has been steady for BUTTON_DEBOUNCE_MS.
+loop() collects the latched presses with buttonsPressed() whenever it gets round
+to it, so a press is never missed while the sketch is busy elsewhere.
+
+The SAMD51 has 16 external interrupt lines and some Wio Terminal buttons share one
+(WIO_5S_UP and WIO_KEY_A both use EXTINT 10), only one pin per line can interrupt.
+
+USAGE:
+
+    static const uint8_t pins[] = { WIO_5S_LEFT, WIO_5S_RIGHT, WIO_5S_PRESS, WIO_KEY_C };
+    buttonsBegin(pins, 4);
+    uint8_t pressed = buttonsPressed();     // bit i set = pins[i] was pressed since the last call
+ */
+
+#ifndef BUTTON_DEBOUNCE_MS
+#define BUTTON_DEBOUNCE_MS 30
+#endif
+
+#define BUTTONS_MAX 8
+
+static const uint8_t * buttonPins = nullptr;
+static uint8_t buttonCount = 0;
+static volatile uint8_t buttonDown = 0;         // last level seen, bit set = held
+static volatile uint8_t buttonLatched = 0;      // presses not collected yet
+static volatile uint32_t buttonChanged[BUTTONS_MAX];
+
+// Function called on any button edge
+static void buttonsIsr(){
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < buttonCount; i++){
+        uint8_t bit = 1 << i;
+        bool down = digitalRead(buttonPins[i]) == LOW;
+        if (down == ((buttonDown & bit) != 0)){
+            continue;
+        }
+        // a bounce within BUTTON_DEBOUNCE_MS of the last edge changes the level but isn't a press
+        if (down && now - buttonChanged[i] >= BUTTON_DEBOUNCE_MS){
+            buttonLatched |= bit;
+        }
+        buttonDown ^= bit;
+        buttonChanged[i] = now;
+    }
+}
+
+// Function to set up the buttons (pull-ups on, interrupts on both edges), pins has to stay valid
+static void buttonsBegin(const uint8_t * pins, uint8_t count){
+    buttonPins = pins;
+    buttonCount = count < BUTTONS_MAX ? count : BUTTONS_MAX;
+    for (uint8_t i = 0; i < buttonCount; i++){
+        pinMode(pins[i], INPUT_PULLUP);
+        buttonChanged[i] = 0;
+        if (digitalRead(pins[i]) == LOW){
+            buttonDown |= 1 << i;       // held at boot, not a press
+        }
+        attachInterrupt(digitalPinToInterrupt(pins[i]), buttonsIsr, CHANGE);
+    }
+}
+
+// Function to collect the presses latched since the last call, bit i for pins[i]
+static uint8_t buttonsPressed(){
+    noInterrupts();
+    uint8_t pressed = buttonLatched;
+    buttonLatched = 0;
+    interrupts();
+    return pressed;
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "TFT_eSPI.h"
+
+/*
+Pre-rendered text for values drawn over a plain background.
+
+A free font is drawn one pixel run at a time, each run its own SPI window, so a
+value like "23.45" costs dozens of small transfers. A GlyphAtlas renders the
+characters it will need once, anti-aliased and already blended over the known
+background colour, and then draws a string as one pushImage() per character.
+
+The glyphs are taken from the same font at twice the size (FreeSerifBold18pt7b
+for a 9pt atlas) and each 2x2 block is averaged, which gives 5 levels of edge
+coverage. Metrics are half those of the big font, so text sits within a pixel
+of where the small font would put it with the TL_DATUM drawString() default.
+
+The atlas holds every character of the strings it is given (a nullptr ended
+list, each character once), so give it the strings the sketch draws with it.
+Characters it doesn't hold (and every character when begin() could not get its
+memory) make draw() return 0 - the caller draws the string with the small font
+instead.
+
+USAGE:
+
+    const char * const numbers[] = { "0123456789.-", nullptr };
+    GlyphAtlas values(&FreeSerifBold9pt7b, &FreeSerifBold18pt7b, TFT_WHITE, TFT_BLACK, numbers);
+    values.begin();                         // after tft.begin(), allocates and renders
+    int16_t w = values.draw("23.45", x, y); // width drawn, 0 if it can't
+ */
+
+#define GLYPH_ATLAS_MAX_CHARS 24
+
+extern TFT_eSPI tft;
+
+class GlyphAtlas {
+public:
+    GlyphAtlas(const GFXfont * font, const GFXfont * font2x, uint16_t fg, uint16_t bg, const char * const * texts)
+        : small(font), big(font2x), fg(fg), bg(bg) {
+        // the character set, each character of the texts once (past GLYPH_ATLAS_MAX_CHARS they fall back)
+        uint8_t count = 0;
+        for (; *texts; texts++){
+            for (const char * c = *texts; *c && count < GLYPH_ATLAS_MAX_CHARS; c++){
+                if (strchr(chars, *c) == nullptr){
+                    chars[count++] = *c;
+                    chars[count] = 0;
+                }
+            }
+        }
+    }
+
+    // Function to render the atlas characters, returns false if there isn't enough memory
+    bool begin(){
+        uint8_t count = strlen(chars) < GLYPH_ATLAS_MAX_CHARS ? strlen(chars) : GLYPH_ATLAS_MAX_CHARS;
+        // the big font's tallest glyph, TFT_eSPI puts that at the top of a TL_DATUM string
+        int16_t ascent = 0;
+        for (uint16_t c = big->first; c <= big->last; c++){
+            int16_t a = -big->glyph[c - big->first].yOffset;
+            ascent = a > ascent ? a : ascent;
+        }
+        h = (big->yAdvance + 1) / 2;
+
+        uint32_t pixels = 0;
+        for (uint8_t i = 0; i < count; i++){
+            w[i] = glyph(chars[i]) ? (glyph(chars[i])->xAdvance + 1) / 2 : 0;
+            offset[i] = pixels;
+            pixels += w[i] * h;
+        }
+        delete[] atlas;
+        atlas = new uint16_t[pixels];
+        if (atlas == nullptr){
+            n = 0;
+            return false;
+        }
+
+        // fg over bg at 0..4 of 4 subpixels covered, byte swapped for pushImage()
+        uint16_t shade[5];
+        for (uint8_t k = 0; k <= 4; k++){
+            shade[k] = swap(blend(k));
+        }
+        for (uint8_t i = 0; i < count; i++){
+            uint16_t * cell = atlas + offset[i];
+            memset(cell, 0, w[i] * h * sizeof(uint16_t));
+            const GFXglyph * g = glyph(chars[i]);
+            if (g == nullptr){
+                continue;
+            }
+            // count the big font's set bits into each cell pixel, the bitmap is packed MSB first
+            // with rows running on without padding
+            const uint8_t * bits = big->bitmap + g->bitmapOffset;
+            uint32_t bit = 0;
+            for (int16_t row = 0; row < g->height; row++){
+                for (int16_t col = 0; col < g->width; col++, bit++){
+                    if ((bits[bit >> 3] & (0x80 >> (bit & 7))) == 0){
+                        continue;
+                    }
+                    int16_t x = (g->xOffset + col) >> 1;
+                    int16_t y = (ascent + g->yOffset + row) >> 1;
+                    if (x >= 0 && x < w[i] && y >= 0 && y < h){
+                        cell[y * w[i] + x]++;
+                    }
+                }
+            }
+            for (uint32_t p = 0; p < (uint32_t)w[i] * h; p++){
+                cell[p] = shade[cell[p]];
+            }
+        }
+        n = count;
+        return true;
+    }
+
+    // Function to get the width of a string in atlas characters, 0 if one of them is missing
+    int16_t width(const char * text) const {
+        int16_t total = 0;
+        for (; *text; text++){
+            int8_t i = index(*text);
+            if (i < 0 || w[i] == 0){
+                return 0;
+            }
+            total += w[i];
+        }
+        return total;
+    }
+
+    // Function to draw a string with its top left corner at x, y, one push per character.
+    // Returns the width drawn, 0 (nothing drawn) if a character isn't in the atlas
+    int16_t draw(const char * text, int16_t x, int16_t y) const {
+        int16_t total = width(text);
+        if (total == 0){
+            return 0;
+        }
+        tft.startWrite();
+        for (; *text; text++){
+            int8_t i = index(*text);
+            tft.pushImage(x, y, w[i], h, (const uint16_t *)atlas + offset[i]);
+            x += w[i];
+        }
+        tft.endWrite();
+        return total;
+    }
+
+    int16_t height() const { return h; }
+    const GFXfont * font() const { return small; }
+    uint16_t color() const { return fg; }
+    uint16_t background() const { return bg; }
+
+private:
+    const GFXfont * small;
+    const GFXfont * big;
+    uint16_t fg, bg;
+    char chars[GLYPH_ATLAS_MAX_CHARS + 1] = "";
+    uint8_t n = 0;                  // characters rendered, 0 until begin() succeeds
+    int16_t h = 0;
+    uint8_t w[GLYPH_ATLAS_MAX_CHARS];
+    uint32_t offset[GLYPH_ATLAS_MAX_CHARS];
+    uint16_t * atlas = nullptr;
+
+    const GFXglyph * glyph(char c) const {
+        if ((uint8_t)c < big->first || (uint8_t)c > big->last){
+            return nullptr;
+        }
+        return &big->glyph[(uint8_t)c - big->first];
+    }
+
+    int8_t index(char c) const {
+        for (uint8_t i = 0; i < n; i++){
+            if (chars[i] == c){
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Function to mix fg into bg by k quarters, per RGB565 channel
+    uint16_t blend(uint8_t k) const {
+        int16_t r = (bg >> 11) + (((fg >> 11) - (bg >> 11)) * k) / 4;
+        int16_t g = ((bg >> 5) & 0x3F) + ((((fg >> 5) & 0x3F) - ((bg >> 5) & 0x3F)) * k) / 4;
+        int16_t b = (bg & 0x1F) + (((fg & 0x1F) - (bg & 0x1F)) * k) / 4;
+        return (r << 11) | (g << 5) | b;
+    }
+
+    static uint16_t swap(uint16_t c){
+        return (c << 8) | (c >> 8);
+    }
+};
@@ -0,0 +1,314 @@
+#pragma once
+#include <stdint.h>
+#include "RawImage.h"
+
+/*
+Resident cache of SD card images, keyed by path.
+
+The first draw of an image loads it from the SD card, later draws push it
+straight from RAM. The cache holds at most IMAGE_CACHE_BUDGET bytes, when a
+new image doesn't fit the least recently drawn ones are released first. An
+image bigger than the whole budget is streamed from the SD card (drawImage).
+
+8-bit images are kept PackBits compressed (PackedImage, the same row coding
+as RAW_RLE files) and expanded a few lines at a time as they are drawn. The
+page backgrounds are mostly flat colour, the Sensor Node and Gateway screens
+take 13 KB and 11 KB instead of 75 KB each, so every page background stays
+resident and a page switch never waits for the SD card. 16-bit images are kept
+as plain pixels.
+
+USAGE:
+
+    ImageCache images;
+    images.draw<uint8_t>("m2e-SN.bmp", 0, 0);    // SD read on the first call only
+    images.preload<uint8_t>("m2e-GW.bmp");       // or read it in ahead of the first draw
+    images.restore<uint8_t>("m2e-SN.bmp", x, y, w, h); // redraw part of it from RAM
+    images.drop("m2e-SN.bmp");                   // free one image
+    images.clear();                              // free everything
+ */
+
+#ifndef IMAGE_CACHE_BUDGET
+#define IMAGE_CACHE_BUDGET (80 * 1024UL)
+#endif
+
+#ifndef IMAGE_CACHE_SLOTS
+#define IMAGE_CACHE_SLOTS 4
+#endif
+
+// 8-bit image packed in RAM, one block: this header, height + 1 row offsets, then the PackBits rows
+struct PackedImage {
+    int16_t  width;
+    int16_t  height;
+
+    // Function to draw the image box x, y, w, h at screen sx + x, sy + y, RAW_IMAGE_CHUNK_LINES
+    // rows per push
+    void draw(int16_t sx, int16_t sy, int16_t x, int16_t y, int16_t w, int16_t h){
+        static uint16_t chunk[RAW_IMAGE_MAX_WIDTH * RAW_IMAGE_CHUNK_LINES];
+        static uint8_t  line[RAW_IMAGE_MAX_WIDTH];
+        for (int16_t row = 0; row < h; row += RAW_IMAGE_CHUNK_LINES){
+            int16_t lines = (h - row < RAW_IMAGE_CHUNK_LINES) ? h - row : RAW_IMAGE_CHUNK_LINES;
+            for (int16_t i = 0; i < lines; i++){
+                unpackRow(data() + rows()[y + row + i], line, width);
+                expandRgb332(line + x, chunk + i * w, w);
+            }
+            tft.pushImage(sx + x, sy + y + row, w, lines, chunk);
+        }
+    }
+
+    // Function to PackBits compress one row of 1 byte pixels (see RawImageFormat.h) into out,
+    // or only count the bytes when out is nullptr. Returns the packed size
+    static uint32_t packRow(const uint8_t * row, int16_t w, uint8_t * out){
+        uint32_t size = 0;
+        int16_t x = 0;
+        while (x < w){
+            int16_t run = 1;
+            while (x + run < w && run < 129 && row[x + run] == row[x]){
+                run++;
+            }
+            if (run >= 2){
+                if (out){
+                    out[size] = run + 126;
+                    out[size + 1] = row[x];
+                }
+                size += 2;
+                x += run;
+                continue;
+            }
+            // literals until the next pair of equal pixels
+            int16_t n = 1;
+            while (x + n < w && n < 128 && !(x + n + 1 < w && row[x + n] == row[x + n + 1])){
+                n++;
+            }
+            if (out){
+                out[size] = n - 1;
+                memcpy(out + size + 1, row + x, n);
+            }
+            size += 1 + n;
+            x += n;
+        }
+        return size;
+    }
+
+    static void unpackRow(const uint8_t * p, uint8_t * out, int16_t w){
+        for (int16_t done = 0; done < w; ){
+            uint8_t n = *p++;
+            if (n < 128){
+                memcpy(out + done, p, n + 1);
+                p += n + 1;
+                done += n + 1;
+            } else {
+                memset(out + done, *p++, n - 126);
+                done += n - 126;
+            }
+        }
+    }
+
+    uint32_t * rows(){ return (uint32_t *)(this + 1); }
+    uint8_t * data(){ return (uint8_t *)(rows() + height + 1); }
+};
+
+// Function to read an RGB332 image (or a bare 8-bit one) once to find its packed size, 0 if it
+// can't be packed
+static inline uint32_t packedBytes(const char * path){
+    static uint8_t line[RAW_IMAGE_MAX_WIDTH];
+    RawImageReader reader;
+    if (!reader.open(path, 1)){
+        return 0;
+    }
+    uint32_t size = 0;
+    if (reader.format == RAW_RGB332 && reader.width <= RAW_IMAGE_MAX_WIDTH){
+        size = sizeof(PackedImage) + (reader.height + 1) * sizeof(uint32_t);
+        for (uint16_t row = 0; row < reader.height && size != 0; row++){
+            size = reader.readRow(line) ? size + PackedImage::packRow(line, reader.width, nullptr) : 0;
+        }
+    }
+    reader.close();
+    return size;
+}
+
+// Function to load an image packedBytes() measured into one block of that size
+static inline PackedImage * newPackedImage(const char * path, uint32_t size){
+    static uint8_t line[RAW_IMAGE_MAX_WIDTH];
+    RawImageReader reader;
+    if (!reader.open(path, 1)){
+        return nullptr;
+    }
+    PackedImage * img = (PackedImage *)new uint8_t[size];
+    if (img == nullptr){
+        reader.close();
+        return nullptr;
+    }
+    img->width = reader.width;
+    img->height = reader.height;
+    uint32_t used = 0;
+    for (uint16_t row = 0; row < reader.height; row++){
+        // the file may have changed since it was measured
+        if (!reader.readRow(line) || (uint8_t *)img->data() + used + PackedImage::packRow(line, reader.width, nullptr) > (uint8_t *)img + size){
+            reader.close();
+            delete [] (uint8_t *)img;
+            return nullptr;
+        }
+        img->rows()[row] = used;
+        used += PackedImage::packRow(line, reader.width, img->data() + used);
+    }
+    img->rows()[reader.height] = used;
+    reader.close();
+    return img;
+}
+
+class ImageCache {
+public:
+    // Function to draw a cached image, loading it on a miss. Returns false if the image can't be read
+    template<class type>
+    bool draw(const char * path, size_t x = 0, size_t y = 0){
+        Entry * e = find(path);
+        if (e == nullptr){
+            e = load<type>(path);
+        }
+        if (e == nullptr){
+            // doesn't fit the budget (or is a palette image) - stream it from the sd card without keeping it
+            return drawImage<type>(path, x, y);
+        }
+        e->lastUse = ++useCount;
+        if (e->packed){
+            PackedImage * img = (PackedImage *)e->img;
+            img->draw(x, y, 0, 0, img->width, img->height);
+        } else {
+            ((RawImage<type> *)e->img)->draw(x, y);
+        }
+        return true;
+    }
+
+    // Function to load an image ahead of its first draw. Returns false if it can't be kept
+    template<class type>
+    bool preload(const char * path){
+        return find(path) != nullptr || load<type>(path) != nullptr;
+    }
+
+    bool cached(const char * path){
+        return find(path) != nullptr;
+    }
+
+    // Function to redraw part of a cached image from RAM, e.g. to erase text drawn over it.
+    // Returns false if the image isn't cached
+    template<class type>
+    bool restore(const char * path, int16_t x, int16_t y, int16_t w, int16_t h){
+        Entry * e = find(path);
+        if (e == nullptr){
+            return false;
+        }
+        int16_t width = e->packed ? ((PackedImage *)e->img)->width : ((RawImage<type> *)e->img)->width();
+        int16_t height = e->packed ? ((PackedImage *)e->img)->height : ((RawImage<type> *)e->img)->height();
+        if (x < 0){ w += x; x = 0; }
+        if (y < 0){ h += y; y = 0; }
+        if (x + w > width){ w = width - x; }
+        if (y + h > height){ h = height - y; }
+        if (w <= 0 || h <= 0){
+            return true;
+        }
+        if (e->packed){
+            ((PackedImage *)e->img)->draw(0, 0, x, y, w, h);
+            return true;
+        }
+        RawImage<type> * img = (RawImage<type> *)e->img;
+        // pushImage has no stride, so the box goes out one image row at a time
+        for (int16_t row = 0; row < h; row++){
+            tft.pushImage(x, y + row, w, 1, img->ptr() + (y + row) * img->width() + x);
+        }
+        return true;
+    }
+
+    void drop(const char * path){
+        Entry * e = find(path);
+        if (e != nullptr){
+            release(*e);
+        }
+    }
+
+    void clear(){
+        for (uint8_t i = 0; i < IMAGE_CACHE_SLOTS; i++){
+            release(entries[i]);
+        }
+    }
+
+    uint32_t used(){ return usedBytes; }
+
+private:
+    struct Entry {
+        char       path[32];
+        void     * img;         // PackedImage * or RawImage<type> *, type only known by the caller
+        bool       packed;
+        uint32_t   bytes;
+        uint32_t   lastUse;
+    };
+
+    Entry    entries[IMAGE_CACHE_SLOTS] = {};
+    uint32_t usedBytes = 0;
+    uint32_t useCount = 0;
+
+    Entry * find(const char * path){
+        for (uint8_t i = 0; i < IMAGE_CACHE_SLOTS; i++){
+            if (entries[i].img != nullptr && strncmp(entries[i].path, path, sizeof(entries[i].path)) == 0){
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Function to load an image into a slot, evicting the least recently used ones until it fits
+    template<class type>
+    Entry * load(const char * path){
+        // 0 = missing, or can't be kept as this pixel type
+        bool packed = sizeof(type) == 1;
+        uint32_t size = packed ? packedBytes(path) : imageBytes<type>(path);
+        if (size == 0 || size > IMAGE_CACHE_BUDGET || strlen(path) >= sizeof(entries[0].path)){
+            return nullptr;
+        }
+        while (usedBytes + size > IMAGE_CACHE_BUDGET || freeSlot() == nullptr){
+            release(*oldest());
+        }
+        Entry * e = freeSlot();
+        e->img = packed ? (void *)newPackedImage(path, size) : (void *)newImage<type>(path);
+        if (e->img == nullptr){
+            return nullptr;
+        }
+        strcpy(e->path, path);
+        e->packed = packed;
+        e->bytes = size;
+        usedBytes += size;
+        return e;
+    }
+
+    Entry * freeSlot(){
+        for (uint8_t i = 0; i < IMAGE_CACHE_SLOTS; i++){
+            if (entries[i].img == nullptr){
+                return &entries[i];
+            }
+        }
+        return nullptr;
+    }
+
+    Entry * oldest(){
+        Entry * best = nullptr;
+        for (uint8_t i = 0; i < IMAGE_CACHE_SLOTS; i++){
+            if (entries[i].img != nullptr && (best == nullptr || entries[i].lastUse < best->lastUse)){
+                best = &entries[i];
+            }
+        }
+        return best;
+    }
+
+    void release(Entry & e){
+        if (e.img == nullptr){
+            return;
+        }
+        if (e.packed){
+            delete [] (uint8_t *)e.img;
+        } else {
+            ((Raw8 *)e.img)->release();     // delete [] of the raw bytes, same for both pixel types
+        }
+        e.img = nullptr;
+        usedBytes -= e.bytes;
+        e.bytes = 0;
+    }
+};
@@ -1,6 +1,8 @@
   #pragma once
 #include<stdint.h>
 #include<SD/Seeed_SD.h>
+#include "RawImageFormat.h"
+#include "PixelConvert.h"
 
 
 /*
@@ -18,8 +20,30 @@ USAGE:
     // remember release it
     img8->release();
     img16->release();
+
+    // or stream it straight from the sd card to the screen, a few scanlines at a time
+    drawImage<uint8_t>("path to sd card image.", x, y);
+
+Files made by Host-Tools/bmp2raw carry a header (RawImageFormat.h) with their pixel format, so
+any of them can be streamed with drawImage<>(). newImage<uint8_t> loads RGB332 files and
+newImage<uint16_t> RGB565 files, bare files (no header) are taken as the caller's type.
  */
 
+// Scanlines per streaming chunk and the widest image drawImage() can stream.
+// Two chunk buffers of RAW_IMAGE_MAX_WIDTH * RAW_IMAGE_CHUNK_LINES RGB565 pixels are
+// kept (5 KB with the defaults)
+#ifndef RAW_IMAGE_CHUNK_LINES
+#define RAW_IMAGE_CHUNK_LINES 4
+#endif
+#ifndef RAW_IMAGE_MAX_WIDTH
+#define RAW_IMAGE_MAX_WIDTH 320
+#endif
+
+// Push chunks to the LCD with SPI DMA (TFT_eSPI pushImageDMA) while the next chunk is read
+// from the sd card - uncomment or add -D RAW_IMAGE_DMA, and call tft.initDMA() after tft.begin().
+// The Wio Terminal's sd card and LCD are on separate SPI buses, so both transfers really overlap
+//#define RAW_IMAGE_DMA
+
 extern TFT_eSPI tft;
 
 template<class type>
@@ -46,26 +70,224 @@ private:
 typedef RawImage<uint8_t>  Raw8;
 typedef RawImage<uint16_t> Raw16;
 
+// Sequential row reader for both the M2EI container and the bare format (see RawImageFormat.h)
+class RawImageReader {
+public:
+    uint16_t width = 0;
+    uint16_t height = 0;
+    uint8_t  format = RAW_LEGACY;
+    uint8_t  compression = RAW_NONE;
+    uint8_t  pixelSize = 1;     // bytes per pixel as stored in the file
+
+    // Function to open an image and check its header. legacySize is the pixel size (1 or 2)
+    // of a bare file, which carries no format of its own
+    bool open(const char * path, uint8_t legacySize){
+        f = SD.open(path, FILE_READ);
+        if (!f){
+            return false;
+        }
+        RawImageHeader h;
+        uint32_t dataStart;
+        if (f.read(&h, sizeof(h)) == sizeof(h) && memcmp(h.magic, RAW_IMAGE_MAGIC, 4) == 0){
+            if (h.version != RAW_IMAGE_VERSION || h.format < RAW_RGB332 || h.format > RAW_PAL8 || h.compression > RAW_RLE){
+                return fail();
+            }
+            format = h.format;
+            compression = h.compression;
+            width = h.width;
+            height = h.height;
+            stride = h.stride;
+            if (format == RAW_PAL8){
+                if (h.paletteSize == 0 || h.paletteSize > 256 ||
+                    f.read(palette, h.paletteSize * 2) != h.paletteSize * 2){
+                    return fail();
+                }
+            }
+            dataStart = sizeof(h) + (format == RAW_PAL8 ? h.paletteSize * 2 : 0);
+        } else {
+            int16_t wh[2];                      // int16 width, int16 height, pixels
+            memcpy(wh, &h, sizeof(wh));
+            format = legacySize == 2 ? RAW_RGB565 : RAW_RGB332;
+            compression = RAW_NONE;
+            width = wh[0] > 0 ? wh[0] : 0;
+            height = wh[1] > 0 ? wh[1] : 0;
+            stride = width * legacySize;
+            dataStart = 4;
+        }
+        pixelSize = rawPixelSize(format);
+        if (width == 0 || height == 0 || stride < width * pixelSize){
+            return fail();
+        }
+        // an uncompressed file must hold every row, RLE rows are checked as they are read
+        if (compression == RAW_NONE && f.size() < dataStart + (uint32_t)stride * height){
+            return fail();
+        }
+        return f.seek(dataStart);
+    }
+
+    // Function to read the next row into out, width pixels as stored in the file (pixelSize bytes each)
+    bool readRow(uint8_t * out){
+        int32_t bytes = width * pixelSize;
+        if (compression == RAW_NONE){
+            if (f.read(out, bytes) != bytes){
+                return false;
+            }
+            return stride == bytes || f.seek(f.position() + stride - bytes);
+        }
+        for (uint16_t done = 0; done < width; ){
+            int n = f.read();
+            if (n < 0){
+                return false;
+            }
+            uint16_t count = n < 128 ? n + 1 : n - 126;
+            if (done + count > width){
+                return false;
+            }
+            uint8_t * p = out + done * pixelSize;
+            if (n < 128){
+                if (f.read(p, count * pixelSize) != count * pixelSize){
+                    return false;
+                }
+            } else {
+                if (f.read(p, pixelSize) != pixelSize){
+                    return false;
+                }
+                for (uint16_t i = 1; i < count; i++){
+                    memcpy(p + i * pixelSize, p, pixelSize);
+                }
+            }
+            done += count;
+        }
+        return true;
+    }
+
+    // Function to expand count pixels read by readRow() to RGB565 (high byte first). in may be the
+    // upper half of out, every pixel is read before it is overwritten
+    void expand(const uint8_t * in, uint16_t * out, int32_t count){
+        switch (format){
+        case RAW_RGB332:
+            expandRgb332(in, out, count);
+            break;
+        case RAW_PAL8:
+            for (int32_t i = 0; i < count; i++){
+                out[i] = palette[in[i]];
+            }
+            break;
+        default:
+            if ((const void *)in != (void *)out){
+                memmove(out, in, count * 2);
+            }
+            break;
+        }
+    }
+
+    void close(){
+        f.close();
+    }
+
+private:
+    File     f;
+    uint16_t stride = 0;
+    uint16_t palette[256];
+
+    bool fail(){
+        f.close();
+        return false;
+    }
+};
+
+// Function to check an image can be loaded as RawImage<type> - RGB332 files as 8-bit, RGB565 files
+// as 16-bit, bare files as either. Returns the RAM it takes, 0 if it can't be loaded
+template<class type>
+uint32_t imageBytes(const char * path){
+    RawImageReader reader;
+    if (!reader.open(path, sizeof(type))){
+        return 0;
+    }
+    reader.close();
+    if (reader.format == RAW_PAL8 || reader.pixelSize != sizeof(type)){
+        return 0;
+    }
+    return sizeof(RawImage<type>) + (uint32_t)reader.width * reader.height * sizeof(type);
+}
+
 template<class type>
 RawImage<type> * newImage(const char * path){
     typedef RawImage<type> raw;
-    File f = SD.open(path, FILE_READ);
-    if (!f){
+    RawImageReader reader;
+    if (!reader.open(path, sizeof(type))){
         return nullptr;
     }
-    int32_t size = f.size();
-    raw   * mem = (raw *)new uint8_t[size];
+    if (reader.format == RAW_PAL8 || reader.pixelSize != sizeof(type)){
+        reader.close();
+        return nullptr;         // drawImage() can still stream it
+    }
+    uint32_t pixels = (uint32_t)reader.width * reader.height;
+    raw   * mem = (raw *)new uint8_t[sizeof(raw) + pixels * sizeof(type)];
     if (mem == nullptr){
+        reader.close();
         return nullptr;
     }
-    f.read(mem, size);
-    f.close();
+    int16_t * wh = (int16_t *)mem;      // same layout as a bare file
+    wh[0] = reader.width;
+    wh[1] = reader.height;
+    for (uint16_t row = 0; row < reader.height; row++){
+        if (!reader.readRow((uint8_t *)(mem->ptr() + (uint32_t)row * reader.width))){
+            reader.close();
+            mem->release();
+            return nullptr;
+        }
+    }
+    reader.close();
     return mem;
 }
 
+// Function to stream an image from the sd card to the screen through two small chunk buffers, 8-bit
+// and palette images are expanded to RGB565 one chunk at a time. The decode path follows the file's
+// header, the template type only tells the pixel size of a bare file. Returns false if it can't be drawn
 template<class type>
-void drawImage(const char * path, size_t x = 0, size_t y = 0){
-    auto img = newImage<type>(path);
-    img->draw(x, y);
-    img->release();
+bool drawImage(const char * path, size_t x = 0, size_t y = 0){
+    static uint16_t chunk[2][RAW_IMAGE_MAX_WIDTH * RAW_IMAGE_CHUNK_LINES];
+
+    RawImageReader reader;
+    if (!reader.open(path, sizeof(type))){
+        return false;
+    }
+    if (reader.width > RAW_IMAGE_MAX_WIDTH){
+        reader.close();
+        return false;
+    }
+    int16_t w = reader.width;
+    int16_t h = reader.height;
+    uint8_t  cur = 0;
+    bool ok = true;
+#ifdef RAW_IMAGE_DMA
+    tft.startWrite();
+#endif
+    for (int16_t row = 0; row < h && ok; row += RAW_IMAGE_CHUNK_LINES){
+        int16_t  lines = (h - row < RAW_IMAGE_CHUNK_LINES) ? h - row : RAW_IMAGE_CHUNK_LINES;
+        int32_t  count = (int32_t)w * lines;
+        uint16_t * buf = chunk[cur];
+        // 1 byte pixels go to the top half and are expanded forwards in place
+        uint8_t * raw = (uint8_t *)buf + (reader.pixelSize == 1 ? count : 0);
+        for (int16_t line = 0; line < lines && ok; line++){
+            ok = reader.readRow(raw + (int32_t)line * w * reader.pixelSize);
+        }
+        if (!ok){
+            break;
+        }
+        reader.expand(raw, buf, count);
+#ifdef RAW_IMAGE_DMA
+        tft.pushImageDMA(x, y + row, w, lines, buf);    // waits for the previous chunk, then returns at once
+#else
+        tft.pushImage(x, y + row, w, lines, buf);
+#endif
+        cur ^= 1;
+    }
+#ifdef RAW_IMAGE_DMA
+    tft.dmaWait();
+    tft.endWrite();
+#endif
+    reader.close();
+    return ok;
 }
@@ -0,0 +1,152 @@
+#pragma once
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include "TelemetryLog.h"
+
+/*
+Bulk export of the telemetry log over the USB serial port.
+
+Reads command lines from the port and streams the requested time range as framed,
+CRC checked blocks - the commands and frames are in TelemetryFormat.h, the host side
+is Host-Tools/src/telemetry_export.cpp. The blocks go out exactly as they are on the
+sd card, there is nothing to encode, so the export runs as fast as the sd card reads
+and USB CDC takes them (a day of raw records is about 100 blocks, 50 KB).
+
+poll() sends blocks for at most TELEMETRY_EXPORT_SLICE_MS and then returns, so
+received packets are still handled during a long export. Log messages only go out
+between frames (both are written from loop()), the receiver skips them.
+
+USAGE:
+
+    TelemetryExport exporter(telemetry, Serial);
+    exporter.poll();                    // in loop(), reads commands and sends the next frames
+ */
+
+// Longest poll() keeps sending
+#ifndef TELEMETRY_EXPORT_SLICE_MS
+#define TELEMETRY_EXPORT_SLICE_MS 20
+#endif
+
+class TelemetryExport {
+public:
+    TelemetryExport(TelemetryLog & log, Stream & port) : log(log), port(port) {}
+
+    // Function to read command bytes and stream the export in progress
+    void poll(){
+        while (port.available()){
+            char c = port.read();
+            if (c == '\r' || c == '\n'){
+                line[len] = '\0';
+                if (len > 0){
+                    command(line);
+                }
+                len = 0;
+            } else if (len < sizeof(line) - 1){
+                line[len++] = c;
+            }
+        }
+        unsigned long start = millis();
+        while (active && millis() - start < TELEMETRY_EXPORT_SLICE_MS){
+            sendNext();
+        }
+    }
+
+    bool busy() const { return active; }
+
+private:
+    TelemetryLog & log;
+    Stream & port;
+    char line[48];
+    uint8_t len = 0;
+    bool active = false;
+    uint8_t kind = TELEMETRY_RAW;
+    uint32_t to = 0;
+    uint32_t sent = 0;          // blocks in the export so far, the next frame's offset
+    TelemetryPosition pos;
+    TelemetryBlock block;
+
+    // Function to run one command line
+    void command(char * text){
+        char * arg = strchr(text, ' ');
+        if (arg != nullptr){
+            *arg++ = '\0';
+        }
+        if (strcmp(text, "EXPORT") == 0 && arg != nullptr){
+            char * next;
+            char * which = strtok_r(arg, " ", &next);
+            char * from = strtok_r(nullptr, " ", &next);
+            char * until = strtok_r(nullptr, " ", &next);
+            char * offset = strtok_r(nullptr, " ", &next);
+            if (which == nullptr || from == nullptr || until == nullptr ||
+                (strcmp(which, "RAW") != 0 && strcmp(which, "HOURLY") != 0)){
+                error("usage: EXPORT RAW|HOURLY <from> <to> [offset]");
+                return;
+            }
+            begin(strcmp(which, "RAW") == 0 ? TELEMETRY_RAW : TELEMETRY_HOURLY,
+                  strtoul(from, nullptr, 10), strtoul(until, nullptr, 10), offset ? strtoul(offset, nullptr, 10) : 0);
+        } else if (strcmp(text, "CLOCK") == 0 && arg != nullptr){
+            log.setClock(strtoul(arg, nullptr, 10));
+        } else if (strcmp(text, "ABORT") == 0){
+            active = false;
+        } else {
+            error("unknown command");
+        }
+    }
+
+    // Function to start an export at block offset of the range
+    void begin(uint8_t which, uint32_t from, uint32_t until, uint32_t offset){
+        kind = which;
+        to = until;
+        sent = 0;
+        pos = log.find(kind, from);
+        active = true;
+        // blocks are counted from the one find() gives, stepping over them needs no sd card reads
+        while (sent < offset && log.next(pos)){
+            sent++;
+        }
+        // the log ends at pos, it holds sent + 1 blocks of the export
+        if (sent < offset){
+            sent++;
+            end();
+        }
+    }
+
+    // Function to send the block at pos and step to the next one, or end the export
+    void sendNext(){
+        bool ok = log.readBlock(pos, block);
+        if (!ok){
+            // past the end of the log, or a damaged block in it
+            TelemetryPosition after = pos;
+            if (!log.next(after)){
+                end();
+                return;
+            }
+        } else if (block.firstTime > to){
+            end();
+            return;
+        }
+        frame(TELEMETRY_FRAME_DATA, sent++, &block, ok ? TELEMETRY_BLOCK_SIZE : 0);
+        if (!log.next(pos)){
+            end();
+        }
+    }
+
+    void end(){
+        frame(TELEMETRY_FRAME_END, sent, nullptr, 0);
+        active = false;
+    }
+
+    void error(const char * message){
+        frame(TELEMETRY_FRAME_ERROR, 0, message, strlen(message));
+    }
+
+    void frame(uint8_t type, uint32_t offset, const void * payload, uint16_t length){
+        TelemetryFrame f = { TELEMETRY_FRAME_SYNC, type, kind, length, offset, 0, 0 };
+        f.crc = telemetryFrameCrc(f, payload);
+        port.write((const uint8_t *)&f, sizeof(f));
+        if (length > 0){
+            port.write((const uint8_t *)payload, length);
+        }
+    }
+};
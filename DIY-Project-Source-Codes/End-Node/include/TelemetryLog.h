@@ -0,0 +1,725 @@
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <Seeed_FS.h>
+#include "SD/Seeed_SD.h"
+#include "TelemetryFormat.h"
+#include "HistoryFormat.h"
+
+/*
+Append-only log of received frames on the sd card, in fixed size segment files.
+
+Every segment file is a row of 512 byte blocks (format in TelemetryFormat.h), raw
+segments hold TelemetryRecords, hourly segments TelemetryRollups.
+
+Records collect in a RAM copy of the segment's last block, which goes out as one
+whole aligned sector when it fills up - or earlier, as a partial block, once the
+oldest unwritten record is TELEMETRY_FLUSH_INTERVAL old. A partial block is
+rewritten in place as it fills. Nothing else is ever written again, so a power
+cut can only tear the last block: on open that block is read, and if its CRC
+fails it is dropped (at most 15 records) and the segment carries on from the
+block before it.
+
+A segment is sealed once it holds TELEMETRY_SEGMENT_BLOCKS blocks and a new one
+is started. The manifest lists the segments with their time span, it is kept in
+two files written in turn (generation + CRC), so a torn manifest write falls back
+to the previous one. It is sized from the retention times at one record every
+TELEMETRY_FRAME_SECONDS, with room for the active segments and one of each kind
+waiting to be retired. Should it fill up anyway (frames coming in faster), a new
+segment takes the place of the oldest compacted raw segment, else the oldest
+hourly one - a raw segment that isn't compacted yet is never dropped, appends
+fail until compaction has made one free. A manifest written with a smaller
+TELEMETRY_MAX_SEGMENTS still loads.
+
+Sealed raw segments are compacted in the background into hourly rollups, one
+block per poll() (TELEMETRY_SLICE_INTERVAL apart), so loop() is never held up
+by more than one sector read and write. Retention: a raw segment is deleted once
+it is compacted and its newest record is TELEMETRY_RAW_DAYS old, an hourly one
+when its newest hour is TELEMETRY_HOURLY_DAYS old. An hour that spans two raw
+segments gets one rollup from each, readers merge rollups with the same time.
+Records are rolled up by the time they were logged, backfill records too.
+
+Times are log seconds: they carry on from the last record after a reboot and
+don't count the time the node was off, so they always increase and the block
+headers form a sparse time index - find() picks the segment from the manifest and
+binary searches its block headers, O(log n) sector reads. setClock() moves the
+log clock forward, e.g. to unix time.
+
+USAGE:
+
+    TelemetryLog telemetry;
+    telemetry.begin();                  // after SD.begin(), loads the manifest and recovers the tails
+    telemetry.append(rec);              // fills in rec.seq and rec.time
+    telemetry.poll();                   // in loop(), writes due blocks, compacts one block, retires segments
+    TelemetryPosition p = telemetry.find(TELEMETRY_RAW, t);    // first block at or after time t
+    telemetry.readBlock(p, block);      // false if the block is damaged or p is past the end
+ */
+
+#define TELEMETRY_MANIFEST_MAGIC 0x4D45324DUL   // "M2EM"
+#define TELEMETRY_DIR           "/log"
+
+// Segment size in blocks, 64 = 32 KB, 960 records
+#ifndef TELEMETRY_SEGMENT_BLOCKS
+#define TELEMETRY_SEGMENT_BLOCKS 64
+#endif
+// Longest a received record waits in RAM before its block is written
+#ifndef TELEMETRY_FLUSH_INTERVAL
+#define TELEMETRY_FLUSH_INTERVAL 60000UL
+#endif
+// Time between compaction slices, each reads one raw block
+#ifndef TELEMETRY_SLICE_INTERVAL
+#define TELEMETRY_SLICE_INTERVAL 200UL
+#endif
+// Retention
+#ifndef TELEMETRY_RAW_DAYS
+#define TELEMETRY_RAW_DAYS 7
+#endif
+#ifndef TELEMETRY_HOURLY_DAYS
+#define TELEMETRY_HOURLY_DAYS 365
+#endif
+// Time between received frames the manifest is sized for, the Sensor Node's send interval
+#ifndef TELEMETRY_FRAME_SECONDS
+#define TELEMETRY_FRAME_SECONDS (SENSOR_SEND_INTERVAL / 1000)
+#endif
+// Segments the manifest can list, raw and hourly together. Raw: the retention time's records, the active
+// segment and one waiting to be retired (7 days = 34). Hourly: an hour each plus the extra rollup of an
+// hour split between raw segments, again with the active one and one to retire (365 days = 13)
+#define TELEMETRY_SEGMENT_RECORDS   ((uint32_t)TELEMETRY_SEGMENT_BLOCKS * TELEMETRY_RECORDS)
+#define TELEMETRY_RAW_SEGMENTS      ((TELEMETRY_RAW_DAYS * 86400UL / TELEMETRY_FRAME_SECONDS + TELEMETRY_SEGMENT_RECORDS - 1) \
+                                     / TELEMETRY_SEGMENT_RECORDS + 2)
+#define TELEMETRY_HOURLY_SEGMENTS   ((TELEMETRY_HOURLY_DAYS * 24UL + TELEMETRY_HOURLY_DAYS * 86400UL / TELEMETRY_FRAME_SECONDS \
+                                     / TELEMETRY_SEGMENT_RECORDS + TELEMETRY_SEGMENT_RECORDS - 1) / TELEMETRY_SEGMENT_RECORDS + 2)
+#ifndef TELEMETRY_MAX_SEGMENTS
+#define TELEMETRY_MAX_SEGMENTS (TELEMETRY_RAW_SEGMENTS + TELEMETRY_HOURLY_SEGMENTS)
+#endif
+
+// Segment states
+#define TELEMETRY_ACTIVE    0
+#define TELEMETRY_SEALED    1
+#define TELEMETRY_COMPACTED 2       // raw only, its hours are in the rollups
+
+struct TelemetrySegment {
+    uint32_t id;                // file name
+    uint8_t  kind;
+    uint8_t  state;
+    uint16_t blocks;            // when sealed
+    uint32_t firstTime;
+    uint32_t lastTime;          // when sealed
+    uint32_t firstSeq;
+    uint32_t records;           // when sealed
+} __attribute__((packed));
+
+struct TelemetryManifest {
+    uint32_t magic;
+    uint32_t generation;        // the higher valid copy wins
+    uint32_t nextId;
+    uint16_t count;
+    uint16_t crc;               // CRC-16/CCITT of the manifest with crc = 0
+    TelemetrySegment segments[TELEMETRY_MAX_SEGMENTS];     // oldest first
+} __attribute__((packed));
+
+// A block of the log: segment id and block number in it
+struct TelemetryPosition {
+    uint32_t segment;
+    uint32_t block;
+};
+
+
+static void telemetryPath(char * path, uint8_t kind, uint32_t id){
+    sprintf(path, TELEMETRY_DIR "/%c%07lu.BIN", kind == TELEMETRY_HOURLY ? 'H' : 'R', (unsigned long)id);
+}
+
+// The segment being written, with its last block in RAM
+class TelemetryFile {
+public:
+    // Function to open (or create) a segment and recover its tail. Returns false if it can't be opened
+    bool open(uint8_t kind, uint32_t id){
+        char path[32];
+        telemetryPath(path, kind, id);
+        f = SD.open(path, FILE_WRITE);
+        if (!f){
+            return false;
+        }
+        this->kind = kind;
+        this->id = id;
+        // a torn append can leave a piece of a block at the end, it is overwritten
+        tail = f.size() / TELEMETRY_BLOCK_SIZE;
+        memset(&current, 0, sizeof(current));
+        dirty = false;
+        dropped = 0;
+        while (tail > 0){
+            if (readBlock(tail - 1, current)){
+                if (current.count == TELEMETRY_RECORDS){
+                    last = current;
+                    memset(&current, 0, sizeof(current));   // full, start the next block
+                } else {
+                    tail--;                                 // carry on filling it
+                }
+                break;
+            }
+            dropped++;
+            tail--;
+        }
+        return true;
+    }
+
+    void close(){
+        flush();
+        f.close();
+    }
+
+    // Function to add a record, writes the block once it is full
+    bool append(const void * record){
+        if (!f){
+            return false;
+        }
+        memcpy(&current.records[current.count++], record, sizeof(TelemetryRecord));
+        if (!dirty){
+            dirty = true;
+            dirtySince = millis();
+        }
+        if (current.count < TELEMETRY_RECORDS){
+            return true;
+        }
+        bool ok = writeCurrent();
+        last = current;
+        tail++;
+        memset(&current, 0, sizeof(current));
+        return ok;
+    }
+
+    // Function to write the partial block once its oldest record has waited TELEMETRY_FLUSH_INTERVAL
+    void poll(){
+        if (dirty && millis() - dirtySince >= TELEMETRY_FLUSH_INTERVAL){
+            writeCurrent();
+        }
+    }
+
+    bool flush(){
+        return !dirty || writeCurrent();
+    }
+
+    // Function to read a block, the last one comes from RAM with any records not written yet.
+    // Returns false if it is out of range or fails its check
+    bool readBlock(uint32_t index, TelemetryBlock & out){
+        if (index == tail && current.count > 0){
+            seal(current);
+            out = current;
+            return true;
+        }
+        if (index >= tail || !f.seek(index * TELEMETRY_BLOCK_SIZE) ||
+            f.read(&out, TELEMETRY_BLOCK_SIZE) != TELEMETRY_BLOCK_SIZE){
+            return false;
+        }
+        return telemetryBlockValid(out, index);
+    }
+
+    // Function to get the newest record (32 bytes), false if the segment is empty
+    bool newest(void * record){
+        const TelemetryBlock & b = current.count > 0 ? current : last;
+        if (b.count == 0){
+            return false;
+        }
+        memcpy(record, &b.records[b.count - 1], sizeof(TelemetryRecord));
+        return true;
+    }
+
+    uint32_t blocks(){ return tail + (current.count > 0 ? 1 : 0); }
+    uint32_t records(){ return tail * TELEMETRY_RECORDS + current.count; }
+    bool full(){ return tail >= TELEMETRY_SEGMENT_BLOCKS; }
+    uint32_t segmentId(){ return id; }
+    uint32_t droppedBlocks(){ return dropped; }
+
+private:
+    File f;
+    uint8_t kind = TELEMETRY_RAW;
+    uint32_t id = 0;
+    TelemetryBlock current;     // the block being filled, block number tail
+    TelemetryBlock last;        // the last full block, for newest()
+    uint32_t tail = 0;
+    unsigned long dirtySince = 0;
+    bool dirty = false;
+    uint32_t dropped = 0;
+
+    // Function to fill in the header and CRC of the block being filled
+    void seal(TelemetryBlock & b){
+        b.magic = TELEMETRY_MAGIC;
+        b.version = TELEMETRY_VERSION;
+        b.kind = kind;
+        b.firstSeq = kind == TELEMETRY_RAW ? b.records[0].seq : 0;
+        b.firstTime = b.timeOf(0);
+        b.lastTime = b.timeOf(b.count - 1);
+        b.index = tail;
+        b.crc = 0;
+        b.crc = telemetryCrc16(&b, sizeof(b));
+    }
+
+    bool writeCurrent(){
+        seal(current);
+        bool ok = f.seek(tail * TELEMETRY_BLOCK_SIZE) &&
+                  f.write((const uint8_t *)&current, TELEMETRY_BLOCK_SIZE) == TELEMETRY_BLOCK_SIZE;
+        f.flush();
+        dirty = false;
+        return ok;
+    }
+};
+
+class TelemetryLog {
+public:
+    // Function to load the manifest and open the newest raw and hourly segments.
+    // Returns false without an sd card
+    bool begin(){
+        SD.mkdir(TELEMETRY_DIR);
+        if (!loadManifest()){
+            memset(&manifest, 0, sizeof(manifest));
+            manifest.magic = TELEMETRY_MANIFEST_MAGIC;
+        }
+        nextSeq = 0;
+        timeBase = 0;
+        // carry the seq and clock on from the newest raw record
+        TelemetrySegment * raw = active(TELEMETRY_RAW);
+        if (raw == nullptr && (raw = create(TELEMETRY_RAW)) == nullptr){
+            return false;
+        }
+        if (!(rawOpen = rawFile.open(TELEMETRY_RAW, raw->id))){
+            return false;
+        }
+        TelemetryRecord rec;
+        if (rawFile.newest(&rec)){
+            nextSeq = rec.seq + 1;
+            timeBase = rec.time + 1;
+        } else {
+            nextSeq = raw->firstSeq;
+            timeBase = newestTime() + (newestTime() ? 1 : 0);
+        }
+        clockStart = millis();
+
+        TelemetrySegment * hourly = active(TELEMETRY_HOURLY);
+        if (hourly == nullptr && (hourly = create(TELEMETRY_HOURLY)) == nullptr){
+            return false;
+        }
+        hourlyOpen = hourlyFile.open(TELEMETRY_HOURLY, hourly->id);
+        // power cut between filling a segment and sealing it
+        if (rawFile.full()){
+            rawOpen = rotate(TELEMETRY_RAW, rawFile);
+        }
+        if (hourlyOpen && hourlyFile.full()){
+            hourlyOpen = rotate(TELEMETRY_HOURLY, hourlyFile);
+        }
+        compactSegment = 0;
+        return true;
+    }
+
+    // Function to log a record, filling in its seq and time. Starts a new segment when one fills up
+    bool append(TelemetryRecord & rec){
+        rec.seq = nextSeq++;
+        rec.time = now();
+        if (!rawOpen && !(rawOpen = reopen(TELEMETRY_RAW, rawFile))){
+            return false;       // the manifest is still full
+        }
+        if (!rawFile.append(&rec)){
+            return false;
+        }
+        return !rawFile.full() || (rawOpen = rotate(TELEMETRY_RAW, rawFile));
+    }
+
+    // Function to run the background work - due block writes, then one slice of compaction or retention
+    void poll(){
+        rawFile.poll();
+        hourlyFile.poll();
+        if (millis() - lastSlice < TELEMETRY_SLICE_INTERVAL){
+            return;
+        }
+        lastSlice = millis();
+        if (!compactSlice()){
+            retire();
+        }
+    }
+
+    // Function to write every partial block now, e.g. before the sd card is removed
+    bool flush(){
+        return rawFile.flush() & hourlyFile.flush();
+    }
+
+    // Function to find the first block of a kind holding records at or after time t (log seconds).
+    // Past the end of the log, the position's block is the active segment's blocks()
+    TelemetryPosition find(uint8_t kind, uint32_t t){
+        TelemetryPosition p = { 0, 0 };
+        for (uint16_t i = 0; i < manifest.count; i++){
+            TelemetrySegment & s = manifest.segments[i];
+            if (s.kind != kind){
+                continue;
+            }
+            p.segment = s.id;
+            if (s.state != TELEMETRY_ACTIVE && s.lastTime < t){
+                p.block = s.blocks;         // all of it is older
+                continue;
+            }
+            uint32_t lo = 0, hi = s.state == TELEMETRY_ACTIVE ? file(kind).blocks() : s.blocks;
+            while (lo < hi){
+                uint32_t mid = lo + (hi - lo) / 2;
+                if (readBlock({ s.id, mid }, scratch) && scratch.lastTime >= t){
+                    hi = mid;
+                } else {
+                    lo = mid + 1;           // damaged blocks are skipped over
+                }
+            }
+            p.block = lo;
+            if (lo < (s.state == TELEMETRY_ACTIVE ? file(kind).blocks() : s.blocks)){
+                return p;
+            }
+        }
+        return p;
+    }
+
+    // Function to step to the next block, into the next segment of the same kind at the end of one.
+    // Returns false at the end of the log
+    bool next(TelemetryPosition & p){
+        TelemetrySegment * s = segment(p.segment);
+        if (s == nullptr){
+            return false;
+        }
+        uint32_t blocks = s->state == TELEMETRY_ACTIVE ? file(s->kind).blocks() : s->blocks;
+        if (p.block + 1 < blocks){
+            p.block++;
+            return true;
+        }
+        for (TelemetrySegment * n = s + 1; n < manifest.segments + manifest.count; n++){
+            if (n->kind == s->kind){
+                p = { n->id, 0 };
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Function to read a block of any segment, false if it is missing or damaged
+    bool readBlock(TelemetryPosition p, TelemetryBlock & out){
+        TelemetrySegment * s = segment(p.segment);
+        if (s == nullptr){
+            return false;
+        }
+        if (s->state == TELEMETRY_ACTIVE){
+            return file(s->kind).readBlock(p.block, out);
+        }
+        if (!reader || readerId != s->id){
+            char path[32];
+            telemetryPath(path, s->kind, s->id);
+            reader.close();
+            reader = SD.open(path, FILE_READ);
+            readerId = s->id;
+        }
+        if (!reader || !reader.seek(p.block * TELEMETRY_BLOCK_SIZE) ||
+            reader.read(&out, TELEMETRY_BLOCK_SIZE) != TELEMETRY_BLOCK_SIZE){
+            return false;
+        }
+        return telemetryBlockValid(out, p.block);
+    }
+
+    uint32_t records(){ return nextSeq; }
+    uint16_t segments(){ return manifest.count; }
+    // Damaged blocks dropped from the end of the active segments at begin()
+    uint32_t droppedBlocks(){ return rawFile.droppedBlocks() + hourlyFile.droppedBlocks(); }
+
+    // Log clock in seconds
+    uint32_t now(){ return timeBase + (millis() - clockStart) / 1000; }
+
+    // Function to move the log clock forward to t (e.g. unix time from the host), it never goes back
+    void setClock(uint32_t t){
+        if (t > now()){
+            timeBase = t;
+            clockStart = millis();
+        }
+    }
+
+private:
+    TelemetryManifest manifest;
+    TelemetryFile rawFile, hourlyFile;
+    bool rawOpen = false;
+    bool hourlyOpen = false;
+    File reader;                // sealed segments, opened on demand
+    uint32_t readerId = 0;
+    TelemetryBlock scratch;
+    uint32_t nextSeq = 0;
+    uint32_t timeBase = 0;
+    unsigned long clockStart = 0;
+    unsigned long lastSlice = 0;
+
+    // Compaction of one raw segment, a block per slice
+    uint32_t compactSegment = 0;    // id, 0 = none in progress
+    uint32_t compactBlock = 0;
+    uint32_t rolledUntil = 0;       // newest hour already in the rollups
+    TelemetryRollup hour;       // being filled, count = 0 while empty
+    int32_t sums[TELEMETRY_ROLLUP_FIELDS];
+
+    TelemetryFile & file(uint8_t kind){
+        return kind == TELEMETRY_HOURLY ? hourlyFile : rawFile;
+    }
+
+    TelemetrySegment * segment(uint32_t id){
+        for (uint16_t i = 0; i < manifest.count; i++){
+            if (manifest.segments[i].id == id){
+                return &manifest.segments[i];
+            }
+        }
+        return nullptr;
+    }
+
+    TelemetrySegment * active(uint8_t kind){
+        for (uint16_t i = 0; i < manifest.count; i++){
+            if (manifest.segments[i].kind == kind && manifest.segments[i].state == TELEMETRY_ACTIVE){
+                return &manifest.segments[i];
+            }
+        }
+        return nullptr;
+    }
+
+    uint32_t newestTime(){
+        uint32_t t = 0;
+        for (uint16_t i = 0; i < manifest.count; i++){
+            t = manifest.segments[i].lastTime > t ? manifest.segments[i].lastTime : t;
+        }
+        return t;
+    }
+
+    // Function to add a segment to the manifest, making room by dropping the oldest one if it is full.
+    // Returns nullptr if only raw segments still to be compacted could make room
+    TelemetrySegment * create(uint8_t kind){
+        if (manifest.count == TELEMETRY_MAX_SEGMENTS){
+            // a compacted raw segment first, its hours are kept in the rollups, else the oldest hourly one
+            int16_t victim = -1;
+            for (uint16_t i = 0; i < manifest.count && victim < 0; i++){
+                if (manifest.segments[i].state == TELEMETRY_COMPACTED){
+                    victim = i;
+                }
+            }
+            for (uint16_t i = 0; i < manifest.count && victim < 0; i++){
+                if (manifest.segments[i].kind == TELEMETRY_HOURLY && manifest.segments[i].state == TELEMETRY_SEALED){
+                    victim = i;
+                }
+            }
+            if (victim < 0){
+                return nullptr;
+            }
+            remove(victim);
+        }
+        TelemetrySegment & s = manifest.segments[manifest.count++];
+        memset(&s, 0, sizeof(s));
+        s.id = ++manifest.nextId;
+        s.kind = kind;
+        s.state = TELEMETRY_ACTIVE;
+        s.firstSeq = nextSeq;
+        s.firstTime = now();
+        saveManifest();
+        return &s;
+    }
+
+    // Function to delete a segment's file and its manifest entry
+    void remove(uint16_t i){
+        char path[32];
+        TelemetrySegment & s = manifest.segments[i];
+        telemetryPath(path, s.kind, s.id);
+        if (reader && readerId == s.id){
+            reader.close();
+        }
+        if (compactSegment == s.id){
+            compactSegment = 0;
+        }
+        SD.remove(path);
+        memmove(&manifest.segments[i], &manifest.segments[i + 1], (manifest.count - i - 1) * sizeof(TelemetrySegment));
+        manifest.count--;
+    }
+
+    // Function to seal a full segment and start the next one of its kind. Returns false if the
+    // new one can't be opened, appends then fail until the next begin()
+    bool rotate(uint8_t kind, TelemetryFile & f){
+        TelemetrySegment * s = segment(f.segmentId());
+        f.close();
+        if (s != nullptr){
+            s->state = TELEMETRY_SEALED;
+            s->blocks = f.blocks();
+            s->records = f.records();
+            s->lastTime = newestIn(f, kind);
+        }
+        return reopen(kind, f);
+    }
+
+    // Function to open the active segment of a kind in f, starting a new one after the last was sealed
+    bool reopen(uint8_t kind, TelemetryFile & f){
+        TelemetrySegment * n = active(kind);
+        if (n == nullptr){
+            n = create(kind);
+        }
+        return n != nullptr && f.open(kind, n->id);
+    }
+
+    // Function to get the time of a file's newest record or rollup, 0 if it is empty
+    static uint32_t newestIn(TelemetryFile & f, uint8_t kind){
+        TelemetryRecord rec;
+        TelemetryRollup rollup;
+        if (kind == TELEMETRY_HOURLY){
+            return f.newest(&rollup) ? rollup.time : 0;
+        }
+        return f.newest(&rec) ? rec.time : 0;
+    }
+
+    // Function to compact one block of the oldest sealed raw segment into hourly rollups.
+    // Returns false if there is nothing to compact
+    bool compactSlice(){
+        if (!hourlyOpen && !(hourlyOpen = reopen(TELEMETRY_HOURLY, hourlyFile))){
+            return false;
+        }
+        if (compactSegment == 0){
+            for (uint16_t i = 0; i < manifest.count; i++){
+                TelemetrySegment & s = manifest.segments[i];
+                if (s.kind == TELEMETRY_RAW && s.state == TELEMETRY_SEALED){
+                    compactSegment = s.id;
+                    compactBlock = 0;
+                    hour.count = 0;
+                    break;
+                }
+            }
+            if (compactSegment == 0){
+                return false;
+            }
+            // after a power cut mid-compaction the hours already rolled up are skipped,
+            // only the last of them can come out twice
+            rolledUntil = newestIn(hourlyFile, TELEMETRY_HOURLY);
+            for (uint16_t i = 0; i < manifest.count && rolledUntil == 0; i++){
+                TelemetrySegment & s = manifest.segments[manifest.count - 1 - i];
+                if (s.kind == TELEMETRY_HOURLY && s.state == TELEMETRY_SEALED){
+                    rolledUntil = s.lastTime;
+                }
+            }
+        }
+        TelemetrySegment * s = segment(compactSegment);
+        if (s == nullptr){
+            compactSegment = 0;
+            return true;
+        }
+        if (compactBlock < s->blocks){
+            if (readBlock({ s->id, compactBlock }, scratch)){
+                for (uint8_t i = 0; i < scratch.count; i++){
+                    fold(scratch.records[i]);
+                }
+            }
+            compactBlock++;
+            return true;
+        }
+        // whole segment done - the last (maybe partial) hour goes out too. That can start a new
+        // hourly segment and move the manifest entries, so look this one up again
+        emitHour();
+        hourlyFile.flush();
+        s = segment(compactSegment);
+        if (s != nullptr){
+            s->state = TELEMETRY_COMPACTED;
+            saveManifest();
+        }
+        compactSegment = 0;
+        return true;
+    }
+
+    // Function to add a raw record to the hour being rolled up
+    void fold(const TelemetryRecord & r){
+        uint32_t start = r.time - r.time % 3600;
+        if (start < rolledUntil){
+            return;
+        }
+        if (hour.count != 0 && start != hour.time){
+            emitHour();
+        }
+        const int16_t v[TELEMETRY_ROLLUP_FIELDS] = { r.rain, r.m1, r.m2, r.disp };
+        if (hour.count == 0){
+            memset(&hour, 0, sizeof(hour));
+            hour.time = start;
+            for (uint8_t k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+                hour.lo[k] = hour.hi[k] = v[k];
+                sums[k] = 0;
+            }
+        }
+        for (uint8_t k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+            hour.lo[k] = v[k] < hour.lo[k] ? v[k] : hour.lo[k];
+            hour.hi[k] = v[k] > hour.hi[k] ? v[k] : hour.hi[k];
+            sums[k] += v[k];
+        }
+        hour.count++;
+        if ((r.flags & TELEMETRY_ALERT) && hour.alerts < 255) hour.alerts++;
+        if ((r.flags & TELEMETRY_VIB) && hour.vibs < 255) hour.vibs++;
+    }
+
+    void emitHour(){
+        if (hour.count == 0){
+            return;
+        }
+        for (uint8_t k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+            hour.mean[k] = sums[k] / hour.count;
+        }
+        hourlyFile.append(&hour);
+        if (hourlyFile.full()){
+            hourlyOpen = rotate(TELEMETRY_HOURLY, hourlyFile);
+        }
+        hour.count = 0;
+    }
+
+    // Function to delete one segment that is past its retention time. Returns false if there is none
+    bool retire(){
+        uint32_t t = now();
+        for (uint16_t i = 0; i < manifest.count; i++){
+            TelemetrySegment & s = manifest.segments[i];
+            uint32_t keep = (s.kind == TELEMETRY_RAW ? TELEMETRY_RAW_DAYS : TELEMETRY_HOURLY_DAYS) * 86400UL;
+            bool done = s.kind == TELEMETRY_RAW ? s.state == TELEMETRY_COMPACTED : s.state == TELEMETRY_SEALED;
+            if (done && t > keep && s.lastTime < t - keep){
+                remove(i);
+                saveManifest();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool loadManifest(){
+        bool found = false;
+        for (char copy = 'A'; copy <= 'B'; copy++){
+            char path[32];
+            sprintf(path, TELEMETRY_DIR "/MANIF%c.BIN", copy);
+            File m = SD.open(path, FILE_READ);
+            if (!m){
+                continue;
+            }
+            // one from a build with fewer segments is shorter, the CRC covers what was written
+            memset(&scratchManifest, 0, sizeof(scratchManifest));
+            int read = m.read(&scratchManifest, sizeof(scratchManifest));
+            m.close();
+            size_t header = offsetof(TelemetryManifest, segments);
+            uint16_t crc = scratchManifest.crc;
+            scratchManifest.crc = 0;
+            if (read >= (int)header && (read - header) % sizeof(TelemetrySegment) == 0 &&
+                scratchManifest.magic == TELEMETRY_MANIFEST_MAGIC &&
+                scratchManifest.count <= (read - header) / sizeof(TelemetrySegment) &&
+                telemetryCrc16(&scratchManifest, read) == crc &&
+                (!found || scratchManifest.generation > manifest.generation)){
+                manifest = scratchManifest;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    // Function to write the manifest over the older of its two copies
+    void saveManifest(){
+        char path[32];
+        manifest.generation++;
+        manifest.crc = 0;
+        manifest.crc = telemetryCrc16(&manifest, sizeof(manifest));
+        sprintf(path, TELEMETRY_DIR "/MANIF%c.BIN", manifest.generation & 1 ? 'B' : 'A');
+        File m = SD.open(path, FILE_WRITE);
+        if (m){
+            m.seek(0);
+            m.write((const uint8_t *)&manifest, sizeof(manifest));
+            m.close();
+        }
+    }
+
+    TelemetryManifest scratchManifest;
+};
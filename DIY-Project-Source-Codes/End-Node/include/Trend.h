@@ -0,0 +1,243 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "TFT_eSPI.h"
+
+/*
+Trend history of one reading at three resolutions, and a chart that draws it.
+
+Trend keeps min/max buckets in three rings:
+    TREND_RAW_SIZE      one per packet
+    TREND_MINUTE_SIZE   one per minute (4 hours with the defaults)
+    TREND_HOUR_SIZE     one per hour   (7 days with the defaults)
+A minute bucket holds the lowest and highest packet of that minute, an hour bucket the
+lowest and highest of its minutes, so a short spike still shows at every resolution
+(an average would flatten it). Minutes and hours without packets are kept as empty
+buckets, the charts stay true to time. Values are stored as int16 in 1 / scale units,
+4 bytes a bucket - 2 KB per Trend.
+
+TrendChart draws one ring as a line, one screen column per bucket, newest on the right.
+It remembers the span it drew in every column and on each draw only touches the
+pixels that differ, so when a bucket is added (everything moves one column left) the
+SPI traffic is the line's change from column to column plus the new column, and the
+chart is never cleared.
+
+USAGE:
+
+    Trend rain(10);                         // 0.1 resolution
+    rain.add(12.5, millis());               // every packet
+    rain.tick(millis());                    // now and then, closes minute/hour buckets
+
+    TrendChart chart(10, 40, 300, 36, TFT_CYAN, TFT_BLACK);
+    chart.draw(rain, TREND_MINUTES);        // incremental
+    chart.invalidate();                     // screen was cleared, draw all of it next time
+ */
+
+#ifndef TREND_RAW_SIZE
+#define TREND_RAW_SIZE 128
+#endif
+#ifndef TREND_MINUTE_SIZE
+#define TREND_MINUTE_SIZE 240
+#endif
+#ifndef TREND_HOUR_SIZE
+#define TREND_HOUR_SIZE 168
+#endif
+#define TREND_CHART_MAX_WIDTH 320
+
+enum TrendResolution : uint8_t { TREND_RAW, TREND_MINUTES, TREND_HOURS };
+
+struct TrendBucket {
+    int16_t lo, hi;             // lo > hi = no data
+
+    bool empty() const { return lo > hi; }
+    void clear(){ lo = INT16_MAX; hi = INT16_MIN; }
+    void merge(const TrendBucket & b){
+        lo = b.lo < lo ? b.lo : lo;
+        hi = b.hi > hi ? b.hi : hi;
+    }
+};
+
+template<uint16_t N>
+struct TrendRing {
+    TrendBucket buckets[N];
+    uint16_t head = 0;          // next slot written
+    uint16_t count = 0;
+
+    void push(const TrendBucket & b){
+        buckets[head] = b;
+        head = (head + 1) % N;
+        if (count < N){
+            count++;
+        }
+    }
+    // i = 0 is the oldest
+    const TrendBucket & at(uint16_t i) const {
+        return buckets[(head + N - count + i) % N];
+    }
+};
+
+class Trend {
+public:
+    Trend(float scale) : scale(scale) {
+        minute.clear();
+        hour.clear();
+    }
+
+    // Function to add a reading received at now (millis)
+    void add(float value, unsigned long now){
+        tick(now);
+        float v = value * scale;
+        v = v > INT16_MAX - 1 ? INT16_MAX - 1 : v < INT16_MIN + 1 ? INT16_MIN + 1 : v;
+        TrendBucket b = { (int16_t)v, (int16_t)v };
+        raw.push(b);
+        minute.merge(b);
+        last = value;
+        changes++;
+    }
+
+    // Function to close the minute and hour buckets that have ended by now (millis)
+    void tick(unsigned long now){
+        if (!started){
+            minuteStart = now;
+            started = true;
+        }
+        while (now - minuteStart >= 60000UL){
+            minutes.push(minute);
+            hour.merge(minute);
+            minute.clear();
+            minuteStart += 60000UL;
+            if (++minutesInHour == 60){
+                hours.push(hour);
+                hour.clear();
+                minutesInHour = 0;
+            }
+            changes++;
+        }
+    }
+
+    uint16_t size(uint8_t res) const {
+        return res == TREND_RAW ? raw.count : res == TREND_MINUTES ? minutes.count : hours.count;
+    }
+    const TrendBucket & at(uint8_t res, uint16_t i) const {
+        return res == TREND_RAW ? raw.at(i) : res == TREND_MINUTES ? minutes.at(i) : hours.at(i);
+    }
+    float value(int16_t stored) const { return stored / scale; }
+    float latest() const { return last; }
+    // bumped whenever a ring changes, a chart only needs drawing when it moved
+    uint32_t version() const { return changes; }
+
+private:
+    float scale;
+    float last = 0;
+    uint32_t changes = 0;
+    TrendRing<TREND_RAW_SIZE>    raw;
+    TrendRing<TREND_MINUTE_SIZE> minutes;
+    TrendRing<TREND_HOUR_SIZE>   hours;
+    TrendBucket minute, hour;   // being filled
+    unsigned long minuteStart = 0;
+    uint8_t minutesInHour = 0;
+    bool started = false;
+};
+
+extern TFT_eSPI tft;
+
+class TrendChart {
+public:
+    TrendChart(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t fg, uint16_t bg)
+        : x(x), y(y), w(w < TREND_CHART_MAX_WIDTH ? w : TREND_CHART_MAX_WIDTH), h(h), fg(fg), bg(bg) {
+        invalidate();
+    }
+
+    // Function to forget what is on screen, the next draw paints every column
+    void invalidate(){
+        memset(top, 0xFF, sizeof(top));     // top > bottom = nothing drawn
+        memset(bottom, 0, sizeof(bottom));
+        drawn = false;
+    }
+
+    // Function to draw the newest w buckets of a trend, autoscaled. Returns false if nothing changed
+    bool draw(const Trend & t, uint8_t res){
+        if (drawn && t.version() == version && res == resolution){
+            return false;
+        }
+        uint16_t n = t.size(res);
+        int16_t first = n > w ? n - w : 0;      // oldest bucket shown
+        int16_t offset = w - (n - first);       // its column
+
+        lo = INT16_MAX;
+        hi = INT16_MIN;
+        for (uint16_t i = first; i < n; i++){
+            const TrendBucket & b = t.at(res, i);
+            if (!b.empty()){
+                lo = b.lo < lo ? b.lo : lo;
+                hi = b.hi > hi ? b.hi : hi;
+            }
+        }
+        if (lo > hi){
+            lo = hi = 0;
+        }
+        int32_t range = hi > lo ? hi - lo : 1;
+
+        tft.startWrite();
+        int16_t prevTop = -1, prevBottom = -1;
+        for (int16_t c = 0; c < w; c++){
+            int16_t nt = 0xFF, nb = 0;          // empty column
+            int16_t i = first + c - offset;
+            if (i >= first && i < (int16_t)n && !t.at(res, i).empty()){
+                const TrendBucket & b = t.at(res, i);
+                nt = (h - 1) - (int32_t)(b.hi - lo) * (h - 1) / range;
+                nb = (h - 1) - (int32_t)(b.lo - lo) * (h - 1) / range;
+                // join up with the previous column so the line has no gaps
+                if (prevTop >= 0){
+                    nt = prevBottom < nt ? prevBottom : nt;
+                    nb = prevTop > nb ? prevTop : nb;
+                }
+                prevTop = (h - 1) - (int32_t)(b.hi - lo) * (h - 1) / range;
+                prevBottom = (h - 1) - (int32_t)(b.lo - lo) * (h - 1) / range;
+            } else {
+                prevTop = prevBottom = -1;
+            }
+            update(c, nt, nb);
+        }
+        tft.endWrite();
+        version = t.version();
+        resolution = res;
+        drawn = true;
+        return true;
+    }
+
+    // Scale of the last draw, in the trend's stored units
+    int16_t low() const { return lo; }
+    int16_t high() const { return hi; }
+
+private:
+    int16_t x, y, w, h;
+    uint16_t fg, bg;
+    uint8_t top[TREND_CHART_MAX_WIDTH];
+    uint8_t bottom[TREND_CHART_MAX_WIDTH];
+    uint32_t version = 0;
+    uint8_t resolution = TREND_RAW;
+    bool drawn = false;
+    int16_t lo = 0, hi = 0;
+
+    // Function to change column c from its drawn span to nt..nb, only the rows that differ
+    void update(int16_t c, int16_t nt, int16_t nb){
+        int16_t ot = top[c], ob = bottom[c];
+        bool wasEmpty = ot > ob, isEmpty = nt > nb;
+        if (wasEmpty && isEmpty){
+            return;
+        }
+        if (wasEmpty || isEmpty || nb < ot || nt > ob){
+            // no overlap, erase the old span and draw the new one
+            if (!wasEmpty) tft.drawFastVLine(x + c, y + ot, ob - ot + 1, bg);
+            if (!isEmpty) tft.drawFastVLine(x + c, y + nt, nb - nt + 1, fg);
+        } else {
+            if (ot < nt) tft.drawFastVLine(x + c, y + ot, nt - ot, bg);
+            if (ob > nb) tft.drawFastVLine(x + c, y + nb + 1, ob - nb, bg);
+            if (nt < ot) tft.drawFastVLine(x + c, y + nt, ot - nt, fg);
+            if (nb > ob) tft.drawFastVLine(x + c, y + ob + 1, nb - ob, fg);
+        }
+        top[c] = nt;
+        bottom[c] = nb;
+    }
+};
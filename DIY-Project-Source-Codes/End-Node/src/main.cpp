@@ -29,25 +29,136 @@
 #include "Free_Fonts.h"       // Include free fonts library 
 #include "Seeed_FS.h"         // Including SD card library
 #include "RawImage.h"         // Including image processing library
+#include "ImageCache.h"       // Keeps screen backgrounds in RAM between redraws
+#include "GlyphAtlas.h"       // Pre-rendered anti-aliased value text
+#include "TextField.h"        // Retained text for the link stats and history pages
+#include "Buttons.h"          // Buttons on interrupts
+#include "Trend.h"            // Multi-resolution trend history and charts
+#include "TelemetryLog.h"     // Append-only log of received frames on the sd card
+#include "TelemetryExport.h"  // Bulk export of the log over USB serial
+#include "HistoryFormat.h"    // Sensor Node history records of the "HB," backfill frames
+#include "E5Link.h"           // Wio E5 baud rate switching and link test
+#include "Log.h"              // Logging with compile-time levels (LOG_LEVEL) and non-blocking output
+
+// Wio E5 on a hardware SERCOM UART (Serial1, interrupt driven RX ring buffer) instead of SoftwareSerial -
+// uncomment or add -D E5_HW_UART to build_flags. Wire E5 TX to header pin 10 (RXD) and E5 RX to pin 8 (TXD).
+//#define E5_HW_UART
+
+// Baud rate for the Wio E5 link, the module is switched over with AT+UART=BR on first boot
+#ifndef E5_BAUD
+#ifdef E5_HW_UART
+#define E5_BAUD 115200
+#else
+#define E5_BAUD 9600      // bit-banged RX drops bytes above this while the LCD/SD are busy
+#endif
+#endif
+
+// Print LINK,... latency/byte loss lines for every baud rate at boot - uncomment or add -D E5_LINK_TEST
+//#define E5_LINK_TEST
+
+// Capture of the Wio E5 AT traffic to the sd card (AT_TRACE_DIR/ATnnn.BIN, one file per boot) for
+// Native-HAL replay (see ../Common/src/AtTrace.h). Uncomment or add -D AT_TRACE to build_flags
+//#define AT_TRACE
+
+#ifdef AT_TRACE
+#include "AtTrace.h"
+#define AT_TRACE_DIR "/trace"
+#endif
 
 // Invoke Display and Create display Instance 
 TFT_eSPI tft; //initialize TFT LCD
 
+// Screen backgrounds, read from the SD card once and redrawn from RAM (IMAGE_CACHE_BUDGET bytes)
+ImageCache images;
+
+#ifdef E5_HW_UART
+HardwareSerial & e5Uart = Serial1;    // Wio-E5 Module on the 40 pin header UART
+#else
 // Lets define Sofware serial Pins for Wio-E5 Module
 const byte rxPin = D0;
 const byte txPin = D1;
 
 // Set up a new SoftwareSerial object
-SoftwareSerial e5 (rxPin, txPin);
+SoftwareSerial e5Uart (rxPin, txPin);
+#endif
+
+#ifdef AT_TRACE
+AtTraceFile<File> atTrace(AT_TRACE_END);
+AtTap<decltype(e5Uart)> e5(e5Uart, atTrace);   // the Wio E5 link, through the capture
+#else
+auto & e5 = e5Uart;
+#endif
 
 // LoRa Data receive buffer
 static char recv_buf[512];
+// Hex payload of the last Sensor Node history backfill frame ("HB,..."), relayed by the Gateway
+static char backfill_hex[256];
+// Bytes recv_parse() has collected in recv_buf so far, a packet's URC lines can span several calls
+static int recv_len = 0;
 static bool is_exist = false;
+// Module was already configured at boot (see configLoRaModule)
+static bool lora_warm = false;
+// millis() when the first LoRa packet went through, 0 until then
+static unsigned long firstPacketTime = 0;
+// Receive mode was requested at rxArmedTime, it is requested again after rxRearmInterval without a packet.
+// RXLRPKT drops a frame on air, so the interval is far longer than the Sensor Node's sendInterval (20 s) plus
+// the Gateway relay - while the link works a packet always comes first. A module that was reset answers
+// the late RXLRPKT with ERROR(-12) and is configured again
+static bool rx_armed = false;
+static unsigned long rxArmedTime = 0;
+const unsigned long rxRearmInterval = 300000;
+// A packet came in that the page on screen hasn't shown yet
+static bool packetFresh = false;
+// Baud rate the Wio E5 link runs at, 0 if the module didn't answer
+static unsigned long e5Baud = 0;
+
+// Wio-E5 TEST mode radio settings, and how AT+TEST=? reports them back
+#define LORA_RFCFG_CMD  "AT+TEST=RFCFG,866,SF12,125,12,15,14,ON,OFF,OFF\r\n"
+#define LORA_RFCFG_ECHO "+TEST: RFCFG F:866000000, SF12, BW125K, TXPR:12, RXPR:15, POW:14dBm, CRC:ON, IQ:OFF, NET:OFF"
 
 // Variables for collecting Sensor data and parameters
 // prfix SN is for data received from (WSN) Sensor Node
 float SN_m1, SN_m2, SN_humi, SN_temp, SN_disp, SN_rain_per, GW_temperature, GW_humidity, GW_rain_per;;
 bool SN_vib, SN_stat;
+// Sensor Node seq of the live frame, -1 if it carried none (Sensor Node without HISTORY_LOG)
+long SN_seq = -1;
+
+// Link quality of the received packets
+struct LinkStats {
+    unsigned long packets;
+    unsigned long lastPacket;   // millis()
+    int16_t rssi, snr;          // last packet
+    int16_t rssiMin, rssiMax;
+};
+LinkStats link = { 0, 0, 0, 0, 0, 0 };
+
+// Last few Sensor Node packets, newest at historyHead - 1
+#define HISTORY_ROWS 8
+struct Reading {
+    unsigned long at;           // millis()
+    float m1, m2, rain;
+    bool stat;
+};
+Reading history[HISTORY_ROWS];
+uint8_t historyHead = 0;
+uint8_t historyCount = 0;
+
+// Trends of the Sensor Node readings, per packet, per minute and per hour
+Trend rainTrend(10), m1Trend(10), m2Trend(10), dispTrend(100);
+
+// Frames recv_parse() recognises
+#define FRAME_NONE     0
+#define FRAME_LIVE     1      // "EN,..." readings from the Gateway
+#define FRAME_BACKFILL 2      // "HB,..." Sensor Node history records, in backfill_hex
+#define FRAME_NOT_TEST 3      // "+TEST: ERROR(-12)", the module isn't in TEST mode any more (it was reset)
+
+// Every received frame goes to the sd card, the host can pull it back over USB
+TelemetryLog telemetry;
+TelemetryExport exporter(telemetry, Serial);
+// The last logged live frame with a Sensor Node seq, backfilled records are placed in time from it: the
+// Sensor Node takes one seq per SENSOR_SEND_INTERVAL
+static uint16_t liveSnSeq = 0;
+static uint32_t liveTime = 0;       // its log time, 0 = none yet
 
 // Readings Update Interval Settings
 const unsigned long updateInterval = 5000;
@@ -88,11 +199,11 @@ char * unHex(const char* input, char* target, size_t len) {
   if (target != nullptr && len) {
     size_t inLen = strlen(input);
     if (inLen & 1) {
-      Serial.println(F("unhex: malformed input"));
+      LOG_WARN("unhex: malformed input");
     }
     size_t chars = inLen / 2;
     if (chars >= len) {
-      Serial.println(F("unhex: target buffer too small"));
+      LOG_WARN("unhex: target buffer too small");
       chars = len - 1;
     }
     for (size_t i = 0; i < chars; i++) {
@@ -102,7 +213,7 @@ char * unHex(const char* input, char* target, size_t len) {
     }
     target[chars] = 0;
   } else {
-    Serial.println(F("unhex: no target buffer"));
+    LOG_ERROR("unhex: no target buffer");
   }
   return target;
 }
@@ -115,11 +226,11 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
     int startMillis = 0;
     va_list args;
     memset(recv_buf, 0, sizeof(recv_buf));
+    recv_len = 0;
     va_start(args, p_cmd);
     e5.printf(p_cmd, args);
-    Serial.printf(p_cmd, args);
+    LOG_DEBUG_STR(p_cmd);
     va_end(args);
-    delay(200);
     startMillis = millis();
  
     if (p_ack == NULL)
@@ -131,10 +242,13 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
         while (e5.available() > 0)
         {
             ch = e5.read();
-            recv_buf[index++] = ch;
-            Serial.print((char)ch);
-            delay(2);
+            if (index < (int)sizeof(recv_buf) - 1)
+            {
+                recv_buf[index++] = ch;
+            }
+            LOG_TRACE_CHAR(ch);
         }
+        logPump();
         if (strstr(recv_buf, p_ack) != NULL)
         {
             return 1;
@@ -144,34 +258,69 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
     return 0;
 }
 
+// Function to report how long after boot the first LoRa packet went through
+static void reportFirstPacket(){
+  if (firstPacketTime == 0)
+  {
+    firstPacketTime = millis();
+    LOG_INFO("First packet at %lu ms after boot", firstPacketTime);
+  }
+}
+
 // Function for parsing the incoming LoRa data
 static int recv_parse(void)
 {
     char ch;
-    int index = 0;
-    memset(recv_buf, 0, sizeof(recv_buf));
-    while (e5.available() > 0)
+    bool eol = false;
+    while (!eol && e5.available() > 0)
     {
         ch = e5.read();
-        recv_buf[index++] = ch;
-        Serial.print((char)ch);
-        delay(2);
+        if (recv_len < (int)sizeof(recv_buf) - 1)
+        {
+            recv_buf[recv_len++] = ch;
+            recv_buf[recv_len] = 0;
+        }
+        LOG_TRACE_CHAR(ch);
+        eol = (ch == '\n');
     }
- 
-    if (index)
+
+    // A packet is reported as "+TEST: LEN:.., RSSI:.., SNR:..\r\n" then "+TEST: RX \"..\"\r\n",
+    // so keep collecting whole lines until the RX line is in
+    bool rx_pending = strstr(recv_buf, "+TEST: LEN") && !strstr(recv_buf, "+TEST: RX \"");
+    if (eol && !rx_pending)
     {
+        recv_len = 0;     // start over on the next call, recv_buf stays valid for parsing below
         char *p_start = NULL;
         char data[128] = {
             0,
         };
 
+        // "+TEST: LEN:.., RSSI:.., SNR:.." came in just before the RX line
+        char *p_len = strstr(recv_buf, "+TEST: LEN");
+        int len, rssi, snr;
+        if (p_len && 3 == sscanf(p_len, "+TEST: LEN:%d, RSSI:%d, SNR:%d", &len, &rssi, &snr))
+        {
+            link.rssi = rssi;
+            link.snr = snr;
+        }
+
+        p_start = strstr(recv_buf, "+TEST: RX \"48422C");
+        if (p_start && (1 == sscanf(p_start, "+TEST: RX \"%255[0-9A-F]", backfill_hex)))
+        {
+            return FRAME_BACKFILL;
+        }
+
+        if (strstr(recv_buf, "+TEST: ERROR(-12)"))
+        {
+            return FRAME_NOT_TEST;
+        }
+
         p_start = strstr(recv_buf, "+TEST: RX \"454E2C");
         if (p_start)
         {
             p_start = strstr(recv_buf, "454E2C");
-            if (p_start && (1 == sscanf(p_start, "454E2C%s", data)))
+            if (p_start && (1 == sscanf(p_start, "454E2C%127[0-9A-F]", data)))
             {
-                data[60] = 0;
                 //Serial.println(data);
                 //Serial.println("Hello");
                 char output[128];
@@ -188,29 +337,134 @@ static int recv_parse(void)
                 GW_rain_per = (getValue(text, ',', 8)).toFloat();  
                 GW_humidity = (getValue(text, ',', 9)).toFloat();  
                 GW_temperature = (getValue(text, ',', 10)).toFloat();
+                String seq = getValue(text, ',', 11);
+                SN_seq = seq.length() ? seq.toInt() : -1;
                 //Serial.println(GW_temperature);              
-                Serial.print("\r\n");
             }
-            return 1;
+            return FRAME_LIVE;
         }
     }
-    return 0;
+    return FRAME_NONE;
 }
 
 
-// Function for Receiving incomming LoRa Packets
-static int node_recv(uint32_t timeout_ms)
+// Function to keep a packet's readings for the link stats and history pages
+static void recordPacket()
 {
-    at_send_check_response("+TEST: RXLRPKT", 1500, "AT+TEST=RXLRPKT\r\n");
-    int startMillis = millis();
-    do
+    link.packets++;
+    link.lastPacket = millis();
+    if (link.packets == 1 || link.rssi < link.rssiMin) link.rssiMin = link.rssi;
+    if (link.packets == 1 || link.rssi > link.rssiMax) link.rssiMax = link.rssi;
+
+    Reading & r = history[historyHead];
+    r.at = link.lastPacket;
+    r.m1 = SN_m1;
+    r.m2 = SN_m2;
+    r.rain = SN_rain_per;
+    r.stat = SN_stat;
+    historyHead = (historyHead + 1) % HISTORY_ROWS;
+    if (historyCount < HISTORY_ROWS) historyCount++;
+
+    rainTrend.add(SN_rain_per, link.lastPacket);
+    m1Trend.add(SN_m1, link.lastPacket);
+    m2Trend.add(SN_m2, link.lastPacket);
+    dispTrend.add(SN_disp, link.lastPacket);
+
+    TelemetryRecord rec = {};
+    rec.snSeq = SN_seq >= 0 ? SN_seq : TELEMETRY_NO_SEQ;
+    rec.flags = (SN_vib ? TELEMETRY_VIB : 0) | (SN_stat ? TELEMETRY_ALERT : 0);
+    rec.rssi = link.rssi;
+    rec.snr = link.snr;
+    rec.m1 = SN_m1 * 10;
+    rec.m2 = SN_m2 * 10;
+    rec.rain = SN_rain_per * 10;
+    rec.humi = SN_humi * 10;
+    rec.temp = SN_temp * 10;
+    rec.disp = SN_disp * 100;
+    rec.gwRain = GW_rain_per * 10;
+    rec.gwHumi = GW_humidity * 10;
+    rec.gwTemp = GW_temperature * 10;
+    if (telemetry.append(rec) && rec.snSeq != TELEMETRY_NO_SEQ)
     {
-        if (recv_parse())
+        liveSnSeq = rec.snSeq;
+        liveTime = rec.time;
+    }
+}
+
+// Function to log the records of a Sensor Node history frame - "HB," <count> <count x HistoryRecord>
+static void recordBackfill()
+{
+    char bytes[sizeof(backfill_hex) / 2];
+    size_t len = strlen(backfill_hex) / 2;
+    unHex(backfill_hex, bytes, sizeof(bytes));
+    uint8_t count = len >= 4 ? bytes[3] : 0;
+    if (count == 0 || 4 + count * sizeof(HistoryRecord) > len)
+    {
+        LOG_WARN("Backfill frame too short");
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++)
+    {
+        HistoryRecord b;
+        memcpy(&b, bytes + 4 + i * sizeof(HistoryRecord), sizeof(b));
+        TelemetryRecord rec = {};
+        rec.snSeq = b.seq;
+        rec.flags = TELEMETRY_BACKFILL | (b.flags & HISTORY_VIB ? TELEMETRY_VIB : 0) | (b.flags & HISTORY_ALERT ? TELEMETRY_ALERT : 0);
+        rec.rssi = link.rssi;
+        rec.snr = link.snr;
+        rec.m1 = b.m1 * 10;
+        rec.m2 = b.m2 * 10;
+        rec.rain = b.rain * 10;
+        rec.humi = b.humi * 10;
+        rec.temp = b.temp * 10;
+        rec.disp = b.disp;
+        // history is older than the live frame sent before it, anything else can't be placed
+        int16_t behind = (int16_t)(liveSnSeq - b.seq);
+        if (liveTime != 0 && behind > 0 && (uint32_t)behind * (SENSOR_SEND_INTERVAL / 1000) < liveTime)
         {
-            return 1;
+            rec.taken = liveTime - (uint32_t)behind * (SENSOR_SEND_INTERVAL / 1000);
         }
-    } while (millis() - startMillis < timeout_ms);
-    return 0;
+        telemetry.append(rec);
+    }
+    LOG_INFO("Logged %u backfill records from seq %u", count, ((HistoryRecord *)(bytes + 4))->seq);
+}
+
+
+void configLoRaModule();
+
+// Function for Receiving incomming LoRa Packets without waiting for them - the Wio E5 stays in
+// receive mode (AT+TEST=RXLRPKT) and each call only takes what the UART has buffered. The command
+// is not waited on, its "+TEST: RXLRPKT" answer goes through recv_parse() like any other line
+static void radioPoll()
+{
+    if (!rx_armed || millis() - rxArmedTime > rxRearmInterval)
+    {
+        e5.print("AT+TEST=RXLRPKT\r\n");
+        LOG_DEBUG("AT+TEST=RXLRPKT");
+        rx_armed = true;
+        rxArmedTime = millis();
+    }
+    int frame = recv_parse();
+    if (frame == FRAME_NOT_TEST)
+    {
+        LOG_WARN("Wio E5 left TEST mode, configuring it again");
+        configLoRaModule();
+        rx_armed = false;
+    }
+    else if (frame != FRAME_NONE)
+    {
+        reportFirstPacket();
+        if (frame == FRAME_LIVE)
+        {
+            recordPacket();
+            packetFresh = true;
+        }
+        else
+        {
+            recordBackfill();
+        }
+        rxArmedTime = millis();
+    }
 }
 
 
@@ -218,132 +472,527 @@ static int node_recv(uint32_t timeout_ms)
 // for more details about these command sequences  
 void configLoRaModule(){
   //Configure Wio E5 Module in Test Mode
-  Serial.println("Configuring Wio E5 Module ...");
-  delay(250);
-  if (at_send_check_response("+AT: OK", 100, "AT\r\n"))
+  LOG_INFO("Configuring Wio E5 Module ...");
+  if (at_send_check_response("+AT: OK", 300, "AT\r\n"))
   {
     is_exist = true;
-    at_send_check_response("+MODE: TEST", 1500, "AT+MODE=TEST\r\n");
-    at_send_check_response("+TEST: RFCFG", 1500, "AT+TEST=RFCFG,866,SF12,125,12,15,14,ON,OFF,OFF\r\n");
-    delay(500);
+    // Warm boot - the module kept its power (only we were reset) and is still in TEST mode
+    // with our RF settings, AT+TEST=? answers ERROR(-12) when it isn't in TEST mode
+    if (at_send_check_response(LORA_RFCFG_ECHO, 500, "AT+TEST=?\r\n"))
+    {
+      lora_warm = true;
+    }
+    // Cold boot - both commands are sent back to back and the module works through them,
+    // fall back to sending RFCFG again if it got lost while the LoRa chip was resetting
+    else if (!at_send_check_response("+TEST: RFCFG", 3000, "AT+MODE=TEST\r\n" LORA_RFCFG_CMD))
+    {
+      at_send_check_response("+TEST: RFCFG", 1500, LORA_RFCFG_CMD);
+    }
+    LOG_INFO("%s, radio ready at %lu ms", lora_warm ? "Wio E5 warm boot" : "Wio E5 configured", millis());
   }
   else
   {
     is_exist = false;
-    Serial.print("No E5 module found.\r\n");
+    LOG_ERROR("No E5 module found.");
   }
-  delay(500);
 }
 
 
+// Page backgrounds on the sd card
+static const char SN_PAGE[] = "m2e-SN.bmp";
+static const char GW_PAGE[] = "m2e-GW.bmp";
+// Pages without a background image, drawn on a cleared screen
+static const char LINK_PAGE[] = "LoRa Link";
+static const char HISTORY_PAGE[] = "History";
+static const char TRENDS_PAGE[] = "Trends";
+
+// Pages, the one on top of the stack is on screen. LEFT/RIGHT on the 5-way switch step through
+// them, PRESS opens the Gateway page over the current one (and closes it again), KEY C goes back.
+// KEY B switches the trends page between per packet, per minute and per hour
+enum Page : uint8_t { PAGE_SENSOR, PAGE_GATEWAY, PAGE_LINK, PAGE_HISTORY, PAGE_TRENDS, PAGE_COUNT };
+#define PAGE_STACK_DEPTH 4
+static uint8_t pageStack[PAGE_STACK_DEPTH] = { PAGE_SENSOR };
+static uint8_t pageDepth = 1;
+
+// Buttons, bit i of buttonsPressed() is buttonList[i]
+static const uint8_t buttonList[] = { WIO_5S_LEFT, WIO_5S_RIGHT, WIO_5S_PRESS, WIO_KEY_C, WIO_KEY_B };
+#define BUTTON_LEFT  0x01
+#define BUTTON_RIGHT 0x02
+#define BUTTON_PRESS 0x04
+#define BUTTON_BACK  0x08
+#define BUTTON_RES   0x10
+
+// How often the page on screen is refreshed without a packet (ages and uptime count up)
+const unsigned long pageTickInterval = 1000;
+unsigned long previousPageTick = 0;
+
+// The words drawn over the pages, and the characters dtostrf() makes of the values
+#define TEXT_NUMBER       "0123456789.-"
+#define TEXT_DETECTED     "Detected"
+#define TEXT_NOT_DETECTED "Not Det"
+#define TEXT_ALERT        "Alert !"
+#define TEXT_OK           "OK"
+
+// Text styles for the values, rendered once at boot over the black value boxes of the page backgrounds.
+// Each holds the characters of the strings drawn with it
+const char * const valueStrings[] = { TEXT_NUMBER, TEXT_NOT_DETECTED, nullptr };
+const char * const alertStrings[] = { TEXT_DETECTED, TEXT_ALERT, nullptr };
+const char * const okStrings[]    = { TEXT_OK, nullptr };
+GlyphAtlas valueText(&FreeSerifBold9pt7b, &FreeSerifBold18pt7b, TFT_WHITE, TFT_BLACK, valueStrings);
+GlyphAtlas alertText(&FreeSerifBold9pt7b, &FreeSerifBold18pt7b, TFT_RED, TFT_BLACK, alertStrings);
+GlyphAtlas okText(&FreeSerifBold9pt7b, &FreeSerifBold18pt7b, TFT_GREEN, TFT_BLACK, okStrings);
+const char * const alertLargeStrings[] = { TEXT_ALERT, nullptr };
+GlyphAtlas alertTextLarge(&FreeSerifBold12pt7b, &FreeSerifBold24pt7b, TFT_RED, TFT_BLACK, alertLargeStrings);
+GlyphAtlas okTextLarge(&FreeSerifBold12pt7b, &FreeSerifBold24pt7b, TFT_GREEN, TFT_BLACK, okStrings);
+
+// A value drawn over a page background. It remembers its last text and box, a changed value
+// overwrites the old one and the part of the old box it doesn't cover is copied back from the
+// cached background
+struct Overlay {
+    Overlay(int16_t x, int16_t y) : x(x), y(y) {}
+
+    int16_t  x, y;
+    char     text[12] = "";
+    const GlyphAtlas * style = nullptr;
+    int16_t  w = 0, h = 0;  // box on screen, w = 0 while nothing is drawn
+    bool     plain = false; // drawn with the free font, its glyphs may reach a pixel past the box
+};
+
+Overlay snFields[] = { {93,62}, {249,60}, {93,110}, {244,111}, {240,160}, {86,209}, {87,162}, {250,209} };
+Overlay gwFields[] = { {197,70}, {82,126}, {237,126}, {200,195} };
+
+// Background currently on screen, overlays are only valid while it stays up
+static const char * shownPage = nullptr;
+
+// Function to draw a page background, all its overlays have to be drawn again
+void showPage(const char * page, Overlay * fields, uint8_t n){
+    images.draw<uint8_t>(page, 0, 0); //Display this 8-bit image (cached from sd card) from (0, 0)
+    shownPage = page;
+    for (uint8_t i = 0; i < n; i++){
+        fields[i].w = 0;
+        fields[i].plain = false;
+    }
+}
+
+// Function to draw an overlay, only if its text or style changed. Strings the style's atlas holds
+// are pushed from it, anything else is drawn with the style's free font
+void drawOverlay(Overlay & f, const char * text, const GlyphAtlas & style){
+    if (f.w != 0 && f.style == &style && strncmp(f.text, text, sizeof(f.text) - 1) == 0){
+        return;
+    }
+    strncpy(f.text, text, sizeof(f.text) - 1);
+    f.text[sizeof(f.text) - 1] = 0;
+    f.style = &style;
+
+    if (f.plain && f.w != 0){
+        // 1 pixel margin for free font glyphs reaching past their advance
+        images.restore<uint8_t>(shownPage, f.x - 1, f.y, f.w + 2, f.h);
+        f.w = 0;
+    }
+
+    int16_t w = style.draw(f.text, f.x, f.y);
+    if (w != 0){
+        // the new cells cover x .. x + w, put back what is left of the old box
+        if (f.w > w){
+            images.restore<uint8_t>(shownPage, f.x + w, f.y, f.w - w, f.h);
+        }
+        if (f.w != 0 && f.h > style.height()){
+            images.restore<uint8_t>(shownPage, f.x, f.y + style.height(), w, f.h - style.height());
+        }
+        f.w = w;
+        f.h = style.height();
+        f.plain = false;
+        return;
+    }
+
+    if (f.w != 0){
+        images.restore<uint8_t>(shownPage, f.x, f.y, f.w, f.h);
+    }
+    tft.setFreeFont(style.font()); //set font type
+    tft.setTextColor(style.color());
+    f.w = tft.drawString(f.text, f.x, f.y); //draw text string
+    f.h = tft.fontHeight();
+    f.plain = true;
+}
+
+// Function to show a page, redrawing the background only when it isn't already up. Without the
+// background in the cache an overlay can't be erased, so then the whole page is redrawn
+void enterPage(const char * page, Overlay * fields, uint8_t n){
+    if (shownPage != page || !images.cached(page)){
+        showPage(page, fields, n);
+    }
+}
+
 // Function to Display the Sensor Readings (WSN)
 void DisplayReadings1(){
+    char buf[16];
 
-    drawImage<uint8_t>("m2e-SN.bmp", 0, 0); //Display this 8-bit image in sd card from (0, 0)
-    tft.setTextColor(TFT_WHITE);
-    tft.setFreeFont(&FreeSerifBold9pt7b); //set font type 
+    enterPage(SN_PAGE, snFields, sizeof(snFields) / sizeof(snFields[0]));
 
-    tft.drawFloat(SN_m1,2,93,62); //draw text string
+    drawOverlay(snFields[0], dtostrf(SN_m1, 0, 2, buf), valueText);
 
-    tft.drawFloat(SN_m2,2,249,60); //draw text string
+    drawOverlay(snFields[1], dtostrf(SN_m2, 0, 2, buf), valueText);
 
-    tft.drawFloat(SN_rain_per,2,93,110); //draw text string
+    drawOverlay(snFields[2], dtostrf(SN_rain_per, 0, 2, buf), valueText);
 
-    tft.drawFloat(SN_disp,2,244,111); //draw text string
+    drawOverlay(snFields[3], dtostrf(SN_disp, 0, 2, buf), valueText);
 
-    tft.drawFloat(SN_temp,2,240,160); //draw text string
+    drawOverlay(snFields[4], dtostrf(SN_temp, 0, 2, buf), valueText);
 
-    tft.drawFloat(SN_humi,2,86,209); //draw text string
+    drawOverlay(snFields[5], dtostrf(SN_humi, 0, 2, buf), valueText);
 
     if(SN_vib == 1){
-        tft.setTextColor(TFT_RED);
-        tft.drawString("Detected",87,162);
+        drawOverlay(snFields[6], TEXT_DETECTED, alertText);
     } else {
-        tft.setTextColor(TFT_WHITE);
-        tft.drawString("Not Det",87,162);
+        drawOverlay(snFields[6], TEXT_NOT_DETECTED, valueText);
     }
     
     if(SN_stat == 1){
-        tft.setTextColor(TFT_RED);
-        tft.drawString("Alert !",250,209);
+        drawOverlay(snFields[7], TEXT_ALERT, alertText);
     } else {
-        tft.setTextColor(TFT_GREEN);
-        tft.drawString("OK",250,209);
+        drawOverlay(snFields[7], TEXT_OK, okText);
     }
 
 }
 
 // Function to Display the Sensor Readings (GW Node)
 void DisplayReadings2(){
+  char buf[16];
 
-  drawImage<uint8_t>("m2e-GW.bmp", 0, 0); //Display this 8-bit image in sd card from (0, 0)
-  tft.setTextColor(TFT_WHITE);
-  tft.setFreeFont(&FreeSerifBold9pt7b); //set font type 
-  tft.drawFloat(GW_rain_per,2,197,70); //draw text string
+  enterPage(GW_PAGE, gwFields, sizeof(gwFields) / sizeof(gwFields[0]));
+  drawOverlay(gwFields[0], dtostrf(GW_rain_per, 0, 2, buf), valueText);
 
-  tft.drawFloat(GW_temperature,2,82,126); //draw text string
+  drawOverlay(gwFields[1], dtostrf(GW_temperature, 0, 2, buf), valueText);
 
-  tft.drawFloat(GW_humidity,2,237,126); //draw text string
+  drawOverlay(gwFields[2], dtostrf(GW_humidity, 0, 2, buf), valueText);
   
-  tft.setFreeFont(&FreeSerifBold12pt7b); //set font type 
   if(SN_stat == 1){
-    tft.setTextColor(TFT_RED);
-    tft.drawString("Alert !",200,195);
+    drawOverlay(gwFields[3], TEXT_ALERT, alertTextLarge);
   } else {
-    tft.setTextColor(TFT_GREEN);
-    tft.drawString("OK",200,195);
+    drawOverlay(gwFields[3], TEXT_OK, okTextLarge);
   }
   
 }
 
+// Link stats page fields
+TextField linkFields[] = { TextField(170, 50, 2), TextField(170, 75, 2), TextField(170, 100, 2), TextField(170, 125, 2),
+                           TextField(170, 150, 2), TextField(170, 175, 2), TextField(170, 200, 2) };
+static const char * const linkLabels[] = { "Packets", "Last", "RSSI", "SNR", "RSSI range", "E5 baud", "Uptime" };
+
+// History page columns (age, moisture 1 and 2, rain, status), one row per packet, newest first
+static const int16_t historyColumns[] = { 4, 64, 136, 208, 280 };
+static const char * const historyLabels[] = { "Age", "M1", "M2", "Rain", "St" };
+TextField historyFields[HISTORY_ROWS][5] = {
+#define HISTORY_ROW(y) { TextField(4, y, 2), TextField(64, y, 2), TextField(136, y, 2), TextField(208, y, 2), TextField(280, y, 2) }
+    HISTORY_ROW(60), HISTORY_ROW(82), HISTORY_ROW(104), HISTORY_ROW(126),
+    HISTORY_ROW(148), HISTORY_ROW(170), HISTORY_ROW(192), HISTORY_ROW(214)
+#undef HISTORY_ROW
+};
+
+// Function to clear the screen for a page without a background image and draw its title,
+// all its fields have to be drawn again
+void showPlainPage(const char * page, TextField * fields, uint8_t n){
+    tft.fillScreen(TFT_BLACK);
+    tft.setFreeFont(&FreeSerifBold12pt7b); //set font type
+    tft.setTextColor(TFT_WHITE);
+    tft.drawString(page, 10, 8);
+    shownPage = page;
+    for (uint8_t i = 0; i < n; i++){
+        fields[i].invalidate();
+    }
+}
+
+// Function to format a time span as "12s", "34m" or "5h"
+char * formatAge(unsigned long ms, char * buf){
+    unsigned long s = ms / 1000;
+    const char * unit = "s";
+    if (s >= 3600){
+        s /= 3600;
+        unit = "h";
+    } else if (s >= 100){
+        s /= 60;
+        unit = "m";
+    }
+    ltoa(s, buf, 10);
+    return strcat(buf, unit);
+}
+
+// Function to Display the LoRa link statistics
+void DisplayLinkStats(){
+    char buf[TEXT_FIELD_LEN + 8];
+    uint8_t n = sizeof(linkFields) / sizeof(linkFields[0]);
+
+    if (shownPage != LINK_PAGE){
+        showPlainPage(LINK_PAGE, linkFields, n);
+        tft.setTextSize(2);
+        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
+        for (uint8_t i = 0; i < n; i++){
+            tft.setCursor(10, 50 + 25 * i);
+            tft.print(linkLabels[i]);
+        }
+    }
+
+    linkFields[0].drawNumber(tft, link.packets, TFT_WHITE, TFT_BLACK);
+    if (link.packets == 0){
+        for (uint8_t i = 1; i < 5; i++){
+            linkFields[i].draw(tft, "-", TFT_WHITE, TFT_BLACK);
+        }
+    } else {
+        linkFields[1].draw(tft, strcat(formatAge(millis() - link.lastPacket, buf), " ago"), TFT_WHITE, TFT_BLACK);
+        linkFields[2].draw(tft, strcat(ltoa(link.rssi, buf, 10), " dBm"), TFT_WHITE, TFT_BLACK);
+        linkFields[3].draw(tft, strcat(ltoa(link.snr, buf, 10), " dB"), TFT_WHITE, TFT_BLACK);
+        ltoa(link.rssiMin, buf, 10);
+        strcat(buf, "..");
+        ltoa(link.rssiMax, buf + strlen(buf), 10);
+        linkFields[4].draw(tft, buf, TFT_WHITE, TFT_BLACK);
+    }
+    linkFields[5].drawNumber(tft, e5Baud, TFT_WHITE, TFT_BLACK);
+    linkFields[6].draw(tft, formatAge(millis(), buf), TFT_WHITE, TFT_BLACK);
+}
+
+// Function to Display the last few Sensor Node packets
+void DisplayHistory(){
+    char buf[TEXT_FIELD_LEN + 8];
+
+    if (shownPage != HISTORY_PAGE){
+        showPlainPage(HISTORY_PAGE, historyFields[0], HISTORY_ROWS * 5);
+        tft.setTextSize(2);
+        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
+        for (uint8_t c = 0; c < 5; c++){
+            tft.setCursor(historyColumns[c], 36);
+            tft.print(historyLabels[c]);
+        }
+    }
+
+    for (uint8_t row = 0; row < HISTORY_ROWS; row++){
+        TextField * f = historyFields[row];
+        if (row >= historyCount){
+            for (uint8_t c = 0; c < 5; c++){
+                f[c].draw(tft, "", TFT_WHITE, TFT_BLACK);
+            }
+            continue;
+        }
+        const Reading & r = history[(historyHead + HISTORY_ROWS - 1 - row) % HISTORY_ROWS];
+        f[0].draw(tft, formatAge(millis() - r.at, buf), TFT_DARKGREY, TFT_BLACK);
+        f[1].draw(tft, dtostrf(r.m1, 0, 1, buf), TFT_WHITE, TFT_BLACK);
+        f[2].draw(tft, dtostrf(r.m2, 0, 1, buf), TFT_WHITE, TFT_BLACK);
+        f[3].draw(tft, dtostrf(r.rain, 0, 1, buf), TFT_WHITE, TFT_BLACK);
+        if (r.stat){
+            f[4].draw(tft, "AL", TFT_RED, TFT_BLACK);
+        } else {
+            f[4].draw(tft, "OK", TFT_GREEN, TFT_BLACK);
+        }
+    }
+}
+
+// Trends page, a chart with its name, latest value and scale for each trend
+#define TREND_CHARTS 4
+Trend * const trends[TREND_CHARTS] = { &rainTrend, &m1Trend, &m2Trend, &dispTrend };
+static const char * const trendLabels[TREND_CHARTS] = { "Rain %", "Moisture 1", "Moisture 2", "Displacement" };
+TrendChart trendCharts[TREND_CHARTS] = {
+    TrendChart(10, 48, 300, 36, TFT_CYAN, TFT_BLACK), TrendChart(10, 98, 300, 36, TFT_GREEN, TFT_BLACK),
+    TrendChart(10, 148, 300, 36, TFT_GREEN, TFT_BLACK), TrendChart(10, 198, 300, 36, TFT_ORANGE, TFT_BLACK)
+};
+TextField trendFields[TREND_CHARTS * 2 + 1] = {
+    TextField(100, 38), TextField(190, 38), TextField(100, 88), TextField(190, 88),
+    TextField(100, 138), TextField(190, 138), TextField(100, 188), TextField(190, 188),
+    TextField(220, 14, 2)
+};
+static const char * const trendResolutions[] = { "packets", "minutes", "hours" };
+uint8_t trendResolution = TREND_RAW;
+
+// Function to Display the trend charts, each one only where its line moved
+void DisplayTrends(){
+    char buf[TEXT_FIELD_LEN + 8];
+
+    if (shownPage != TRENDS_PAGE){
+        showPlainPage(TRENDS_PAGE, trendFields, sizeof(trendFields) / sizeof(trendFields[0]));
+        tft.setTextSize(1);
+        tft.setTextColor(TFT_DARKGREY, TFT_BLACK);
+        for (uint8_t i = 0; i < TREND_CHARTS; i++){
+            tft.setCursor(10, 38 + 50 * i);
+            tft.print(trendLabels[i]);
+            trendCharts[i].invalidate();
+        }
+    }
+    trendFields[TREND_CHARTS * 2].draw(tft, trendResolutions[trendResolution], TFT_WHITE, TFT_BLACK);
+
+    for (uint8_t i = 0; i < TREND_CHARTS; i++){
+        if (!trendCharts[i].draw(*trends[i], trendResolution)){
+            continue;
+        }
+        const Trend & t = *trends[i];
+        uint8_t dp = t.value(1) < 0.05 ? 2 : 1;
+        trendFields[i * 2].drawFloat(tft, t.latest(), dp, TFT_WHITE, TFT_BLACK);
+        dtostrf(t.value(trendCharts[i].low()), 0, dp, buf);
+        strcat(buf, "..");
+        dtostrf(t.value(trendCharts[i].high()), 0, dp, buf + strlen(buf));
+        trendFields[i * 2 + 1].draw(tft, buf, TFT_DARKGREY, TFT_BLACK);
+    }
+}
+
+// Function to draw the page on top of the stack, only what changed since it was last drawn
+void drawTopPage(){
+    switch (pageStack[pageDepth - 1]){
+    case PAGE_SENSOR:
+        DisplayReadings1();
+        break;
+    case PAGE_GATEWAY:
+        DisplayReadings2();
+        break;
+    case PAGE_LINK:
+        DisplayLinkStats();
+        break;
+    case PAGE_HISTORY:
+        DisplayHistory();
+        break;
+    case PAGE_TRENDS:
+        DisplayTrends();
+        break;
+    }
+}
+
+// Function to handle the buttons and keep the page on screen up to date. Never waits, so the
+// radio is polled again as soon as the page is drawn
+void uiPoll(){
+    uint8_t pressed = buttonsPressed();
+    uint8_t & top = pageStack[pageDepth - 1];
+    if (pressed & BUTTON_LEFT){
+        top = (top + PAGE_COUNT - 1) % PAGE_COUNT;
+    }
+    if (pressed & BUTTON_RIGHT){
+        top = (top + 1) % PAGE_COUNT;
+    }
+    if (pressed & BUTTON_PRESS){
+        if (top == PAGE_GATEWAY && pageDepth > 1){
+            pageDepth--;
+        } else if (top != PAGE_GATEWAY && pageDepth < PAGE_STACK_DEPTH){
+            pageStack[pageDepth++] = PAGE_GATEWAY;
+        }
+    }
+    if ((pressed & BUTTON_BACK) && pageDepth > 1){
+        pageDepth--;
+    }
+    if ((pressed & BUTTON_RES) && pageStack[pageDepth - 1] == PAGE_TRENDS){
+        trendResolution = (trendResolution + 1) % 3;
+    }
+
+    unsigned long now = millis();
+    if (pressed || packetFresh || now - previousPageTick >= pageTickInterval){
+        previousPageTick = now;
+        for (uint8_t i = 0; i < TREND_CHARTS; i++){
+            trends[i]->tick(now);
+        }
+        packetFresh = false;
+        drawTopPage();
+        if (pressed){
+            LOG_DEBUG("Page %u drawn in %lu ms", pageStack[pageDepth - 1], millis() - now);
+        }
+    }
+}
+
 // Function to Setup Display for Initial Screen - make2explore logo
 void HomeScreen(){
   drawImage<uint16_t>("WioTerminal-screen-m2e.bmp", 0, 0); //Display this 8-bit image in sd card from (0, 0)
 }
 
-// Function to Setup Display for First (WSN Data) Screen
-void FirstScreen(){
-  drawImage<uint8_t>("m2e-SN.bmp", 0, 0); //Display this 8-bit image in sd card from (0, 0)
-}
+// How long the make2explore logo stays up on a cold boot
+const unsigned long splashTime = 3000;
 
-// Function to Setup Display for First (GW Node Data) Screen
-void secondScreen(){
-  drawImage<uint8_t>("m2e-GW.bmp", 0, 0); //Display this 8-bit image in sd card from (0, 0)
+#ifdef AT_TRACE
+// Function to start this boot's AT trace file, the first free AT_TRACE_DIR/ATnnn.BIN
+static void atTraceOpen()
+{
+    char path[32];
+    SD.mkdir(AT_TRACE_DIR);
+    for (uint16_t n = 0; n < 1000; n++)
+    {
+        snprintf(path, sizeof(path), AT_TRACE_DIR "/AT%03u.BIN", n);
+        if (!SD.exists(path))
+        {
+            if (atTrace.begin(SD.open(path, FILE_WRITE)))
+            {
+                LOG_INFO("AT trace in %s", path);
+            }
+            return;
+        }
+    }
+    LOG_WARN("No free AT trace file in " AT_TRACE_DIR);
 }
+#endif
 
 // Function to Setup the Initializations and Configurations
 void setup() {
     Serial.begin (9600);
-    e5.begin(9600);
+    logBegin(Serial);
+    unsigned long baud = e5Begin(e5, E5_BAUD);
+    e5Baud = baud;
+    LOG_INFO("Wio E5 link at %lu baud", baud);
+#ifdef E5_LINK_TEST
+    logFlush();
+    if (baud) {
+        e5LinkSweep(e5, Serial, baud, 50, E5_BAUD);
+    }
+#endif
     //Initialise SD card
     if (!SD.begin(SDCARD_SS_PIN, SDCARD_SPI)) {
         while (1);
     }
+    if (telemetry.begin()) {
+        LOG_INFO("Telemetry log: %lu records in %u segments, %lu damaged blocks dropped",
+                 telemetry.records(), telemetry.segments(), telemetry.droppedBlocks());
+    } else {
+        LOG_ERROR("Can't open the telemetry log in " TELEMETRY_DIR);
+    }
+#ifdef AT_TRACE
+    atTraceOpen();
+#endif
 
-    pinMode(WIO_5S_PRESS, INPUT_PULLUP);
+    buttonsBegin(buttonList, sizeof(buttonList));
 
     tft.begin(); //start TFT LCD 
+#ifdef RAW_IMAGE_DMA
+    tft.initDMA();      // drawImage() pushes chunks with DMA
+#endif
     tft.setRotation(1); //set screen rotation 
 
-    configLoRaModule();
+    // Render the value text styles, a style without memory falls back to its free font
+    valueText.begin();
+    alertText.begin();
+    okText.begin();
+    alertTextLarge.begin();
+    okTextLarge.begin();
 
     HomeScreen();
-    delay(3000);
-    FirstScreen();
+    unsigned long splashStart = millis();
+
+    configLoRaModule();     // Configure Wio E5 while the logo is up
+
+    // Both page backgrounds into RAM now, so switching pages never reads the sd card
+    images.preload<uint8_t>(SN_PAGE);
+    images.preload<uint8_t>(GW_PAGE);
+
+    // Keep the logo up for the rest of splashTime on a cold boot only, a warm (brown-out) reset
+    // goes straight back to receiving
+    while (!lora_warm && millis() - splashStart < splashTime) {
+        yield();
+    }
+    drawTopPage();
     
 }
 
 // Function main Loop
 void loop() {
+    logPump();
+    telemetry.poll();
+#ifdef AT_TRACE
+    atTrace.poll();
+#endif
+    exporter.poll();
     if (is_exist)
     {
-        node_recv(6000);
-        DisplayReadings1();
-    }
-
-    if (digitalRead(WIO_5S_PRESS) == LOW) {
-        DisplayReadings2();
-        delay(2000);
+        radioPoll();
     }
+    uiPoll();
 }
 // ---------------------------------- make2explore.com ----------------------------------------------------//
\ No newline at end of file
@@ -0,0 +1,193 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Program           - End Node unit tests
+// Software          - C/C++, PlatformIO IDE - pio test -e native
+// -----------------------------------------------------------------------------------------------------------//
+// Builds the End Node sketch over Native-HAL and runs its frame parsing and telemetry logging on the PC. The
+// Wio E5 link (SoftwareSerial e5Uart) is driven through the HAL, the sd card is a temporary folder and the
+// clock is the simulated one, so the log times are exact and the tests take no real time.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <Arduino.h>
+#include <unity.h>
+
+#ifdef E5_HW_UART
+#error "The tests drive the SoftwareSerial Wio E5 link, build them without E5_HW_UART"
+#endif
+
+// The sketch, its setup() / loop() stay unused, main() below (Native-HAL's is weak) runs the tests
+#include "../../src/main.cpp"
+
+#include "Hal.h"
+
+#include <stdlib.h>
+#include <filesystem>
+#include <string>
+
+// The Wio E5 link's name in the HAL
+static const char E5[] = "SoftwareSerial";
+
+// Function to hex encode bytes, as the Wio E5 reports a received payload
+static std::string toHex(const void * data, size_t len){
+    static const char digits[] = "0123456789ABCDEF";
+    std::string out;
+    for (size_t i = 0; i < len; i++){
+        uint8_t b = ((const uint8_t *)data)[i];
+        out += digits[b >> 4];
+        out += digits[b & 0x0F];
+    }
+    return out;
+}
+
+// Function to feed a received packet, the LEN line and the RX line, as the module reports it
+static void feedPacket(const std::string & payload, int rssi = -70, int snr = 9){
+    std::string urc = "+TEST: LEN:" + std::to_string(payload.size()) + ", RSSI:" + std::to_string(rssi)
+                    + ", SNR:" + std::to_string(snr) + "\r\n"
+                    + "+TEST: RX \"" + toHex(payload.data(), payload.size()) + "\"\r\n";
+    halUartFeed(E5, urc.data(), urc.size());
+}
+
+// Function to run recv_parse() until it reports a frame or the module has nothing more to say
+static int parseAll(){
+    int frame = FRAME_NONE;
+    while (frame == FRAME_NONE && e5.available() > 0){
+        frame = recv_parse();
+    }
+    return frame;
+}
+
+// Function to build a backfill frame of count records from seq first on
+static std::string backfillFrame(uint16_t first, uint8_t count){
+    std::string frame = "HB,";
+    frame += (char)count;
+    for (uint8_t i = 0; i < count; i++){
+        HistoryRecord r = {};
+        r.seq = first + i;
+        r.m1 = 40 + i;
+        r.m2 = 45;
+        r.rain = 30;
+        r.humi = 50;
+        r.temp = 21;
+        r.disp = 12;
+        r.flags = i == 0 ? HISTORY_VIB : HISTORY_ALERT;
+        r.check = historyCheck(r);
+        frame.append((const char *)&r, sizeof(r));
+    }
+    return frame;
+}
+
+void setUp(){
+    while (e5.available() > 0) e5.read();
+    recv_len = 0;
+    recv_buf[0] = 0;
+    halUartTake(E5);
+    SN_seq = -1;
+}
+
+void tearDown(){
+}
+
+// ---- recv_parse()
+
+static void test_live_frame(){
+    feedPacket("EN,220.00,148.00,25.00,60.00,25.00,0.57,1,1,30.00,55.00,24.00,17", -82, -3);
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 220, SN_m1);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 148, SN_m2);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 25, SN_rain_per);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.57, SN_disp);
+    TEST_ASSERT_TRUE(SN_vib);
+    TEST_ASSERT_TRUE(SN_stat);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 30, GW_rain_per);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 55, GW_humidity);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 24, GW_temperature);
+    TEST_ASSERT_EQUAL_INT(17, SN_seq);
+    TEST_ASSERT_EQUAL_INT(-82, link.rssi);
+    TEST_ASSERT_EQUAL_INT(-3, link.snr);
+}
+
+static void test_live_frame_without_seq(){
+    SN_seq = 5;
+    feedPacket("EN,220.00,148.00,25.00,60.00,25.00,0.57,0,0,30.00,55.00,24.00");
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    TEST_ASSERT_EQUAL_INT(-1, SN_seq);
+}
+
+static void test_module_reset(){
+    static const char err[] = "+TEST: ERROR(-12)\r\n";
+    halUartFeed(E5, err, sizeof(err) - 1);
+    TEST_ASSERT_EQUAL_INT(FRAME_NOT_TEST, parseAll());
+}
+
+static void test_backfill_frame(){
+    std::string frame = backfillFrame(0x0123, 4);
+    feedPacket(frame);
+    TEST_ASSERT_EQUAL_INT(FRAME_BACKFILL, parseAll());
+    char bytes[sizeof(backfill_hex) / 2];
+    TEST_ASSERT_EQUAL_INT(frame.size() * 2, strlen(backfill_hex));
+    unHex(backfill_hex, bytes, sizeof(bytes));
+    TEST_ASSERT_EQUAL_MEMORY(frame.data(), bytes, frame.size());
+}
+
+// ---- recordPacket() / recordBackfill()
+
+static void test_backfill_placed_in_time(){
+    TEST_ASSERT_TRUE(SD.begin(SDCARD_SS_PIN, SDCARD_SPI));
+    TEST_ASSERT_TRUE(telemetry.begin());
+    telemetry.setClock(100000);
+
+    feedPacket("EN,40.00,45.00,30.00,50.00,21.00,0.12,0,0,30.00,55.00,24.00,10");
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    recordPacket();
+    uint32_t live = telemetry.now();
+
+    // two records the Sensor Node logged while the Gateway was out, 3 and 2 sends before the live frame
+    delay(5000);
+    feedPacket(backfillFrame(7, 2));
+    TEST_ASSERT_EQUAL_INT(FRAME_BACKFILL, parseAll());
+    recordBackfill();
+    TEST_ASSERT_TRUE(telemetry.flush());
+
+    TelemetryBlock block;
+    TEST_ASSERT_TRUE(telemetry.readBlock(telemetry.find(TELEMETRY_RAW, 0), block));
+    TEST_ASSERT_EQUAL_UINT16(3, block.count);
+
+    const TelemetryRecord & r = block.records[0];
+    TEST_ASSERT_EQUAL_UINT16(10, r.snSeq);
+    TEST_ASSERT_EQUAL_UINT32(live, r.time);
+    TEST_ASSERT_BITS_LOW(TELEMETRY_BACKFILL, r.flags);
+    TEST_ASSERT_EQUAL_INT(240, r.gwTemp);
+
+    const TelemetryRecord & b0 = block.records[1];
+    TEST_ASSERT_EQUAL_UINT16(7, b0.snSeq);
+    TEST_ASSERT_EQUAL_UINT32(live + 5, b0.time);
+    TEST_ASSERT_BITS_HIGH(TELEMETRY_BACKFILL | TELEMETRY_VIB, b0.flags);
+    TEST_ASSERT_EQUAL_UINT32(live - 3 * SENSOR_SEND_INTERVAL / 1000, b0.taken);
+    TEST_ASSERT_EQUAL_INT(400, b0.m1);
+
+    const TelemetryRecord & b1 = block.records[2];
+    TEST_ASSERT_EQUAL_UINT16(8, b1.snSeq);
+    TEST_ASSERT_BITS_HIGH(TELEMETRY_BACKFILL | TELEMETRY_ALERT, b1.flags);
+    TEST_ASSERT_EQUAL_UINT32(live - 2 * SENSOR_SEND_INTERVAL / 1000, b1.taken);
+    TEST_ASSERT_EQUAL_UINT32(live - 2 * SENSOR_SEND_INTERVAL / 1000, telemetryTaken(b1));
+}
+
+int main(int, char **){
+    // a fresh sd card, removed again at the end
+    char sdDir[] = "/tmp/end-node-test-XXXXXX";
+    if (!mkdtemp(sdDir)){
+        return 1;
+    }
+    halSdRoot(sdDir);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_live_frame);
+    RUN_TEST(test_live_frame_without_seq);
+    RUN_TEST(test_module_reset);
+    RUN_TEST(test_backfill_frame);
+    RUN_TEST(test_backfill_placed_in_time);
+    int failures = UNITY_END();
+
+    std::filesystem::remove_all(sdDir);
+    return failures;
+}
@@ -0,0 +1,112 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Program           - Gateway Node hot path micro-benchmarks
+// Software          - C/C++, PlatformIO IDE - pio run -e bench -t upload (board), pio run -e native_bench (PC)
+// -----------------------------------------------------------------------------------------------------------//
+// Builds the Gateway Node sketch with its Wio E5 link (SoftwareSerial e5) replaced by a BenchModem, then times
+// the code every relayed packet runs: the URC parsing and its helpers, the AT command ack matching and the
+// String payload of the frame to the End Node. One BENCH,... line per case on the serial monitor (see
+// ../Common/src/Bench.h).
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "Bench.h"
+
+#ifdef E5_HW_UART
+#error "The benchmarks replace the SoftwareSerial Wio E5 link, build them without E5_HW_UART"
+#endif
+
+// The sketch, with its own setup() / loop() renamed out of the way
+#define SoftwareSerial BenchModem
+#define setup sketchSetup
+#define loop sketchLoop
+#include "../src/main.cpp"
+#undef setup
+#undef loop
+#undef SoftwareSerial
+
+#ifdef ARDUINO_ARCH_NATIVE
+#include "Hal.h"
+#endif
+
+// A Sensor Node live frame and a 4 record history backfill frame, as the Wio E5 reports them
+static const char liveUrc[] = "+TEST: LEN:32, RSSI:-90, SNR:8\r\n"
+                              "+TEST: RX \"47572C3232302C3134382C3235342C36302C32352C302E35372C302C302C3137\"\r\n";
+static const char backfillUrc[] = "+TEST: LEN:48, RSSI:-90, SNR:8\r\n"
+                                  "+TEST: RX \"48422C040D00DC94143C19390000000E00DC94153C19390000000F00DC94163C1939"
+                                  "0000001000DC94173C1939000000\"\r\n";
+static const char txDone[] = "+TEST: TXLRSTR \"454E2C3232302C3134382C3235342C36302C32352C302E35372C302C302C3235342C"
+                             "36302C3235\"\r\n"
+                             "+TEST: TX DONE\r\n";
+
+static char txCmd[] = "AT+TEST=TXLRSTR,\"EN,220,148,254,60,25,0.57,0,0,254,60,25\"\r\n";
+static const char payloadHex[] = "3232302C3134382C3235342C36302C32352C302E35372C302C302C3137";
+static const char payloadText[] = "220,148,254,60,25,0.57,0,0,17";
+
+static void atAckOp(){
+    benchSink += at_send_check_response("TX DONE", 6000, txCmd);
+}
+
+static void recvLiveOp(){
+    e5.feed(liveUrc);
+    int frame = FRAME_NONE;
+    for (uint8_t i = 0; i < 4 && frame == FRAME_NONE; i++){
+        frame = recv_parse();
+    }
+    benchSink += frame;
+}
+
+static void recvBackfillOp(){
+    e5.feed(backfillUrc);
+    int frame = FRAME_NONE;
+    for (uint8_t i = 0; i < 4 && frame == FRAME_NONE; i++){
+        frame = recv_parse();
+    }
+    benchSink += frame;
+}
+
+// The nine fields recv_parse() takes from a live frame
+static void getValueOp(){
+    for (int i = 0; i < 9; i++){
+        benchSink += getValue(payloadText, ',', i).length();
+    }
+}
+
+static void unHexOp(){
+    char output[128];
+    benchSink += unHex(payloadHex, output, sizeof(output))[0];
+}
+
+static void sendOp(){
+    benchSink += LoRa_send();
+}
+
+void setup(){
+    dbg.begin(9600);
+    SN_m1 = 220;
+    SN_m2 = 148;
+    SN_rain_per = 254;
+    SN_humi = 60;
+    SN_temp = 25;
+    SN_disp = 0.57;
+    GW_rain_per = 254;
+    GW_humidity = 60;
+    GW_temperature = 25;
+
+    benchBegin(dbg);
+    e5.answer(nullptr);
+    benchRun("recv_parse_live", recvLiveOp, 200);
+    benchRun("recv_parse_backfill", recvBackfillOp, 200);
+    benchRun("getValue_x9", getValueOp, 200);
+    benchRun("unHex", unHexOp, 500);
+    e5.answer(txDone);
+    benchRun("at_send_check_response", atAckOp, 200);
+    benchRun("LoRa_send", sendOp, 200);
+}
+
+void loop(){
+#ifdef ARDUINO_ARCH_NATIVE
+    halStop();
+#endif
+}
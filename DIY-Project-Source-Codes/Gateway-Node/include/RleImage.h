@@ -0,0 +1,54 @@
+#pragma once
+#include <Arduino.h>
+
+/*
+Palette + run length compressed RGB565 images in flash, drawn straight to the LCD.
+
+Images are converted at build time with Host-Tools/img2rle, which writes a header with the
+palette, the run stream and an RleImage describing them. The pixels are runs in raster order
+(a run may continue on the next line), every run starts with one byte
+
+    iiii nnnn       i = palette index (up to 16 colours)
+                    n = 0..14 : run of n + 1 pixels
+                    n = 15    : run of 16 + the next byte pixels (16..271)
+
+so a 240x240 logo with a few flat colours takes a few KB instead of 112 KB.
+
+USAGE:
+
+    #include "m2e-logo-rle.h"           // generated: img2rle include/m2e-logo.h 240 240 m2elogo
+    drawRle(tft, m2elogo_rle, 0, 0);
+ */
+
+struct RleImage {
+    uint16_t         width;
+    uint16_t         height;
+    const uint16_t * palette;       // RGB565, PROGMEM
+    const uint8_t  * data;          // run stream, PROGMEM
+    uint32_t         size;          // bytes in data
+};
+
+// Function to decode an RleImage into the LCD, each run goes out as one block of a single colour
+template<class Display>
+void drawRle(Display & d, const RleImage & img, int32_t x, int32_t y){
+    uint32_t left = (uint32_t)img.width * img.height;
+    uint32_t i = 0;
+    d.startWrite();
+    d.setAddrWindow(x, y, img.width, img.height);
+    while (left > 0 && i < img.size){
+        uint8_t  b = pgm_read_byte(img.data + i++);
+        uint32_t n = (b & 0x0F) + 1;
+        if ((b & 0x0F) == 0x0F && i < img.size){
+            n = 16 + pgm_read_byte(img.data + i++);
+        }
+        if (n > left){
+            n = left;
+        }
+        d.pushBlock(pgm_read_word(img.palette + (b >> 4)), n);
+        left -= n;
+    }
+    if (left > 0){
+        d.pushBlock(0, left);       // truncated stream - fill the window so the next draw lines up
+    }
+    d.endWrite();
+}
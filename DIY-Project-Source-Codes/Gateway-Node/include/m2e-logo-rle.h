@@ -0,0 +1,226 @@
+// Generated by Host-Tools/img2rle from m2e-logo.h - do not edit, regenerate instead
+// 240x240, 4 colours, 3400 bytes (115200 bytes raw)
+#pragma once
+#include "RleImage.h"
+
+static const uint16_t m2elogo_rle_palette[] PROGMEM = {
+    0x0000, 0x8410, 0xC618, 0xFFFF,
+};
+
+static const uint8_t m2elogo_rle_data[] PROGMEM = {
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x85, 0x12, 0x23,
+    0x33, 0x23, 0x12, 0x0F, 0xC9, 0x11, 0x20, 0x3F, 0x06, 0x20, 0x11, 0x0F, 0xC1, 0x10, 0x20, 0x3F,
+    0x0E, 0x20, 0x10, 0x0F, 0xBB, 0x10, 0x20, 0x39, 0x21, 0x16, 0x01, 0x13, 0x21, 0x38, 0x20, 0x10,
+    0x0F, 0xB5, 0x10, 0x20, 0x37, 0x20, 0x11, 0x0F, 0x05, 0x10, 0x20, 0x37, 0x20, 0x10, 0x0F, 0xB0,
+    0x10, 0x20, 0x36, 0x20, 0x10, 0x0F, 0x0D, 0x10, 0x20, 0x35, 0x20, 0x10, 0x0F, 0xAC, 0x10, 0x20,
+    0x35, 0x20, 0x10, 0x0E, 0x13, 0x0F, 0x00, 0x10, 0x35, 0x20, 0x10, 0x0F, 0xA9, 0x20, 0x35, 0x10,
+    0x09, 0x11, 0x21, 0x39, 0x21, 0x10, 0x0C, 0x10, 0x20, 0x34, 0x20, 0x0F, 0xA6, 0x10, 0x34, 0x20,
+    0x10, 0x07, 0x10, 0x20, 0x3F, 0x04, 0x20, 0x10, 0x0C, 0x20, 0x34, 0x10, 0x0F, 0xA2, 0x10, 0x35,
+    0x10, 0x06, 0x10, 0x20, 0x3F, 0x09, 0x20, 0x0D, 0x20, 0x34, 0x10, 0x0F, 0x9F, 0x10, 0x34, 0x10,
+    0x05, 0x10, 0x20, 0x3F, 0x0E, 0x10, 0x0C, 0x10, 0x20, 0x33, 0x10, 0x0F, 0x9D, 0x20, 0x33, 0x20,
+    0x05, 0x10, 0x20, 0x3F, 0x11, 0x20, 0x0D, 0x10, 0x33, 0x20, 0x0F, 0x9A, 0x10, 0x34, 0x10, 0x04,
+    0x10, 0x20, 0x3F, 0x15, 0x10, 0x0D, 0x20, 0x33, 0x10, 0x0F, 0x97, 0x10, 0x33, 0x20, 0x05, 0x20,
+    0x3F, 0x18, 0x10, 0x0D, 0x10, 0x33, 0x10, 0x0F, 0x95, 0x10, 0x33, 0x10, 0x04, 0x10, 0x3F, 0x1B,
+    0x10, 0x0D, 0x10, 0x33, 0x10, 0x0F, 0x93, 0x20, 0x33, 0x10, 0x04, 0x20, 0x3F, 0x1D, 0x0F, 0x00,
+    0x33, 0x20, 0x0F, 0x91, 0x20, 0x33, 0x04, 0x10, 0x3F, 0x1F, 0x20, 0x0F, 0x00, 0x20, 0x32, 0x20,
+    0x0F, 0x8F, 0x20, 0x33, 0x04, 0x20, 0x3F, 0x21, 0x10, 0x0F, 0x00, 0x20, 0x32, 0x20, 0x0F, 0x8D,
+    0x10, 0x33, 0x04, 0x20, 0x3F, 0x0B, 0x20, 0x15, 0x20, 0x3F, 0x00, 0x0F, 0x01, 0x20, 0x32, 0x10,
+    0x0F, 0x8B, 0x10, 0x33, 0x04, 0x3F, 0x0D, 0x20, 0x05, 0x20, 0x3F, 0x00, 0x10, 0x0F, 0x01, 0x20,
+    0x32, 0x10, 0x0F, 0x89, 0x10, 0x33, 0x03, 0x10, 0x3F, 0x0E, 0x20, 0x05, 0x20, 0x3F, 0x01, 0x0F,
+    0x02, 0x20, 0x32, 0x10, 0x0F, 0x88, 0x33, 0x03, 0x10, 0x3F, 0x0F, 0x20, 0x05, 0x20, 0x3F, 0x01,
+    0x10, 0x0F, 0x02, 0x33, 0x0F, 0x87, 0x20, 0x32, 0x10, 0x03, 0x3F, 0x10, 0x20, 0x05, 0x20, 0x3F,
+    0x01, 0x20, 0x0F, 0x03, 0x32, 0x20, 0x0F, 0x85, 0x10, 0x32, 0x10, 0x03, 0x3F, 0x11, 0x20, 0x05,
+    0x20, 0x3F, 0x02, 0x0F, 0x03, 0x10, 0x32, 0x10, 0x0F, 0x83, 0x10, 0x32, 0x20, 0x03, 0x20, 0x3F,
+    0x11, 0x20, 0x05, 0x20, 0x3F, 0x02, 0x10, 0x0F, 0x03, 0x10, 0x32, 0x10, 0x0F, 0x82, 0x33, 0x03,
+    0x20, 0x3F, 0x12, 0x20, 0x05, 0x20, 0x3F, 0x02, 0x10, 0x0F, 0x04, 0x20, 0x32, 0x0F, 0x81, 0x10,
+    0x32, 0x10, 0x02, 0x10, 0x3F, 0x0C, 0x16, 0x07, 0x16, 0x3A, 0x20, 0x0F, 0x05, 0x32, 0x10, 0x0F,
+    0x80, 0x32, 0x20, 0x03, 0x3F, 0x0C, 0x20, 0x0F, 0x06, 0x20, 0x39, 0x20, 0x0F, 0x05, 0x10, 0x32,
+    0x0F, 0x7F, 0x20, 0x32, 0x03, 0x20, 0x3F, 0x0C, 0x20, 0x0F, 0x06, 0x20, 0x3A, 0x0F, 0x06, 0x20,
+    0x31, 0x20, 0x0F, 0x7D, 0x10, 0x32, 0x10, 0x02, 0x10, 0x3F, 0x0D, 0x20, 0x0F, 0x06, 0x20, 0x3A,
+    0x0F, 0x06, 0x10, 0x32, 0x10, 0x0F, 0x7C, 0x20, 0x32, 0x03, 0x3F, 0x0E, 0x20, 0x0F, 0x06, 0x20,
+    0x3A, 0x0F, 0x07, 0x20, 0x31, 0x20, 0x0F, 0x7B, 0x10, 0x32, 0x10, 0x02, 0x20, 0x3F, 0x0E, 0x20,
+    0x0F, 0x06, 0x20, 0x3A, 0x0F, 0x08, 0x32, 0x10, 0x0F, 0x7A, 0x20, 0x31, 0x20, 0x02, 0x10, 0x3F,
+    0x0F, 0x20, 0x0F, 0x06, 0x20, 0x39, 0x20, 0x0F, 0x08, 0x20, 0x31, 0x20, 0x0F, 0x79, 0x10, 0x32,
+    0x10, 0x02, 0x20, 0x3F, 0x17, 0x20, 0x05, 0x20, 0x3F, 0x02, 0x20, 0x0F, 0x09, 0x32, 0x10, 0x0F,
+    0x78, 0x20, 0x32, 0x02, 0x10, 0x3F, 0x18, 0x20, 0x05, 0x20, 0x3F, 0x02, 0x10, 0x0F, 0x09, 0x20,
+    0x31, 0x20, 0x0F, 0x78, 0x32, 0x10, 0x02, 0x20, 0x3F, 0x18, 0x20, 0x05, 0x20, 0x3F, 0x02, 0x0F,
+    0x0A, 0x10, 0x32, 0x0F, 0x77, 0x10, 0x32, 0x02, 0x10, 0x3F, 0x19, 0x20, 0x05, 0x20, 0x3F, 0x02,
+    0x0F, 0x0B, 0x32, 0x10, 0x0F, 0x76, 0x20, 0x31, 0x20, 0x02, 0x20, 0x3F, 0x19, 0x20, 0x05, 0x20,
+    0x3F, 0x01, 0x10, 0x0F, 0x0B, 0x10, 0x31, 0x20, 0x0F, 0x76, 0x32, 0x10, 0x02, 0x3F, 0x1A, 0x20,
+    0x05, 0x20, 0x3F, 0x01, 0x0F, 0x0D, 0x32, 0x0F, 0x75, 0x10, 0x32, 0x02, 0x10, 0x3F, 0x1A, 0x20,
+    0x05, 0x20, 0x3F, 0x00, 0x20, 0x0F, 0x0D, 0x20, 0x31, 0x10, 0x0F, 0x74, 0x20, 0x31, 0x20, 0x02,
+    0x20, 0x3F, 0x1A, 0x20, 0x05, 0x20, 0x3F, 0x00, 0x10, 0x0F, 0x0D, 0x10, 0x31, 0x20, 0x0F, 0x74,
+    0x32, 0x10, 0x02, 0x3F, 0x32, 0x20, 0x0F, 0x0F, 0x32, 0x0F, 0x73, 0x10, 0x32, 0x02, 0x10, 0x3F,
+    0x32, 0x0F, 0x10, 0x32, 0x10, 0x0F, 0x72, 0x10, 0x31, 0x20, 0x02, 0x20, 0x3F, 0x31, 0x10, 0x0F,
+    0x10, 0x20, 0x31, 0x10, 0x0F, 0x72, 0x20, 0x31, 0x10, 0x02, 0x3F, 0x31, 0x10, 0x0F, 0x11, 0x10,
+    0x31, 0x20, 0x0F, 0x72, 0x32, 0x10, 0x02, 0x3F, 0x30, 0x20, 0x0F, 0x13, 0x32, 0x0F, 0x72, 0x32,
+    0x02, 0x10, 0x3F, 0x2F, 0x10, 0x0F, 0x14, 0x32, 0x0F, 0x71, 0x10, 0x32, 0x02, 0x10, 0x3F, 0x2E,
+    0x10, 0x0F, 0x15, 0x20, 0x31, 0x10, 0x0F, 0x70, 0x10, 0x31, 0x20, 0x02, 0x20, 0x3F, 0x2D, 0x10,
+    0x0F, 0x16, 0x20, 0x31, 0x10, 0x0F, 0x70, 0x10, 0x31, 0x20, 0x02, 0x3F, 0x2C, 0x10, 0x0F, 0x18,
+    0x10, 0x31, 0x10, 0x0F, 0x70, 0x20, 0x31, 0x10, 0x02, 0x3F, 0x2A, 0x10, 0x0F, 0x1A, 0x10, 0x31,
+    0x20, 0x0F, 0x70, 0x20, 0x31, 0x10, 0x02, 0x3F, 0x27, 0x20, 0x10, 0x0F, 0x1C, 0x10, 0x31, 0x20,
+    0x0F, 0x70, 0x32, 0x10, 0x02, 0x3F, 0x1D, 0x24, 0x12, 0x0F, 0x20, 0x10, 0x32, 0x0F, 0x70, 0x32,
+    0x10, 0x02, 0x3F, 0x19, 0x11, 0x0F, 0x2B, 0x32, 0x0F, 0x70, 0x32, 0x10, 0x01, 0x10, 0x3F, 0x16,
+    0x10, 0x0F, 0x2F, 0x32, 0x0F, 0x70, 0x32, 0x10, 0x01, 0x10, 0x3F, 0x13, 0x20, 0x10, 0x0F, 0x31,
+    0x32, 0x0F, 0x70, 0x32, 0x10, 0x01, 0x10, 0x3F, 0x12, 0x10, 0x0F, 0x33, 0x32, 0x0F, 0x70, 0x32,
+    0x10, 0x01, 0x10, 0x3F, 0x10, 0x20, 0x0F, 0x35, 0x32, 0x0F, 0x70, 0x32, 0x10, 0x02, 0x3F, 0x0F,
+    0x10, 0x0F, 0x36, 0x32, 0x0F, 0x70, 0x32, 0x10, 0x02, 0x3F, 0x0D, 0x20, 0x0F, 0x37, 0x10, 0x32,
+    0x0F, 0x70, 0x20, 0x31, 0x10, 0x02, 0x3F, 0x0C, 0x20, 0x0F, 0x38, 0x10, 0x31, 0x20, 0x0F, 0x70,
+    0x20, 0x31, 0x10, 0x02, 0x3F, 0x0B, 0x20, 0x0F, 0x39, 0x10, 0x31, 0x20, 0x0F, 0x70, 0x10, 0x31,
+    0x20, 0x02, 0x3F, 0x0A, 0x20, 0x0F, 0x3A, 0x10, 0x31, 0x10, 0x0F, 0x70, 0x10, 0x31, 0x20, 0x02,
+    0x20, 0x3F, 0x09, 0x0F, 0x3B, 0x20, 0x31, 0x10, 0x0F, 0x70, 0x10, 0x32, 0x02, 0x10, 0x3F, 0x08,
+    0x10, 0x0F, 0x3B, 0x20, 0x31, 0x10, 0x0F, 0x71, 0x32, 0x02, 0x10, 0x3F, 0x07, 0x10, 0x0F, 0x3C,
+    0x32, 0x0F, 0x72, 0x32, 0x10, 0x02, 0x3F, 0x06, 0x20, 0x0F, 0x3D, 0x32, 0x0F, 0x72, 0x20, 0x31,
+    0x10, 0x02, 0x3F, 0x06, 0x10, 0x0F, 0x3C, 0x10, 0x31, 0x20, 0x0F, 0x72, 0x10, 0x31, 0x20, 0x02,
+    0x20, 0x3F, 0x04, 0x20, 0x0F, 0x3D, 0x20, 0x31, 0x10, 0x0F, 0x72, 0x10, 0x32, 0x02, 0x10, 0x3F,
+    0x04, 0x0F, 0x3E, 0x32, 0x10, 0x0F, 0x73, 0x32, 0x10, 0x02, 0x3F, 0x03, 0x20, 0x0F, 0x3E, 0x32,
+    0x0F, 0x74, 0x20, 0x31, 0x20, 0x02, 0x20, 0x3F, 0x02, 0x10, 0x0F, 0x3D, 0x10, 0x31, 0x20, 0x0F,
+    0x74, 0x10, 0x32, 0x02, 0x10, 0x3F, 0x02, 0x0F, 0x3E, 0x20, 0x31, 0x10, 0x0F, 0x75, 0x32, 0x10,
+    0x02, 0x3F, 0x01, 0x20, 0x0F, 0x3E, 0x32, 0x0F, 0x76, 0x20, 0x31, 0x20, 0x02, 0x20, 0x3F, 0x00,
+    0x10, 0x0F, 0x3D, 0x10, 0x31, 0x20, 0x0F, 0x76, 0x10, 0x32, 0x02, 0x10, 0x3F, 0x00, 0x0F, 0x3E,
+    0x32, 0x10, 0x0F, 0x77, 0x32, 0x10, 0x02, 0x20, 0x3E, 0x0F, 0x3D, 0x10, 0x32, 0x0F, 0x78, 0x20,
+    0x32, 0x02, 0x10, 0x3D, 0x20, 0x0F, 0x3D, 0x20, 0x31, 0x20, 0x0F, 0x78, 0x10, 0x32, 0x10, 0x02,
+    0x20, 0x3C, 0x10, 0x0F, 0x3D, 0x32, 0x10, 0x0F, 0x79, 0x20, 0x31, 0x20, 0x02, 0x10, 0x3C, 0x10,
+    0x0F, 0x02, 0x3F, 0x06, 0x0F, 0x14, 0x20, 0x31, 0x20, 0x0F, 0x7A, 0x10, 0x32, 0x10, 0x02, 0x20,
+    0x3B, 0x10, 0x0F, 0x02, 0x3F, 0x06, 0x0F, 0x14, 0x32, 0x10, 0x0F, 0x7B, 0x20, 0x32, 0x03, 0x3B,
+    0x10, 0x0F, 0x02, 0x3F, 0x06, 0x0F, 0x13, 0x20, 0x31, 0x20, 0x0F, 0x7C, 0x10, 0x32, 0x10, 0x02,
+    0x10, 0x3A, 0x10, 0x0F, 0x02, 0x3F, 0x06, 0x0F, 0x12, 0x10, 0x32, 0x10, 0x0F, 0x7D, 0x20, 0x32,
+    0x03, 0x20, 0x39, 0x10, 0x0F, 0x02, 0x3F, 0x06, 0x0F, 0x12, 0x20, 0x31, 0x20, 0x0F, 0x7F, 0x32,
+    0x20, 0x03, 0x39, 0x10, 0x0F, 0x02, 0x3F, 0x06, 0x0F, 0x11, 0x10, 0x32, 0x0F, 0x80, 0x10, 0x32,
+    0x10, 0x02, 0x10, 0x38, 0x10, 0x0F, 0x02, 0x2F, 0x06, 0x0F, 0x11, 0x32, 0x10, 0x0F, 0x81, 0x33,
+    0x03, 0x20, 0x37, 0x10, 0x0F, 0x38, 0x20, 0x32, 0x0F, 0x82, 0x10, 0x32, 0x20, 0x03, 0x20, 0x36,
+    0x20, 0x0F, 0x37, 0x10, 0x32, 0x10, 0x0F, 0x83, 0x10, 0x32, 0x10, 0x03, 0x37, 0x0F, 0x36, 0x10,
+    0x32, 0x10, 0x0F, 0x85, 0x20, 0x32, 0x10, 0x03, 0x36, 0x0F, 0x36, 0x32, 0x20, 0x0F, 0x87, 0x33,
+    0x03, 0x10, 0x35, 0x10, 0x0F, 0x34, 0x33, 0x0F, 0x88, 0x10, 0x33, 0x03, 0x10, 0x34, 0x20, 0x0F,
+    0x33, 0x20, 0x32, 0x10, 0x0F, 0x89, 0x10, 0x33, 0x04, 0x34, 0x0F, 0x32, 0x20, 0x32, 0x10, 0x0F,
+    0x8B, 0x10, 0x33, 0x04, 0x20, 0x32, 0x10, 0x0F, 0x30, 0x20, 0x32, 0x10, 0x0F, 0x8D, 0x20, 0x33,
+    0x04, 0x20, 0x32, 0x0F, 0x2F, 0x20, 0x32, 0x20, 0x0F, 0x8F, 0x20, 0x33, 0x04, 0x10, 0x31, 0x10,
+    0x0F, 0x2D, 0x20, 0x32, 0x20, 0x0F, 0x91, 0x20, 0x33, 0x10, 0x04, 0x20, 0x30, 0x0F, 0x2C, 0x33,
+    0x20, 0x0F, 0x93, 0x10, 0x33, 0x10, 0x04, 0x11, 0x0F, 0x29, 0x10, 0x33, 0x10, 0x0F, 0x95, 0x10,
+    0x33, 0x20, 0x0F, 0x2E, 0x10, 0x33, 0x10, 0x0F, 0x97, 0x10, 0x34, 0x10, 0x0F, 0x2B, 0x20, 0x33,
+    0x10, 0x0F, 0x9A, 0x20, 0x33, 0x20, 0x0F, 0x28, 0x10, 0x33, 0x20, 0x0F, 0x9D, 0x10, 0x34, 0x10,
+    0x0F, 0x24, 0x10, 0x20, 0x33, 0x10, 0x0F, 0x9F, 0x10, 0x35, 0x10, 0x0F, 0x21, 0x20, 0x34, 0x10,
+    0x0F, 0xA2, 0x10, 0x34, 0x20, 0x10, 0x0F, 0x1D, 0x20, 0x34, 0x10, 0x0F, 0xA6, 0x20, 0x35, 0x10,
+    0x0F, 0x18, 0x10, 0x20, 0x34, 0x20, 0x0F, 0xA9, 0x10, 0x20, 0x35, 0x20, 0x10, 0x0F, 0x13, 0x10,
+    0x35, 0x20, 0x10, 0x0F, 0xAC, 0x10, 0x20, 0x36, 0x20, 0x10, 0x0F, 0x0D, 0x10, 0x20, 0x35, 0x20,
+    0x10, 0x0F, 0xB0, 0x10, 0x20, 0x37, 0x20, 0x11, 0x0F, 0x05, 0x10, 0x20, 0x37, 0x20, 0x10, 0x0F,
+    0xB5, 0x10, 0x20, 0x39, 0x21, 0x13, 0x03, 0x14, 0x21, 0x38, 0x20, 0x10, 0x0F, 0xBB, 0x10, 0x20,
+    0x3F, 0x0E, 0x20, 0x10, 0x0F, 0xC1, 0x11, 0x20, 0x3F, 0x06, 0x20, 0x11, 0x0F, 0xC9, 0x12, 0x21,
+    0x37, 0x21, 0x12, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F,
+    0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F,
+    0xC4, 0x21, 0x0F, 0x01, 0x10, 0x21, 0x10, 0x0F, 0x0F, 0x10, 0x20, 0x10, 0x0F, 0x11, 0x10, 0x21,
+    0x10, 0x0F, 0x82, 0x31, 0x0F, 0x00, 0x20, 0x34, 0x0F, 0x0E, 0x20, 0x30, 0x10, 0x0F, 0x10, 0x35,
+    0x10, 0x0F, 0x05, 0x21, 0x0F, 0x69, 0x31, 0x0F, 0x00, 0x31, 0x10, 0x00, 0x20, 0x30, 0x20, 0x0F,
+    0x0D, 0x20, 0x30, 0x10, 0x0F, 0x0F, 0x20, 0x30, 0x10, 0x01, 0x10, 0x31, 0x10, 0x0F, 0x04, 0x31,
+    0x0F, 0x52, 0x21, 0x00, 0x10, 0x20, 0x10, 0x01, 0x10, 0x20, 0x10, 0x03, 0x10, 0x21, 0x10, 0x03,
+    0x31, 0x02, 0x20, 0x10, 0x02, 0x10, 0x21, 0x10, 0x02, 0x10, 0x30, 0x10, 0x02, 0x31, 0x02, 0x10,
+    0x21, 0x10, 0x02, 0x10, 0x20, 0x10, 0x02, 0x21, 0x00, 0x10, 0x20, 0x10, 0x00, 0x10, 0x20, 0x10,
+    0x02, 0x20, 0x30, 0x10, 0x02, 0x11, 0x20, 0x11, 0x02, 0x10, 0x20, 0x10, 0x00, 0x11, 0x01, 0x10,
+    0x21, 0x10, 0x07, 0x31, 0x03, 0x20, 0x30, 0x10, 0x00, 0x10, 0x20, 0x10, 0x02, 0x10, 0x20, 0x10,
+    0x01, 0x10, 0x21, 0x10, 0x02, 0x20, 0x31, 0x20, 0x10, 0x01, 0x10, 0x21, 0x10, 0x03, 0x21, 0x00,
+    0x10, 0x20, 0x10, 0x01, 0x10, 0x20, 0x10, 0x03, 0x10, 0x21, 0x10, 0x0F, 0x33, 0x35, 0x20, 0x33,
+    0x10, 0x01, 0x20, 0x34, 0x10, 0x01, 0x31, 0x01, 0x20, 0x30, 0x10, 0x01, 0x20, 0x34, 0x06, 0x10,
+    0x31, 0x01, 0x34, 0x20, 0x02, 0x31, 0x10, 0x00, 0x20, 0x30, 0x10, 0x00, 0x10, 0x30, 0x20, 0x33,
+    0x20, 0x01, 0x20, 0x30, 0x10, 0x01, 0x10, 0x34, 0x20, 0x01, 0x10, 0x33, 0x10, 0x00, 0x20, 0x34,
+    0x06, 0x31, 0x08, 0x31, 0x02, 0x31, 0x10, 0x00, 0x35, 0x01, 0x33, 0x10, 0x00, 0x20, 0x34, 0x02,
+    0x35, 0x20, 0x33, 0x10, 0x01, 0x20, 0x34, 0x10, 0x0F, 0x31, 0x31, 0x10, 0x00, 0x20, 0x31, 0x10,
+    0x00, 0x20, 0x31, 0x01, 0x31, 0x10, 0x00, 0x10, 0x30, 0x20, 0x01, 0x31, 0x00, 0x10, 0x30, 0x10,
+    0x01, 0x10, 0x31, 0x11, 0x20, 0x30, 0x20, 0x05, 0x20, 0x30, 0x20, 0x00, 0x10, 0x31, 0x11, 0x31,
+    0x10, 0x01, 0x10, 0x30, 0x20, 0x10, 0x30, 0x20, 0x01, 0x10, 0x31, 0x10, 0x00, 0x10, 0x31, 0x10,
+    0x00, 0x20, 0x30, 0x10, 0x01, 0x31, 0x10, 0x00, 0x10, 0x31, 0x10, 0x00, 0x10, 0x31, 0x10, 0x01,
+    0x10, 0x31, 0x11, 0x20, 0x30, 0x20, 0x05, 0x10, 0x32, 0x20, 0x11, 0x03, 0x20, 0x30, 0x10, 0x01,
+    0x31, 0x00, 0x10, 0x30, 0x20, 0x00, 0x10, 0x31, 0x10, 0x00, 0x10, 0x31, 0x10, 0x00, 0x10, 0x31,
+    0x11, 0x20, 0x30, 0x20, 0x01, 0x31, 0x10, 0x00, 0x20, 0x31, 0x10, 0x00, 0x20, 0x31, 0x01, 0x31,
+    0x10, 0x00, 0x10, 0x31, 0x0F, 0x31, 0x31, 0x02, 0x31, 0x02, 0x31, 0x05, 0x10, 0x31, 0x01, 0x31,
+    0x10, 0x30, 0x20, 0x02, 0x20, 0x30, 0x10, 0x02, 0x31, 0x04, 0x20, 0x31, 0x01, 0x31, 0x10, 0x01,
+    0x10, 0x30, 0x20, 0x02, 0x20, 0x32, 0x02, 0x10, 0x31, 0x02, 0x20, 0x30, 0x10, 0x00, 0x20, 0x30,
+    0x10, 0x00, 0x10, 0x30, 0x20, 0x02, 0x10, 0x30, 0x20, 0x00, 0x10, 0x30, 0x20, 0x02, 0x20, 0x30,
+    0x10, 0x02, 0x31, 0x06, 0x10, 0x20, 0x34, 0x02, 0x10, 0x30, 0x10, 0x00, 0x10, 0x30, 0x10, 0x00,
+    0x20, 0x30, 0x20, 0x10, 0x05, 0x31, 0x01, 0x20, 0x30, 0x10, 0x02, 0x31, 0x01, 0x31, 0x02, 0x31,
+    0x02, 0x31, 0x01, 0x31, 0x10, 0x0F, 0x35, 0x31, 0x02, 0x31, 0x02, 0x31, 0x01, 0x11, 0x34, 0x01,
+    0x34, 0x02, 0x20, 0x30, 0x23, 0x31, 0x02, 0x10, 0x32, 0x02, 0x31, 0x23, 0x31, 0x03, 0x31, 0x20,
+    0x02, 0x10, 0x30, 0x20, 0x02, 0x10, 0x30, 0x20, 0x00, 0x20, 0x30, 0x10, 0x00, 0x20, 0x30, 0x10,
+    0x02, 0x10, 0x31, 0x00, 0x10, 0x30, 0x20, 0x02, 0x20, 0x30, 0x23, 0x31, 0x0A, 0x10, 0x31, 0x20,
+    0x02, 0x30, 0x20, 0x00, 0x20, 0x30, 0x10, 0x00, 0x10, 0x34, 0x10, 0x02, 0x31, 0x01, 0x20, 0x30,
+    0x23, 0x31, 0x01, 0x31, 0x02, 0x31, 0x02, 0x31, 0x01, 0x20, 0x33, 0x20, 0x0F, 0x32, 0x31, 0x02,
+    0x31, 0x02, 0x31, 0x01, 0x31, 0x10, 0x01, 0x31, 0x01, 0x32, 0x20, 0x30, 0x10, 0x01, 0x20, 0x30,
+    0x10, 0x06, 0x10, 0x31, 0x20, 0x03, 0x31, 0x10, 0x07, 0x10, 0x32, 0x02, 0x10, 0x30, 0x20, 0x02,
+    0x10, 0x30, 0x20, 0x00, 0x20, 0x30, 0x10, 0x00, 0x20, 0x30, 0x10, 0x02, 0x10, 0x31, 0x00, 0x10,
+    0x30, 0x20, 0x02, 0x20, 0x30, 0x10, 0x0A, 0x21, 0x03, 0x10, 0x31, 0x02, 0x20, 0x30, 0x00, 0x31,
+    0x03, 0x11, 0x32, 0x10, 0x01, 0x31, 0x01, 0x20, 0x30, 0x10, 0x06, 0x31, 0x02, 0x31, 0x02, 0x31,
+    0x02, 0x11, 0x20, 0x32, 0x0F, 0x31, 0x31, 0x02, 0x31, 0x02, 0x31, 0x00, 0x10, 0x30, 0x20, 0x01,
+    0x10, 0x31, 0x01, 0x31, 0x11, 0x31, 0x01, 0x10, 0x30, 0x20, 0x01, 0x10, 0x21, 0x01, 0x31, 0x10,
+    0x04, 0x31, 0x10, 0x01, 0x10, 0x20, 0x10, 0x02, 0x31, 0x10, 0x30, 0x20, 0x01, 0x10, 0x31, 0x02,
+    0x31, 0x10, 0x00, 0x20, 0x30, 0x10, 0x00, 0x10, 0x31, 0x02, 0x20, 0x30, 0x10, 0x00, 0x10, 0x30,
+    0x20, 0x02, 0x10, 0x30, 0x20, 0x01, 0x10, 0x21, 0x05, 0x31, 0x10, 0x02, 0x10, 0x31, 0x02, 0x10,
+    0x30, 0x20, 0x30, 0x10, 0x01, 0x21, 0x02, 0x10, 0x30, 0x20, 0x01, 0x31, 0x01, 0x10, 0x30, 0x20,
+    0x01, 0x10, 0x21, 0x01, 0x31, 0x02, 0x31, 0x02, 0x31, 0x00, 0x10, 0x20, 0x10, 0x02, 0x31, 0x0F,
+    0x31, 0x31, 0x02, 0x31, 0x02, 0x31, 0x00, 0x10, 0x31, 0x21, 0x32, 0x01, 0x31, 0x01, 0x20, 0x30,
+    0x10, 0x01, 0x31, 0x21, 0x31, 0x10, 0x00, 0x10, 0x31, 0x24, 0x00, 0x10, 0x31, 0x21, 0x31, 0x10,
+    0x01, 0x20, 0x30, 0x10, 0x00, 0x31, 0x10, 0x00, 0x10, 0x32, 0x20, 0x32, 0x01, 0x20, 0x30, 0x10,
+    0x01, 0x32, 0x21, 0x31, 0x01, 0x10, 0x30, 0x20, 0x03, 0x31, 0x21, 0x31, 0x10, 0x05, 0x10, 0x31,
+    0x22, 0x31, 0x10, 0x03, 0x32, 0x10, 0x01, 0x20, 0x31, 0x21, 0x31, 0x10, 0x01, 0x31, 0x20, 0x10,
+    0x00, 0x31, 0x21, 0x31, 0x10, 0x01, 0x31, 0x02, 0x31, 0x02, 0x31, 0x01, 0x31, 0x22, 0x31, 0x0F,
+    0x31, 0x31, 0x02, 0x31, 0x02, 0x31, 0x01, 0x20, 0x31, 0x20, 0x10, 0x31, 0x10, 0x00, 0x31, 0x01,
+    0x10, 0x31, 0x01, 0x10, 0x20, 0x32, 0x10, 0x01, 0x10, 0x36, 0x01, 0x10, 0x33, 0x10, 0x01, 0x10,
+    0x31, 0x01, 0x10, 0x31, 0x00, 0x10, 0x30, 0x20, 0x10, 0x32, 0x10, 0x01, 0x20, 0x30, 0x10, 0x02,
+    0x20, 0x33, 0x10, 0x01, 0x10, 0x30, 0x20, 0x03, 0x10, 0x20, 0x32, 0x10, 0x07, 0x10, 0x34, 0x10,
+    0x04, 0x20, 0x31, 0x03, 0x20, 0x33, 0x10, 0x02, 0x20, 0x31, 0x10, 0x00, 0x10, 0x20, 0x32, 0x10,
+    0x02, 0x31, 0x02, 0x31, 0x02, 0x31, 0x01, 0x10, 0x34, 0x10, 0x0F, 0x74, 0x10, 0x30, 0x20, 0x0F,
+    0x26, 0x10, 0x30, 0x10, 0x0F, 0xA4, 0x10, 0x30, 0x20, 0x0F, 0x24, 0x21, 0x31, 0x0F, 0xA5, 0x10,
+    0x30, 0x20, 0x0F, 0x24, 0x32, 0x10, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xC5, 0x11, 0x0B, 0x10, 0x30, 0x20, 0x30, 0x20, 0x0F, 0x07, 0x30, 0x0F, 0xB5,
+    0x20, 0x0B, 0x20, 0x10, 0x02, 0x20, 0x10, 0x0F, 0x05, 0x10, 0x20, 0x0F, 0x82, 0x10, 0x06, 0x10,
+    0x00, 0x10, 0x06, 0x10, 0x00, 0x10, 0x06, 0x10, 0x03, 0x13, 0x00, 0x12, 0x03, 0x12, 0x02, 0x30,
+    0x02, 0x11, 0x01, 0x12, 0x06, 0x10, 0x20, 0x01, 0x12, 0x01, 0x10, 0x03, 0x10, 0x01, 0x13, 0x01,
+    0x11, 0x02, 0x12, 0x03, 0x11, 0x01, 0x12, 0x06, 0x12, 0x02, 0x12, 0x03, 0x12, 0x01, 0x11, 0x0F,
+    0x56, 0x20, 0x01, 0x10, 0x30, 0x01, 0x10, 0x20, 0x00, 0x20, 0x01, 0x10, 0x30, 0x01, 0x10, 0x20,
+    0x00, 0x20, 0x01, 0x10, 0x30, 0x01, 0x10, 0x20, 0x02, 0x10, 0x30, 0x11, 0x20, 0x30, 0x13, 0x01,
+    0x30, 0x12, 0x30, 0x01, 0x30, 0x01, 0x10, 0x20, 0x00, 0x10, 0x30, 0x11, 0x30, 0x10, 0x05, 0x20,
+    0x10, 0x00, 0x20, 0x12, 0x20, 0x00, 0x10, 0x20, 0x01, 0x20, 0x10, 0x00, 0x20, 0x12, 0x30, 0x10,
+    0x00, 0x11, 0x01, 0x20, 0x12, 0x20, 0x01, 0x30, 0x11, 0x00, 0x20, 0x12, 0x20, 0x04, 0x20, 0x11,
+    0x20, 0x10, 0x00, 0x10, 0x20, 0x11, 0x30, 0x01, 0x20, 0x12, 0x30, 0x20, 0x11, 0x30, 0x0F, 0x55,
+    0x30, 0x01, 0x21, 0x01, 0x20, 0x10, 0x00, 0x30, 0x01, 0x21, 0x01, 0x20, 0x10, 0x00, 0x30, 0x01,
+    0x21, 0x01, 0x20, 0x10, 0x02, 0x11, 0x01, 0x10, 0x20, 0x02, 0x30, 0x00, 0x11, 0x02, 0x20, 0x01,
+    0x30, 0x00, 0x11, 0x01, 0x30, 0x10, 0x01, 0x11, 0x04, 0x20, 0x10, 0x00, 0x10, 0x20, 0x02, 0x30,
+    0x01, 0x30, 0x00, 0x20, 0x10, 0x01, 0x30, 0x02, 0x11, 0x00, 0x20, 0x10, 0x00, 0x10, 0x20, 0x02,
+    0x30, 0x00, 0x11, 0x01, 0x10, 0x20, 0x02, 0x30, 0x03, 0x11, 0x04, 0x30, 0x02, 0x20, 0x10, 0x00,
+    0x30, 0x02, 0x30, 0x02, 0x20, 0x10, 0x0F, 0x54, 0x30, 0x01, 0x10, 0x20, 0x01, 0x20, 0x01, 0x30,
+    0x01, 0x10, 0x20, 0x01, 0x20, 0x01, 0x30, 0x01, 0x10, 0x20, 0x01, 0x20, 0x03, 0x11, 0x01, 0x11,
+    0x01, 0x10, 0x20, 0x00, 0x20, 0x02, 0x10, 0x20, 0x00, 0x10, 0x21, 0x10, 0x02, 0x30, 0x02, 0x20,
+    0x10, 0x03, 0x20, 0x10, 0x01, 0x11, 0x01, 0x10, 0x30, 0x01, 0x10, 0x30, 0x20, 0x02, 0x30, 0x02,
+    0x11, 0x00, 0x30, 0x01, 0x11, 0x02, 0x30, 0x00, 0x11, 0x01, 0x11, 0x01, 0x10, 0x30, 0x03, 0x20,
+    0x04, 0x10, 0x20, 0x02, 0x20, 0x01, 0x30, 0x02, 0x30, 0x02, 0x20, 0x0F, 0x55, 0x20, 0x13, 0x00,
+    0x11, 0x01, 0x20, 0x13, 0x00, 0x11, 0x01, 0x20, 0x13, 0x00, 0x11, 0x03, 0x20, 0x10, 0x01, 0x11,
+    0x01, 0x11, 0x00, 0x30, 0x02, 0x11, 0x00, 0x10, 0x30, 0x21, 0x02, 0x30, 0x20, 0x30, 0x20, 0x10,
+    0x03, 0x30, 0x10, 0x02, 0x22, 0x30, 0x10, 0x02, 0x10, 0x30, 0x10, 0x02, 0x20, 0x02, 0x20, 0x10,
+    0x00, 0x30, 0x01, 0x20, 0x10, 0x02, 0x20, 0x00, 0x20, 0x02, 0x22, 0x30, 0x10, 0x04, 0x30, 0x04,
+    0x11, 0x02, 0x30, 0x01, 0x20, 0x02, 0x30, 0x02, 0x30, 0x0F, 0x55, 0x11, 0x20, 0x00, 0x11, 0x20,
+    0x02, 0x11, 0x20, 0x00, 0x11, 0x20, 0x02, 0x11, 0x20, 0x00, 0x11, 0x20, 0x04, 0x30, 0x02, 0x20,
+    0x02, 0x11, 0x00, 0x30, 0x02, 0x20, 0x10, 0x00, 0x11, 0x00, 0x20, 0x10, 0x00, 0x10, 0x20, 0x05,
+    0x10, 0x30, 0x10, 0x03, 0x20, 0x06, 0x30, 0x10, 0x30, 0x01, 0x10, 0x20, 0x02, 0x30, 0x01, 0x30,
+    0x01, 0x20, 0x02, 0x10, 0x20, 0x00, 0x30, 0x02, 0x20, 0x08, 0x30, 0x04, 0x11, 0x02, 0x30, 0x00,
+    0x10, 0x20, 0x02, 0x20, 0x02, 0x30, 0x0F, 0x55, 0x10, 0x20, 0x10, 0x00, 0x10, 0x20, 0x10, 0x02,
+    0x10, 0x20, 0x10, 0x00, 0x10, 0x20, 0x10, 0x02, 0x10, 0x20, 0x10, 0x00, 0x10, 0x20, 0x10, 0x01,
+    0x20, 0x01, 0x30, 0x02, 0x30, 0x02, 0x20, 0x10, 0x00, 0x30, 0x10, 0x00, 0x10, 0x30, 0x01, 0x20,
+    0x10, 0x01, 0x30, 0x01, 0x30, 0x10, 0x00, 0x11, 0x00, 0x10, 0x30, 0x14, 0x00, 0x20, 0x10, 0x00,
+    0x10, 0x20, 0x01, 0x30, 0x01, 0x20, 0x10, 0x00, 0x10, 0x20, 0x01, 0x10, 0x20, 0x01, 0x30, 0x10,
+    0x00, 0x11, 0x00, 0x10, 0x30, 0x10, 0x00, 0x30, 0x02, 0x20, 0x10, 0x00, 0x10, 0x20, 0x01, 0x20,
+    0x01, 0x30, 0x10, 0x00, 0x10, 0x30, 0x00, 0x10, 0x20, 0x01, 0x20, 0x10, 0x00, 0x11, 0x01, 0x11,
+    0x02, 0x20, 0x0F, 0x56, 0x20, 0x02, 0x20, 0x04, 0x20, 0x02, 0x20, 0x04, 0x20, 0x02, 0x20, 0x02,
+    0x20, 0x01, 0x20, 0x02, 0x20, 0x02, 0x10, 0x01, 0x10, 0x21, 0x11, 0x01, 0x10, 0x02, 0x11, 0x00,
+    0x10, 0x21, 0x10, 0x01, 0x10, 0x24, 0x10, 0x01, 0x10, 0x30, 0x20, 0x10, 0x00, 0x11, 0x02, 0x10,
+    0x00, 0x23, 0x10, 0x02, 0x10, 0x20, 0x01, 0x10, 0x30, 0x20, 0x10, 0x01, 0x20, 0x03, 0x10, 0x30,
+    0x20, 0x10, 0x01, 0x20, 0x02, 0x20, 0x30, 0x10, 0x02, 0x10, 0x21, 0x10, 0x01, 0x11, 0x01, 0x11,
+    0x01, 0x11, 0x0F, 0xA9, 0x20, 0x0F, 0xDF, 0x30, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF,
+    0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0xFF, 0x0F, 0x60,
+};
+
+static const RleImage m2elogo_rle = { 240, 240, m2elogo_rle_palette, m2elogo_rle_data, sizeof(m2elogo_rle_data) };
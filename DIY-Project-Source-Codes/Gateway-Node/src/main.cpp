@@ -24,23 +24,78 @@
 #include <Arduino.h>
 #include <SPI.h>              // SPI Library needed for display
 #include <TFT_eSPI.h>         // Graphics library
-#include "m2e-logo.h"         // make2explore Logo Bitmap header file
+#include "m2e-logo-rle.h"     // make2explore Logo, compressed from m2e-logo.h by Host-Tools/img2rle
 #include <SoftwareSerial.h>   // Software Serial Library for communicating with Wio E5 Mini Board
 #include "DHT.h"              // Include DHT Sensors library
+#include "E5Link.h"           // Wio E5 baud rate switching and link test
+#include "Log.h"              // Logging with compile-time levels (LOG_LEVEL) and non-blocking output
+#include "TextField.h"        // Display fields that are only redrawn when their value changes
+
+// Wio E5 on the ESP8266 hardware UART0 instead of SoftwareSerial - uncomment or add -D E5_HW_UART to build_flags.
+// UART0 can't use its swapped pins (GPIO13/15), GPIO13 is the display's MOSI, so the E5 goes on the board's
+// TX/RX pins (disconnect it while flashing over USB) and debug output moves to Serial1 (TX only, GPIO2 = D4).
+//#define E5_HW_UART
+
+// Baud rate for the Wio E5 link, the module is switched over with AT+UART=BR on first boot
+#ifndef E5_BAUD
+#ifdef E5_HW_UART
+#define E5_BAUD 115200
+#else
+#define E5_BAUD 9600      // SoftwareSerial on the ESP8266 isn't reliable much above this
+#endif
+#endif
+
+// Print LINK,... latency/byte loss lines for every baud rate at boot - uncomment or add -D E5_LINK_TEST
+//#define E5_LINK_TEST
+
+// Capture of the Wio E5 AT traffic in a RAM ring, a "TRACE" line on the serial monitor prints it for
+// Native-HAL replay (see ../Common/src/AtTrace.h), not with E5_HW_UART - its monitor is TX only. Uncomment or
+// add -D AT_TRACE to build_flags
+//#define AT_TRACE
+
+#ifdef AT_TRACE
+#include "AtTrace.h"
+#endif
 
 // Invoke Display and Create display Instance 
 TFT_eSPI tft = TFT_eSPI();
 
+#ifdef E5_HW_UART
+#if defined(TFT_RST) && (TFT_RST == PIN_D4)
+#error "E5_HW_UART sends debug output on Serial1 (D4), set TFT_RST to -1 in the TFT_eSPI user setup"
+#endif
+HardwareSerial & e5Uart = Serial; // Wio E5 Mini on UART0 (TX/RX pins)
+HardwareSerial & dbg = Serial1;   // Serial Monitor output, TX only on D4
+#else
 // Lets define Sofware serial Pins for WIo E5 Mini Dev Board
 const byte rxPin = D2;
 const byte txPin = D3;
 
 // Set up a new SoftwareSerial object
-SoftwareSerial e5 (rxPin, txPin);
+SoftwareSerial e5Uart (rxPin, txPin);
+HardwareSerial & dbg = Serial;    // Serial Monitor output
+#endif
+
+#ifdef AT_TRACE
+AtTraceRing<AT_TRACE_SIZE> atTrace(AT_TRACE_GATEWAY);
+AtTap<decltype(e5Uart)> e5(e5Uart, atTrace);   // the Wio E5 link, through the capture
+#else
+auto & e5 = e5Uart;
+#endif
 
 // LoRa Data receive buffer
 static char recv_buf[512];
+// Bytes recv_parse() has collected in recv_buf so far, a packet's URC lines can span several calls
+static int recv_len = 0;
 static bool is_exist = false;
+// Module was already configured at boot (see configLoRaModule)
+static bool lora_warm = false;
+// millis() when the first LoRa packet went through, 0 until then
+static unsigned long firstPacketTime = 0;
+
+// Wio-E5 TEST mode radio settings, and how AT+TEST=? reports them back
+#define LORA_RFCFG_CMD  "AT+TEST=RFCFG,866,SF12,125,12,15,14,ON,OFF,OFF\r\n"
+#define LORA_RFCFG_ECHO "+TEST: RFCFG F:866000000, SF12, BW125K, TXPR:12, RXPR:15, POW:14dBm, CRC:ON, IQ:OFF, NET:OFF"
 
 // Rain Sensor (10K Pot as Tipping bucket Rain Gauge) attached to Analog Pin A0
 const int rainSensor = A0;  // ESP8266 Analog Pin ADC0 = A0 for tipping bucketRain Sensor
@@ -63,6 +118,16 @@ float SN_disp;
 bool SN_vib, SN_stat;
 int RSSI, SNR;
 
+// Sequence number of the last Sensor Node frame, -1 when the frame had none (older SN firmware)
+long SN_seq = -1;
+// Hex payload of the last Sensor Node history backfill frame ("HB,..."), relayed as-is to the End Node
+static char backfill_hex[256];
+
+// recv_parse() results
+#define FRAME_NONE      0
+#define FRAME_LIVE      1
+#define FRAME_BACKFILL  2
+
 // Function for parsing the incomming data String
 String getValue(String data, char separator, int index)
 {
@@ -97,11 +162,11 @@ char * unHex(const char* input, char* target, size_t len) {
   if (target != nullptr && len) {
     size_t inLen = strlen(input);
     if (inLen & 1) {
-      Serial.println(F("unhex: malformed input"));
+      LOG_WARN("unhex: malformed input");
     }
     size_t chars = inLen / 2;
     if (chars >= len) {
-      Serial.println(F("unhex: target buffer too small"));
+      LOG_WARN("unhex: target buffer too small");
       chars = len - 1;
     }
     for (size_t i = 0; i < chars; i++) {
@@ -111,7 +176,7 @@ char * unHex(const char* input, char* target, size_t len) {
     }
     target[chars] = 0;
   } else {
-    Serial.println(F("unhex: no target buffer"));
+    LOG_ERROR("unhex: no target buffer");
   }
   return target;
 }
@@ -124,11 +189,11 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
     int startMillis = 0;
     va_list args;
     memset(recv_buf, 0, sizeof(recv_buf));
+    recv_len = 0;
     va_start(args, p_cmd);
     e5.printf(p_cmd, args);
-    Serial.printf(p_cmd, args);
+    LOG_DEBUG_STR(p_cmd);
     va_end(args);
-    delay(200);
     startMillis = millis();
 
     if (p_ack == NULL)
@@ -140,10 +205,13 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
         while (e5.available() > 0)
         {
             ch = e5.read();
-            recv_buf[index++] = ch;
-            Serial.print((char)ch);
-            delay(2);
+            if (index < (int)sizeof(recv_buf) - 1)
+            {
+                recv_buf[index++] = ch;
+            }
+            LOG_TRACE_CHAR(ch);
         }
+        logPump();
         if (strstr(recv_buf, p_ack) != NULL)
         {
             return 1;
@@ -153,22 +221,38 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
     return 0;
 }
 
+// Function to report how long after boot the first LoRa packet went through
+static void reportFirstPacket(){
+  if (firstPacketTime == 0)
+  {
+    firstPacketTime = millis();
+    LOG_INFO("First packet at %lu ms after boot", firstPacketTime);
+  }
+}
+
 // Function for parsing the incoming LoRa data
 static int recv_parse(void)
 {
     char ch;
-    int index = 0;
-    memset(recv_buf, 0, sizeof(recv_buf));
-    while (e5.available() > 0)
+    bool eol = false;
+    while (!eol && e5.available() > 0)
     {
         ch = e5.read();
-        recv_buf[index++] = ch;
-        Serial.print((char)ch);
-        delay(2);
+        if (recv_len < (int)sizeof(recv_buf) - 1)
+        {
+            recv_buf[recv_len++] = ch;
+            recv_buf[recv_len] = 0;
+        }
+        LOG_TRACE_CHAR(ch);
+        eol = (ch == '\n');
     }
- 
-    if (index)
+
+    // A packet is reported as "+TEST: LEN:.., RSSI:.., SNR:..\r\n" then "+TEST: RX \"..\"\r\n",
+    // so keep collecting whole lines until the RX line is in
+    bool rx_pending = strstr(recv_buf, "+TEST: LEN") && !strstr(recv_buf, "+TEST: RX \"");
+    if (eol && !rx_pending)
     {
+        recv_len = 0;     // start over on the next call, recv_buf stays valid for parsing below
         char *p_start = NULL;
         char data[128] = {
             0,
@@ -176,13 +260,22 @@ static int recv_parse(void)
         int rss = 0;
         int snr = 0;
 
+        p_start = strstr(recv_buf, "+TEST: RX \"48422C");
+        if (p_start && (1 == sscanf(p_start, "+TEST: RX \"%255[0-9A-F]", backfill_hex)))
+        {
+            // "HB," <count> <records...> - first record starts with its little endian seq
+            char seq_hex[5] = { backfill_hex[10], backfill_hex[11], backfill_hex[8], backfill_hex[9], 0 };
+            SN_seq = strtol(seq_hex, NULL, 16);
+            return FRAME_BACKFILL;
+        }
+
         p_start = strstr(recv_buf, "+TEST: RX \"47572C");
         if (p_start)
         {
             p_start = strstr(recv_buf, "47572C");
-            if (p_start && (1 == sscanf(p_start, "47572C%s", data)))
+            // hex digits only, the seq field makes the frame longer than the 35 characters once kept
+            if (p_start && (1 == sscanf(p_start, "47572C%127[0-9A-F]", data)))
             {
-              data[70] = 0;
               //Serial.println(data);
               char output[128];
               char* text = unHex(data, output, sizeof(output));
@@ -195,7 +288,8 @@ static int recv_parse(void)
               SN_disp = (getValue(text, ',', 5)).toFloat();
               SN_vib = (getValue(text, ',', 6)).toInt();
               SN_stat = (getValue(text, ',', 7)).toInt();
-              Serial.println("\r\n");
+              String seq = getValue(text, ',', 8);
+              SN_seq = seq.length() ? seq.toInt() : -1;
 
             }
             p_start = strstr(recv_buf, "RSSI:");
@@ -207,10 +301,10 @@ static int recv_parse(void)
             if (p_start && (1 == sscanf(p_start, "SNR:%d", &snr))){
               SNR = snr;
             }
-            return 1;
+            return FRAME_LIVE;
         }
     }
-    return 0;
+    return FRAME_NONE;
 }
 
 // Function for Receiving incomming LoRa Packets
@@ -220,12 +314,35 @@ static int node_recv(uint32_t timeout_ms)
     int startMillis = millis();
     do
     {
-        if (recv_parse())
+        logPump();
+        int frame = recv_parse();
+        if (frame != FRAME_NONE)
         {
-            return 1;
+            reportFirstPacket();
+            return frame;
         }
     } while (millis() - startMillis < timeout_ms);
+    return FRAME_NONE;
+}
+
+// Function to acknowledge a Sensor Node frame, so it can drop it from its backfill log
+static int LoRa_ack()
+{
+  char cmd[48] = "";
+  if (SN_seq < 0)
+  {
     return 0;
+  }
+  sprintf(cmd, "AT+TEST=TXLRSTR,\"AK,%ld\"\r\n", SN_seq);
+  return at_send_check_response("TX DONE", 6000, cmd);
+}
+
+// Function to relay a Sensor Node history backfill frame unchanged to the End Node
+static int LoRa_forward_backfill()
+{
+  char cmd[300] = "";
+  sprintf(cmd, "AT+TEST=TXLRPKT,\"%s\"\r\n", backfill_hex);
+  return at_send_check_response("TX DONE", 6000, cmd);
 }
 
 // Function for LoRa packet preparation and sending
@@ -239,6 +356,11 @@ static int LoRa_send()
   sensorData = sensorData + String(SN_m1) + "," + String(SN_m2) + "," + String(SN_rain_per) + "," + String(SN_humi) 
                 + "," + String(SN_temp) + "," + String(SN_disp) + "," + String(SN_vib) + "," + String(SN_stat) + "," 
                 + String(GW_rain_per) + "," + String(GW_humidity) + "," + String(GW_temperature);
+  // The Sensor Node's seq goes last, as on its own frame, so the End Node can line up backfilled history
+  if (SN_seq >= 0)
+  {
+    sensorData = sensorData + "," + String(SN_seq);
+  }
 
   strncpy(data,sensorData.c_str(),sizeof(data));
   data[sizeof(data) -1] = 0;
@@ -250,13 +372,11 @@ static int LoRa_send()
   ret = at_send_check_response("TX DONE", 6000, cmd);
     if (ret == 1)
     {
-      Serial.println("");
-      Serial.print("Sent successfully!\r\n");
+      LOG_INFO("Sent successfully!");
     }
     else
     {
-      Serial.println("");
-      Serial.print("Send failed!\r\n");
+      LOG_WARN("Send failed!");
     }
   return ret;
 }
@@ -267,34 +387,49 @@ static void node_recv_then_send(uint32_t timeout)
     int ret = 0;
     ret = node_recv(timeout);
     delay(100);
-    if (!ret)
+    if (ret == FRAME_NONE)
     {
-        Serial.print("\r\n");
         return;
     }
-    LoRa_send();
-    Serial.print("\r\n");
+    // Ack first, the Sensor Node is listening right after its transmit
+    LoRa_ack();
+    if (ret == FRAME_BACKFILL)
+    {
+        LoRa_forward_backfill();
+    }
+    else
+    {
+        LoRa_send();
+    }
 }
 
 // Function to configure Wio-E5 Mini in Test Mode - Check AT commands Specification Guide
 // for more details about these command sequences  
 void configLoRaModule(){
   //Configure Wio E5 Mini Board in Test Mode
-  Serial.println("Configuring Wio E5 Mini Board ...");
-  delay(250);
-  if (at_send_check_response("+AT: OK", 100, "AT\r\n"))
+  LOG_INFO("Configuring Wio E5 Mini Board ...");
+  if (at_send_check_response("+AT: OK", 300, "AT\r\n"))
   {
     is_exist = true;
-    at_send_check_response("+MODE: TEST", 1500, "AT+MODE=TEST\r\n");
-    at_send_check_response("+TEST: RFCFG", 1500, "AT+TEST=RFCFG,866,SF12,125,12,15,14,ON,OFF,OFF\r\n");
-    delay(500);
+    // Warm boot - the module kept its power (only we were reset) and is still in TEST mode
+    // with our RF settings, AT+TEST=? answers ERROR(-12) when it isn't in TEST mode
+    if (at_send_check_response(LORA_RFCFG_ECHO, 500, "AT+TEST=?\r\n"))
+    {
+      lora_warm = true;
+    }
+    // Cold boot - both commands are sent back to back and the module works through them,
+    // fall back to sending RFCFG again if it got lost while the LoRa chip was resetting
+    else if (!at_send_check_response("+TEST: RFCFG", 3000, "AT+MODE=TEST\r\n" LORA_RFCFG_CMD))
+    {
+      at_send_check_response("+TEST: RFCFG", 1500, LORA_RFCFG_CMD);
+    }
+    LOG_INFO("%s, radio ready at %lu ms", lora_warm ? "Wio E5 warm boot" : "Wio E5 configured", millis());
   }
   else
   {
     is_exist = false;
-    Serial.print("No E5 module found.\r\n");
+    LOG_ERROR("No E5 module found.");
   }
-  delay(500);
 }
 
 // Function to Setup Display for Initial Screen
@@ -327,25 +462,59 @@ void HomeScreen(){
   tft.drawString("Stat = ", 10, 210);
 }
 
-// Function to Display the sensor Readings
-void displayReadings(){
+// Value column of the Home Screen (between the labels and the units), composed off-screen in a
+// sprite and pushed to the LCD in one burst. 8-bit colour keeps it at 13 KB of the ESP8266's heap
+#define VALUES_X 100
+#define VALUES_Y 85
+#define VALUES_W 95
+#define VALUES_H 141
+TFT_eSprite values = TFT_eSprite(&tft);
+bool valuesSprite = false;
+
+// On-screen value fields (text size 2, relative to the value column), redrawn only when their value changes
+TextField rainField(0, 0, 2), humiField(0, 25, 2), tempField(0, 50, 2);
+TextField rssiField(0, 75, 2), snrField(0, 100, 2), statField(0, 125, 2);
+
+// Function to allocate the value column sprite, without it the values are drawn straight to the LCD
+void setupValuesSprite(){
+  values.setColorDepth(8);
+  valuesSprite = values.createSprite(VALUES_W, VALUES_H) != nullptr;
+  if (valuesSprite) {
+    values.fillSprite(TFT_BLACK);
+  }
+}
 
-  tft.setTextColor(TFT_CYAN, TFT_BLACK); 
+// Function to draw the changed value fields on the sprite or the LCD, returns true if any changed
+template<class Display>
+bool drawValues(Display & d){
+  bool changed = false;
 
-  tft.drawFloat(GW_rain_per, 2, 100, 85);
-  
-  tft.drawFloat(GW_humidity, 2, 100, 110);
+  changed |= rainField.drawFloat(d, GW_rain_per, 2, TFT_CYAN, TFT_BLACK);
+
+  changed |= humiField.drawFloat(d, GW_humidity, 2, TFT_CYAN, TFT_BLACK);
 
-  tft.drawFloat(GW_temperature, 2, 100, 135);
+  changed |= tempField.drawFloat(d, GW_temperature, 2, TFT_CYAN, TFT_BLACK);
 
-  tft.drawNumber(RSSI, 100, 160);
+  changed |= rssiField.drawNumber(d, RSSI, TFT_CYAN, TFT_BLACK);
 
-  tft.drawNumber(SNR, 100, 185);
+  changed |= snrField.drawNumber(d, SNR, TFT_CYAN, TFT_BLACK);
 
-  if(SN_stat == 1){
-    tft.drawString("Alert!", 100, 210);
+  changed |= statField.draw(d, SN_stat == 1 ? "Alert!" : "OK", TFT_CYAN, TFT_BLACK);
+
+  return changed;
+}
+
+// Function to Display the sensor Readings
+void displayReadings(){
+
+  if (valuesSprite) {
+    if (drawValues(values)) {
+      values.pushSprite(VALUES_X, VALUES_Y);    // one SPI transaction for the whole column
+    }
   } else {
-    tft.drawString("OK", 100, 210);
+    tft.setViewport(VALUES_X, VALUES_Y, VALUES_W, VALUES_H);
+    drawValues(tft);
+    tft.resetViewport();
   }
   
 }
@@ -359,7 +528,7 @@ void getDHTReadings(){
   float f = dht.readTemperature(true);
   // Check if any reads failed and exit early (to try again).
   if (isnan(h) || isnan(t) || isnan(f)) {
-    Serial.println(F("Failed to read from DHT sensor!"));
+    LOG_WARN("Failed to read from DHT sensor!");
     return;
   }
   GW_temperature = t;
@@ -380,28 +549,51 @@ void getRainReading(){
   //Serial.println("%");
 }
 
+// How long the make2explore logo stays up on a cold boot
+const unsigned long splashTime = 3000;
+
 // Function to Setup the Initializations and Configurations
 void setup(void) {
   
-  Serial.begin (9600);
-  e5.begin(9600);
+  dbg.begin (9600);
+  logBegin(dbg);
+  unsigned long baud = e5Begin(e5, E5_BAUD);
+  (void)baud;           // only logged and swept, both compile out with LOG_LEVEL 0 and no E5_LINK_TEST
+  LOG_INFO("Wio E5 link at %lu baud", baud);
+#ifdef E5_LINK_TEST
+  logFlush();
+  if (baud) {
+    e5LinkSweep(e5, dbg, baud, 50, E5_BAUD);
+  }
+#endif
   tft.begin ();                                 // initialize a ST7789 chip
   tft.setSwapBytes (true);                      // swap the byte order for pushImage() - corrects endianness
 
   tft.setRotation(0);
   tft.fillScreen (TFT_BLACK);
-  tft.pushImage (0,0,240,240,m2elogo);
-  delay(3000);
-  
-  HomeScreen();         // Display Home Screen
+  drawRle (tft, m2elogo_rle, 0, 0);           // decoded run by run straight into the SPI push
+  unsigned long splashStart = millis();
 
-  configLoRaModule();   // Configure Wio E5 Mini Dev Board
+  configLoRaModule();   // Configure Wio E5 Mini Dev Board while the logo is up
 
   dht.begin();          // Init DHT Sensor
+
+  // Keep the logo up for the rest of splashTime on a cold boot only, a warm (brown-out) reset
+  // goes straight back to receiving
+  while (!lora_warm && millis() - splashStart < splashTime) {
+    yield();
+  }
+
+  setupValuesSprite();  // Off-screen buffer for the readings
+  HomeScreen();         // Display Home Screen
 }
 
 // Function main Loop
 void loop() {
+  logPump();
+#ifdef AT_TRACE
+  atTrace.serve(dbg);
+#endif
   if (is_exist)
   {
     getDHTReadings();
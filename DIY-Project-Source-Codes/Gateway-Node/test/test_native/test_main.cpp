@@ -0,0 +1,173 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Program           - Gateway Node unit tests
+// Software          - C/C++, PlatformIO IDE - pio test -e native
+// -----------------------------------------------------------------------------------------------------------//
+// Builds the Gateway sketch over Native-HAL and runs its Sensor Node frame parsing and acks on the PC. The
+// Wio E5 link (SoftwareSerial e5Uart) is driven through the HAL, the clock is the simulated one, so the
+// module's timing and the AT timeouts are exact and the tests take no real time.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <Arduino.h>
+#include <unity.h>
+
+#ifdef E5_HW_UART
+#error "The tests drive the SoftwareSerial Wio E5 link, build them without E5_HW_UART"
+#endif
+
+// The sketch, its setup() / loop() stay unused, main() below (Native-HAL's is weak) runs the tests
+#include "../../src/main.cpp"
+
+#include "Hal.h"
+#include "HistoryFormat.h"
+
+#include <string>
+
+// The Wio E5 link's name in the HAL
+static const char E5[] = "SoftwareSerial";
+
+// Milliseconds of simulated time since boot
+static uint64_t wallMillis(){ return halWallMicros() / 1000; }
+
+// Function to hex encode bytes, as the Wio E5 reports a received payload
+static std::string toHex(const void * data, size_t len){
+    static const char digits[] = "0123456789ABCDEF";
+    std::string out;
+    for (size_t i = 0; i < len; i++){
+        uint8_t b = ((const uint8_t *)data)[i];
+        out += digits[b >> 4];
+        out += digits[b & 0x0F];
+    }
+    return out;
+}
+
+// Function to feed a received packet, the LEN line and the RX line, as the module reports it
+static void feedPacket(const std::string & payload){
+    std::string urc = "+TEST: LEN:" + std::to_string(payload.size()) + ", RSSI:-70, SNR:9\r\n"
+                    + "+TEST: RX \"" + toHex(payload.data(), payload.size()) + "\"\r\n";
+    halUartFeed(E5, urc.data(), urc.size());
+}
+
+// Function to run recv_parse() until it reports a frame or the module has nothing more to say
+static int parseAll(){
+    int frame = FRAME_NONE;
+    while (frame == FRAME_NONE && e5.available() > 0){
+        frame = recv_parse();
+    }
+    return frame;
+}
+
+void setUp(){
+    while (e5.available() > 0) e5.read();
+    recv_len = 0;
+    recv_buf[0] = 0;
+    halUartTake(E5);
+    SN_seq = -1;
+    RSSI = SNR = 0;
+}
+
+void tearDown(){
+}
+
+// ---- recv_parse()
+
+static void test_live_frame(){
+    feedPacket("GW,220,148,254,60,25,0.57,1,1,17");
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    TEST_ASSERT_EQUAL_UINT8(220, SN_m1);
+    TEST_ASSERT_EQUAL_UINT8(148, SN_m2);
+    TEST_ASSERT_EQUAL_UINT8(254, SN_rain_per);
+    TEST_ASSERT_EQUAL_UINT8(60, SN_humi);
+    TEST_ASSERT_EQUAL_UINT8(25, SN_temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.001, 0.57, SN_disp);
+    TEST_ASSERT_TRUE(SN_vib);
+    TEST_ASSERT_TRUE(SN_stat);
+    TEST_ASSERT_EQUAL_INT(17, SN_seq);
+    TEST_ASSERT_EQUAL_INT(-70, RSSI);
+    TEST_ASSERT_EQUAL_INT(9, SNR);
+}
+
+static void test_live_frame_without_seq(){
+    SN_seq = 5;
+    feedPacket("GW,220,148,254,60,25,0.57,0,0");
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    TEST_ASSERT_EQUAL_INT(-1, SN_seq);
+    TEST_ASSERT_FALSE(SN_stat);
+}
+
+static void test_rx_line_arrives_later(){
+    // the module reports the RX line a little after the LEN line, recv_parse() waits for it
+    static const char len[] = "+TEST: LEN:29, RSSI:-82, SNR:-3\r\n";
+    halUartFeed(E5, len, sizeof(len) - 1);
+    TEST_ASSERT_EQUAL_INT(FRAME_NONE, parseAll());
+    halAt(wallMillis() + 50, []{
+        static const char rx[] = "+TEST: RX \"47572C34302C34352C33302C35302C33302C302E31322C302C302C3138\"\r\n";
+        halUartFeed(E5, rx, sizeof(rx) - 1);
+    });
+    delay(60);
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    TEST_ASSERT_EQUAL_UINT8(40, SN_m1);
+    TEST_ASSERT_EQUAL_INT(18, SN_seq);
+    TEST_ASSERT_EQUAL_INT(-82, RSSI);
+    TEST_ASSERT_EQUAL_INT(-3, SNR);
+}
+
+static void test_other_frames_ignored(){
+    feedPacket("EN,1,2,3");
+    TEST_ASSERT_EQUAL_INT(FRAME_NONE, parseAll());
+    TEST_ASSERT_EQUAL_INT(-1, SN_seq);
+}
+
+static void test_backfill_frame(){
+    HistoryRecord recs[2] = {};
+    for (uint8_t i = 0; i < 2; i++){
+        recs[i].seq = 0x0123 + i;
+        recs[i].m1 = 220;
+        recs[i].disp = 57;
+        recs[i].flags = HISTORY_VIB;
+        recs[i].check = historyCheck(recs[i]);
+    }
+    std::string frame = "HB,";
+    frame += (char)2;
+    frame.append((const char *)recs, sizeof(recs));
+    feedPacket(frame);
+    TEST_ASSERT_EQUAL_INT(FRAME_BACKFILL, parseAll());
+    TEST_ASSERT_EQUAL_INT(0x0123, SN_seq);
+    TEST_ASSERT_EQUAL_STRING(toHex(frame.data(), frame.size()).c_str(), backfill_hex);
+}
+
+// ---- LoRa_ack()
+
+static void test_ack_sent_for_seq(){
+    feedPacket("GW,220,148,254,60,25,0.57,0,0,17");
+    TEST_ASSERT_EQUAL_INT(FRAME_LIVE, parseAll());
+    halUartTake(E5);
+    halAt(wallMillis() + 100, []{ halUartFeed(E5, "+TEST: TX DONE\r\n", 16); });
+    TEST_ASSERT_EQUAL_INT(1, LoRa_ack());
+    TEST_ASSERT_EQUAL_STRING("AT+TEST=TXLRSTR,\"AK,17\"\r\n", halUartTake(E5).c_str());
+}
+
+static void test_ack_timeout(){
+    SN_seq = 17;
+    uint64_t start = wallMillis();
+    TEST_ASSERT_EQUAL_INT(0, LoRa_ack());
+    TEST_ASSERT_GREATER_OR_EQUAL(6000, wallMillis() - start);
+}
+
+static void test_no_ack_without_seq(){
+    TEST_ASSERT_EQUAL_INT(0, LoRa_ack());
+    TEST_ASSERT_EQUAL_STRING("", halUartTake(E5).c_str());
+}
+
+int main(int, char **){
+    UNITY_BEGIN();
+    RUN_TEST(test_live_frame);
+    RUN_TEST(test_live_frame_without_seq);
+    RUN_TEST(test_rx_line_arrives_later);
+    RUN_TEST(test_other_frames_ignored);
+    RUN_TEST(test_backfill_frame);
+    RUN_TEST(test_ack_sent_for_seq);
+    RUN_TEST(test_ack_timeout);
+    RUN_TEST(test_no_ack_without_seq);
+    return UNITY_END();
+}
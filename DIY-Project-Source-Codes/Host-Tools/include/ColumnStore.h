@@ -0,0 +1,275 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+Columnar table in a folder, one memory mapped file per column (POSIX only).
+
+    <dir>/<name>.<type>     little endian array of the column's values, type u8 i8 u16 i16 u32
+    <dir>/schema.csv        name,type,scale,rows - value = integer / scale
+
+The same layout telemetry_export --format columns writes. Column files grow in
+COLUMN_GROW_ROWS steps and are written straight through their mappings, schema.csv
+holds the committed row count and is replaced atomically (write + rename) by
+commit(), so a reader (or a collector restarted after a crash) only sees whole
+committed rows, whatever state the column files were left in.
+
+Rows must be appended in time order when the table has a time column, readers
+binary search it.
+
+USAGE:
+
+    ColumnStore store;
+    store.create("data", { { "time", COLUMN_U32, 1 }, { "rain", COLUMN_I16, 10 } });   // or open an existing one
+    int64_t row[] = { 1700000000, 125 };
+    store.append(row);
+    store.commit();
+
+    ColumnStore table;
+    table.open("data");                                     // read only
+    const uint32_t * time = table.data<uint32_t>(table.find("time"));
+ */
+
+#define COLUMN_GROW_ROWS (1u << 20)
+
+enum ColumnType : uint8_t { COLUMN_U8, COLUMN_I8, COLUMN_U16, COLUMN_I16, COLUMN_U32 };
+
+struct ColumnInfo {
+    std::string name;
+    ColumnType type;
+    int scale;
+};
+
+static inline const char * columnTypeName(ColumnType t){
+    static const char * names[] = { "u8", "i8", "u16", "i16", "u32" };
+    return names[t];
+}
+
+static inline size_t columnTypeSize(ColumnType t){
+    return t == COLUMN_U32 ? 4 : t >= COLUMN_U16 ? 2 : 1;
+}
+
+class ColumnStore {
+public:
+    ~ColumnStore(){ close(); }
+
+    // Function to open an existing table, writable to append to it. Returns false if it isn't one
+    bool open(const std::string & dir, bool writable = false){
+        close();
+        this->dir = dir;
+        this->writable = writable;
+        std::ifstream in(dir + "/schema.csv");
+        std::string line;
+        if (!std::getline(in, line) || line.compare(0, 4, "name") != 0){
+            return false;
+        }
+        while (std::getline(in, line)){
+            std::stringstream ss(line);
+            std::string name, type, scale, rows;
+            if (!std::getline(ss, name, ',') || !std::getline(ss, type, ',') || !std::getline(ss, scale, ',') ||
+                !std::getline(ss, rows, ',')){
+                continue;
+            }
+            Column c;
+            c.info.name = name;
+            c.info.scale = atoi(scale.c_str());
+            bool known = false;
+            for (uint8_t t = COLUMN_U8; t <= COLUMN_U32; t++){
+                if (type == columnTypeName((ColumnType)t)){
+                    c.info.type = (ColumnType)t;
+                    known = true;
+                }
+            }
+            if (!known){
+                return false;
+            }
+            count = strtoull(rows.c_str(), nullptr, 10);
+            columns.push_back(c);
+        }
+        committed = count;
+        for (Column & c : columns){
+            if (!map(c, count)){
+                return false;
+            }
+        }
+        return !columns.empty();
+    }
+
+    // Function to make a new empty table (an existing one in dir is replaced), writable
+    bool create(const std::string & dir, const std::vector<ColumnInfo> & schema){
+        close();
+        this->dir = dir;
+        writable = true;
+        mkdir(dir.c_str(), 0755);
+        for (const ColumnInfo & info : schema){
+            Column c;
+            c.info = info;
+            unlink(path(c).c_str());
+            columns.push_back(c);
+        }
+        count = 0;
+        for (Column & c : columns){
+            if (!map(c, COLUMN_GROW_ROWS)){
+                return false;
+            }
+        }
+        return commit();
+    }
+
+    // Function to open dir for appending, creating it with schema if it isn't a table yet
+    bool openOrCreate(const std::string & dir, const std::vector<ColumnInfo> & schema){
+        return open(dir, true) || create(dir, schema);
+    }
+
+    void close(){
+        for (Column & c : columns){
+            if (c.base != nullptr){
+                munmap(c.base, c.mapped);
+            }
+            if (c.fd >= 0){
+                ::close(c.fd);
+            }
+        }
+        columns.clear();
+        count = 0;
+    }
+
+    // Function to add a row, values in column order (stored integers). Only visible to readers after commit()
+    bool append(const int64_t * values){
+        for (Column & c : columns){
+            if ((count + 1) * columnTypeSize(c.info.type) > c.mapped && !map(c, count + COLUMN_GROW_ROWS)){
+                return false;
+            }
+        }
+        for (size_t i = 0; i < columns.size(); i++){
+            uint8_t * p = (uint8_t *)columns[i].base + count * columnTypeSize(columns[i].info.type);
+            switch (columns[i].info.type){
+                case COLUMN_U8:  *(uint8_t *)p = values[i];  break;
+                case COLUMN_I8:  *(int8_t *)p = values[i];   break;
+                case COLUMN_U16: *(uint16_t *)p = values[i]; break;
+                case COLUMN_I16: *(int16_t *)p = values[i];  break;
+                case COLUMN_U32: *(uint32_t *)p = values[i]; break;
+            }
+        }
+        count++;
+        return true;
+    }
+
+    // Function to make the appended rows durable and visible - column data first, then the row count
+    bool commit(){
+        for (Column & c : columns){
+            msync(c.base, c.mapped, MS_SYNC);
+        }
+        std::string tmp = dir + "/schema.csv.tmp";
+        {
+            std::ofstream out(tmp);
+            out << "name,type,scale,rows\n";
+            for (Column & c : columns){
+                out << c.info.name << "," << columnTypeName(c.info.type) << "," << c.info.scale << "," << count << "\n";
+            }
+            if (!out.flush()){
+                return false;
+            }
+        }
+        committed = count;
+        return rename(tmp.c_str(), (dir + "/schema.csv").c_str()) == 0;
+    }
+
+    uint64_t rows() const { return count; }
+    uint64_t uncommitted() const { return count - committed; }
+    size_t width() const { return columns.size(); }
+    const ColumnInfo & info(size_t i) const { return columns[i].info; }
+
+    // Function to find a column by name, -1 if there isn't one
+    int find(const std::string & name) const {
+        for (size_t i = 0; i < columns.size(); i++){
+            if (columns[i].info.name == name){
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    template<typename T> const T * data(int i) const {
+        return (const T *)columns[i].base;
+    }
+
+    // Function to read any column's value as its stored integer
+    int64_t value(int i, uint64_t row) const {
+        const void * p = columns[i].base;
+        switch (columns[i].info.type){
+            case COLUMN_U8:  return ((const uint8_t *)p)[row];
+            case COLUMN_I8:  return ((const int8_t *)p)[row];
+            case COLUMN_U16: return ((const uint16_t *)p)[row];
+            case COLUMN_I16: return ((const int16_t *)p)[row];
+            default:         return ((const uint32_t *)p)[row];
+        }
+    }
+
+private:
+    struct Column {
+        ColumnInfo info;
+        int fd = -1;
+        void * base = nullptr;
+        size_t mapped = 0;
+    };
+    std::string dir;
+    bool writable = false;
+    std::vector<Column> columns;
+    uint64_t count = 0;
+    uint64_t committed = 0;
+
+    std::string path(const Column & c) const {
+        return dir + "/" + c.info.name + "." + columnTypeName(c.info.type);
+    }
+
+    // Function to (re)map a column for at least rows rows, growing its file when writable
+    bool map(Column & c, uint64_t rows){
+        if (c.base != nullptr){
+            munmap(c.base, c.mapped);
+            c.base = nullptr;
+        }
+        if (c.fd < 0){
+            c.fd = ::open(path(c).c_str(), writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+            if (c.fd < 0){
+                return false;
+            }
+        }
+        struct stat st;
+        fstat(c.fd, &st);
+        size_t want = rows * columnTypeSize(c.info.type);
+        if (writable && (size_t)st.st_size < want){
+            if (ftruncate(c.fd, want) != 0){
+                return false;
+            }
+            st.st_size = want;
+        }
+        if ((size_t)st.st_size < want){
+            return false;               // shorter than schema.csv says
+        }
+        c.mapped = st.st_size;
+        if (c.mapped == 0){
+            c.base = nullptr;
+            return true;
+        }
+        c.base = mmap(nullptr, c.mapped, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, c.fd, 0);
+        if (c.base == MAP_FAILED){
+            c.base = nullptr;
+            return false;
+        }
+        if (!writable){
+            madvise(c.base, c.mapped, MADV_SEQUENTIAL);
+        }
+        return true;
+    }
+};
@@ -0,0 +1,244 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+/*
+Host side batch pixel conversion, 24-bit BGR (BMP order) to RGB332 or RGB565 (high byte first),
+with optional 4x4 ordered dithering.
+
+Every path does the same integer arithmetic - add the dither threshold with unsigned saturation,
+then drop the low bits of each channel - so the SIMD paths (AVX2, SSSE3, NEON, picked at compile
+time, build with -march=native) give exactly the scalar result. Without dithering the result is
+plain truncation, the same as the original bmp_converter.
+
+USAGE:
+
+    convertRowRgb332(bgr, width, y, dither, out);      // out: width bytes
+    convertRowRgb565(bgr, width, y, dither, out);      // out: width * 2 bytes
+    pixelKernelPath();                                 // "avx2", "ssse3", "neon" or "scalar"
+ */
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PIXEL_KERNEL_SSSE3
+#define PIXEL_KERNEL_AVX2
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#define PIXEL_KERNEL_SSSE3
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PIXEL_KERNEL_NEON
+#endif
+
+static inline const char * pixelKernelPath(){
+#if defined(PIXEL_KERNEL_AVX2)
+    return "avx2";
+#elif defined(PIXEL_KERNEL_SSSE3)
+    return "ssse3";
+#elif defined(PIXEL_KERNEL_NEON)
+    return "neon";
+#else
+    return "scalar";
+#endif
+}
+
+// Dither thresholds for one row phase (y & 3), 16 pixels x B,G,R in BMP byte order. The 4x4 Bayer
+// value 0..15 is scaled to the step of each channel, 2^(bits dropped)
+struct DitherRow {
+    alignas(32) uint8_t t[48];
+};
+
+// Function to build the thresholds for a target with rBits/gBits/bBits bits per channel
+static inline void ditherRows(int rBits, int gBits, int bBits, DitherRow rows[4]){
+    static const uint8_t bayer[4][4] = { { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+    const int bits[3] = { bBits, gBits, rBits };
+    for (int y = 0; y < 4; y++){
+        for (int i = 0; i < 48; i++){
+            int x = i / 3;
+            rows[y].t[i] = (uint8_t)((bayer[y][x & 3] << (8 - bits[i % 3])) >> 4);
+        }
+    }
+}
+
+static inline const DitherRow * ditherRgb332(){
+    static DitherRow rows[4];
+    static bool ready = false;
+    if (!ready){
+        ditherRows(3, 3, 2, rows);
+        ready = true;
+    }
+    return rows;
+}
+
+static inline const DitherRow * ditherRgb565(){
+    static DitherRow rows[4];
+    static bool ready = false;
+    if (!ready){
+        ditherRows(5, 6, 5, rows);
+        ready = true;
+    }
+    return rows;
+}
+
+static inline uint8_t addSat(uint8_t v, uint8_t t){
+    int s = v + t;
+    return s > 255 ? 255 : (uint8_t)s;
+}
+
+// Scalar reference for pixels [from, to) of a row
+static inline void convertRgb332Scalar(const uint8_t * bgr, int from, int to, const uint8_t * thr, uint8_t * out){
+    for (int x = from; x < to; x++){
+        const uint8_t * t = thr + (x & 3) * 3;
+        const uint8_t * p = bgr + (size_t)x * 3;
+        uint8_t b = addSat(p[0], t[0]), g = addSat(p[1], t[1]), r = addSat(p[2], t[2]);
+        out[x] = (r & 0xE0) | ((g & 0xE0) >> 3) | (b >> 6);
+    }
+}
+
+static inline void convertRgb565Scalar(const uint8_t * bgr, int from, int to, const uint8_t * thr, uint8_t * out){
+    for (int x = from; x < to; x++){
+        const uint8_t * t = thr + (x & 3) * 3;
+        const uint8_t * p = bgr + (size_t)x * 3;
+        uint8_t b = addSat(p[0], t[0]), g = addSat(p[1], t[1]), r = addSat(p[2], t[2]);
+        out[(size_t)x * 2]     = (r & 0xF8) | (g >> 5);
+        out[(size_t)x * 2 + 1] = ((g << 3) & 0xE0) | (b >> 3);
+    }
+}
+
+#if defined(PIXEL_KERNEL_SSSE3)
+// Function to split 16 BGR pixels (48 bytes) into B, G and R vectors
+static inline void deinterleave16(const uint8_t * p, __m128i & b, __m128i & g, __m128i & r){
+    static __m128i masks[3][3];     // [channel][source vector]
+    static bool ready = false;
+    if (!ready){
+        for (int ch = 0; ch < 3; ch++){
+            for (int v = 0; v < 3; v++){
+                alignas(16) int8_t m[16];
+                for (int i = 0; i < 16; i++){
+                    int src = i * 3 + ch - v * 16;
+                    m[i] = (src >= 0 && src < 16) ? (int8_t)src : (int8_t)0x80;
+                }
+                masks[ch][v] = _mm_load_si128((const __m128i *)m);
+            }
+        }
+        ready = true;
+    }
+    __m128i a = _mm_loadu_si128((const __m128i *)p);
+    __m128i m = _mm_loadu_si128((const __m128i *)(p + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(p + 32));
+    __m128i * out[3] = { &b, &g, &r };
+    for (int ch = 0; ch < 3; ch++){
+        *out[ch] = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, masks[ch][0]), _mm_shuffle_epi8(m, masks[ch][1])),
+                                _mm_shuffle_epi8(c, masks[ch][2]));
+    }
+}
+
+// Function to load 16 pixels with the dither thresholds added
+static inline void load16(const uint8_t * p, const uint8_t * thr, __m128i & b, __m128i & g, __m128i & r){
+    alignas(16) uint8_t d[48];
+    for (int i = 0; i < 3; i++){
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + i * 16));
+        _mm_store_si128((__m128i *)(d + i * 16), _mm_adds_epu8(v, _mm_load_si128((const __m128i *)(thr + i * 16))));
+    }
+    deinterleave16(d, b, g, r);
+}
+
+// Byte-wise shifts - SSE only shifts 16-bit lanes, the masks drop the bits that cross into the next byte
+#define SHR8(v, n) _mm_and_si128(_mm_srli_epi16((v), (n)), _mm_set1_epi8((char)(0xFF >> (n))))
+#define SHL8(v, n) _mm_and_si128(_mm_slli_epi16((v), (n)), _mm_set1_epi8((char)(0xFF << (n) & 0xFF)))
+#endif
+
+#if defined(PIXEL_KERNEL_AVX2)
+#define SHR8x2(v, n) _mm256_and_si256(_mm256_srli_epi16((v), (n)), _mm256_set1_epi8((char)(0xFF >> (n))))
+#define SHL8x2(v, n) _mm256_and_si256(_mm256_slli_epi16((v), (n)), _mm256_set1_epi8((char)(0xFF << (n) & 0xFF)))
+
+// Function to load 32 pixels (two groups of 16) as B, G and R 256-bit vectors, thresholds added
+static inline void load32(const uint8_t * p, const uint8_t * thr, __m256i & b, __m256i & g, __m256i & r){
+    __m128i b0, g0, r0, b1, g1, r1;
+    load16(p, thr, b0, g0, r0);
+    load16(p + 48, thr, b1, g1, r1);
+    b = _mm256_set_m128i(b1, b0);
+    g = _mm256_set_m128i(g1, g0);
+    r = _mm256_set_m128i(r1, r0);
+}
+#endif
+
+// Function to convert one row of BGR pixels to RGB332. y selects the dither phase
+static inline void convertRowRgb332(const uint8_t * bgr, int width, int y, bool dither, uint8_t * out){
+    static const DitherRow none = {};
+    const uint8_t * thr = dither ? ditherRgb332()[y & 3].t : none.t;
+    int x = 0;
+#if defined(PIXEL_KERNEL_AVX2)
+    for (; x + 32 <= width; x += 32){
+        __m256i b, g, r;
+        load32(bgr + x * 3, thr, b, g, r);
+        __m256i v = _mm256_or_si256(_mm256_and_si256(r, _mm256_set1_epi8((char)0xE0)),
+                    _mm256_or_si256(_mm256_and_si256(SHR8x2(g, 3), _mm256_set1_epi8(0x1C)), SHR8x2(b, 6)));
+        _mm256_storeu_si256((__m256i *)(out + x), v);
+    }
+#endif
+#if defined(PIXEL_KERNEL_SSSE3)
+    for (; x + 16 <= width; x += 16){
+        __m128i b, g, r;
+        load16(bgr + x * 3, thr, b, g, r);
+        __m128i v = _mm_or_si128(_mm_and_si128(r, _mm_set1_epi8((char)0xE0)),
+                    _mm_or_si128(_mm_and_si128(SHR8(g, 3), _mm_set1_epi8(0x1C)), SHR8(b, 6)));
+        _mm_storeu_si128((__m128i *)(out + x), v);
+    }
+#elif defined(PIXEL_KERNEL_NEON)
+    for (; x + 16 <= width; x += 16){
+        uint8x16x3_t px = vld3q_u8(bgr + x * 3);
+        uint8x16x3_t t = vld3q_u8(thr);
+        uint8x16_t b = vqaddq_u8(px.val[0], t.val[0]);
+        uint8x16_t g = vqaddq_u8(px.val[1], t.val[1]);
+        uint8x16_t r = vqaddq_u8(px.val[2], t.val[2]);
+        uint8x16_t v = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xE0)),
+                       vorrq_u8(vandq_u8(vshrq_n_u8(g, 3), vdupq_n_u8(0x1C)), vshrq_n_u8(b, 6)));
+        vst1q_u8(out + x, v);
+    }
+#endif
+    convertRgb332Scalar(bgr, x, width, thr, out);
+}
+
+// Function to convert one row of BGR pixels to RGB565, high byte first. y selects the dither phase
+static inline void convertRowRgb565(const uint8_t * bgr, int width, int y, bool dither, uint8_t * out){
+    static const DitherRow none = {};
+    const uint8_t * thr = dither ? ditherRgb565()[y & 3].t : none.t;
+    int x = 0;
+#if defined(PIXEL_KERNEL_AVX2)
+    for (; x + 32 <= width; x += 32){
+        __m256i b, g, r;
+        load32(bgr + x * 3, thr, b, g, r);
+        __m256i hi = _mm256_or_si256(_mm256_and_si256(r, _mm256_set1_epi8((char)0xF8)), SHR8x2(g, 5));
+        __m256i lo = _mm256_or_si256(_mm256_and_si256(SHL8x2(g, 3), _mm256_set1_epi8((char)0xE0)), SHR8x2(b, 3));
+        // unpack works per 128-bit lane, lane 0 holds pixels 0..15 and lane 1 pixels 16..31
+        __m256i p0 = _mm256_unpacklo_epi8(hi, lo);
+        __m256i p1 = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i *)(out + x * 2), _mm256_permute2x128_si256(p0, p1, 0x20));
+        _mm256_storeu_si256((__m256i *)(out + x * 2 + 32), _mm256_permute2x128_si256(p0, p1, 0x31));
+    }
+#endif
+#if defined(PIXEL_KERNEL_SSSE3)
+    for (; x + 16 <= width; x += 16){
+        __m128i b, g, r;
+        load16(bgr + x * 3, thr, b, g, r);
+        __m128i hi = _mm_or_si128(_mm_and_si128(r, _mm_set1_epi8((char)0xF8)), SHR8(g, 5));
+        __m128i lo = _mm_or_si128(_mm_and_si128(SHL8(g, 3), _mm_set1_epi8((char)0xE0)), SHR8(b, 3));
+        _mm_storeu_si128((__m128i *)(out + x * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i *)(out + x * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#elif defined(PIXEL_KERNEL_NEON)
+    for (; x + 16 <= width; x += 16){
+        uint8x16x3_t px = vld3q_u8(bgr + x * 3);
+        uint8x16x3_t t = vld3q_u8(thr);
+        uint8x16_t b = vqaddq_u8(px.val[0], t.val[0]);
+        uint8x16_t g = vqaddq_u8(px.val[1], t.val[1]);
+        uint8x16_t r = vqaddq_u8(px.val[2], t.val[2]);
+        uint8x16x2_t v;
+        v.val[0] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+        v.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(g, 3), vdupq_n_u8(0xE0)), vshrq_n_u8(b, 3));
+        vst2q_u8(out + x * 2, v);
+    }
+#endif
+    convertRgb565Scalar(bgr, x, width, thr, out);
+}
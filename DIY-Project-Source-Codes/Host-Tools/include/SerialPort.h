@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/select.h>
+#include <termios.h>
+#include <unistd.h>
+
+/*
+Raw serial port for the host tools that talk to a node over USB (POSIX only, Linux / macOS).
+
+The Wio Terminal's USB CDC port runs at full USB speed whatever baud rate is set, the
+rate only matters for the Mega / NodeMCU USB-UART bridges.
+
+USAGE:
+
+    SerialPort port;
+    if (!port.open("/dev/ttyACM0", 115200)) ...
+    port.write("EXPORT RAW 0 4294967295\n");
+    int n = port.read(buf, sizeof(buf), 100);      // waits up to 100 ms, 0 = nothing came, < 0 = port gone
+ */
+
+class SerialPort {
+public:
+    ~SerialPort(){ close(); }
+
+    // Function to open a port in raw 8N1 mode, returns false if it can't be opened
+    bool open(const std::string & path, int baud){
+        close();
+        fd = ::open(path.c_str(), O_RDWR | O_NOCTTY);
+        if (fd < 0){
+            return false;
+        }
+        termios tty;
+        if (tcgetattr(fd, &tty) != 0){
+            close();
+            return false;
+        }
+        cfmakeraw(&tty);
+        speed_t speed = baud == 9600 ? B9600 : baud == 57600 ? B57600 : baud == 230400 ? B230400 : B115200;
+        cfsetispeed(&tty, speed);
+        cfsetospeed(&tty, speed);
+        tty.c_cflag |= CLOCAL | CREAD;
+        tty.c_cc[VMIN] = 0;
+        tty.c_cc[VTIME] = 0;
+        if (tcsetattr(fd, TCSANOW, &tty) != 0){
+            close();
+            return false;
+        }
+        tcflush(fd, TCIOFLUSH);
+        return true;
+    }
+
+    void close(){
+        if (fd >= 0){
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    bool isOpen() const { return fd >= 0; }
+
+    // Function to write all of data, false if the port has gone
+    bool write(const void * data, size_t size){
+        const uint8_t * p = (const uint8_t *)data;
+        while (size > 0){
+            ssize_t n = ::write(fd, p, size);
+            if (n <= 0){
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    bool write(const std::string & text){
+        return write(text.data(), text.size());
+    }
+
+    // Function to read what has arrived, waiting up to timeoutMs for the first byte.
+    // Returns the bytes read, 0 on timeout, -1 if the port has gone (e.g. the board reset)
+    int read(void * buf, size_t size, int timeoutMs){
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(fd, &set);
+        timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+        int ready = select(fd + 1, &set, nullptr, nullptr, &tv);
+        if (ready <= 0){
+            return ready;
+        }
+        ssize_t n = ::read(fd, buf, size);
+        return n > 0 ? (int)n : -1;     // readable but no data = hung up
+    }
+
+private:
+    int fd = -1;
+};
@@ -0,0 +1,138 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "HistoryFormat.h"
+#include "TelemetryFormat.h"
+
+/*
+Host side decoder for the Wio-E5 receive URCs the End Node handles in recv_parse()
+(End-Node/src/main.cpp), giving the same TelemetryRecord fields recordPacket() and
+recordBackfill() log on the sd card.
+
+    +TEST: LEN:<n>, RSSI:<dBm>, SNR:<dB>        link quality, applies to the next RX line
+    +TEST: RX "454E2C..."                       "EN,m1,m2,rain,humi,temp,disp,vib,stat,gwrain,gwhumi,gwtemp"
+    +TEST: RX "48422C..."                       "HB," count, count x 11 byte Sensor Node history records
+
+Any other line is ignored. Lines can come with or without the \r\n. Fields of an EN
+frame are read like getValue().toFloat() reads them - missing or bad ones are 0.
+
+USAGE:
+
+    UrcDecoder decoder;
+    TelemetryRecord recs[URC_MAX_RECORDS];
+    int n = decoder.line(text, recs);           // records in this line, 0 for anything but an RX line
+ */
+
+#define URC_MAX_RECORDS 24          // a full 255 byte HB frame holds 23
+
+#define URC_NONE     0
+#define URC_LIVE     1
+#define URC_BACKFILL 2
+
+class UrcDecoder {
+public:
+    // Function to decode one URC line into records (seq and time left 0). Returns how many
+    int line(const char * text, TelemetryRecord * out){
+        kind = URC_NONE;
+        const char * p = strstr(text, "+TEST: ");
+        if (p == nullptr){
+            return 0;
+        }
+        p += 7;
+        int len, r, s;
+        if (strncmp(p, "LEN:", 4) == 0 && sscanf(p, "LEN:%d, RSSI:%d, SNR:%d", &len, &r, &s) == 3){
+            rssi = r;
+            snr = s;
+            return 0;
+        }
+        if (strncmp(p, "RX \"", 4) != 0){
+            return 0;
+        }
+        p += 4;
+        uint8_t bytes[256];
+        size_t n = 0;
+        while (n < sizeof(bytes) && hex(p[0]) >= 0 && hex(p[1]) >= 0){
+            bytes[n++] = hex(p[0]) << 4 | hex(p[1]);
+            p += 2;
+        }
+        if (n >= 3 && memcmp(bytes, "EN,", 3) == 0){
+            kind = URC_LIVE;
+            return live((const char *)bytes + 3, n - 3, out);
+        }
+        if (n >= 4 && memcmp(bytes, "HB,", 3) == 0){
+            kind = URC_BACKFILL;
+            return backfill(bytes, n, out);
+        }
+        return 0;
+    }
+
+    // Frame type of the last line, URC_NONE unless it was an RX line that decoded
+    int last() const { return kind; }
+
+private:
+    int16_t rssi = 0;
+    int8_t snr = 0;
+    int kind = URC_NONE;
+
+    static int hex(char c){
+        return c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10 : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+    }
+
+    int live(const char * text, size_t len, TelemetryRecord * out){
+        float v[12] = {};
+        char field[32];
+        size_t f = 0, at = 0;
+        for (size_t i = 0; i <= len && f < 12; i++){
+            if (i == len || text[i] == ','){
+                size_t n = i - at < sizeof(field) - 1 ? i - at : sizeof(field) - 1;
+                memcpy(field, text + at, n);
+                field[n] = '\0';
+                v[f++] = strtof(field, nullptr);
+                at = i + 1;
+            }
+        }
+        TelemetryRecord & rec = out[0];
+        memset(&rec, 0, sizeof(rec));
+        rec.snSeq = f > 11 ? (uint16_t)v[11] : TELEMETRY_NO_SEQ;     // the Sensor Node seq, HISTORY_LOG builds
+        rec.flags = ((int)v[6] ? TELEMETRY_VIB : 0) | ((int)v[7] ? TELEMETRY_ALERT : 0);
+        rec.rssi = rssi;
+        rec.snr = snr;
+        rec.m1 = v[0] * 10;
+        rec.m2 = v[1] * 10;
+        rec.rain = v[2] * 10;
+        rec.humi = v[3] * 10;
+        rec.temp = v[4] * 10;
+        rec.disp = v[5] * 100;
+        rec.gwRain = v[8] * 10;
+        rec.gwHumi = v[9] * 10;
+        rec.gwTemp = v[10] * 10;
+        return 1;
+    }
+
+    int backfill(const uint8_t * bytes, size_t len, TelemetryRecord * out){
+        uint8_t count = bytes[3];
+        if (count == 0 || count > URC_MAX_RECORDS || 4 + count * sizeof(HistoryRecord) > len){
+            return 0;
+        }
+        for (uint8_t i = 0; i < count; i++){
+            HistoryRecord b;
+            memcpy(&b, bytes + 4 + i * sizeof(b), sizeof(b));
+            TelemetryRecord & rec = out[i];
+            memset(&rec, 0, sizeof(rec));
+            rec.snSeq = b.seq;
+            rec.flags = TELEMETRY_BACKFILL | (b.flags & HISTORY_VIB ? TELEMETRY_VIB : 0) | (b.flags & HISTORY_ALERT ? TELEMETRY_ALERT : 0);
+            rec.rssi = rssi;
+            rec.snr = snr;
+            rec.m1 = b.m1 * 10;
+            rec.m2 = b.m2 * 10;
+            rec.rain = b.rain * 10;
+            rec.humi = b.humi * 10;
+            rec.temp = b.temp * 10;
+            rec.disp = b.disp;
+        }
+        return count;
+    }
+};
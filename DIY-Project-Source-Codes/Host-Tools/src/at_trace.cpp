@@ -0,0 +1,249 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Wio-E5 AT traffic trace tool (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -Iinclude src/at_trace.cpp -o build/at_trace
+// -----------------------------------------------------------------------------------------------------------//
+// Reads the binary AT traffic traces a node built with AT_TRACE captures (Common/src/AtTrace.h):
+// the End Node writes them to its sd card (/trace/ATnnn.BIN), the Sensor and Gateway Nodes keep a RAM ring and
+// print it on the Serial Monitor as TRACE,... lines when sent a "TRACE" line. A trace replays into the sketch
+// on the PC with the Native-HAL program: program --replay Serial1=AT000.BIN
+//
+// Usage : at_trace <command> ...
+//     extract <capture.txt> <out.bin>     the last complete TRACE,BEGIN ... TRACE,END dump in a Serial Monitor
+//                                         capture ("-" = stdin) to a trace file
+//     dump <trace.bin>                    one line per record: time (s), direction, bytes (escaped)
+//     stats <trace.bin>                   records, bytes each way, command lines, gaps, duration, overhead
+//
+// e.g.    build/at_trace extract gateway-monitor.txt gw.bin && build/at_trace dump gw.bin | less
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define TRACE_TX        0x80        // Common/src/AtTrace.h
+#define TRACE_GAP       0xFF
+#define TRACE_HEADER    12
+#define TRACE_FROM_BOOT 0x01
+
+struct Record {
+    bool gap;                       // a gap marker, records were lost here
+    bool tx;                        // sketch -> module
+    uint64_t ms;                    // since the header's clock
+    std::string bytes;
+};
+
+struct Trace {
+    char node = '?';
+    uint8_t flags = 0;
+    uint32_t clock = 0;
+    size_t size = 0;
+    bool truncated = false;
+    std::vector<Record> records;
+};
+
+static void usage(){
+    fprintf(stderr, "usage: at_trace extract <capture.txt|-> <out.bin>\n"
+                    "       at_trace dump <trace.bin>\n"
+                    "       at_trace stats <trace.bin>\n");
+    exit(1);
+}
+
+// Function to parse a trace file, false if it isn't one
+static bool load(const char * path, Trace & t){
+    std::ifstream file(path, std::ios::binary);
+    if (!file){
+        fprintf(stderr, "at_trace: cannot open %s\n", path);
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < TRACE_HEADER || data.compare(0, 4, "M2AT") != 0 || data[4] != 1){
+        fprintf(stderr, "at_trace: %s is not a version 1 AT trace\n", path);
+        return false;
+    }
+    t.size = data.size();
+    t.node = data[5];
+    t.flags = data[6];
+    for (int i = 0; i < 4; i++){
+        t.clock |= (uint32_t)(uint8_t)data[8 + i] << (8 * i);
+    }
+    uint64_t ms = 0;
+    size_t pos = TRACE_HEADER;
+    while (pos < data.size()){
+        uint8_t tag = data[pos++];
+        uint64_t delta = 0;
+        bool ok = false;
+        for (unsigned shift = 0; pos < data.size() && shift < 64; shift += 7){
+            uint8_t b = data[pos++];
+            delta |= (uint64_t)(b & 0x7F) << shift;
+            if ((b & 0x80) == 0){
+                ok = true;
+                break;
+            }
+        }
+        size_t len = tag == TRACE_GAP ? 0 : (tag & 0x7F) + 1;
+        if (!ok || pos + len > data.size()){
+            t.truncated = true;     // the last write didn't make it to the card
+            break;
+        }
+        ms += delta;
+        t.records.push_back({ tag == TRACE_GAP, tag != TRACE_GAP && (tag & TRACE_TX), ms, data.substr(pos, len) });
+        pos += len;
+    }
+    return true;
+}
+
+// Function to print bytes as text, escaping CR, LF and anything not printable
+static std::string escape(const std::string & s){
+    std::string out;
+    char buf[8];
+    for (unsigned char c : s){
+        if (c == '\r')              out += "\\r";
+        else if (c == '\n')         out += "\\n";
+        else if (c == '\\')         out += "\\\\";
+        else if (c < 32 || c > 126){
+            snprintf(buf, sizeof(buf), "\\x%02X", c);
+            out += buf;
+        } else                      out += (char)c;
+    }
+    return out;
+}
+
+// Function to turn a hex digit into its value, -1 if it isn't one
+static int hexDigit(char c){
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+static int extract(const char * in, const char * out){
+    std::ifstream file;
+    if (strcmp(in, "-") != 0){
+        file.open(in);
+        if (!file){
+            fprintf(stderr, "at_trace: cannot open %s\n", in);
+            return 1;
+        }
+    }
+    std::istream & lines = strcmp(in, "-") != 0 ? static_cast<std::istream &>(file) : std::cin;
+
+    std::string line, dump, last;
+    bool inDump = false;
+    size_t expected = 0, found = 0;
+    while (std::getline(lines, line)){
+        while (!line.empty() && (line.back() == '\r' || line.back() == '\n')){
+            line.pop_back();
+        }
+        // the dump can share the monitor with the sketch's own output, only TRACE, lines count
+        size_t at = line.find("TRACE,");
+        if (at == std::string::npos){
+            continue;
+        }
+        std::string body = line.substr(at + 6);
+        if (body.compare(0, 6, "BEGIN,") == 0){
+            inDump = true;
+            dump.clear();
+            expected = strtoul(body.c_str() + 6, nullptr, 10);
+        } else if (body == "END"){
+            if (inDump && dump.size() == expected){
+                last = dump;
+                found++;
+            } else if (inDump){
+                fprintf(stderr, "at_trace: skipped a dump with %zu of %zu bytes\n", dump.size(), expected);
+            }
+            inDump = false;
+        } else if (inDump){
+            for (size_t i = 0; i + 1 < body.size(); i += 2){
+                int hi = hexDigit(body[i]), lo = hexDigit(body[i + 1]);
+                if (hi < 0 || lo < 0){
+                    inDump = false;     // garbled line, this dump is no good
+                    break;
+                }
+                dump += (char)(hi << 4 | lo);
+            }
+        }
+    }
+    if (found == 0){
+        fprintf(stderr, "at_trace: no complete TRACE dump in %s\n", in);
+        return 1;
+    }
+    std::ofstream f(out, std::ios::binary);
+    f.write(last.data(), last.size());
+    if (!f){
+        fprintf(stderr, "at_trace: cannot write %s\n", out);
+        return 1;
+    }
+    fprintf(stderr, "%zu bytes to %s (the last of %zu dumps)\n", last.size(), out, found);
+    return 0;
+}
+
+static int dump(const char * path){
+    Trace t;
+    if (!load(path, t)){
+        return 1;
+    }
+    printf("# node %c, %s, clock %lu ms\n", t.node,
+           (t.flags & TRACE_FROM_BOOT) ? "from boot" : "started late", (unsigned long)t.clock);
+    for (const Record & r : t.records){
+        if (r.gap){
+            printf("%10.3f  -- records lost --\n", (t.clock + r.ms) / 1000.0);
+        } else {
+            printf("%10.3f  %s  %s\n", (t.clock + r.ms) / 1000.0, r.tx ? ">>" : "<<", escape(r.bytes).c_str());
+        }
+    }
+    if (t.truncated){
+        printf("# cut short after the last record\n");
+    }
+    return 0;
+}
+
+static int stats(const char * path){
+    Trace t;
+    if (!load(path, t)){
+        return 1;
+    }
+    unsigned long records[2] = { 0, 0 }, bytes[2] = { 0, 0 }, lines[2] = { 0, 0 }, gaps = 0;
+    for (const Record & r : t.records){
+        if (r.gap){
+            gaps++;
+            continue;
+        }
+        records[r.tx]++;
+        bytes[r.tx] += r.bytes.size();
+        for (char c : r.bytes){
+            lines[r.tx] += c == '\n';
+        }
+    }
+    unsigned long payload = bytes[0] + bytes[1];
+    double secs = t.records.empty() ? 0 : t.records.back().ms / 1000.0;
+    printf("node          %c (%s)\n", t.node, (t.flags & TRACE_FROM_BOOT) ? "from boot" : "started late");
+    printf("duration      %.3f s\n", secs);
+    printf("records       %lu to the module, %lu from it, %lu gaps%s\n", records[1], records[0], gaps,
+           t.truncated ? ", cut short" : "");
+    printf("bytes         %lu to the module (%lu lines), %lu from it (%lu lines)\n",
+           bytes[1], lines[1], bytes[0], lines[0]);
+    printf("file          %zu bytes, %.1f %% over the traffic\n", t.size,
+           payload ? 100.0 * (double)(t.size - payload) / payload : 0.0);
+    if (secs > 0){
+        printf("rate          %.1f bytes/s of trace\n", t.size / secs);
+    }
+    return 0;
+}
+
+int main(int argc, char ** argv){
+    if (argc < 3){
+        usage();
+    }
+    if (!strcmp(argv[1], "extract") && argc == 4) return extract(argv[2], argv[3]);
+    if (!strcmp(argv[1], "dump") && argc == 3)    return dump(argv[2]);
+    if (!strcmp(argv[1], "stats") && argc == 3)   return stats(argv[2]);
+    usage();
+}
@@ -0,0 +1,272 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - BMP to End Node sd card image converter (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -march=native -Iinclude -I../Common/src src/bmp2raw.cpp -o build/bmp2raw
+// -----------------------------------------------------------------------------------------------------------//
+// Batch converts 24/32-bit BMP files (Images/Wio-Terminal-Screens/Original) into the M2EI image container read
+// by End-Node/include/RawImage.h (format in Common/src/RawImageFormat.h). The output keeps the input file name,
+// copy the files to the sd card root.
+//
+// Usage : bmp2raw [options] <file.bmp>...
+//     --out <dir>          output folder                                           (default converted)
+//     --format <f>         rgb332 | rgb565 | pal8                                  (default rgb332)
+//     --dither             4x4 ordered dithering instead of plain truncation
+//     --rle                run length compress the rows
+//     --align <n>          pad uncompressed rows to a multiple of n bytes          (default 1)
+//     --legacy             bare int16 width, int16 height, pixels file as the old bmp_converter wrote
+//                          (rgb332/rgb565 only), for End Node firmware older than the M2EI container
+//
+// e.g.    build/bmp2raw --out sd ../../Images/Wio-Terminal-Screens/Original/*.bmp
+//
+// RGB332 and RGB565 drop the low bits of each channel (no rounding), the same as the bmp_converter the
+// Converted/rgb332-8Bit screens were made with, so --legacy --format rgb332 reproduces them byte for byte.
+// The conversion runs on SIMD kernels (include/PixelKernels.h) when built with -march=native.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "PixelKernels.h"
+#include "RawImageFormat.h"
+
+struct Options {
+    std::string out = "converted";
+    uint8_t format = RAW_RGB332;
+    bool rle = false;
+    bool legacy = false;
+    bool dither = false;
+    int align = 1;
+};
+
+// Decoded BMP, top row first, 3 bytes B,G,R per pixel
+struct Bitmap {
+    int width = 0;
+    int height = 0;
+    std::vector<uint8_t> bgr;
+};
+
+static uint32_t le32(const uint8_t * p){ return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint16_t le16(const uint8_t * p){ return p[0] | (p[1] << 8); }
+
+// Function to read an uncompressed 24 or 32-bit BMP (bottom-up or top-down)
+static bool readBmp(const std::string & path, Bitmap & bmp, std::string & error){
+    std::ifstream in(path, std::ios::binary);
+    if (!in){
+        error = "can't open";
+        return false;
+    }
+    std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (file.size() < 54 || file[0] != 'B' || file[1] != 'M'){
+        error = "not a BMP file";
+        return false;
+    }
+    uint32_t offset = le32(&file[10]);
+    int32_t  w = (int32_t)le32(&file[18]);
+    int32_t  h = (int32_t)le32(&file[22]);
+    uint16_t bpp = le16(&file[28]);
+    uint32_t compression = le32(&file[30]);
+    if ((bpp != 24 && bpp != 32) || (compression != 0 && !(compression == 3 && bpp == 32))){
+        error = "only uncompressed 24/32-bit BMPs are supported";
+        return false;
+    }
+    bool bottomUp = h > 0;
+    h = bottomUp ? h : -h;
+    if (w <= 0 || h <= 0 || w > 0x7FFF || h > 0x7FFF){
+        error = "bad size";
+        return false;
+    }
+    size_t bytes = bpp / 8;
+    size_t stride = (w * bytes + 3) & ~(size_t)3;
+    if (offset + stride * h > file.size()){
+        error = "truncated";
+        return false;
+    }
+    bmp.width = w;
+    bmp.height = h;
+    bmp.bgr.resize((size_t)w * h * 3);
+    for (int y = 0; y < h; y++){
+        const uint8_t * src = &file[offset + stride * (bottomUp ? h - 1 - y : y)];
+        uint8_t * dst = &bmp.bgr[(size_t)y * w * 3];
+        for (int x = 0; x < w; x++){
+            memcpy(dst + x * 3, src + x * bytes, 3);
+        }
+    }
+    return true;
+}
+
+// Function to convert one row to file pixels with the kernels in PixelKernels.h. RGB565 and palette
+// entries are high byte first, palette images are matched on their RGB565 colour
+static void convertRow(const uint8_t * bgr, int w, int y, const Options & opt, const std::map<uint16_t, uint8_t> & palette, uint8_t * out){
+    if (opt.format == RAW_RGB332){
+        convertRowRgb332(bgr, w, y, opt.dither, out);
+        return;
+    }
+    if (opt.format == RAW_RGB565){
+        convertRowRgb565(bgr, w, y, opt.dither, out);
+        return;
+    }
+    std::vector<uint8_t> rgb565(w * 2);
+    convertRowRgb565(bgr, w, y, opt.dither, rgb565.data());
+    for (int x = 0; x < w; x++){
+        out[x] = palette.at((rgb565[x * 2] << 8) | rgb565[x * 2 + 1]);
+    }
+}
+
+// Function to PackBits compress one row in whole pixels, see RawImageFormat.h
+static void rleRow(const uint8_t * row, int w, int ps, std::vector<uint8_t> & out){
+    auto same = [&](int a, int b){ return memcmp(row + a * ps, row + b * ps, ps) == 0; };
+    int x = 0;
+    while (x < w){
+        int run = 1;
+        while (x + run < w && run < 129 && same(x, x + run)){
+            run++;
+        }
+        if (run >= 2){
+            out.push_back((uint8_t)(run + 126));
+            out.insert(out.end(), row + x * ps, row + (x + 1) * ps);
+            x += run;
+            continue;
+        }
+        // literals until the next pair of equal pixels
+        int n = 1;
+        while (x + n < w && n < 128 && !(x + n + 1 < w && same(x + n, x + n + 1))){
+            n++;
+        }
+        out.push_back((uint8_t)(n - 1));
+        out.insert(out.end(), row + x * ps, row + (x + n) * ps);
+        x += n;
+    }
+}
+
+// Function to convert one BMP, returns the output size or 0 on error
+static size_t convert(const std::string & path, const Options & opt){
+    Bitmap bmp;
+    std::string error;
+    if (!readBmp(path, bmp, error)){
+        fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+        return 0;
+    }
+
+    std::map<uint16_t, uint8_t> palette;
+    std::vector<uint16_t> entries;
+    if (opt.format == RAW_PAL8){
+        std::vector<uint8_t> rgb565(bmp.width * 2);
+        for (int i = 0; i < bmp.width * bmp.height; i++){
+            if (i % bmp.width == 0){
+                convertRowRgb565(&bmp.bgr[(size_t)i * 3], bmp.width, i / bmp.width, opt.dither, rgb565.data());
+            }
+            uint16_t c = (rgb565[(i % bmp.width) * 2] << 8) | rgb565[(i % bmp.width) * 2 + 1];
+            if (palette.count(c) == 0){
+                if (entries.size() == 256){
+                    fprintf(stderr, "%s: more than 256 colours, use rgb332 or rgb565\n", path.c_str());
+                    return 0;
+                }
+                palette[c] = (uint8_t)entries.size();
+                entries.push_back(c);
+            }
+        }
+    }
+
+    int ps = rawPixelSize(opt.format);
+    int rowBytes = bmp.width * ps;
+    int stride = opt.legacy || opt.rle ? rowBytes : (rowBytes + opt.align - 1) / opt.align * opt.align;
+    std::vector<uint8_t> out;
+    if (opt.legacy){
+        int16_t wh[2] = { (int16_t)bmp.width, (int16_t)bmp.height };
+        out.insert(out.end(), (uint8_t *)wh, (uint8_t *)wh + sizeof(wh));
+    } else {
+        RawImageHeader h = {};
+        memcpy(h.magic, RAW_IMAGE_MAGIC, 4);
+        h.version = RAW_IMAGE_VERSION;
+        h.format = opt.format;
+        h.compression = opt.rle ? RAW_RLE : RAW_NONE;
+        h.width = bmp.width;
+        h.height = bmp.height;
+        h.stride = stride;
+        h.paletteSize = entries.size();
+        out.insert(out.end(), (uint8_t *)&h, (uint8_t *)&h + sizeof(h));
+        for (uint16_t c : entries){
+            out.push_back(c >> 8);
+            out.push_back(c & 0xFF);
+        }
+    }
+
+    std::vector<uint8_t> row(stride, 0);
+    for (int y = 0; y < bmp.height; y++){
+        convertRow(&bmp.bgr[(size_t)y * bmp.width * 3], bmp.width, y, opt, palette, row.data());
+        if (opt.rle){
+            rleRow(row.data(), bmp.width, ps, out);
+        } else {
+            out.insert(out.end(), row.begin(), row.end());
+        }
+    }
+
+    const char * slash = strrchr(path.c_str(), '/');
+    std::string name = opt.out + "/" + (slash ? slash + 1 : path);
+    std::ofstream file(name, std::ios::binary);
+    if (!file.write((const char *)out.data(), out.size())){
+        fprintf(stderr, "%s: can't write %s\n", path.c_str(), name.c_str());
+        return 0;
+    }
+    printf("%s -> %s  %dx%d  %zu bytes\n", path.c_str(), name.c_str(), bmp.width, bmp.height, out.size());
+    return out.size();
+}
+
+int main(int argc, char ** argv){
+    Options opt;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc){
+            opt.out = argv[++i];
+        } else if (arg == "--format" && i + 1 < argc){
+            std::string f = argv[++i];
+            opt.format = f == "rgb565" ? RAW_RGB565 : f == "pal8" ? RAW_PAL8 : f == "rgb332" ? RAW_RGB332 : RAW_LEGACY;
+            if (opt.format == RAW_LEGACY){
+                fprintf(stderr, "bmp2raw: unknown format %s\n", f.c_str());
+                return 2;
+            }
+        } else if (arg == "--dither"){
+            opt.dither = true;
+        } else if (arg == "--rle"){
+            opt.rle = true;
+        } else if (arg == "--align" && i + 1 < argc){
+            opt.align = atoi(argv[++i]);
+        } else if (arg == "--legacy"){
+            opt.legacy = true;
+        } else if (arg.size() > 2 && arg.compare(0, 2, "--") == 0){
+            fprintf(stderr, "bmp2raw: unknown option %s\n", arg.c_str());
+            return 2;
+        } else {
+            files.push_back(arg);
+        }
+    }
+    if (files.empty()){
+        fprintf(stderr, "usage: bmp2raw [--out dir] [--format rgb332|rgb565|pal8] [--dither] [--rle] [--align n] [--legacy] <file.bmp>...\n");
+        return 2;
+    }
+    if (opt.legacy && (opt.format == RAW_PAL8 || opt.rle)){
+        fprintf(stderr, "bmp2raw: --legacy files can only be rgb332 or rgb565, uncompressed\n");
+        return 2;
+    }
+    if (opt.align < 1 || opt.align > 64){
+        opt.align = 1;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(opt.out, ec);
+
+    int failed = 0;
+    for (const std::string & f : files){
+        failed += convert(f, opt) == 0;
+    }
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,239 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Telemetry collector daemon (host side)
+// Software          - C/C++ (C++17), Linux/macOS compiler (POSIX serial port, mmap)
+// Build             - g++ -std=c++17 -O2 -Iinclude -I../Common/src src/collector.cpp -o build/collector
+// -----------------------------------------------------------------------------------------------------------//
+// Reads the Wio-E5 receive URCs (+TEST: LEN / +TEST: RX) from End Nodes' USB serial output or from replay
+// files, decodes them like the End Node's recv_parse() (include/UrcDecode.h) and appends every frame to a
+// columnar table of memory mapped files (include/ColumnStore.h), queried with telemetry_query.
+//
+// Usage : collector [options] <node>=<source>...
+//     --store <dir>        table folder, created on first use                      (default telemetry-store)
+//     --commit <ms>        how often appended rows are made durable and visible    (default 1000)
+//
+// A source is a serial port (the End Node built with -D LOG_LEVEL=LOG_LEVEL_TRACE, which echoes the modem
+// bytes), a text file or - for stdin. <node> is the number stored with each of its rows, e.g.
+//
+//     build/collector --store /var/lib/landslide 1=/dev/ttyACM0 2=/dev/ttyACM1
+//     build/collector --store bench 1=capture.txt
+//
+// Lines may start with a unix timestamp ("1697712000.25 +TEST: RX ..."), as replay files and AT captures
+// have, otherwise rows get the time the line was read. Times are kept non-decreasing so the table stays
+// sorted by time. Files are read as fast as possible and the collector exits when all of them are done,
+// serial ports are read until SIGINT / SIGTERM; serial ports that go away are reopened.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "ColumnStore.h"
+#include "SerialPort.h"
+#include "TelemetryFormat.h"
+#include "UrcDecode.h"
+
+// Columns of the collector table, in append() order
+static const std::vector<ColumnInfo> schema = {
+    { "time", COLUMN_U32, 1 },  { "node", COLUMN_U16, 1 },  { "sn_seq", COLUMN_U16, 1 }, { "flags", COLUMN_U8, 1 },
+    { "rssi", COLUMN_I16, 1 },  { "snr", COLUMN_I8, 1 },    { "m1", COLUMN_I16, 10 },    { "m2", COLUMN_I16, 10 },
+    { "rain", COLUMN_I16, 10 }, { "humi", COLUMN_I16, 10 }, { "temp", COLUMN_I16, 10 },  { "disp", COLUMN_I16, 100 },
+    { "gw_rain", COLUMN_I16, 10 }, { "gw_humi", COLUMN_I16, 10 }, { "gw_temp", COLUMN_I16, 10 },
+};
+
+struct Source {
+    uint16_t node;
+    std::string path;
+    bool serial = false;
+    FILE * file = nullptr;
+    SerialPort port;
+    std::string line;           // serial bytes up to the next \n, or the file line read ahead
+    uint32_t lineTime = 0;      // of the file line read ahead
+    bool ahead = false;
+    UrcDecoder decoder;
+    bool done = false;
+};
+
+struct Totals {
+    uint64_t lines = 0;
+    uint64_t frames = 0;
+    uint64_t rows = 0;
+};
+
+static volatile sig_atomic_t stopping = 0;
+
+static void onSignal(int){
+    stopping = 1;
+}
+
+// Function to split the unix timestamp off the start of a line, the time now if it has none
+static uint32_t stamp(const char * text, const char ** rest){
+    char * end;
+    double t = strtod(text, &end);
+    if (end != text && *end == ' ' && t > 0){
+        *rest = end + 1;
+        return (uint32_t)t;
+    }
+    *rest = text;
+    return (uint32_t)time(nullptr);
+}
+
+// Function to decode one line and append its rows
+static void take(Source & src, const char * text, ColumnStore & store, uint32_t & lastTime, Totals & totals){
+    totals.lines++;
+    const char * rest;
+    uint32_t t = stamp(text, &rest);
+    TelemetryRecord recs[URC_MAX_RECORDS];
+    int n = src.decoder.line(rest, recs);
+    if (n == 0){
+        return;
+    }
+    totals.frames++;
+    lastTime = t > lastTime ? t : lastTime;
+    for (int i = 0; i < n; i++){
+        const TelemetryRecord & r = recs[i];
+        int64_t row[] = { lastTime, src.node, r.snSeq, r.flags, r.rssi, r.snr, r.m1, r.m2, r.rain, r.humi, r.temp,
+                          r.disp, r.gwRain, r.gwHumi, r.gwTemp };
+        if (store.append(row)){
+            totals.rows++;
+        }
+    }
+}
+
+static bool openSource(Source & src){
+    if (src.path == "-"){
+        src.file = stdin;
+        return true;
+    }
+    struct stat st;
+    if (stat(src.path.c_str(), &st) != 0){
+        return false;
+    }
+    src.serial = S_ISCHR(st.st_mode);
+    if (src.serial){
+        return src.port.open(src.path, 115200);
+    }
+    src.file = fopen(src.path.c_str(), "r");
+    return src.file != nullptr;
+}
+
+static void usage(){
+    fprintf(stderr, "usage: collector [--store dir] [--commit ms] <node>=<serial port|file|->...\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv){
+    std::string dir = "telemetry-store";
+    int commitMs = 1000;
+    std::vector<Source> sources;
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--store" && i + 1 < argc){
+            dir = argv[++i];
+        } else if (arg == "--commit" && i + 1 < argc){
+            commitMs = atoi(argv[++i]);
+        } else if (arg.find('=') != std::string::npos && arg[0] != '-'){
+            Source src;
+            src.node = atoi(arg.c_str());
+            src.path = arg.substr(arg.find('=') + 1);
+            sources.push_back(std::move(src));
+        } else {
+            usage();
+        }
+    }
+    if (sources.empty()){
+        usage();
+    }
+    for (Source & src : sources){
+        if (!openSource(src)){
+            fprintf(stderr, "collector: can't open %s\n", src.path.c_str());
+            return 1;
+        }
+    }
+    ColumnStore store;
+    if (!store.openOrCreate(dir, schema) || store.find("node") < 0){
+        fprintf(stderr, "collector: %s isn't a collector table\n", dir.c_str());
+        return 1;
+    }
+    uint32_t lastTime = store.rows() ? store.value(store.find("time"), store.rows() - 1) : 0;
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    Totals totals;
+    auto start = std::chrono::steady_clock::now();
+    auto lastCommit = start;
+    char text[512];
+    while (!stopping){
+        bool pending = false;
+        // files first, up to 4096 lines a round, merged in timestamp order
+        for (int k = 0; k < 4096; k++){
+            Source * next = nullptr;
+            for (Source & src : sources){
+                if (!src.serial && !src.done && !src.ahead){
+                    const char * rest;
+                    src.ahead = fgets(text, sizeof(text), src.file) != nullptr;
+                    src.done = !src.ahead;
+                    src.line = src.ahead ? text : "";
+                    src.lineTime = src.ahead ? stamp(text, &rest) : 0;
+                }
+                if (src.ahead && (next == nullptr || src.lineTime < next->lineTime)){
+                    next = &src;
+                }
+            }
+            if (next == nullptr){
+                break;
+            }
+            take(*next, next->line.c_str(), store, lastTime, totals);
+            next->ahead = false;
+            pending = true;
+        }
+        // then whatever the serial ports have, waiting a little when there are no files left
+        int wait = pending ? 0 : 50 / (int)sources.size() + 1;
+        for (Source & src : sources){
+            if (!src.serial){
+                continue;
+            }
+            pending = true;
+            if (!src.port.isOpen() && !src.port.open(src.path, 115200)){
+                continue;
+            }
+            uint8_t buf[4096];
+            int n = src.port.read(buf, sizeof(buf), wait);
+            if (n < 0){
+                fprintf(stderr, "collector: %s went away\n", src.path.c_str());
+                src.port.close();
+                continue;
+            }
+            for (int i = 0; i < n; i++){
+                if (buf[i] == '\n'){
+                    take(src, src.line.c_str(), store, lastTime, totals);
+                    src.line.clear();
+                } else if (src.line.size() < sizeof(text)){
+                    src.line += (char)buf[i];
+                }
+            }
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (store.uncommitted() && now - lastCommit >= std::chrono::milliseconds(commitMs)){
+            store.commit();
+            lastCommit = now;
+        }
+        if (!pending){
+            break;
+        }
+    }
+    store.commit();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu lines, %llu frames, %llu rows in %.2f s (%.0f rows/s), table has %llu rows\n",
+            (unsigned long long)totals.lines, (unsigned long long)totals.frames, (unsigned long long)totals.rows, s,
+            totals.rows / (s > 0 ? s : 1), (unsigned long long)store.rows());
+    return 0;
+}
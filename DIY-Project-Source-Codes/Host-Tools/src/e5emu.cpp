@@ -0,0 +1,566 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Wio-E5 modem emulator on pseudo terminals (host side)
+// Software          - C/C++ (C++17), Linux/macOS compiler (POSIX pty, UDP)
+// Build             - g++ -std=c++17 -O2 -Iinclude src/e5emu.cpp -o build/e5emu
+// -----------------------------------------------------------------------------------------------------------//
+// Emulates Wio-E5 modules in TEST mode, one pseudo terminal each, so the three sketches (or any tool talking
+// to a module) can run without radios. Every emulated module transmits into one simulated LoRa channel,
+// shared by all modules of this process and of every other e5emu on the machine, so a
+// Sensor -> Gateway -> End Node chain runs end to end on one PC.
+//
+// Usage : e5emu [options] <name>[:<rssi>]...
+//     --dir <path>         where the <name> links to the pseudo terminals go         (default .)
+//     --latency <ms>       command answer delay, +-50 % jitter                       (default 8)
+//     --loss <p>           probability a frame is lost on its way to each receiver   (default 0)
+//     --corrupt <p>        probability a received frame has a byte flipped, as if the CRC missed it
+//                                                                                    (default 0)
+//     --channel <port>     first UDP port of the shared channel, on 127.0.0.1        (default 47700)
+//     --seed <n>           random seed                                               (default time)
+//     --quiet              no traffic log on stderr
+//
+// <rssi> is the level the module's frames arrive at with everyone else (dBm, default -80), e.g.
+//
+//     build/e5emu sensor:-105 gateway:-70 end     then open ./sensor, ./gateway and ./end as the modules' UARTs
+//
+// AT commands (case insensitive, \r\n or \n terminated, answers \r\n terminated):
+//     AT                       +AT: OK
+//     AT+VER                   +VER: 4.0.11
+//     AT+MODE=TEST             +MODE: TEST                   (AT+MODE=LWABP / LWOTAA leave TEST mode)
+//     AT+TEST=RFCFG,<f MHz>,SF<n>,<bw kHz>,<txpr>,<rxpr>,<pow>,<crc>,<iq>,<net>
+//                              +TEST: RFCFG F:866000000, SF12, BW125K, TXPR:12, RXPR:15, POW:14dBm, CRC:ON, ...
+//     AT+TEST=?                the RFCFG line
+//     AT+TEST=TXLRSTR,"text"   +TEST: TXLRSTR "<hex>", +TEST: TX DONE after the airtime
+//     AT+TEST=TXLRPKT,"hex"    +TEST: TXLRPKT "<hex>", +TEST: TX DONE after the airtime
+//     AT+TEST=RXLRPKT          +TEST: RXLRPKT, then for every frame received
+//                              +TEST: LEN:<n>, RSSI:<dBm>, SNR:<dB> and +TEST: RX "<hex>"
+//     AT+LOWPOWER              +LOWPOWER: SLEEP, +LOWPOWER: WAKEUP on the next byte
+//     AT+UART=BR, <baud>       +UART: BR, <baud>             (a pty has no baud, it's only remembered)
+//     AT+RESET                 +RESET: OK, back to LWABP mode
+// AT+TEST commands outside TEST mode answer +TEST: ERROR(-12), anything else +AT: ERROR(-1).
+//
+// The radio model: airtime from the LoRa formula (SF, bandwidth, preamble, 4/5 coding, explicit header, CRC,
+// low data rate optimisation at SF11/12 125 kHz). Transmitting stops receive mode like the real module, and
+// TX commands wait for a transmission in progress. A module receives a frame when it was in receive mode on
+// the same frequency / SF / bandwidth for the whole frame, and no other frame overlapping it at that module
+// came in less than 6 dB weaker (capture effect). RSSI gets +-2 dB of noise, SNR follows it.
+//
+// Modules of other e5emu processes are reached over UDP datagrams on 127.0.0.1 ports <channel>..<channel>+31,
+// each process takes the first free port and sends every frame to the others as its transmission starts.
+// Ctrl-C prints per module counts.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+#define CHANNEL_SYNC  0x5245324DUL      // "M2ER"
+#define CHANNEL_PORTS 32
+#define CAPTURE_DB    6                 // a frame survives an overlapping one this much weaker
+
+// One frame on air, as sent between processes
+struct ChannelFrame {
+    uint32_t sync;
+    uint32_t process;           // sender's pid
+    uint16_t modem;             // sender's index in its process
+    uint8_t  sf;
+    uint8_t  length;
+    uint32_t freq;              // Hz
+    uint16_t bw;                // kHz
+    int16_t  rssi;              // dBm at the receivers
+    double   start;             // ms, CLOCK_MONOTONIC - the same clock in every process
+    double   airtime;           // ms
+    uint8_t  payload[255];
+} __attribute__((packed));
+
+struct RadioConfig {
+    uint32_t freq = 868000000;
+    uint8_t sf = 12;
+    uint16_t bw = 125;
+    uint8_t txpr = 8, rxpr = 8;
+    int8_t pow = 14;
+    bool crc = true, iq = false, net = false;
+};
+
+// A frame heard by one module
+struct Heard {
+    ChannelFrame frame;
+    bool spoiled;               // another frame overlapped it, less than CAPTURE_DB weaker
+};
+
+struct Modem {
+    std::string name;
+    int rssi = -80;
+    int master = -1, slave = -1;
+    std::string in;             // command bytes up to the next \n
+    bool test = false;          // TEST mode
+    bool sleeping = false;
+    RadioConfig rf;
+    unsigned long baud = 9600;
+    bool receiving = false;
+    double rxSince = 0;
+    double busyUntil = 0;       // end of the transmission in progress
+    double answerAt = 0;        // when the last command queued gets answered, commands run in order
+    std::vector<Heard> air;     // frames heard and not finished yet
+    unsigned long tx = 0, rx = 0, lost = 0, collided = 0, missed = 0, corrupted = 0;
+};
+
+struct Options {
+    std::string dir = ".";
+    double latency = 8;
+    double loss = 0;
+    double corrupt = 0;
+    int channel = 47700;
+    bool quiet = false;
+};
+
+static Options opt;
+static std::vector<Modem> modems;
+static std::mt19937 rng;
+static int sock = -1;
+static int ownPort = 0;
+static volatile sig_atomic_t stopping = 0;
+
+// Timers, run in time order
+struct Timer {
+    double at;
+    uint64_t order;
+    std::function<void()> run;
+    bool operator>(const Timer & o) const { return at != o.at ? at > o.at : order > o.order; }
+};
+static std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+static uint64_t timerCount = 0;
+
+static void onSignal(int){
+    stopping = 1;
+}
+
+static double now(){
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+static void after(double ms, std::function<void()> run){
+    timers.push({ now() + ms, timerCount++, std::move(run) });
+}
+
+static double jitter(double ms){
+    return ms * std::uniform_real_distribution<double>(0.5, 1.5)(rng);
+}
+
+static void trace(const Modem & m, const char * what, const std::string & text){
+    if (!opt.quiet){
+        fprintf(stderr, "%10.3f %-10s %s %s\n", now() / 1e3, m.name.c_str(), what, text.c_str());
+    }
+}
+
+// Function to write an answer line to the module's UART, dropped when nobody reads the pty
+static void answer(Modem & m, const std::string & line){
+    std::string out = line + "\r\n";
+    if (write(m.master, out.data(), out.size()) < 0){
+        return;
+    }
+    trace(m, "<", line);
+}
+
+// LoRa airtime in ms (Semtech AN1200.13), 4/5 coding rate, explicit header
+static double airtime(const RadioConfig & rf, size_t length){
+    double symbol = (double)(1u << rf.sf) / rf.bw;
+    int de = rf.sf >= 11 && rf.bw == 125;
+    double bits = 8.0 * length - 4 * rf.sf + 28 + (rf.crc ? 16 : 0);
+    double symbols = 8 + std::max(ceil(bits / (4 * (rf.sf - 2 * de))) * 5, 0.0);
+    return (rf.txpr + 4.25) * symbol + symbols * symbol;
+}
+
+static std::string toHex(const uint8_t * data, size_t size){
+    static const char digits[] = "0123456789ABCDEF";
+    std::string hex;
+    for (size_t i = 0; i < size; i++){
+        hex += digits[data[i] >> 4];
+        hex += digits[data[i] & 15];
+    }
+    return hex;
+}
+
+static int fromHex(char c){
+    c = toupper(c);
+    return c >= '0' && c <= '9' ? c - '0' : c >= 'A' && c <= 'F' ? c - 'A' + 10 : -1;
+}
+
+static std::string rfcfgLine(const RadioConfig & rf){
+    char line[160];
+    snprintf(line, sizeof(line), "+TEST: RFCFG F:%u, SF%u, BW%uK, TXPR:%u, RXPR:%u, POW:%ddBm, CRC:%s, IQ:%s, NET:%s",
+             rf.freq, rf.sf, rf.bw, rf.txpr, rf.rxpr, rf.pow, rf.crc ? "ON" : "OFF", rf.iq ? "ON" : "OFF",
+             rf.net ? "ON" : "OFF");
+    return line;
+}
+
+// Function to finish a frame at one module - collision, loss and corruption, then the URCs
+static void finish(Modem & m, uint32_t process, uint16_t modem, double start){
+    auto it = std::find_if(m.air.begin(), m.air.end(), [&](const Heard & h){
+        return h.frame.process == process && h.frame.modem == modem && h.frame.start == start;
+    });
+    if (it == m.air.end()){
+        return;
+    }
+    Heard h = *it;
+    m.air.erase(it);
+    const ChannelFrame & f = h.frame;
+    if (!m.receiving || m.rxSince > f.start || m.rf.freq != f.freq || m.rf.sf != f.sf || m.rf.bw != f.bw){
+        m.missed++;
+        return;
+    }
+    if (h.spoiled){
+        m.collided++;
+        trace(m, "x", "collision");
+        return;
+    }
+    std::uniform_real_distribution<double> p(0, 1);
+    if (p(rng) < opt.loss){
+        m.lost++;
+        trace(m, "x", "lost");
+        return;
+    }
+    uint8_t payload[255];
+    memcpy(payload, f.payload, f.length);
+    if (f.length > 0 && p(rng) < opt.corrupt){
+        payload[rng() % f.length] ^= 1 << (rng() % 8);
+        m.corrupted++;
+    }
+    m.rx++;
+    int rssi = f.rssi + (int)lround(std::normal_distribution<double>(0, 2)(rng));
+    int snr = std::max(-20, std::min(12, (rssi + 120) / 3));
+    char line[64];
+    snprintf(line, sizeof(line), "+TEST: LEN:%u, RSSI:%d, SNR:%d", f.length, rssi, snr);
+    answer(m, line);
+    answer(m, "+TEST: RX \"" + toHex(payload, f.length) + "\"");
+}
+
+// Function to put a frame on air for every module that can hear it
+static void hear(const ChannelFrame & f){
+    for (size_t i = 0; i < modems.size(); i++){
+        if (f.process == (uint32_t)getpid() && f.modem == i){
+            continue;
+        }
+        Modem & m = modems[i];
+        Heard h = { f, false };
+        for (Heard & o : m.air){
+            if (o.frame.start + o.frame.airtime > f.start && o.frame.freq == f.freq && o.frame.sf == f.sf){
+                o.spoiled |= o.frame.rssi < f.rssi + CAPTURE_DB;
+                h.spoiled |= f.rssi < o.frame.rssi + CAPTURE_DB;
+            }
+        }
+        m.air.push_back(h);
+        uint32_t process = f.process;
+        uint16_t modem = f.modem;
+        double start = f.start;
+        double wait = f.start + f.airtime - now();
+        after(wait > 0 ? wait : 0, [i, process, modem, start](){ finish(modems[i], process, modem, start); });
+    }
+}
+
+// Function to start a transmission once the module is free
+static void transmit(size_t index, const std::string & command, std::vector<uint8_t> payload){
+    Modem & m = modems[index];
+    if (m.busyUntil > now()){
+        after(m.busyUntil - now(), [index, command, payload](){ transmit(index, command, payload); });
+        return;
+    }
+    if (payload.size() > 255){
+        answer(m, "+TEST: ERROR(-2)");
+        return;
+    }
+    answer(m, "+TEST: " + command + " \"" + toHex(payload.data(), payload.size()) + "\"");
+    m.receiving = false;
+    ChannelFrame f;
+    memset(&f, 0, sizeof(f));
+    f.sync = CHANNEL_SYNC;
+    f.process = getpid();
+    f.modem = index;
+    f.sf = m.rf.sf;
+    f.length = payload.size();
+    f.freq = m.rf.freq;
+    f.bw = m.rf.bw;
+    f.rssi = m.rssi;
+    f.start = now();
+    f.airtime = airtime(m.rf, payload.size());
+    memcpy(f.payload, payload.data(), payload.size());
+    m.busyUntil = f.start + f.airtime;
+    m.tx++;
+    trace(m, ">", toHex(payload.data(), payload.size()) + " (" + std::to_string((int)f.airtime) + " ms)");
+    hear(f);
+    for (int p = opt.channel; p < opt.channel + CHANNEL_PORTS; p++){
+        if (p != ownPort){
+            sockaddr_in to = {};
+            to.sin_family = AF_INET;
+            to.sin_port = htons(p);
+            to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            sendto(sock, &f, offsetof(ChannelFrame, payload) + f.length, 0, (sockaddr *)&to, sizeof(to));
+        }
+    }
+    after(f.airtime, [index](){ answer(modems[index], "+TEST: TX DONE"); });
+}
+
+// Function to read "...", the quoted argument of TXLRSTR / TXLRPKT
+static bool quoted(const std::string & args, std::string & out){
+    size_t a = args.find('"'), b = args.rfind('"');
+    if (a == std::string::npos || b == a){
+        return false;
+    }
+    out = args.substr(a + 1, b - a - 1);
+    return true;
+}
+
+// Function to run one AT command line
+static void command(size_t index, const std::string & line){
+    Modem & m = modems[index];
+    trace(m, ">", line);
+    size_t eq = line.find('=');
+    std::string cmd = line.substr(0, eq), args = eq == std::string::npos ? "" : line.substr(eq + 1);
+    for (char & c : cmd) c = toupper(c);
+    std::string key = args.substr(0, args.find(','));
+    for (char & c : key) c = toupper(c);
+
+    if (cmd == "AT"){
+        answer(m, "+AT: OK");
+    } else if (cmd == "AT+VER"){
+        answer(m, "+VER: 4.0.11");
+    } else if (cmd == "AT+MODE"){
+        if (eq != std::string::npos){
+            m.test = key == "TEST";
+            m.receiving = false;
+        }
+        answer(m, std::string("+MODE: ") + (m.test ? "TEST" : eq != std::string::npos ? key : "LWABP"));
+    } else if (cmd == "AT+LOWPOWER"){
+        m.sleeping = true;
+        answer(m, "+LOWPOWER: SLEEP");
+    } else if (cmd == "AT+UART"){
+        m.baud = strtoul(args.c_str() + args.find(',') + 1, nullptr, 10);
+        answer(m, "+UART: BR, " + std::to_string(m.baud));
+    } else if (cmd == "AT+RESET"){
+        answer(m, "+RESET: OK");
+        m.test = m.receiving = false;
+        m.rf = RadioConfig();
+    } else if (cmd != "AT+TEST"){
+        answer(m, "+AT: ERROR(-1)");
+    } else if (!m.test){
+        answer(m, "+TEST: ERROR(-12)");
+    } else if (key == "?"){
+        answer(m, rfcfgLine(m.rf));
+    } else if (key == "RFCFG"){
+        char sf[8], crc[4], iq[4], net[4];
+        double mhz;
+        unsigned bw, txpr, rxpr;
+        int pow;
+        if (sscanf(args.c_str() + 6, "%lf,%7[^,],%u,%u,%u,%d,%3[^,],%3[^,],%3s", &mhz, sf, &bw, &txpr, &rxpr, &pow, crc,
+                   iq, net) != 9 || toupper(sf[0]) != 'S' || atoi(sf + 2) < 7 || atoi(sf + 2) > 12){
+            answer(m, "+TEST: ERROR(-2)");
+            return;
+        }
+        m.rf.freq = (uint32_t)lround(mhz * 1e6);
+        m.rf.sf = atoi(sf + 2);
+        m.rf.bw = bw;
+        m.rf.txpr = txpr;
+        m.rf.rxpr = rxpr;
+        m.rf.pow = pow;
+        m.rf.crc = toupper(crc[1]) == 'N';
+        m.rf.iq = toupper(iq[1]) == 'N';
+        m.rf.net = toupper(net[1]) == 'N';
+        answer(m, rfcfgLine(m.rf));
+    } else if (key == "TXLRSTR" || key == "TXLRPKT"){
+        std::string text;
+        if (!quoted(args, text)){
+            answer(m, "+TEST: ERROR(-2)");
+            return;
+        }
+        std::vector<uint8_t> payload(text.begin(), text.end());
+        if (key == "TXLRPKT"){
+            payload.clear();
+            for (size_t i = 0; i + 1 < text.size(); i += 2){
+                if (fromHex(text[i]) < 0 || fromHex(text[i + 1]) < 0){
+                    answer(m, "+TEST: ERROR(-2)");
+                    return;
+                }
+                payload.push_back(fromHex(text[i]) << 4 | fromHex(text[i + 1]));
+            }
+        }
+        transmit(index, key, payload);
+    } else if (key == "RXLRPKT"){
+        // restarts receive mode, a frame already on air is missed
+        m.receiving = true;
+        m.rxSince = std::max(now(), m.busyUntil);
+        answer(m, "+TEST: RXLRPKT");
+    } else {
+        answer(m, "+TEST: ERROR(-1)");
+    }
+}
+
+// Function to take bytes the sketch wrote to the module
+static void input(size_t index, const char * data, ssize_t n){
+    Modem & m = modems[index];
+    for (ssize_t i = 0; i < n; i++){
+        if (m.sleeping){
+            m.sleeping = false;
+            answer(m, "+LOWPOWER: WAKEUP");
+        }
+        char c = data[i];
+        if (c == '\r'){
+            continue;
+        }
+        if (c != '\n'){
+            if (m.in.size() < 600){
+                m.in += c;
+            }
+            continue;
+        }
+        std::string line = m.in;
+        m.in.clear();
+        while (!line.empty() && isspace((unsigned char)line[0])){
+            line.erase(0, 1);
+        }
+        if (!line.empty()){
+            m.answerAt = std::max(m.answerAt, now()) + jitter(opt.latency);
+            after(m.answerAt - now(), [index, line](){ command(index, line); });
+        }
+    }
+}
+
+// Function to make a pty for a module, linked as <dir>/<name>
+static bool openPty(Modem & m){
+    m.master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m.master < 0 || grantpt(m.master) != 0 || unlockpt(m.master) != 0){
+        return false;
+    }
+    const char * path = ptsname(m.master);
+    // keeping the slave open stops the master hanging up while no sketch has it open
+    m.slave = open(path, O_RDWR | O_NOCTTY);
+    termios tty;
+    if (m.slave < 0 || tcgetattr(m.slave, &tty) != 0){
+        return false;
+    }
+    cfmakeraw(&tty);
+    tcsetattr(m.slave, TCSANOW, &tty);
+    fcntl(m.master, F_SETFL, fcntl(m.master, F_GETFL) | O_NONBLOCK);
+    std::string link = opt.dir + "/" + m.name;
+    unlink(link.c_str());
+    if (symlink(path, link.c_str()) != 0){
+        return false;
+    }
+    fprintf(stderr, "%s -> %s\n", link.c_str(), path);
+    return true;
+}
+
+static void usage(){
+    fprintf(stderr, "usage: e5emu [--dir path] [--latency ms] [--loss p] [--corrupt p] [--channel port] [--seed n]\n"
+                    "             [--quiet] <name>[:<rssi>]...\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv){
+    unsigned seed = time(nullptr);
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        bool more = i + 1 < argc;
+        if      (arg == "--dir" && more)     opt.dir = argv[++i];
+        else if (arg == "--latency" && more) opt.latency = atof(argv[++i]);
+        else if (arg == "--loss" && more)    opt.loss = atof(argv[++i]);
+        else if (arg == "--corrupt" && more) opt.corrupt = atof(argv[++i]);
+        else if (arg == "--channel" && more) opt.channel = atoi(argv[++i]);
+        else if (arg == "--seed" && more)    seed = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--quiet")           opt.quiet = true;
+        else if (arg[0] == '-')              usage();
+        else {
+            Modem m;
+            m.name = arg.substr(0, arg.find(':'));
+            if (arg.find(':') != std::string::npos){
+                m.rssi = atoi(arg.c_str() + arg.find(':') + 1);
+            }
+            modems.push_back(m);
+        }
+    }
+    if (modems.empty()){
+        usage();
+    }
+    rng.seed(seed);
+    for (Modem & m : modems){
+        if (!openPty(m)){
+            fprintf(stderr, "e5emu: can't make the pty for %s\n", m.name.c_str());
+            return 1;
+        }
+    }
+    sock = socket(AF_INET, SOCK_DGRAM, 0);
+    for (int p = opt.channel; p < opt.channel + CHANNEL_PORTS && ownPort == 0; p++){
+        sockaddr_in addr = {};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(p);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(sock, (sockaddr *)&addr, sizeof(addr)) == 0){
+            ownPort = p;
+        }
+    }
+    if (ownPort == 0){
+        fprintf(stderr, "e5emu: no free channel port from %d, running on its own\n", opt.channel);
+    }
+    fcntl(sock, F_SETFL, fcntl(sock, F_GETFL) | O_NONBLOCK);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<pollfd> fds(modems.size() + 1);
+    while (!stopping){
+        for (size_t i = 0; i < modems.size(); i++){
+            fds[i] = { modems[i].master, POLLIN, 0 };
+        }
+        fds.back() = { sock, POLLIN, 0 };
+        double wait = timers.empty() ? 100 : timers.top().at - now();
+        poll(fds.data(), fds.size(), wait <= 0 ? 0 : wait > 100 ? 100 : (int)ceil(wait));
+        for (size_t i = 0; i < modems.size(); i++){
+            char buf[512];
+            ssize_t n;
+            while ((fds[i].revents & POLLIN) && (n = read(modems[i].master, buf, sizeof(buf))) > 0){
+                input(i, buf, n);
+            }
+        }
+        ChannelFrame f;
+        ssize_t n;
+        while ((n = recv(sock, &f, sizeof(f), 0)) > 0){
+            if (n >= (ssize_t)offsetof(ChannelFrame, payload) && f.sync == CHANNEL_SYNC &&
+                n == (ssize_t)(offsetof(ChannelFrame, payload) + f.length)){
+                hear(f);
+            }
+        }
+        while (!timers.empty() && timers.top().at <= now()){
+            Timer t = timers.top();
+            timers.pop();
+            t.run();
+        }
+    }
+    fprintf(stderr, "\nmodem,tx,rx,missed,collided,lost,corrupted\n");
+    for (Modem & m : modems){
+        fprintf(stderr, "%s,%lu,%lu,%lu,%lu,%lu,%lu\n", m.name.c_str(), m.tx, m.rx, m.missed, m.collided, m.lost,
+                m.corrupted);
+        unlink((opt.dir + "/" + m.name).c_str());
+    }
+    return 0;
+}
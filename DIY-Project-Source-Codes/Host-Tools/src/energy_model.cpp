@@ -0,0 +1,140 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Sensor Node energy model (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -Iinclude src/energy_model.cpp -o build/energy_model
+// -----------------------------------------------------------------------------------------------------------//
+// Reads the Serial Monitor capture of a Sensor Node built with LOW_POWER_MODE and estimates average current
+// and battery life from the instrumented wake cycles. Every wake cycle prints one line :
+//
+//     PWR,<cycle>,<wake source 0=timer 1=accel>,<active ms>,<tx ms>,<slept ms before this cycle>,<rx ms>
+//
+// <rx ms> is the part of the transmit phase spent listening for the Gateway's acks (HISTORY_LOG), charged at
+// the E5's receive current - captures from older builds without it charge the whole phase at TX current.
+// All other lines in the capture are ignored. Currents are in mA and can be overridden from the command line
+// with the values measured on your own board.
+//
+// Usage : energy_model [options] [capture.txt]      (reads stdin when no file is given)
+//     --mcu-active <mA>    MCU + sensors + display awake          (default 35)
+//     --mcu-sleep <mA>     MCU + sensors in POWER_DOWN             (default 0.5)
+//     --e5-tx <mA>         Wio-E5 transmitting at 14 dBm           (default 45)
+//     --e5-rx <mA>         Wio-E5 receiving (RXLRPKT)               (default 6.5)
+//     --e5-sleep <mA>      Wio-E5 in AT+LOWPOWER                   (default 0.0021)
+//     --battery <mAh>      battery capacity for the life estimate  (default 2500)
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+struct Currents {
+    double mcuActive = 35.0;
+    double mcuSleep = 0.5;
+    double e5Tx = 45.0;
+    double e5Rx = 6.5;
+    double e5Sleep = 0.0021;
+    double battery = 2500.0;
+};
+
+struct Totals {
+    unsigned long cycles = 0;
+    unsigned long accelWakes = 0;
+    double activeMs = 0;    // awake, excluding transmit
+    double txMs = 0;        // wake E5 + send + E5 back to sleep, minus rxMs
+    double rxMs = 0;        // listening for acks within the transmit phase
+    double sleepMs = 0;
+    double maxActiveMs = 0;
+};
+
+// Function to parse one "PWR,..." line, returns false for anything else
+static bool parseLine(const std::string & line, Totals & t){
+    unsigned long cycle, src, active, tx, slept, rx = 0;
+    const char * p = strstr(line.c_str(), "PWR,");
+    if (p == nullptr || sscanf(p, "PWR,%lu,%lu,%lu,%lu,%lu,%lu", &cycle, &src, &active, &tx, &slept, &rx) < 5){
+        return false;
+    }
+    if (rx > tx){
+        rx = tx;
+    }
+    t.cycles++;
+    t.accelWakes += (src == 1);
+    t.txMs += tx - rx;
+    t.rxMs += rx;
+    t.activeMs += (active > tx) ? active - tx : 0;
+    t.sleepMs += slept;
+    if (active > t.maxActiveMs){
+        t.maxActiveMs = active;
+    }
+    return true;
+}
+
+static void usage(){
+    fprintf(stderr, "usage: energy_model [--mcu-active mA] [--mcu-sleep mA] [--e5-tx mA] [--e5-rx mA]\n"
+                    "                    [--e5-sleep mA] [--battery mAh] [capture.txt]\n");
+    exit(1);
+}
+
+int main(int argc, char ** argv){
+    Currents c;
+    const char * path = nullptr;
+
+    for (int i = 1; i < argc; i++){
+        auto value = [&](double & v){
+            if (++i >= argc) usage();
+            v = atof(argv[i]);
+        };
+        if      (!strcmp(argv[i], "--mcu-active")) value(c.mcuActive);
+        else if (!strcmp(argv[i], "--mcu-sleep"))  value(c.mcuSleep);
+        else if (!strcmp(argv[i], "--e5-tx"))      value(c.e5Tx);
+        else if (!strcmp(argv[i], "--e5-rx"))      value(c.e5Rx);
+        else if (!strcmp(argv[i], "--e5-sleep"))   value(c.e5Sleep);
+        else if (!strcmp(argv[i], "--battery"))    value(c.battery);
+        else if (argv[i][0] == '-')                usage();
+        else                                       path = argv[i];
+    }
+
+    std::ifstream file;
+    if (path){
+        file.open(path);
+        if (!file){
+            fprintf(stderr, "energy_model: cannot open %s\n", path);
+            return 1;
+        }
+    }
+    std::istream & in = path ? static_cast<std::istream &>(file) : std::cin;
+
+    Totals t;
+    std::string line;
+    while (std::getline(in, line)){
+        parseLine(line, t);
+    }
+    if (t.cycles == 0){
+        fprintf(stderr, "energy_model: no PWR lines found - is the Sensor Node built with LOW_POWER_MODE ?\n");
+        return 1;
+    }
+
+    // Charge in mA*ms for each phase; the transmit phase draws TX current (worst case) except while listening
+    double qActive = t.activeMs * (c.mcuActive + c.e5Sleep);
+    double qTx = t.txMs * (c.mcuActive + c.e5Tx);
+    double qRx = t.rxMs * (c.mcuActive + c.e5Rx);
+    double qSleep = t.sleepMs * (c.mcuSleep + c.e5Sleep);
+    double qAll = qActive + qTx + qRx + qSleep;
+    double totalMs = t.activeMs + t.txMs + t.rxMs + t.sleepMs;
+    double meanMa = qAll / totalMs;
+    double perDayMah = meanMa * 24.0;
+
+    printf("Wake cycles        : %lu (%lu by ADXL345 activity)\n", t.cycles, t.accelWakes);
+    printf("Observed time      : %.1f s\n", totalMs / 1000.0);
+    printf("Mean active / cycle: %.1f ms (max %.0f ms)\n", (t.activeMs + t.txMs + t.rxMs) / t.cycles, t.maxActiveMs);
+    printf("Duty cycle         : awake %.2f %%, transmitting %.2f %%, listening %.2f %%\n",
+           100.0 * (t.activeMs + t.txMs + t.rxMs) / totalMs, 100.0 * t.txMs / totalMs, 100.0 * t.rxMs / totalMs);
+    printf("Charge share       : active %.1f %%, tx %.1f %%, rx %.1f %%, sleep %.1f %%\n",
+           100.0 * qActive / qAll, 100.0 * qTx / qAll, 100.0 * qRx / qAll, 100.0 * qSleep / qAll);
+    printf("Mean current       : %.3f mA\n", meanMa);
+    printf("Consumption        : %.1f mAh/day\n", perDayMah);
+    printf("Battery life       : %.1f days on %.0f mAh\n", c.battery / perDayMah, c.battery);
+    return 0;
+}
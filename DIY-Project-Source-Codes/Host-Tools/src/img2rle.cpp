@@ -0,0 +1,182 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - RGB565 image to palette + RLE header converter (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -Iinclude src/img2rle.cpp -o build/img2rle
+// -----------------------------------------------------------------------------------------------------------//
+// Compresses an RGB565 image with few colours (logos, splash screens) into the run length format decoded by
+// Gateway-Node/include/RleImage.h, and writes it as a C header for PROGMEM. Input is either a C header with
+// one uint16_t array of 0xNNNN pixels (as m2e-logo.h, made with image2cpp/lcd-image-converter) or a raw
+// little endian RGB565 file (.bin).
+//
+// Usage : img2rle <input.h|input.bin> <width> <height> <name> [output.h]   (writes stdout when no output)
+//
+// e.g.    build/img2rle ../Gateway-Node/include/m2e-logo.h 240 240 m2elogo ../Gateway-Node/include/m2e-logo-rle.h
+//
+// The stream is decoded again after encoding and compared with the input, a mismatch is an error. Images
+// with more than 16 colours don't fit the format and are rejected.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Function to read the pixels of the first array in a C header - every 0xNNNN after the first '{'
+static bool readHeader(const std::string & path, std::vector<uint16_t> & pixels){
+    std::ifstream in(path);
+    if (!in){
+        return false;
+    }
+    std::stringstream ss;
+    ss << in.rdbuf();
+    std::string text = ss.str();
+    size_t pos = text.find('{', text.find("[]"));
+    if (pos == std::string::npos){
+        return false;
+    }
+    size_t end = text.find("};", pos);
+    while ((pos = text.find("0x", pos)) != std::string::npos && pos < end){
+        pixels.push_back((uint16_t)strtoul(text.c_str() + pos, nullptr, 16));
+        pos += 2;
+    }
+    return true;
+}
+
+// Function to read a raw little endian RGB565 file
+static bool readRaw(const std::string & path, std::vector<uint16_t> & pixels){
+    std::ifstream in(path, std::ios::binary);
+    if (!in){
+        return false;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    for (size_t i = 0; i + 1 < bytes.size(); i += 2){
+        pixels.push_back(bytes[i] | (bytes[i + 1] << 8));
+    }
+    return true;
+}
+
+// Function to encode pixels as runs of "iiii nnnn" [+ extra length byte], see RleImage.h
+static bool encode(const std::vector<uint16_t> & pixels, std::vector<uint16_t> & palette, std::vector<uint8_t> & out){
+    size_t i = 0;
+    while (i < pixels.size()){
+        uint16_t colour = pixels[i];
+        size_t index = 0;
+        while (index < palette.size() && palette[index] != colour){
+            index++;
+        }
+        if (index == palette.size()){
+            if (palette.size() == 16){
+                return false;
+            }
+            palette.push_back(colour);
+        }
+        size_t run = 1;
+        while (i + run < pixels.size() && pixels[i + run] == colour && run < 271){
+            run++;
+        }
+        if (run <= 15){
+            out.push_back((uint8_t)((index << 4) | (run - 1)));
+        } else {
+            out.push_back((uint8_t)((index << 4) | 0x0F));
+            out.push_back((uint8_t)(run - 16));
+        }
+        i += run;
+    }
+    return true;
+}
+
+// Function to decode the stream the way drawRle() does
+static std::vector<uint16_t> decode(const std::vector<uint16_t> & palette, const std::vector<uint8_t> & data, size_t count){
+    std::vector<uint16_t> pixels;
+    size_t i = 0;
+    while (pixels.size() < count && i < data.size()){
+        uint8_t b = data[i++];
+        size_t n = (b & 0x0F) + 1;
+        if ((b & 0x0F) == 0x0F && i < data.size()){
+            n = 16 + data[i++];
+        }
+        pixels.insert(pixels.end(), n, palette[b >> 4]);
+    }
+    pixels.resize(count, 0);
+    return pixels;
+}
+
+static void writeHeader(std::ostream & out, const std::string & name, const std::string & source, int w, int h,
+                        const std::vector<uint16_t> & palette, const std::vector<uint8_t> & data){
+    char buf[16];
+    out << "// Generated by Host-Tools/img2rle from " << source << " - do not edit, regenerate instead\n";
+    out << "// " << w << "x" << h << ", " << palette.size() << " colours, " << data.size() << " bytes ("
+        << (size_t)w * h * 2 << " bytes raw)\n";
+    out << "#pragma once\n#include \"RleImage.h\"\n\n";
+    out << "static const uint16_t " << name << "_rle_palette[] PROGMEM = {\n   ";
+    for (uint16_t c : palette){
+        snprintf(buf, sizeof(buf), " 0x%04X,", c);
+        out << buf;
+    }
+    out << "\n};\n\n";
+    out << "static const uint8_t " << name << "_rle_data[] PROGMEM = {";
+    for (size_t i = 0; i < data.size(); i++){
+        snprintf(buf, sizeof(buf), "%s0x%02X,", (i % 16) ? " " : "\n    ", data[i]);
+        out << buf;
+    }
+    out << "\n};\n\n";
+    out << "static const RleImage " << name << "_rle = { " << w << ", " << h << ", " << name << "_rle_palette, "
+        << name << "_rle_data, sizeof(" << name << "_rle_data) };\n";
+}
+
+int main(int argc, char ** argv){
+    if (argc < 5){
+        fprintf(stderr, "usage: img2rle <input.h|input.bin> <width> <height> <name> [output.h]\n");
+        return 2;
+    }
+    std::string input = argv[1];
+    int w = atoi(argv[2]);
+    int h = atoi(argv[3]);
+    std::string name = argv[4];
+    size_t count = (size_t)w * h;
+
+    std::vector<uint16_t> pixels;
+    bool isHeader = input.size() > 2 && input.compare(input.size() - 2, 2, ".h") == 0;
+    if (!(isHeader ? readHeader(input, pixels) : readRaw(input, pixels))){
+        fprintf(stderr, "img2rle: can't read %s\n", input.c_str());
+        return 1;
+    }
+    if (w <= 0 || h <= 0 || pixels.size() != count){
+        fprintf(stderr, "img2rle: %s has %zu pixels, expected %dx%d = %zu\n", input.c_str(), pixels.size(), w, h, count);
+        return 1;
+    }
+
+    std::vector<uint16_t> palette;
+    std::vector<uint8_t> data;
+    if (!encode(pixels, palette, data)){
+        fprintf(stderr, "img2rle: more than 16 colours, keep this image raw\n");
+        return 1;
+    }
+    if (decode(palette, data, count) != pixels){
+        fprintf(stderr, "img2rle: round trip mismatch\n");
+        return 1;
+    }
+
+    const char * slash = strrchr(input.c_str(), '/');
+    std::string source = slash ? slash + 1 : input;
+    if (argc > 5){
+        std::ofstream out(argv[5]);
+        if (!out){
+            fprintf(stderr, "img2rle: can't write %s\n", argv[5]);
+            return 1;
+        }
+        writeHeader(out, name, source, w, h, palette, data);
+    } else {
+        writeHeader(std::cout, name, source, w, h, palette, data);
+    }
+    fprintf(stderr, "%s: %zu colours, %zu -> %zu bytes (%.1f%%)\n", source.c_str(), palette.size(), count * 2,
+            data.size(), 100.0 * data.size() / (count * 2));
+    return 0;
+}
@@ -0,0 +1,331 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Synthetic sensor traffic generator (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -Iinclude -I../Common/src src/loadgen.cpp -o build/loadgen
+// -----------------------------------------------------------------------------------------------------------//
+// Generates realistic Sensor Node readings for N nodes and writes them as the frames a Wio-E5 modem reports,
+// to load the Gateway / End Node parsers, the collector and the other host tools without hardware.
+//
+// Usage : loadgen [options]
+//     --nodes <n>          Sensor Nodes                                            (default 1)
+//     --days <d>           simulated time                                          (default 1)
+//     --interval <s>       send interval of each node, Sensor Node sendInterval    (default 20)
+//     --start <t>          unix time of the first frame                            (default now - days)
+//     --hop <gw|en>        frames as the Gateway receives them ("GW,...") or the End Node ("EN,...")
+//                                                                                  (default en)
+//     --backfill <p>       HISTORY_LOG build: the seq field on GW / EN frames, and an "HB," history frame after a
+//                          live frame with probability p
+//     --format <urc|bin>   URC text or binary frames                              (default urc)
+//     --timestamps         start every URC line with its unix time, as collector and replay files take
+//     --speed <x>          x times real time, e.g. 1000; 0 = as fast as possible  (default 0)
+//     --out <path>         output file, - for stdout                              (default -)
+//     --split              one file per node, <out>-<node>.txt / .bin
+//     --seed <n>           random seed, the same seed gives the same traffic      (default 1)
+//
+// e.g.    build/loadgen --nodes 20 --days 30 --timestamps --split --out sim && build/collector 1=sim-1.txt ...
+//         build/loadgen --hop gw --speed 100 --out /dev/pts/3
+//
+// URC output is exactly what the modem prints in receive mode, \r\n terminated:
+//     +TEST: LEN:<n>, RSSI:<dBm>, SNR:<dB>
+//     +TEST: RX "<payload hex>"
+// Binary output is one LoadFrame header per frame followed by the raw LoRa payload (the bytes before hex
+// encoding), little endian:
+//     uint32 sync "M2EF", uint32 time (unix s), uint16 ms, uint16 node, int16 rssi, int8 snr, uint8 length
+//
+// The model, per node, with the weather shared between nodes:
+//     temperature / humidity   daily cycle (warmest at 14:00) plus noise, humidity up with rain
+//     rain                     storms arriving every ~2 days on average, lasting hours, the sensor drying after
+//     soil moisture            m1 (shallow) soaks up rain and dries over days, m2 (deep) follows m1 with a lag
+//     displacement             the ADXL345 x reading, a tilt offset plus slow creep that speeds up when the
+//                              deep soil is wet
+//     vibration                short bursts, ~1 every 3 days
+//     alerts                   episodes of tens of minutes, ~1 every 10 days: vibration, displacement over 1
+//                              m/s^2 and the alert status set, as checkStatus() sets it
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "HistoryFormat.h"
+
+#define LOAD_FRAME_SYNC 0x4645324DUL    // "M2EF"
+#define HISTORY_BATCH 4                 // records per "HB," frame, as the Sensor Node sends them
+
+struct LoadFrame {
+    uint32_t sync;
+    uint32_t time;
+    uint16_t ms;
+    uint16_t node;
+    int16_t  rssi;
+    int8_t   snr;
+    uint8_t  length;
+} __attribute__((packed));
+
+struct Options {
+    int nodes = 1;
+    double days = 1;
+    double interval = SENSOR_SEND_INTERVAL / 1000.0;
+    double start = 0;
+    bool endHop = true;
+    double backfill = -1;       // < 0 = no seq, no backfill
+    bool binary = false;
+    bool timestamps = false;
+    double speed = 0;
+    std::string out = "-";
+    bool split = false;
+    unsigned seed = 1;
+};
+
+// Weather shared by all nodes
+struct Weather {
+    double stormEnd = -1;       // simulated seconds
+    double nextStorm = 0;
+    double intensity = 0;       // 0..100 while it rains
+};
+
+struct Node {
+    int id;
+    double tempOffset, tilt, rssi;
+    double m1, m2, wet;         // wet = rain sensor reading, decays after the rain
+    double creep = 0;
+    double vibUntil = -1, nextVib = 0;
+    double alertUntil = -1, nextAlert = 0;
+    uint16_t seq = 0;
+    std::vector<HistoryRecord> history;     // not yet backfilled
+    FILE * out = nullptr;
+};
+
+struct Totals {
+    uint64_t frames = 0, backfills = 0, alerts = 0, bytes = 0;
+};
+
+static std::mt19937_64 rng;
+
+static double uniform(double a, double b){ return std::uniform_real_distribution<double>(a, b)(rng); }
+static double gauss(double sd){ return std::normal_distribution<double>(0, sd)(rng); }
+static double expo(double mean){ return std::exponential_distribution<double>(1 / mean)(rng); }
+static double clamp(double v, double lo, double hi){ return v < lo ? lo : v > hi ? hi : v; }
+
+// Function to move the weather on to simulated time t
+static void weather(Weather & w, double t){
+    while (t >= w.nextStorm){
+        w.stormEnd = w.nextStorm + expo(4 * 3600);
+        w.intensity = uniform(30, 100);
+        w.nextStorm += expo(2 * 86400);
+    }
+}
+
+
+// Function to write one received frame
+static void emit(Node & n, double unix, const std::string & payload, const Options & opt, Totals & totals){
+    int rssi = (int)std::lround(n.rssi + gauss(2));
+    int snr = (int)clamp(std::lround((rssi + 120) / 3.0 + gauss(1)), -20, 12);
+    FILE * f = n.out;
+    if (opt.binary){
+        LoadFrame h = { LOAD_FRAME_SYNC, (uint32_t)unix, (uint16_t)((unix - floor(unix)) * 1000), (uint16_t)n.id,
+                        (int16_t)rssi, (int8_t)snr, (uint8_t)payload.size() };
+        fwrite(&h, sizeof(h), 1, f);
+        fwrite(payload.data(), 1, payload.size(), f);
+        totals.bytes += sizeof(h) + payload.size();
+        return;
+    }
+    char stamp[24] = "";
+    if (opt.timestamps){
+        snprintf(stamp, sizeof(stamp), "%.3f ", unix);
+    }
+    std::string hex;
+    hex.reserve(payload.size() * 2);
+    static const char digits[] = "0123456789ABCDEF";
+    for (unsigned char c : payload){
+        hex += digits[c >> 4];
+        hex += digits[c & 15];
+    }
+    totals.bytes += fprintf(f, "%s+TEST: LEN:%zu, RSSI:%d, SNR:%d\r\n%s+TEST: RX \"%s\"\r\n", stamp, payload.size(), rssi,
+                            snr, stamp, hex.c_str());
+}
+
+// Function to take one reading of node n at simulated time t and send it
+static void step(Node & n, Weather & w, double t, const Options & opt, Totals & totals){
+    double dt = opt.interval;
+    double unix = opt.start + t;
+    weather(w, t);
+    double hour = fmod(unix, 86400) / 3600;
+    double raining = t < w.stormEnd ? clamp(w.intensity * uniform(0.8, 1.2), 0, 100) : 0;
+    n.wet = raining > n.wet ? raining : n.wet * exp(-dt / 1800);
+
+    double daily = sin(2 * M_PI * (hour - 8) / 24);
+    double temp = 24 + n.tempOffset + 6 * daily - 4 * (raining > 0) + gauss(0.3);
+    double humi = 62 - 15 * daily + 0.3 * n.wet + gauss(1);
+    n.m1 += (1e-4 * raining * (1 - n.m1 / 100) - (n.m1 - 20) / (2 * 86400)) * dt;
+    n.m2 += (n.m1 - n.m2) / (12 * 3600) * dt;
+    n.creep += (1e-8 + 5e-9 * clamp(n.m2 - 55, 0, 45)) * dt;
+
+    if (t >= n.nextVib){
+        n.vibUntil = t + uniform(1, 5) * dt;
+        n.nextVib = t + expo(3 * 86400);
+    }
+    if (t >= n.nextAlert){
+        n.alertUntil = t + uniform(10, 60) * 60;
+        n.nextAlert = t + expo(10 * 86400);
+    }
+    bool alert = t < n.alertUntil;
+    bool vib = alert || t < n.vibUntil;
+    double disp = n.tilt + n.creep + gauss(vib ? 0.4 : 0.02) + (alert ? uniform(1.1, 2.5) : 0);
+    totals.alerts += alert;
+
+    int m1 = (int)clamp(n.m1 + gauss(0.5), 0, 100), m2 = (int)clamp(n.m2 + gauss(0.5), 0, 100);
+    int rain = (int)clamp(n.wet, 0, 100), h = (int)clamp(humi, 0, 100), tc = (int)clamp(temp, 0, 60);
+    char text[128];
+    if (opt.endHop){
+        // as the Gateway relays it, with its own readings on the end (uint8_t fields, disp as String(float))
+        int gwRain = rain / 2, gwHumi = (int)clamp(humi + 3, 0, 100), gwTemp = (int)clamp(temp + 1, 0, 60);
+        int len = snprintf(text, sizeof(text), "EN,%d,%d,%d,%d,%d,%.2f,%d,%d,%d,%d,%d", m1, m2, rain, h, tc, disp, vib,
+                           alert, gwRain, gwHumi, gwTemp);
+        if (opt.backfill >= 0){
+            snprintf(text + len, sizeof(text) - len, ",%u", n.seq);     // the Sensor Node seq, relayed last
+        }
+    } else if (opt.backfill >= 0){
+        snprintf(text, sizeof(text), "GW,%d,%d,%d,%d,%d,%.2f,%d,%d,%u", m1, m2, rain, h, tc, disp, vib, alert, n.seq);
+    } else {
+        snprintf(text, sizeof(text), "GW,%d,%d,%d,%d,%d,%.2f,%d,%d", m1, m2, rain, h, tc, disp, vib, alert);
+    }
+    emit(n, unix, text, opt, totals);
+    totals.frames++;
+
+    if (opt.backfill < 0){
+        return;
+    }
+    HistoryRecord r = { n.seq++, (uint8_t)m1, (uint8_t)m2, (uint8_t)rain, (uint8_t)h, (int8_t)tc,
+                        (int16_t)(disp * 100), (uint8_t)((vib ? HISTORY_VIB : 0) | (alert ? HISTORY_ALERT : 0)), 0 };
+    r.check = historyCheck(r);
+    n.history.push_back(r);
+    if (n.history.size() > 512){
+        n.history.erase(n.history.begin());
+    }
+    if (uniform(0, 1) < opt.backfill){
+        size_t count = n.history.size() < HISTORY_BATCH ? n.history.size() : HISTORY_BATCH;
+        std::string hb = "HB,";
+        hb += (char)count;
+        hb.append((const char *)n.history.data(), count * sizeof(HistoryRecord));
+        n.history.erase(n.history.begin(), n.history.begin() + count);
+        emit(n, unix + 2.5, hb, opt, totals);      // after the ack, one SF12 airtime later
+        totals.backfills++;
+    }
+}
+
+static void usage(){
+    fprintf(stderr, "usage: loadgen [--nodes n] [--days d] [--interval s] [--start t] [--hop gw|en] [--backfill p]\n"
+                    "               [--format urc|bin] [--timestamps] [--speed x] [--out path] [--split] [--seed n]\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv){
+    Options opt;
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        auto value = [&](){
+            if (++i >= argc) usage();
+            return argv[i];
+        };
+        if      (arg == "--nodes")      opt.nodes = atoi(value());
+        else if (arg == "--days")       opt.days = atof(value());
+        else if (arg == "--interval")   opt.interval = atof(value());
+        else if (arg == "--start")      opt.start = atof(value());
+        else if (arg == "--hop")        opt.endHop = std::string(value()) != "gw";
+        else if (arg == "--backfill")   opt.backfill = atof(value());
+        else if (arg == "--format")     opt.binary = std::string(value()) == "bin";
+        else if (arg == "--timestamps") opt.timestamps = true;
+        else if (arg == "--speed")      opt.speed = atof(value());
+        else if (arg == "--out")        opt.out = value();
+        else if (arg == "--split")      opt.split = true;
+        else if (arg == "--seed")       opt.seed = strtoul(value(), nullptr, 10);
+        else usage();
+    }
+    if (opt.nodes < 1 || opt.nodes > 65535 || opt.interval <= 0 || opt.days <= 0 || (opt.split && opt.out == "-")){
+        usage();
+    }
+    if (opt.start == 0){
+        opt.start = floor(time(nullptr) - opt.days * 86400);
+    }
+    rng.seed(opt.seed);
+
+    std::vector<Node> nodes(opt.nodes);
+    FILE * shared = opt.out == "-" ? stdout : nullptr;
+    for (int i = 0; i < opt.nodes; i++){
+        Node & n = nodes[i];
+        n.id = i + 1;
+        n.tempOffset = uniform(-2, 2);
+        n.tilt = uniform(0.05, 0.4);
+        n.rssi = uniform(-115, -60);
+        n.m1 = uniform(20, 40);
+        n.m2 = n.m1 + uniform(-5, 5);
+        n.wet = 0;
+        n.nextVib = expo(3 * 86400);
+        n.nextAlert = expo(10 * 86400);
+        if (opt.split){
+            std::string path = opt.out + "-" + std::to_string(n.id) + (opt.binary ? ".bin" : ".txt");
+            n.out = fopen(path.c_str(), opt.binary ? "wb" : "w");
+        } else {
+            if (shared == nullptr){
+                shared = fopen(opt.out.c_str(), opt.binary ? "wb" : "w");
+            }
+            n.out = shared;
+        }
+        if (n.out == nullptr){
+            fprintf(stderr, "loadgen: can't write %s\n", opt.out.c_str());
+            return 1;
+        }
+    }
+
+    // every node sends on its own schedule, frames go out in time order
+    typedef std::pair<double, int> Due;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due;
+    for (int i = 0; i < opt.nodes; i++){
+        due.push({ uniform(0, opt.interval), i });
+    }
+    Weather w;
+    w.nextStorm = expo(2 * 86400);
+    Totals totals;
+    double end = opt.days * 86400;
+    auto start = std::chrono::steady_clock::now();
+    while (!due.empty() && due.top().first < end){
+        Due d = due.top();
+        due.pop();
+        if (opt.speed > 0){
+            auto at = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  std::chrono::duration<double>(d.first / opt.speed));
+            if (at > std::chrono::steady_clock::now()){
+                for (Node & n : nodes) fflush(n.out);
+                std::this_thread::sleep_until(at);
+            }
+        }
+        step(nodes[d.second], w, d.first, opt, totals);
+        // the Sensor Node's loop drifts a little from its interval
+        due.push({ d.first + opt.interval + uniform(0, 0.3), d.second });
+    }
+    if (opt.split){
+        for (Node & n : nodes){
+            fclose(n.out);
+        }
+    } else if (shared == stdout){
+        fflush(stdout);
+    } else {
+        fclose(shared);
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu frames (%llu backfill), %llu alert readings, %.1f MB in %.2f s, %.0f frames/s, %.0fx real time\n",
+            (unsigned long long)totals.frames, (unsigned long long)totals.backfills, (unsigned long long)totals.alerts,
+            totals.bytes / 1e6, s, (totals.frames + totals.backfills) / (s > 0 ? s : 1), end / (s > 0 ? s : 1));
+    return 0;
+}
@@ -0,0 +1,679 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - LoRa network capacity simulator (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -pthread -Iinclude src/netsim.cpp -o build/netsim
+// -----------------------------------------------------------------------------------------------------------//
+// Discrete event simulation of N Sensor Nodes, one Gateway Node and one End Node sharing one LoRa channel, to
+// see how many Sensor Nodes a Gateway can take before deploying them. Every combination of the swept
+// parameters (and every run of it) is one simulation, spread over all cores. One CSV row per simulation.
+//
+// Usage : netsim [options]
+//     --nodes <n,n...>     Sensor Nodes                                            (default 10,50,100)
+//     --sf <n,n...>        spreading factor, 125 kHz                               (default 12)
+//     --interval <s,s...>  Sensor Node sendInterval                                (default 20)
+//     --payload <n,n...>   Sensor Node live frame bytes, 0 = the sketch's own "GW,..." frame
+//                                                                                  (default 0)
+//     --days <d>           simulated time per run                                  (default 1)
+//     --runs <n>           runs (seeds) per combination                            (default 1)
+//     --history            HISTORY_LOG builds - Gateway acks, Sensor Node backfill of unacked readings
+//     --radius <km>        Sensor Nodes spread over a disc this big round the Gateway   (default 2)
+//     --end-km <km>        End Node distance from the Gateway                      (default 1)
+//     --capture <dB>       a frame survives overlapping frames this much weaker    (default 6)
+//     --drift <%>          Sensor Node clock error, +- (ceramic resonator)         (default 0.3)
+//     --latency <ms>       Wio-E5 command latency                                  (default 10)
+//     --threads <n>        worker threads                                          (default all cores)
+//     --seed <n>           seed of the first run                                   (default 1)
+//
+// e.g.    build/netsim --nodes 10,20,50,100,200,500,1000 --sf 7,9,12 --interval 20,60,300 --days 2 > capacity.csv
+//
+// What is modelled, from the sketches:
+//     Sensor Node  loop() sends every sendInterval of its own clock, the AT command going out at 9600 baud.
+//                  HISTORY_LOG: after TX DONE it listens ackTimeout (4 s) for "AK,<seq>", and after an acked
+//                  live frame waits HISTORY_BACKFILL_DELAY (3.5 s, the Gateway's relay and re-arm) and sends
+//                  one "HB," batch of up to 4 unacked readings (372 kept, oldest dropped).
+//     Gateway      node_recv_then_send(5000): RXLRPKT, a 5 s receive window that ends at the first frame,
+//                  delay(100), the ack (frames with a seq), the "EN,..." relay or the "HB," forward, then the
+//                  DHT / rain / display loop. Frames outside the window - while it relays, in the delay(100)
+//                  and loop, or started before RXLRPKT restarted receive - are lost ("blind").
+//     End Node     radioPoll(): always receiving, RXLRPKT re-sent after 5 min without a frame (a frame on air
+//                  then is lost). Takes "EN," and "HB," frames, the Sensor Nodes' own "HB," included.
+//     Radio        LoRa airtime formula, log-distance path loss (exponent 2.7) with 4 dB shadowing per link
+//                  and 2 dB fading per frame, Wio-E5 sensitivity per SF, half duplex. A frame is lost at a
+//                  receiver when an overlapping frame there is less than --capture dB weaker.
+//
+// Columns:
+//     readings             Sensor Node readings taken (one per send)
+//     gw_pdr               live frames the Gateway received / sent
+//     gw_collided, gw_blind, gw_weak    Sensor Node frames lost at the Gateway by cause / sent
+//     e2e_pdr              readings that reached the End Node (live or backfilled) / readings
+//     dups                 readings that reached the End Node more than once
+//     ack_rate             acks received / ack waits (HISTORY_LOG)
+//     lat_p50/p90/p99_s    reading taken -> first at the End Node, seconds
+//     gw_duty_pct, sensor_duty_max_pct, sensor_duty_mean_pct     transmit time / simulated time
+//     events, run_s        simulation events and wall time
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define HISTORY_BATCH   4           // Sensor-Node/include/HistoryLog.h
+#define HISTORY_SLOTS   372         // 4 KB EEPROM / 11 byte records
+#define ACK_TIMEOUT_MS  4000        // Sensor Node ackTimeout
+#define BACKFILL_DELAY_MS 3500      // Sensor Node HISTORY_BACKFILL_DELAY
+#define GW_WINDOW_MS    5000        // node_recv_then_send(5000)
+#define GW_DELAY_MS     100         // delay(100) after node_recv
+#define GW_LOOP_MS      60          // DHT, rain and display between windows
+#define END_REARM_MS    300000      // End Node rxRearmInterval
+#define URC_READ_MS     35          // at_send_check_response reading a short URC, delay(2) per byte
+#define TX_POWER_DBM    14
+#define LOOP_JITTER_MS  30          // Sensor Node loop() granularity
+
+struct Params {
+    int nodes, sf;
+    double interval;                // s
+    int payload;                    // 0 = real frames
+    bool history;
+    double days, radius, endKm, capture, drift, latency;
+    uint64_t seed;
+    int run;
+};
+
+struct Result {
+    uint64_t readings = 0, liveSent = 0, liveAtGateway = 0, sensorFrames = 0;
+    uint64_t collided = 0, blind = 0, weak = 0;
+    uint64_t delivered = 0, dups = 0, ackWaits = 0, acks = 0, events = 0;
+    double latency[3] = { 0, 0, 0 };
+    double gwDuty = 0, sensorDutyMax = 0, sensorDutyMean = 0, seconds = 0;
+};
+
+// Function to mix a 64 bit key into a well spread hash (splitmix64)
+static uint64_t mix(uint64_t x){
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Function to get a standard normal value fixed by its key, so both ends of a link agree on it
+static double keyedGauss(uint64_t key){
+    uint64_t h = mix(key), g = mix(h);
+    double u1 = ((h >> 11) + 0.5) / 9007199254740992.0, u2 = (g >> 11) / 9007199254740992.0;
+    return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+class Rng {
+public:
+    explicit Rng(uint64_t seed) : state(seed){}
+    double uniform(){ state = mix(state); return (state >> 11) / 9007199254740992.0; }
+    double uniform(double a, double b){ return a + (b - a) * uniform(); }
+private:
+    uint64_t state;
+};
+
+// LoRa airtime in ms, 125 kHz, 4/5 coding, explicit header, CRC on, preamble 12 (LORA_RFCFG_CMD)
+static double airtime(int sf, int length){
+    double symbol = (double)(1 << sf) / 125;
+    int de = sf >= 11;
+    double symbols = 8 + std::max(ceil((8.0 * length - 4 * sf + 28 + 16) / (4 * (sf - 2 * de))) * 5, 0.0);
+    return (12 + 4.25) * symbol + symbols * symbol;
+}
+
+// Wio-E5 receive sensitivity at 125 kHz, dBm
+static double sensitivity(int sf){
+    static const double dbm[] = { -124, -127, -130, -133, -135, -137 };
+    return dbm[std::min(std::max(sf, 7), 12) - 7];
+}
+
+// Time to send n bytes over a UART, ms
+static double uart(int bytes, double baud){
+    return bytes * 10000.0 / baud;
+}
+
+static int digits(uint32_t v){
+    int n = 1;
+    while (v >= 10){
+        v /= 10;
+        n++;
+    }
+    return n;
+}
+
+// Log spaced latency histogram, 50 buckets per decade from 10 ms
+class Histogram {
+public:
+    void add(double s){
+        int b = s <= 0.01 ? 0 : (int)(log10(s / 0.01) * 50);
+        counts[std::min(b, (int)counts.size() - 1)]++;
+        total++;
+    }
+    double percentile(double p) const {
+        uint64_t want = (uint64_t)ceil(p * total), seen = 0;
+        for (size_t b = 0; b < counts.size(); b++){
+            seen += counts[b];
+            if (seen >= want && seen > 0){
+                return 0.01 * pow(10, (b + 0.5) / 50);
+            }
+        }
+        return 0;
+    }
+private:
+    std::vector<uint64_t> counts = std::vector<uint64_t>(400, 0);
+    uint64_t total = 0;
+};
+
+class Simulation {
+public:
+    explicit Simulation(const Params & p) : p(p), rng(mix(p.seed)){}
+
+    Result run(){
+        auto wall = std::chrono::steady_clock::now();
+        place();
+        end = p.days * 86400e3;
+        for (int s = 0; s < p.nodes; s++){
+            at(rng.uniform(0, p.interval * 1e3), SENSOR_TICK, s);
+        }
+        at(rng.uniform(0, 1000), GW_ARM);
+        at(0, END_REARM, 0);
+        while (!queue.empty() && queue.front().t < end){
+            std::pop_heap(queue.begin(), queue.end(), Later());
+            Event e = queue.back();
+            queue.pop_back();
+            now = e.t;
+            handle(e);
+            r.events++;
+        }
+        r.latency[0] = latencies.percentile(0.5);
+        r.latency[1] = latencies.percentile(0.9);
+        r.latency[2] = latencies.percentile(0.99);
+        r.gwDuty = 100 * gw.airtime / end;
+        for (const Sensor & s : sensors){
+            r.sensorDutyMax = std::max(r.sensorDutyMax, 100 * s.airtime / end);
+            r.sensorDutyMean += 100 * s.airtime / end / p.nodes;
+        }
+        r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall).count();
+        return r;
+    }
+
+private:
+    enum { SENSOR_TICK, SENSOR_BACKFILL, TX_START, TX_END, ACK_TIMEOUT, GW_ARM, GW_TIMEOUT, GW_ACK, GW_RELAY, END_REARM };
+    enum { LIVE, HB_SENSOR, AK, EN, HB_RELAY };
+    enum { IDLE, SENDING, WAIT_LIVE_ACK, WAIT_HB_ACK };
+    enum { RECEIVED, BLIND, WEAK, COLLIDED };
+
+    struct Event {
+        double t;
+        uint64_t order;
+        uint32_t type, a, b;
+    };
+    struct Later {
+        bool operator()(const Event & x, const Event & y) const { return x.t != y.t ? x.t > y.t : x.order > y.order; }
+    };
+    struct Reading {
+        uint32_t seq;
+        double taken;
+    };
+    struct Interferer {
+        uint32_t id, sender;
+    };
+    struct Frame {
+        uint32_t id, sender, origin;        // origin = the Sensor Node the readings are from
+        int kind, length, count;
+        double start, end;
+        Reading readings[HISTORY_BATCH];
+        std::vector<Interferer> overlaps;
+    };
+    struct Sensor {
+        double x, y, rate, previous = 0, airtime = 0, listenFrom = 0;
+        double toGateway, toEnd;            // link budgets, dBm
+        uint32_t seq = 0, token = 0, waitSeq = 0;
+        int state = IDLE;
+        bool listening = false;
+        std::deque<Reading> backlog;
+        std::vector<uint32_t> delivered = std::vector<uint32_t>(512, 0);     // seq + 1 by seq % 512
+    };
+    struct Gateway {
+        bool listening = false;
+        double windowStart = 0, airtime = 0;
+        uint32_t token = 0;
+        Frame relay;                        // the frame being acked and relayed
+    };
+    struct EndNode {
+        double listenSince = 0;
+        uint32_t token = 0;
+    };
+
+    Params p;
+    Rng rng;
+    Result r;
+    Histogram latencies;
+    double now = 0, end = 0;
+    uint64_t order = 0;
+    uint32_t frameIds = 0;
+    std::vector<Event> queue;
+    std::deque<Frame> frames;               // pool, indexed by the TX events (deque: stays put as it grows)
+    std::vector<uint32_t> freeFrames, active;
+    std::vector<Sensor> sensors;
+    Gateway gw;
+    EndNode endNode;
+    double gwToEnd = 0;
+    uint32_t gwIndex = 0, endIndex = 0;
+
+    void at(double t, uint32_t type, uint32_t a = 0, uint32_t b = 0){
+        queue.push_back({ t, order++, type, a, b });
+        std::push_heap(queue.begin(), queue.end(), Later());
+    }
+
+    // Function to give the link budget between two devices (symmetric), from the distance and its shadowing
+    double link(uint32_t a, uint32_t b, double distanceKm) const {
+        double d = std::max(distanceKm * 1000, 10.0);
+        uint64_t key = p.seed * 0x100000001B3ULL ^ ((uint64_t)std::min(a, b) << 32 | std::max(a, b));
+        return TX_POWER_DBM - (40 + 27 * log10(d)) + 4 * keyedGauss(key);
+    }
+
+    void place(){
+        sensors.resize(p.nodes);
+        gwIndex = p.nodes;
+        endIndex = p.nodes + 1;
+        for (int i = 0; i < p.nodes; i++){
+            Sensor & s = sensors[i];
+            double radius = p.radius * sqrt(rng.uniform()), angle = rng.uniform(0, 2 * M_PI);
+            s.x = radius * cos(angle);
+            s.y = radius * sin(angle);
+            s.rate = 1 + rng.uniform(-p.drift, p.drift) / 100;
+            s.toGateway = link(i, gwIndex, radius);
+            s.toEnd = link(i, endIndex, hypot(s.x - p.endKm, s.y));
+        }
+        gwToEnd = link(gwIndex, endIndex, p.endKm);
+    }
+
+    // Function to get a frame's level at a receiver, the link plus this frame's fading there
+    double level(uint32_t sender, uint32_t id, uint32_t receiver) const {
+        double base;
+        if (sender == gwIndex || receiver == gwIndex){
+            uint32_t other = sender == gwIndex ? receiver : sender;
+            base = other == endIndex ? gwToEnd : sensors[other].toGateway;
+        } else if (sender == endIndex || receiver == endIndex){
+            base = sensors[sender == endIndex ? receiver : sender].toEnd;
+        } else {
+            const Sensor & a = sensors[sender], & b = sensors[receiver];
+            base = link(sender, receiver, hypot(a.x - b.x, a.y - b.y));
+        }
+        return base + 2 * keyedGauss((uint64_t)id << 32 | receiver);
+    }
+
+    // Function to decide whether a receiver that listened since listenFrom gets a frame
+    int receive(const Frame & f, uint32_t receiver, bool listening, double listenFrom) const {
+        if (!listening || f.start < listenFrom){
+            return BLIND;
+        }
+        double wanted = level(f.sender, f.id, receiver);
+        if (wanted < sensitivity(p.sf)){
+            return WEAK;
+        }
+        for (const Interferer & o : f.overlaps){
+            if (o.sender != receiver && wanted < level(o.sender, o.id, receiver) + p.capture){
+                return COLLIDED;
+            }
+        }
+        return RECEIVED;
+    }
+
+    uint32_t newFrame(uint32_t sender, int kind, int length, uint32_t origin, double start){
+        uint32_t slot;
+        if (freeFrames.empty()){
+            slot = frames.size();
+            frames.emplace_back();
+        } else {
+            slot = freeFrames.back();
+            freeFrames.pop_back();
+        }
+        Frame & f = frames[slot];
+        f.id = ++frameIds;
+        f.sender = sender;
+        f.kind = kind;
+        f.length = length;
+        f.origin = origin;
+        f.count = 0;
+        f.start = start;
+        f.overlaps.clear();
+        at(start, TX_START, slot);
+        return slot;
+    }
+
+    void handle(const Event & e){
+        switch (e.type){
+            case SENSOR_TICK:     sensorTick(e.a);     break;
+            case SENSOR_BACKFILL: sensorBackfill(e.a); break;
+            case TX_START:        txStart(e.a);        break;
+            case TX_END:          txEnd(e.a);          break;
+            case ACK_TIMEOUT:
+                if (sensors[e.a].token == e.b){
+                    sensors[e.a].listening = false;
+                    sensorDone(e.a);
+                }
+                break;
+            case GW_ARM:
+                gw.windowStart = now + p.latency;
+                gw.listening = true;
+                at(gw.windowStart + GW_WINDOW_MS, GW_TIMEOUT, 0, ++gw.token);
+                break;
+            case GW_TIMEOUT:
+                if (gw.token == e.b){
+                    gw.listening = false;
+                    at(now + GW_DELAY_MS + GW_LOOP_MS, GW_ARM);
+                }
+                break;
+            case GW_ACK: {
+                uint32_t seq = gw.relay.readings[0].seq;
+                uint32_t f = newFrame(gwIndex, AK, 3 + digits(seq), gw.relay.origin, now + p.latency);
+                frames[f].readings[0] = gw.relay.readings[0];
+                frames[f].count = 1;
+                break;
+            }
+            case GW_RELAY: {
+                // "EN," + the Gateway's readings, the seq stays on the end
+                int length = gw.relay.kind == LIVE ? gw.relay.length + 8 : gw.relay.length;
+                uint32_t f = newFrame(gwIndex, gw.relay.kind == LIVE ? EN : HB_RELAY, length, gw.relay.origin,
+                                      now + p.latency);
+                frames[f].count = gw.relay.count;
+                std::copy(gw.relay.readings, gw.relay.readings + gw.relay.count, frames[f].readings);
+                break;
+            }
+            case END_REARM:
+                if (e.a == 0 || endNode.token == e.b){
+                    endNode.listenSince = now + p.latency;
+                    at(now + END_REARM_MS, END_REARM, 1, ++endNode.token);
+                }
+                break;
+        }
+    }
+
+    // Function to take a reading and send it, loop() after sendInterval
+    void sensorTick(uint32_t s){
+        Sensor & n = sensors[s];
+        n.previous = now;
+        Reading reading = { n.seq++, now };
+        r.readings++;
+        if (p.history){
+            n.backlog.push_back(reading);
+            if (n.backlog.size() > HISTORY_SLOTS){
+                n.backlog.pop_front();
+            }
+        }
+        int length = p.payload > 0 ? p.payload : 25;
+        length += p.history ? 1 + digits(reading.seq) : 0;
+        n.state = SENDING;
+        uint32_t f = newFrame(s, LIVE, length, s, now + uart(length + 20, 9600) + p.latency);
+        frames[f].readings[0] = reading;
+        frames[f].count = 1;
+        r.liveSent++;
+    }
+
+    // Function to send one "HB," batch of the oldest unacked readings
+    void sensorBackfill(uint32_t s){
+        Sensor & n = sensors[s];
+        int count = std::min<int>(n.backlog.size(), HISTORY_BATCH);
+        int length = 4 + 11 * count;
+        uint32_t f = newFrame(s, HB_SENSOR, length, s, now + URC_READ_MS + uart(20 + 2 * length, 9600) + p.latency);
+        for (int i = 0; i < count; i++){
+            frames[f].readings[i] = n.backlog[i];
+        }
+        frames[f].count = count;
+    }
+
+    // Function for the end of a send - the next one goes sendInterval (of this node's clock) after the last
+    void sensorDone(uint32_t s){
+        Sensor & n = sensors[s];
+        n.state = IDLE;
+        double next = n.previous + p.interval * 1e3 * n.rate + rng.uniform(0, LOOP_JITTER_MS);
+        at(std::max(next, now + 1), SENSOR_TICK, s);
+    }
+
+    void txStart(uint32_t slot){
+        Frame & f = frames[slot];
+        f.end = now + airtime(p.sf, f.length);
+        for (uint32_t other : active){
+            Frame & o = frames[other];
+            o.overlaps.push_back({ f.id, f.sender });
+            f.overlaps.push_back({ o.id, o.sender });
+        }
+        active.push_back(slot);
+        if (f.sender == gwIndex){
+            gw.airtime += f.end - f.start;
+        } else {
+            sensors[f.sender].airtime += f.end - f.start;
+            sensors[f.sender].listening = false;
+        }
+        at(f.end, TX_END, slot);
+    }
+
+    void txEnd(uint32_t slot){
+        active.erase(std::find(active.begin(), active.end(), slot));
+        const Frame & f = frames[slot];
+        switch (f.kind){
+            case LIVE:
+            case HB_SENSOR:
+                atGateway(f);
+                if (f.kind == HB_SENSOR){
+                    atEndNode(f);
+                }
+                // TX DONE, then the ack wait or the next send
+                if (p.history){
+                    Sensor & n = sensors[f.sender];
+                    n.state = f.kind == LIVE ? WAIT_LIVE_ACK : WAIT_HB_ACK;
+                    n.waitSeq = f.readings[0].seq;
+                    n.listening = true;
+                    n.listenFrom = now + URC_READ_MS + uart(17, 9600) + p.latency;
+                    r.ackWaits++;
+                    at(now + URC_READ_MS + ACK_TIMEOUT_MS, ACK_TIMEOUT, f.sender, ++n.token);
+                } else {
+                    sensorDone(f.sender);
+                }
+                break;
+            case AK:
+                atSensor(f);
+                at(now + 1, GW_RELAY);
+                break;
+            case EN:
+            case HB_RELAY:
+                atEndNode(f);
+                at(now + GW_LOOP_MS, GW_ARM);
+                break;
+        }
+        freeFrames.push_back(slot);
+    }
+
+    void atGateway(const Frame & f){
+        r.sensorFrames++;
+        switch (receive(f, gwIndex, gw.listening, gw.windowStart)){
+            case BLIND:    r.blind++;    return;
+            case WEAK:     r.weak++;     return;
+            case COLLIDED: r.collided++; return;
+        }
+        r.liveAtGateway += f.kind == LIVE;
+        gw.listening = false;
+        gw.token++;
+        gw.relay.kind = f.kind;
+        gw.relay.length = f.length;
+        gw.relay.origin = f.origin;
+        gw.relay.count = f.count;
+        std::copy(f.readings, f.readings + f.count, gw.relay.readings);
+        // frames with a seq are acked first, then relayed
+        if (p.history){
+            at(now + GW_DELAY_MS, GW_ACK);
+        } else {
+            at(now + GW_DELAY_MS, GW_RELAY);
+        }
+    }
+
+    void atSensor(const Frame & f){
+        Sensor & n = sensors[f.origin];
+        if (n.waitSeq != f.readings[0].seq || receive(f, f.origin, n.listening, n.listenFrom) != RECEIVED){
+            return;
+        }
+        r.acks++;
+        n.listening = false;
+        n.token++;
+        if (n.state == WAIT_LIVE_ACK){
+            // markSent(), then one backfill batch when there's a backlog, once the Gateway is listening again
+            for (auto it = n.backlog.begin(); it != n.backlog.end(); it++){
+                if (it->seq == f.readings[0].seq){
+                    n.backlog.erase(it);
+                    break;
+                }
+            }
+            if (!n.backlog.empty()){
+                n.state = SENDING;
+                at(now + BACKFILL_DELAY_MS, SENSOR_BACKFILL, f.origin);
+                return;
+            }
+        } else {
+            // ackBatch(), the batch is the oldest readings
+            int count = std::min<int>(n.backlog.size(), HISTORY_BATCH);
+            while (count-- > 0 && n.backlog.front().seq - f.readings[0].seq < HISTORY_BATCH){
+                n.backlog.pop_front();
+            }
+        }
+        sensorDone(f.origin);
+    }
+
+    void atEndNode(const Frame & f){
+        if (receive(f, endIndex, true, endNode.listenSince) != RECEIVED){
+            return;
+        }
+        at(now + END_REARM_MS, END_REARM, 1, ++endNode.token);
+        Sensor & n = sensors[f.origin];
+        for (int i = 0; i < f.count; i++){
+            uint32_t & mark = n.delivered[f.readings[i].seq % n.delivered.size()];
+            if (mark == f.readings[i].seq + 1){
+                r.dups++;
+                continue;
+            }
+            mark = f.readings[i].seq + 1;
+            r.delivered++;
+            latencies.add((now - f.readings[i].taken) / 1e3);
+        }
+    }
+};
+
+// Function to split "a,b,c" into numbers
+static std::vector<double> list(const char * text){
+    std::vector<double> out;
+    for (const char * p = text; *p; ){
+        char * next;
+        out.push_back(strtod(p, &next));
+        if (next == p){
+            break;
+        }
+        p = *next == ',' ? next + 1 : next;
+    }
+    return out;
+}
+
+static void usage(){
+    fprintf(stderr, "usage: netsim [--nodes n,..] [--sf n,..] [--interval s,..] [--payload n,..] [--days d] [--runs n]\n"
+                    "              [--history] [--radius km] [--end-km km] [--capture dB] [--drift %%] [--latency ms]\n"
+                    "              [--threads n] [--seed n]\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv){
+    std::vector<double> nodes = { 10, 50, 100 }, sfs = { 12 }, intervals = { 20 }, payloads = { 0 };
+    Params base = { 0, 0, 0, 0, false, 1, 2, 1, 6, 0.3, 10, 1, 0 };
+    int runs = 1;
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        if (arg == "--history"){
+            base.history = true;
+            continue;
+        }
+        if (i + 1 >= argc) usage();
+        const char * v = argv[++i];
+        if      (arg == "--nodes")    nodes = list(v);
+        else if (arg == "--sf")       sfs = list(v);
+        else if (arg == "--interval") intervals = list(v);
+        else if (arg == "--payload")  payloads = list(v);
+        else if (arg == "--days")     base.days = atof(v);
+        else if (arg == "--runs")     runs = atoi(v);
+        else if (arg == "--radius")   base.radius = atof(v);
+        else if (arg == "--end-km")   base.endKm = atof(v);
+        else if (arg == "--capture")  base.capture = atof(v);
+        else if (arg == "--drift")    base.drift = atof(v);
+        else if (arg == "--latency")  base.latency = atof(v);
+        else if (arg == "--threads")  threads = std::max(1, atoi(v));
+        else if (arg == "--seed")     base.seed = strtoull(v, nullptr, 10);
+        else usage();
+    }
+
+    std::vector<Params> jobs;
+    for (double n : nodes)
+        for (double sf : sfs)
+            for (double interval : intervals)
+                for (double payload : payloads)
+                    for (int run = 0; run < runs; run++){
+                        Params p = base;
+                        p.nodes = (int)n;
+                        p.sf = (int)sf;
+                        p.interval = interval;
+                        p.payload = (int)payload;
+                        p.run = run;
+                        p.seed = base.seed + run;
+                        if (p.nodes < 1 || p.sf < 7 || p.sf > 12 || p.interval <= 0 || p.payload < 0 || p.payload > 240){
+                            usage();
+                        }
+                        jobs.push_back(p);
+                    }
+
+    // biggest first, so the last thread to finish isn't stuck with the longest run
+    std::vector<size_t> order(jobs.size());
+    for (size_t i = 0; i < order.size(); i++){
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b){
+        return jobs[a].nodes / jobs[a].interval > jobs[b].nodes / jobs[b].interval;
+    });
+    std::vector<Result> results(jobs.size());
+    std::atomic<size_t> next(0), done(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < std::min<size_t>(threads, jobs.size()); t++){
+        workers.emplace_back([&](){
+            for (size_t k; (k = next++) < jobs.size(); ){
+                results[order[k]] = Simulation(jobs[order[k]]).run();
+                fprintf(stderr, "\r%zu / %zu", ++done, jobs.size());
+            }
+        });
+    }
+    for (std::thread & w : workers){
+        w.join();
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "\r%zu simulations in %.2f s on %zu threads\n", jobs.size(), wall, workers.size());
+
+    printf("nodes,sf,interval_s,payload,history,run,readings,gw_pdr,gw_collided,gw_blind,gw_weak,e2e_pdr,dups,ack_rate,"
+           "lat_p50_s,lat_p90_s,lat_p99_s,gw_duty_pct,sensor_duty_max_pct,sensor_duty_mean_pct,events,run_s\n");
+    for (size_t i = 0; i < jobs.size(); i++){
+        const Params & p = jobs[i];
+        const Result & r = results[i];
+        double frames = r.sensorFrames ? r.sensorFrames : 1;
+        printf("%d,%d,%g,%d,%d,%d,%llu,%.4f,%.4f,%.4f,%.4f,%.4f,%llu,%.4f,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%llu,%.3f\n",
+               p.nodes, p.sf, p.interval, p.payload, p.history, p.run, (unsigned long long)r.readings,
+               r.liveSent ? (double)r.liveAtGateway / r.liveSent : 0, r.collided / frames, r.blind / frames,
+               r.weak / frames, r.readings ? (double)r.delivered / r.readings : 0, (unsigned long long)r.dups,
+               r.ackWaits ? (double)r.acks / r.ackWaits : 0, r.latency[0], r.latency[1], r.latency[2], r.gwDuty,
+               r.sensorDutyMax, r.sensorDutyMean, (unsigned long long)r.events, r.seconds);
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Pixel conversion kernel check and benchmark (host side)
+// Software          - C/C++ (C++17), any Linux/Windows/macOS compiler
+// Build             - g++ -std=c++17 -O2 -march=native -Iinclude -I../Common/src src/pixel_bench.cpp -o build/pixel_bench
+// -----------------------------------------------------------------------------------------------------------//
+// Checks that the pixel kernels agree bit for bit, then reports their throughput in Mpixels/s :
+//
+//   - the RGB332 -> RGB565 table used by the End Node (Common/src/PixelConvert.h)
+//     against the per-pixel formula, for all 256 values and for in-place expansion
+//   - the SIMD BGR -> RGB332/RGB565 converters of bmp2raw (include/PixelKernels.h) against their scalar
+//     reference, with and without dithering, for widths that exercise every tail length
+//
+// Usage : pixel_bench [megapixels per kernel]      (default 50)
+// Exits with 1 if any check fails.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "PixelConvert.h"
+#include "PixelKernels.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char * what){
+    if (!ok){
+        printf("FAIL  %s\n", what);
+        failures++;
+    }
+}
+
+// Function to compare the SIMD path with the scalar reference for one width
+static void checkConvert(std::mt19937 & rng, int width, bool dither){
+    std::vector<uint8_t> bgr(width * 3);
+    for (auto & v : bgr){
+        v = rng();
+    }
+    for (int y = 0; y < 4; y++){
+        std::vector<uint8_t> a(width), b(width), c(width * 2), d(width * 2);
+        convertRowRgb332(bgr.data(), width, y, dither, a.data());
+        convertRgb332Scalar(bgr.data(), 0, width, dither ? ditherRgb332()[y].t : DitherRow{}.t, b.data());
+        convertRowRgb565(bgr.data(), width, y, dither, c.data());
+        convertRgb565Scalar(bgr.data(), 0, width, dither ? ditherRgb565()[y].t : DitherRow{}.t, d.data());
+        char what[64];
+        snprintf(what, sizeof(what), "rgb332 width %d dither %d row %d", width, dither, y);
+        check(a == b, what);
+        snprintf(what, sizeof(what), "rgb565 width %d dither %d row %d", width, dither, y);
+        check(c == d, what);
+    }
+}
+
+// Function to time a kernel over whole 320x240 frames, returns Mpixels/s
+static double bench(const char * name, double mpix, const std::function<void()> & frame){
+    const double pixels = 320.0 * 240.0;
+    long frames = (long)(mpix * 1e6 / pixels) + 1;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long i = 0; i < frames; i++){
+        frame();
+    }
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double rate = frames * pixels / s / 1e6;
+    printf("%-34s %9.1f Mpixels/s\n", name, rate);
+    return rate;
+}
+
+int main(int argc, char ** argv){
+    double mpix = argc > 1 ? atof(argv[1]) : 50;
+    std::mt19937 rng(1234);
+
+    // RGB332 table against the formula, and in-place expansion (input in the top half of the output)
+    for (int i = 0; i < 256; i++){
+        check(rgb332Lut()[i] == rgb332To565be(i), "rgb332 table entry");
+    }
+    for (int count : { 1, 3, 4, 5, 17, 320 * 4 }){
+        std::vector<uint16_t> buf(count), ref(count);
+        uint8_t * in = (uint8_t *)buf.data() + count;
+        for (int i = 0; i < count; i++){
+            in[i] = rng();
+            ref[i] = rgb332To565be(in[i]);
+        }
+        expandRgb332(in, buf.data(), count);
+        check(buf == ref, "rgb332 in-place expansion");
+    }
+    for (int width = 1; width <= 100; width++){
+        checkConvert(rng, width, false);
+        checkConvert(rng, width, true);
+    }
+    checkConvert(rng, 320, true);
+    printf("kernel path: %s, checks %s\n\n", pixelKernelPath(), failures ? "FAILED" : "passed");
+
+    // One 320x240 frame of test data
+    const int w = 320, h = 240;
+    std::vector<uint8_t> bgr(w * h * 3), rgb332(w * h), rgb565(w * h * 2);
+    std::vector<uint16_t> expanded(w * h);
+    for (auto & v : bgr){
+        v = rng();
+    }
+    for (auto & v : rgb332){
+        v = rng();
+    }
+    volatile uint32_t sink = 0;     // keeps the results alive
+
+    bench("BGR -> RGB332 scalar", mpix, [&]{
+        for (int y = 0; y < h; y++) convertRgb332Scalar(&bgr[y * w * 3], 0, w, DitherRow{}.t, &rgb332[y * w]);
+        sink = sink + rgb332[7];
+    });
+    bench("BGR -> RGB332 kernel", mpix, [&]{
+        for (int y = 0; y < h; y++) convertRowRgb332(&bgr[y * w * 3], w, y, false, &rgb332[y * w]);
+        sink = sink + rgb332[7];
+    });
+    bench("BGR -> RGB332 kernel, dithered", mpix, [&]{
+        for (int y = 0; y < h; y++) convertRowRgb332(&bgr[y * w * 3], w, y, true, &rgb332[y * w]);
+        sink = sink + rgb332[7];
+    });
+    bench("BGR -> RGB565 scalar", mpix, [&]{
+        for (int y = 0; y < h; y++) convertRgb565Scalar(&bgr[y * w * 3], 0, w, DitherRow{}.t, &rgb565[y * w * 2]);
+        sink = sink + rgb565[7];
+    });
+    bench("BGR -> RGB565 kernel", mpix, [&]{
+        for (int y = 0; y < h; y++) convertRowRgb565(&bgr[y * w * 3], w, y, false, &rgb565[y * w * 2]);
+        sink = sink + rgb565[7];
+    });
+    bench("BGR -> RGB565 kernel, dithered", mpix, [&]{
+        for (int y = 0; y < h; y++) convertRowRgb565(&bgr[y * w * 3], w, y, true, &rgb565[y * w * 2]);
+        sink = sink + rgb565[7];
+    });
+    bench("RGB332 -> RGB565 formula", mpix, [&]{
+        for (int i = 0; i < w * h; i++) expanded[i] = rgb332To565be(rgb332[i]);
+        sink = sink + expanded[7];
+    });
+    bench("RGB332 -> RGB565 table", mpix, [&]{
+        expandRgb332(rgb332.data(), expanded.data(), w * h);
+        sink = sink + expanded[7];
+    });
+    return failures ? 1 : 0;
+}
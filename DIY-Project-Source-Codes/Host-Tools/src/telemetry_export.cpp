@@ -0,0 +1,478 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - End Node telemetry log export receiver (host side)
+// Software          - C/C++ (C++17), Linux/macOS compiler (POSIX serial port)
+// Build             - g++ -std=c++17 -O2 -Iinclude -I../Common/src src/telemetry_export.cpp -o build/telemetry_export
+// -----------------------------------------------------------------------------------------------------------//
+// Pulls a time range of the End Node's sd card telemetry log over its USB serial port (End-Node/include/
+// TelemetryExport.h, format in Common/src/TelemetryFormat.h) and writes it as CSV or as a folder of column files.
+//
+// Usage : telemetry_export [options] <port>
+//         telemetry_export [options] --input <file>...      convert sd card segment files (/log/R*.BIN, H*.BIN)
+//     --from <t>           first time, unix seconds                                (default 0)
+//     --to <t>             last time, unix seconds                                 (default no limit)
+//     --days <n>           from = now - n days
+//     --hourly             the hourly rollups instead of the raw records
+//     --format <f>         csv | columns                                           (default csv)
+//     --out <path>         CSV file or columns folder                              (default telemetry.csv / telemetry)
+//     --no-clock           don't set the End Node clock to this computer's time first
+//
+// e.g.    build/telemetry_export --days 1 --out today.csv /dev/ttyACM0
+//
+// Blocks are appended to <out>.part as they arrive. When a frame fails its CRC, the stream stalls or the port
+// drops, the export is asked for again from the next missing block - and running the same command again after
+// the tool was stopped carries on from the .part file. It is removed once the output is written.
+//
+// Columns are one little endian array file per field (<name>.<type>, e.g. rain.i16) plus schema.csv with each
+// column's type and the scale its integers are stored in (value = integer / scale).
+//
+// Raw rows: time is when the End Node logged the record, taken when its readings were taken - the same for
+// live frames, worked out from the Sensor Node seq for backfilled history (empty / 0 if it couldn't be).
+// Backfilled rows have no Gateway readings.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "SerialPort.h"
+#include "TelemetryFormat.h"
+
+#define PART_MAGIC 0x5045324DUL     // "M2EP"
+#define RETRIES 8                   // in a row without a new block
+
+struct Options {
+    uint32_t from = 0;
+    uint32_t to = 0xFFFFFFFF;
+    uint8_t kind = TELEMETRY_RAW;
+    bool columns = false;
+    bool clock = true;
+    std::string out;
+    std::string port;
+    std::vector<std::string> inputs;
+};
+
+// Header of the .part file, a resume only continues a part file of the same request
+struct PartHeader {
+    uint32_t magic;
+    uint32_t kind;
+    uint32_t from;
+    uint32_t to;
+};
+
+// Function to check a block whatever its position, damaged and empty slots fail
+static bool blockValid(TelemetryBlock & b){
+    return telemetryBlockValid(b, b.index);
+}
+
+// -------------------------------------------- receiving ------------------------------------------------------//
+
+class Receiver {
+public:
+    Receiver(const Options & opt, const std::string & partPath) : opt(opt), partPath(partPath) {}
+
+    // Function to run the export into the part file, returns false if it couldn't be finished
+    bool run(){
+        if (!openPart()){
+            return false;
+        }
+        if (!port.open(opt.port, 115200)){
+            fprintf(stderr, "telemetry_export: can't open %s\n", opt.port.c_str());
+            return false;
+        }
+        if (opt.clock){
+            port.write("CLOCK " + std::to_string((uint32_t)time(nullptr)) + "\n");
+        }
+        auto start = std::chrono::steady_clock::now();
+        uint32_t resumedAt = blocks;
+        int retries = 0;
+        while (retries < RETRIES){
+            uint32_t before = blocks;
+            int result = session();
+            if (result > 0){
+                double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                fprintf(stderr, "\r%u blocks (%u new) in %.2f s, %.0f KB/s\n", blocks, blocks - resumedAt, s,
+                        (blocks - resumedAt) * (double)TELEMETRY_BLOCK_SIZE / 1024 / (s > 0 ? s : 1));
+                return true;
+            }
+            if (result < 0){
+                return false;
+            }
+            retries = blocks > before ? 0 : retries + 1;
+            fprintf(stderr, "resuming at block %u\n", blocks);
+            if (!port.isOpen()){
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                port.open(opt.port, 115200);
+            }
+        }
+        fprintf(stderr, "telemetry_export: giving up after %d retries, run again to carry on\n", RETRIES);
+        return false;
+    }
+
+private:
+    const Options & opt;
+    std::string partPath;
+    SerialPort port;
+    std::fstream part;
+    uint32_t blocks = 0;            // in the part file, the offset the export carries on from
+    std::vector<uint8_t> buf;
+    bool badFrame = false;          // a frame failed its CRC or one went missing
+    bool synced = false;            // the first block of this session's stream has come
+
+    bool openPart(){
+        PartHeader want = { PART_MAGIC, opt.kind, opt.from, opt.to };
+        PartHeader have = {};
+        std::ifstream in(partPath, std::ios::binary);
+        bool resume = in.read((char *)&have, sizeof(have)) && memcmp(&have, &want, sizeof(want)) == 0;
+        if (resume){
+            in.seekg(0, std::ios::end);
+            blocks = ((uint64_t)in.tellg() - sizeof(have)) / TELEMETRY_BLOCK_SIZE;
+            fprintf(stderr, "carrying on from %s, %u blocks\n", partPath.c_str(), blocks);
+        }
+        in.close();
+        if (!resume){
+            std::ofstream create(partPath, std::ios::binary | std::ios::trunc);
+            create.write((const char *)&want, sizeof(want));
+        }
+        part.open(partPath, std::ios::binary | std::ios::in | std::ios::out);
+        // drop a torn last block
+        part.seekp(sizeof(PartHeader) + (uint64_t)blocks * TELEMETRY_BLOCK_SIZE);
+        if (!part){
+            fprintf(stderr, "telemetry_export: can't write %s\n", partPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // Function to ask for the export from the next missing block and take frames until it ends.
+    // Returns 1 when it ended, 0 to retry, -1 on an error reply
+    int session(){
+        buf.clear();
+        synced = false;
+        char cmd[80];
+        snprintf(cmd, sizeof(cmd), "ABORT\nEXPORT %s %u %u %u\n", opt.kind == TELEMETRY_HOURLY ? "HOURLY" : "RAW",
+                 opt.from, opt.to, blocks);
+        if (!port.write(cmd, strlen(cmd))){
+            port.close();
+            return 0;
+        }
+        uint8_t chunk[4096];
+        while (true){
+            int n = port.read(chunk, sizeof(chunk), 3000);
+            if (n <= 0){
+                if (n < 0){
+                    port.close();
+                }
+                return 0;               // stalled or gone
+            }
+            buf.insert(buf.end(), chunk, chunk + n);
+            badFrame = false;
+            int result = frames();
+            if (result != 0 || badFrame){
+                return badFrame ? 0 : result;
+            }
+        }
+    }
+
+    // Function to take the complete frames out of buf. Returns 1 at the end frame, -1 on an error frame,
+    // 0 for more (badFrame set when the stream has to be asked for again)
+    int frames(){
+        size_t at = 0;
+        while (true){
+            // text between frames is the End Node's log output
+            const uint8_t sync[4] = { 'M', '2', 'E', 'X' };
+            while (at + 4 <= buf.size() && memcmp(&buf[at], sync, 4) != 0){
+                at++;
+            }
+            if (at + sizeof(TelemetryFrame) > buf.size()){
+                break;
+            }
+            TelemetryFrame f;
+            memcpy(&f, &buf[at], sizeof(f));
+            if (f.length > TELEMETRY_BLOCK_SIZE){
+                at++;
+                continue;
+            }
+            if (at + sizeof(f) + f.length > buf.size()){
+                break;
+            }
+            const uint8_t * payload = &buf[at + sizeof(f)];
+            if (telemetryFrameCrc(f, payload) != f.crc){
+                at++;
+                badFrame = true;
+                continue;
+            }
+            at += sizeof(f) + f.length;
+            if (f.type == TELEMETRY_FRAME_ERROR){
+                fprintf(stderr, "telemetry_export: End Node says %.*s\n", f.length, (const char *)payload);
+                buf.erase(buf.begin(), buf.begin() + at);
+                return -1;
+            }
+            // until this session's stream starts, frames still on their way from the one before are dropped
+            if (f.type == TELEMETRY_FRAME_END && (synced || f.offset == blocks)){
+                buf.erase(buf.begin(), buf.begin() + at);
+                return f.offset == blocks ? 1 : 0;
+            }
+            if (f.type != TELEMETRY_FRAME_DATA || (!synced && f.offset != blocks)){
+                continue;
+            }
+            if (f.offset != blocks){
+                badFrame = true;        // one went missing
+                continue;
+            }
+            synced = true;
+            // a damaged block on the card keeps its slot as zeros
+            uint8_t block[TELEMETRY_BLOCK_SIZE] = {};
+            memcpy(block, payload, f.length);
+            part.write((const char *)block, sizeof(block));
+            part.flush();
+            blocks++;
+            if (blocks % 64 == 0){
+                fprintf(stderr, "\r%u blocks", blocks);
+            }
+        }
+        buf.erase(buf.begin(), buf.begin() + at);
+        return 0;
+    }
+};
+
+// -------------------------------------------- output ---------------------------------------------------------//
+
+// Function to read the valid blocks of a part file or sd card segment file
+static bool readBlocks(const std::string & path, size_t skip, std::vector<TelemetryBlock> & blocks){
+    std::ifstream in(path, std::ios::binary);
+    if (!in){
+        fprintf(stderr, "telemetry_export: can't read %s\n", path.c_str());
+        return false;
+    }
+    in.seekg(skip);
+    TelemetryBlock b;
+    while (in.read((char *)&b, sizeof(b))){
+        if (blockValid(b)){
+            blocks.push_back(b);
+        }
+    }
+    return true;
+}
+
+struct Column {
+    std::string name;
+    const char * type;          // u32, u16, u8, i16, i8
+    int scale;
+    std::vector<uint8_t> data;
+
+    Column(const std::string & name, const char * type, int scale) : name(name), type(type), scale(scale), data() {}
+
+    template<typename T> void add(T v){
+        data.insert(data.end(), (const uint8_t *)&v, (const uint8_t *)&v + sizeof(v));
+    }
+};
+
+// Function to write a folder of column files and schema.csv
+static bool writeColumns(const std::string & dir, std::vector<Column> & columns, size_t rows){
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    std::ofstream schema(dir + "/schema.csv");
+    schema << "name,type,scale,rows\n";
+    for (Column & c : columns){
+        std::ofstream f(dir + "/" + c.name + "." + c.type, std::ios::binary);
+        if (!f.write((const char *)c.data.data(), c.data.size())){
+            return false;
+        }
+        schema << c.name << "," << c.type << "," << c.scale << "," << rows << "\n";
+    }
+    return (bool)schema;
+}
+
+// Function to write the raw records in from..to, once each (by seq) in seq order
+static bool writeRaw(const std::vector<TelemetryBlock> & blocks, const Options & opt, size_t & rows){
+    std::map<uint32_t, TelemetryRecord> records;
+    for (const TelemetryBlock & b : blocks){
+        for (uint16_t i = 0; i < b.count && b.kind == TELEMETRY_RAW; i++){
+            if (b.records[i].time >= opt.from && b.records[i].time <= opt.to){
+                records[b.records[i].seq] = b.records[i];
+            }
+        }
+    }
+    rows = records.size();
+    if (opt.columns){
+        std::vector<Column> c = {
+            { "seq", "u32", 1 }, { "time", "u32", 1 }, { "sn_seq", "u16", 1 }, { "flags", "u8", 1 },
+            { "rssi", "i16", 1 }, { "snr", "i8", 1 }, { "m1", "i16", 10 }, { "m2", "i16", 10 },
+            { "rain", "i16", 10 }, { "humi", "i16", 10 }, { "temp", "i16", 10 }, { "disp", "i16", 100 },
+            { "gw_rain", "i16", 10 }, { "gw_humi", "i16", 10 }, { "gw_temp", "i16", 10 }, { "taken", "u32", 1 },
+        };
+        for (auto & [seq, r] : records){
+            bool live = (r.flags & TELEMETRY_BACKFILL) == 0;
+            c[0].add(r.seq); c[1].add(r.time); c[2].add(r.snSeq); c[3].add(r.flags);
+            c[4].add(r.rssi); c[5].add(r.snr); c[6].add(r.m1); c[7].add(r.m2);
+            c[8].add(r.rain); c[9].add(r.humi); c[10].add(r.temp); c[11].add(r.disp);
+            c[12].add(live ? r.gwRain : (int16_t)0); c[13].add(live ? r.gwHumi : (int16_t)0);
+            c[14].add(live ? r.gwTemp : (int16_t)0); c[15].add(telemetryTaken(r));
+        }
+        return writeColumns(opt.out, c, rows);
+    }
+    FILE * f = fopen(opt.out.c_str(), "w");
+    if (f == nullptr){
+        return false;
+    }
+    fprintf(f, "seq,time,taken,sn_seq,vib,alert,backfill,rssi,snr,m1,m2,rain,humi,temp,disp,gw_rain,gw_humi,gw_temp\n");
+    for (auto & [seq, r] : records){
+        char sn[8] = "", taken[12] = "", gw[40] = ",,";
+        if (r.snSeq != TELEMETRY_NO_SEQ){
+            snprintf(sn, sizeof(sn), "%u", r.snSeq);
+        }
+        if (telemetryTaken(r) != 0){
+            snprintf(taken, sizeof(taken), "%u", telemetryTaken(r));
+        }
+        if ((r.flags & TELEMETRY_BACKFILL) == 0){
+            snprintf(gw, sizeof(gw), "%.1f,%.1f,%.1f", r.gwRain / 10.0, r.gwHumi / 10.0, r.gwTemp / 10.0);
+        }
+        fprintf(f, "%u,%u,%s,%s,%d,%d,%d,%d,%d,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f,%s\n", r.seq, r.time, taken, sn,
+                (r.flags & TELEMETRY_VIB) != 0, (r.flags & TELEMETRY_ALERT) != 0, (r.flags & TELEMETRY_BACKFILL) != 0,
+                r.rssi, r.snr, r.m1 / 10.0, r.m2 / 10.0, r.rain / 10.0, r.humi / 10.0, r.temp / 10.0, r.disp / 100.0, gw);
+    }
+    return fclose(f) == 0;
+}
+
+// Function to write the hourly rollups in from..to, merging the two halves of an hour split between segments
+static bool writeHourly(const std::vector<TelemetryBlock> & blocks, const Options & opt, size_t & rows){
+    std::map<uint32_t, TelemetryRollup> hours;
+    std::map<uint32_t, int64_t> sums[TELEMETRY_ROLLUP_FIELDS];
+    for (const TelemetryBlock & b : blocks){
+        for (uint16_t i = 0; i < b.count && b.kind == TELEMETRY_HOURLY; i++){
+            const TelemetryRollup & r = b.rollups[i];
+            if (r.time < opt.from || r.time > opt.to || r.count == 0){
+                continue;
+            }
+            auto it = hours.find(r.time);
+            if (it == hours.end()){
+                hours[r.time] = r;
+                for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++) sums[k][r.time] = (int64_t)r.mean[k] * r.count;
+                continue;
+            }
+            TelemetryRollup & h = it->second;
+            for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+                h.lo[k] = r.lo[k] < h.lo[k] ? r.lo[k] : h.lo[k];
+                h.hi[k] = r.hi[k] > h.hi[k] ? r.hi[k] : h.hi[k];
+                sums[k][r.time] += (int64_t)r.mean[k] * r.count;
+            }
+            h.count += r.count;
+            h.alerts = h.alerts + r.alerts > 255 ? 255 : h.alerts + r.alerts;
+            h.vibs = h.vibs + r.vibs > 255 ? 255 : h.vibs + r.vibs;
+        }
+    }
+    for (auto & [t, h] : hours){
+        for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++) h.mean[k] = sums[k][t] / h.count;
+    }
+    rows = hours.size();
+    static const char * names[TELEMETRY_ROLLUP_FIELDS] = { "rain", "m1", "m2", "disp" };
+    static const int scales[TELEMETRY_ROLLUP_FIELDS] = { 10, 10, 10, 100 };
+    if (opt.columns){
+        std::vector<Column> c = { { "time", "u32", 1 }, { "count", "u16", 1 }, { "alerts", "u8", 1 }, { "vibs", "u8", 1 } };
+        for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+            for (const char * stat : { "_min", "_max", "_mean" }){
+                c.push_back({ std::string(names[k]) + stat, "i16", scales[k] });
+            }
+        }
+        for (auto & [t, h] : hours){
+            c[0].add(h.time); c[1].add(h.count); c[2].add(h.alerts); c[3].add(h.vibs);
+            for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+                c[4 + k * 3].add(h.lo[k]); c[5 + k * 3].add(h.hi[k]); c[6 + k * 3].add(h.mean[k]);
+            }
+        }
+        return writeColumns(opt.out, c, rows);
+    }
+    FILE * f = fopen(opt.out.c_str(), "w");
+    if (f == nullptr){
+        return false;
+    }
+    fprintf(f, "time,count,alerts,vibs");
+    for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+        fprintf(f, ",%s_min,%s_max,%s_mean", names[k], names[k], names[k]);
+    }
+    fprintf(f, "\n");
+    for (auto & [t, h] : hours){
+        fprintf(f, "%u,%u,%u,%u", h.time, h.count, h.alerts, h.vibs);
+        for (int k = 0; k < TELEMETRY_ROLLUP_FIELDS; k++){
+            double s = scales[k];
+            fprintf(f, ",%.*f,%.*f,%.*f", k == 3 ? 2 : 1, h.lo[k] / s, k == 3 ? 2 : 1, h.hi[k] / s, k == 3 ? 2 : 1, h.mean[k] / s);
+        }
+        fprintf(f, "\n");
+    }
+    return fclose(f) == 0;
+}
+
+static void usage(){
+    fprintf(stderr, "usage: telemetry_export [--from t] [--to t] [--days n] [--hourly] [--format csv|columns]\n"
+                    "                        [--out path] [--no-clock] <port> | --input <file>...\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv){
+    Options opt;
+    for (int i = 1; i < argc; i++){
+        std::string arg = argv[i];
+        auto value = [&](){
+            if (++i >= argc) usage();
+            return argv[i];
+        };
+        if      (arg == "--from")     opt.from = strtoul(value(), nullptr, 10);
+        else if (arg == "--to")       opt.to = strtoul(value(), nullptr, 10);
+        else if (arg == "--days")     opt.from = (uint32_t)time(nullptr) - (uint32_t)(atof(value()) * 86400);
+        else if (arg == "--hourly")   opt.kind = TELEMETRY_HOURLY;
+        else if (arg == "--format")   opt.columns = std::string(value()) == "columns";
+        else if (arg == "--out")      opt.out = value();
+        else if (arg == "--no-clock") opt.clock = false;
+        else if (arg == "--input"){
+            while (i + 1 < argc && argv[i + 1][0] != '-'){
+                opt.inputs.push_back(argv[++i]);
+            }
+        }
+        else if (arg.compare(0, 2, "--") == 0) usage();
+        else opt.port = arg;
+    }
+    if (opt.port.empty() == opt.inputs.empty()){
+        usage();
+    }
+    if (opt.out.empty()){
+        opt.out = opt.columns ? "telemetry" : "telemetry.csv";
+    }
+
+    std::vector<TelemetryBlock> blocks;
+    std::string partPath = opt.out + ".part";
+    if (opt.inputs.empty()){
+        Receiver receiver(opt, partPath);
+        if (!receiver.run() || !readBlocks(partPath, sizeof(PartHeader), blocks)){
+            return 1;
+        }
+    } else {
+        for (const std::string & in : opt.inputs){
+            if (!readBlocks(in, 0, blocks)){
+                return 1;
+            }
+        }
+    }
+
+    size_t rows = 0;
+    bool ok = opt.kind == TELEMETRY_HOURLY ? writeHourly(blocks, opt, rows) : writeRaw(blocks, opt, rows);
+    if (!ok){
+        fprintf(stderr, "telemetry_export: can't write %s\n", opt.out.c_str());
+        return 1;
+    }
+    printf("%zu %s from %zu blocks -> %s\n", rows, opt.kind == TELEMETRY_HOURLY ? "hours" : "records", blocks.size(),
+           opt.out.c_str());
+    if (opt.inputs.empty()){
+        std::remove(partPath.c_str());
+    }
+    return 0;
+}
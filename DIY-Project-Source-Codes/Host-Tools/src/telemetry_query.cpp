@@ -0,0 +1,292 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Tool              - Telemetry table query (host side)
+// Software          - C/C++ (C++17), Linux/macOS compiler (mmap)
+// Build             - g++ -std=c++17 -O2 -march=native -Iinclude -I../Common/src src/telemetry_query.cpp -o build/telemetry_query
+// -----------------------------------------------------------------------------------------------------------//
+// Queries a columnar telemetry table (include/ColumnStore.h) - the collector's store, or the columns folder
+// telemetry_export --format columns writes. Results are CSV on stdout, the time the query took on stderr.
+//
+// Usage : telemetry_query <table> [options] <query>
+//     --from <t>           first time, unix seconds                                (default start of the table)
+//     --to <t>             last time, unix seconds                                 (default end of the table)
+//     --node <n>           only rows of node n (tables with a node column)
+//
+// Queries :
+//     info                 rows, time span and columns, rows per node
+//     scan [column...]     the rows, all columns when none are given
+//     agg <column> <bucket>    count, min, max, mean of a column per bucket of time (seconds, or 15m 1h 1d 7d)
+//     alerts               alert episodes - node, start, end, records, highest displacement - a run of records
+//                          with the alert flag from one node, ended by its next record without it
+//
+// e.g.    build/telemetry_query /var/lib/landslide --from 1696118400 agg rain 1d
+//
+// The time column is sorted, so the range is found by binary search and only the rows in it are read, and
+// only the columns the query needs are touched. agg runs on the stored integers (no conversion per row).
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "ColumnStore.h"
+#include "TelemetryFormat.h"
+
+struct Range {
+    uint64_t lo = 0, hi = 0;    // rows [lo, hi)
+    int node = -1;              // -1 = all
+    const uint16_t * nodes = nullptr;
+};
+
+// Function to print a stored integer in its column's units
+static void printValue(FILE * f, int64_t v, int scale){
+    if (scale <= 1){
+        fprintf(f, "%lld", (long long)v);
+    } else {
+        fprintf(f, "%.*f", scale >= 100 ? 2 : 1, (double)v / scale);
+    }
+}
+
+static void info(const ColumnStore & t, const Range & r){
+    int time = t.find("time");
+    printf("rows,%llu\n", (unsigned long long)t.rows());
+    if (t.rows() > 0){
+        printf("first,%lld\nlast,%lld\n", (long long)t.value(time, 0), (long long)t.value(time, t.rows() - 1));
+    }
+    printf("columns");
+    for (size_t i = 0; i < t.width(); i++){
+        printf(",%s:%s/%d", t.info(i).name.c_str(), columnTypeName(t.info(i).type), t.info(i).scale);
+    }
+    printf("\n");
+    if (r.nodes != nullptr){
+        std::vector<uint64_t> perNode(65536, 0);
+        for (uint64_t i = r.lo; i < r.hi; i++){
+            perNode[r.nodes[i]]++;
+        }
+        for (int n = 0; n < 65536; n++){
+            if (perNode[n]){
+                printf("node %d,%llu\n", n, (unsigned long long)perNode[n]);
+            }
+        }
+    }
+}
+
+static void scan(const ColumnStore & t, const Range & r, std::vector<int> columns){
+    if (columns.empty()){
+        for (size_t i = 0; i < t.width(); i++){
+            columns.push_back(i);
+        }
+    }
+    for (size_t c = 0; c < columns.size(); c++){
+        printf("%s%s", c ? "," : "", t.info(columns[c]).name.c_str());
+    }
+    printf("\n");
+    for (uint64_t i = r.lo; i < r.hi; i++){
+        if (r.node >= 0 && r.nodes[i] != r.node){
+            continue;
+        }
+        for (size_t c = 0; c < columns.size(); c++){
+            if (c){
+                putchar(',');
+            }
+            printValue(stdout, t.value(columns[c], i), t.info(columns[c]).scale);
+        }
+        putchar('\n');
+    }
+}
+
+struct Bucket {
+    uint32_t start;
+    uint64_t count;
+    int64_t lo, hi, sum;
+};
+
+// Function to aggregate one column per time bucket, on the column's own integer type
+template<typename T>
+static void aggregate(const T * v, const uint32_t * time, const Range & r, uint32_t size, std::vector<Bucket> & out){
+    Bucket b = { 0, 0, 0, 0, 0 };
+    for (uint64_t i = r.lo; i < r.hi; i++){
+        if (r.node >= 0 && r.nodes[i] != r.node){
+            continue;
+        }
+        uint32_t start = time[i] - time[i] % size;
+        if (b.count == 0 || start != b.start){
+            if (b.count){
+                out.push_back(b);
+            }
+            b = { start, 0, v[i], v[i], 0 };
+        }
+        b.count++;
+        b.lo = v[i] < b.lo ? v[i] : b.lo;
+        b.hi = v[i] > b.hi ? v[i] : b.hi;
+        b.sum += v[i];
+    }
+    if (b.count){
+        out.push_back(b);
+    }
+}
+
+static void agg(const ColumnStore & t, const Range & r, int column, uint32_t size){
+    const uint32_t * time = t.data<uint32_t>(t.find("time"));
+    std::vector<Bucket> buckets;
+    switch (t.info(column).type){
+        case COLUMN_U8:  aggregate(t.data<uint8_t>(column), time, r, size, buckets);  break;
+        case COLUMN_I8:  aggregate(t.data<int8_t>(column), time, r, size, buckets);   break;
+        case COLUMN_U16: aggregate(t.data<uint16_t>(column), time, r, size, buckets); break;
+        case COLUMN_I16: aggregate(t.data<int16_t>(column), time, r, size, buckets);  break;
+        case COLUMN_U32: aggregate(t.data<uint32_t>(column), time, r, size, buckets); break;
+    }
+    int scale = t.info(column).scale;
+    printf("time,count,min,max,mean\n");
+    for (const Bucket & b : buckets){
+        printf("%u,%llu,", b.start, (unsigned long long)b.count);
+        printValue(stdout, b.lo, scale);
+        putchar(',');
+        printValue(stdout, b.hi, scale);
+        printf(",%.*f\n", scale >= 100 ? 3 : 2, (double)b.sum / b.count / (scale > 0 ? scale : 1));
+    }
+}
+
+static bool alerts(const ColumnStore & t, const Range & r){
+    int flagsColumn = t.find("flags"), dispColumn = t.find("disp");
+    if (flagsColumn < 0 || t.info(flagsColumn).type != COLUMN_U8){
+        fprintf(stderr, "telemetry_query: the table has no flags column\n");
+        return false;
+    }
+    const uint8_t * flags = t.data<uint8_t>(flagsColumn);
+    const uint32_t * time = t.data<uint32_t>(t.find("time"));
+    struct Episode {
+        uint32_t start, end;
+        uint64_t records;
+        int64_t disp;
+    };
+    std::vector<Episode> open(65536, Episode{ 0, 0, 0, 0 });
+    printf("node,start,end,records,max_disp\n");
+    auto close = [&](uint16_t node){
+        Episode & e = open[node];
+        printf("%u,%u,%u,%llu,", node, e.start, e.end, (unsigned long long)e.records);
+        if (dispColumn >= 0){
+            printValue(stdout, e.disp, t.info(dispColumn).scale);
+        }
+        printf("\n");
+        e.records = 0;
+    };
+    for (uint64_t i = r.lo; i < r.hi; i++){
+        uint16_t node = r.nodes ? r.nodes[i] : 0;
+        if (r.node >= 0 && node != r.node){
+            continue;
+        }
+        Episode & e = open[node];
+        if ((flags[i] & TELEMETRY_ALERT) == 0){
+            if (e.records){
+                close(node);
+            }
+            continue;
+        }
+        int64_t d = dispColumn >= 0 ? t.value(dispColumn, i) : 0;
+        if (e.records == 0){
+            e = { time[i], time[i], 0, d };
+        }
+        e.end = time[i];
+        e.records++;
+        e.disp = d > e.disp ? d : e.disp;
+    }
+    // still going at the end of the range
+    for (int n = 0; n < 65536; n++){
+        if (open[n].records){
+            close(n);
+        }
+    }
+    return true;
+}
+
+// Function to read a bucket size - seconds, or a number with m, h or d
+static uint32_t duration(const char * text){
+    char * unit;
+    double v = strtod(text, &unit);
+    return (uint32_t)(v * (*unit == 'm' ? 60 : *unit == 'h' ? 3600 : *unit == 'd' ? 86400 : 1));
+}
+
+static void usage(){
+    fprintf(stderr, "usage: telemetry_query <table> [--from t] [--to t] [--node n] info | scan [column...] |\n"
+                    "                       agg <column> <bucket> | alerts\n");
+    exit(2);
+}
+
+int main(int argc, char ** argv){
+    if (argc < 3){
+        usage();
+    }
+    ColumnStore table;
+    if (!table.open(argv[1])){
+        fprintf(stderr, "telemetry_query: %s isn't a telemetry table\n", argv[1]);
+        return 1;
+    }
+    int time = table.find("time");
+    if (time < 0 || table.info(time).type != COLUMN_U32){
+        fprintf(stderr, "telemetry_query: %s has no time column\n", argv[1]);
+        return 1;
+    }
+    uint32_t from = 0, to = 0xFFFFFFFF;
+    Range r;
+    int i = 2;
+    for (; i < argc && argv[i][0] == '-'; i++){
+        if (i + 1 >= argc) usage();
+        if      (!strcmp(argv[i], "--from")) from = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--to"))   to = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--node")) r.node = atoi(argv[++i]);
+        else usage();
+    }
+    if (i >= argc){
+        usage();
+    }
+    std::string query = argv[i++];
+
+    auto start = std::chrono::steady_clock::now();
+    const uint32_t * times = table.data<uint32_t>(time);
+    r.lo = std::lower_bound(times, times + table.rows(), from) - times;
+    r.hi = std::upper_bound(times, times + table.rows(), to) - times;
+    int node = table.find("node");
+    if (node >= 0 && table.info(node).type == COLUMN_U16){
+        r.nodes = table.data<uint16_t>(node);
+    } else if (r.node >= 0){
+        fprintf(stderr, "telemetry_query: %s has no node column\n", argv[1]);
+        return 1;
+    }
+
+    if (query == "info"){
+        info(table, r);
+    } else if (query == "scan"){
+        std::vector<int> columns;
+        for (; i < argc; i++){
+            if (table.find(argv[i]) < 0){
+                fprintf(stderr, "telemetry_query: no column %s\n", argv[i]);
+                return 1;
+            }
+            columns.push_back(table.find(argv[i]));
+        }
+        scan(table, r, columns);
+    } else if (query == "agg" && i + 2 == argc){
+        int column = table.find(argv[i]);
+        uint32_t size = duration(argv[i + 1]);
+        if (column < 0 || size == 0){
+            fprintf(stderr, "telemetry_query: no column %s, or bad bucket %s\n", argv[i], argv[i + 1]);
+            return 1;
+        }
+        agg(table, r, column, size);
+    } else if (query == "alerts"){
+        if (!alerts(table, r)){
+            return 1;
+        }
+    } else {
+        usage();
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu rows in range, %.2f ms\n", (unsigned long long)(r.hi - r.lo), ms);
+    return 0;
+}
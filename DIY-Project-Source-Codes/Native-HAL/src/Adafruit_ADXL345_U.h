@@ -0,0 +1,71 @@
+#pragma once
+#include <Adafruit_Sensor.h>
+#include "Hal.h"
+
+#define ADXL345_DEFAULT_ADDRESS 0x53
+#define ADXL345_REG_DEVID 0x00
+#define ADXL345_REG_THRESH_ACT 0x24
+#define ADXL345_REG_THRESH_INACT 0x25
+#define ADXL345_REG_TIME_INACT 0x26
+#define ADXL345_REG_ACT_INACT_CTL 0x27
+#define ADXL345_REG_BW_RATE 0x2C
+#define ADXL345_REG_POWER_CTL 0x2D
+#define ADXL345_REG_INT_ENABLE 0x2E
+#define ADXL345_REG_INT_MAP 0x2F
+#define ADXL345_REG_INT_SOURCE 0x30
+#define ADXL345_REG_DATA_FORMAT 0x31
+
+typedef enum {
+    ADXL345_RANGE_16_G = 0b11,
+    ADXL345_RANGE_8_G = 0b10,
+    ADXL345_RANGE_4_G = 0b01,
+    ADXL345_RANGE_2_G = 0b00
+} range_t;
+
+// ADXL345 for the native build, the readings are Hal.h's "accel.x" / "accel.y" / "accel.z" values (m/s^2).
+// The registers are plain memory, INT_SOURCE reads back whatever "accel.int_source" is set to.
+class Adafruit_ADXL345_Unified : public Adafruit_Sensor {
+public:
+    Adafruit_ADXL345_Unified(int32_t sensorID = -1) : id(sensorID) {}
+
+    bool begin(uint8_t = ADXL345_DEFAULT_ADDRESS) {
+        regs[ADXL345_REG_DEVID] = 0xE5;
+        return halValue("accel.present", 1) != 0;
+    }
+    void setRange(range_t range) { regs[ADXL345_REG_DATA_FORMAT] = (regs[ADXL345_REG_DATA_FORMAT] & ~3) | range; }
+    range_t getRange() { return (range_t)(regs[ADXL345_REG_DATA_FORMAT] & 3); }
+    uint8_t getDeviceID() { return regs[ADXL345_REG_DEVID]; }
+    void writeRegister(uint8_t reg, uint8_t value) { regs[reg & 0x3F] = value; }
+    uint8_t readRegister(uint8_t reg) {
+        if ((reg & 0x3F) == ADXL345_REG_INT_SOURCE) {
+            return (uint8_t)halValue("accel.int_source", 0);
+        }
+        return regs[reg & 0x3F];
+    }
+    int16_t getX() { return (int16_t)(halValue("accel.x", 0) / SENSORS_GRAVITY_STANDARD * 256); }
+    int16_t getY() { return (int16_t)(halValue("accel.y", 0) / SENSORS_GRAVITY_STANDARD * 256); }
+    int16_t getZ() { return (int16_t)(halValue("accel.z", SENSORS_GRAVITY_STANDARD) / SENSORS_GRAVITY_STANDARD * 256); }
+
+    bool getEvent(sensors_event_t * event) override {
+        memset(event, 0, sizeof(sensors_event_t));
+        event->version = sizeof(sensors_event_t);
+        event->sensor_id = id;
+        event->type = SENSOR_TYPE_ACCELEROMETER;
+        event->timestamp = millis();
+        event->acceleration.x = halValue("accel.x", 0);
+        event->acceleration.y = halValue("accel.y", 0);
+        event->acceleration.z = halValue("accel.z", SENSORS_GRAVITY_STANDARD);
+        return true;
+    }
+    void getSensor(sensor_t * sensor) override {
+        memset(sensor, 0, sizeof(sensor_t));
+        strncpy(sensor->name, "ADXL345", sizeof(sensor->name) - 1);
+        sensor->version = 1;
+        sensor->sensor_id = id;
+        sensor->type = SENSOR_TYPE_ACCELEROMETER;
+    }
+
+private:
+    int32_t id;
+    uint8_t regs[64] = { 0 };
+};
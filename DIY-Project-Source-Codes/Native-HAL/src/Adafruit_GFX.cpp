@@ -0,0 +1,37 @@
+#include "Adafruit_GFX.h"
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h, uint16_t color){
+    count();
+    int16_t rowBytes = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++){
+        for (int16_t i = 0; i < w; i++){
+            if (bitmap[j * rowBytes + i / 8] & (0x80 >> (i & 7))){
+                put(x + i, y + j, color);
+            }
+        }
+    }
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h, uint16_t color,
+                              uint16_t bg){
+    count();
+    int16_t rowBytes = (w + 7) / 8;
+    for (int16_t j = 0; j < h; j++){
+        for (int16_t i = 0; i < w; i++){
+            put(x + i, y + j, (bitmap[j * rowBytes + i / 8] & (0x80 >> (i & 7))) ? color : bg);
+        }
+    }
+}
+
+void Adafruit_GFX::getTextBounds(const char * str, int16_t x, int16_t y, int16_t * x1, int16_t * y1, uint16_t * w,
+                                 uint16_t * h){
+    *x1 = x;
+    *w = textWidth(str);
+    if (gfxFont){
+        *y1 = y - ascent();
+        *h = ascent();
+    } else {
+        *y1 = y;
+        *h = fontHeight();
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "HalCanvas.h"
+
+// Adafruit GFX for the native build, drawing into Hal.h's frame buffer
+class Adafruit_GFX : public HalCanvas {
+public:
+    Adafruit_GFX(int16_t w, int16_t h) : HalCanvas(w, h) {}
+
+    void setFont(const GFXfont * f = nullptr) { setFreeFont(f); }
+    void cp437(bool = true) {}
+    void invertDisplay(bool) {}
+
+    void startWrite() {}
+    void endWrite() {}
+    void writePixel(int16_t x, int16_t y, uint16_t color) { drawPixel(x, y, color); }
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) { fillRect(x, y, w, h, color); }
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { drawFastVLine(x, y, h, color); }
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { drawFastHLine(x, y, w, color); }
+    void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) { drawLine(x0, y0, x1, y1, color); }
+
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t * bitmap, int16_t w, int16_t h) {
+        image(x, y, w, h, bitmap, true, w);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h, uint16_t color);
+    void drawBitmap(int16_t x, int16_t y, const uint8_t * bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg);
+
+    void getTextBounds(const char * str, int16_t x, int16_t y, int16_t * x1, int16_t * y1, uint16_t * w, uint16_t * h);
+    void getTextBounds(const String & str, int16_t x, int16_t y, int16_t * x1, int16_t * y1, uint16_t * w, uint16_t * h) {
+        getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+    }
+};
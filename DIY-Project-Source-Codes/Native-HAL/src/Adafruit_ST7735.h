@@ -0,0 +1,57 @@
+#pragma once
+#include "Adafruit_GFX.h"
+
+#define INITR_GREENTAB 0x00
+#define INITR_REDTAB 0x01
+#define INITR_BLACKTAB 0x02
+#define INITR_18GREENTAB INITR_GREENTAB
+#define INITR_18REDTAB INITR_REDTAB
+#define INITR_18BLACKTAB INITR_BLACKTAB
+#define INITR_144GREENTAB 0x01
+#define INITR_MINI160x80 0x04
+#define INITR_HALLOWING 0x05
+
+#define ST7735_BLACK   0x0000
+#define ST7735_WHITE   0xFFFF
+#define ST7735_RED     0xF800
+#define ST7735_GREEN   0x07E0
+#define ST7735_BLUE    0x001F
+#define ST7735_CYAN    0x07FF
+#define ST7735_MAGENTA 0xF81F
+#define ST7735_YELLOW  0xFFE0
+#define ST7735_ORANGE  0xFC00
+#define ST77XX_BLACK   ST7735_BLACK
+#define ST77XX_WHITE   ST7735_WHITE
+#define ST77XX_RED     ST7735_RED
+#define ST77XX_GREEN   ST7735_GREEN
+#define ST77XX_BLUE    ST7735_BLUE
+#define ST77XX_CYAN    ST7735_CYAN
+#define ST77XX_MAGENTA ST7735_MAGENTA
+#define ST77XX_YELLOW  ST7735_YELLOW
+#define ST77XX_ORANGE  ST7735_ORANGE
+
+// 1.8" 128 x 160 ST7735 (1.44" 128 x 128, mini 80 x 160 by the initR() option)
+class Adafruit_ST7735 : public Adafruit_GFX {
+public:
+    Adafruit_ST7735(int8_t, int8_t, int8_t) : Adafruit_GFX(128, 160) {}
+    Adafruit_ST7735(int8_t, int8_t, int8_t, int8_t, int8_t) : Adafruit_GFX(128, 160) {}
+
+    void initB() { panel(128, 160); }
+    void initR(uint8_t options = INITR_GREENTAB) {
+        panel(options == INITR_144GREENTAB ? 128 : options == INITR_MINI160x80 ? 80 : 128,
+              options == INITR_144GREENTAB ? 128 : 160);
+        setRotation(0);
+    }
+
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) { window(x, y, w, h); }
+    void writePixels(uint16_t * colors, uint32_t len, bool = true, bool bigEndian = false) {
+        stream(colors, len, !bigEndian);
+    }
+    void writeColor(uint16_t color, uint32_t len) {
+        for (uint32_t i = 0; i < len; i++) stream(&color, 1, true);
+    }
+    void pushColor(uint16_t color) { stream(&color, 1, true); }
+    void enableDisplay(bool) {}
+    void enableSleep(bool) {}
+    void enableTearing(bool) {}
+};
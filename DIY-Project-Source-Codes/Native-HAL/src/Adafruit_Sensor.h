@@ -0,0 +1,56 @@
+#pragma once
+#include <Arduino.h>
+
+#define SENSORS_GRAVITY_STANDARD 9.80665F
+#define SENSORS_GRAVITY_EARTH SENSORS_GRAVITY_STANDARD
+
+typedef enum {
+    SENSOR_TYPE_ACCELEROMETER = 1,
+    SENSOR_TYPE_TEMPERATURE = 13,
+    SENSOR_TYPE_RELATIVE_HUMIDITY = 12,
+} sensors_type_t;
+
+typedef struct {
+    union {
+        float v[3];
+        struct {
+            float x;
+            float y;
+            float z;
+        };
+    };
+    int8_t status;
+    uint8_t reserved[3];
+} sensors_vec_t;
+
+typedef struct {
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    int32_t reserved0;
+    int32_t timestamp;
+    union {
+        float data[4];
+        sensors_vec_t acceleration;
+        float temperature;
+        float relative_humidity;
+    };
+} sensors_event_t;
+
+typedef struct {
+    char name[12];
+    int32_t version;
+    int32_t sensor_id;
+    int32_t type;
+    float max_value;
+    float min_value;
+    float resolution;
+    int32_t min_delay;
+} sensor_t;
+
+class Adafruit_Sensor {
+public:
+    virtual ~Adafruit_Sensor() {}
+    virtual bool getEvent(sensors_event_t *) = 0;
+    virtual void getSensor(sensor_t *) = 0;
+};
@@ -0,0 +1,135 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdarg.h>
+#include <math.h>
+
+#include <avr/pgmspace.h>
+#include <avr/interrupt.h>
+
+/*
+Arduino core API for the native (PC) build, see Hal.h. Pin names are the union
+of the three boards' (Mega 2560, NodeMCU, Wio Terminal), they only have to be
+distinct here.
+ */
+
+#define ARDUINO 10819
+#define ARDUINO_ARCH_NATIVE
+
+typedef uint8_t byte;
+typedef bool boolean;
+typedef uint16_t word;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define INPUT_PULLDOWN 0x3
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define PI 3.1415926535897932384626433832795
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define _BV(bit) (1 << (bit))
+#define bit(b) (1UL << (b))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+
+#define D0 0
+#define D1 1
+#define D2 2
+#define D3 3
+#define D4 4
+#define D5 5
+#define D6 6
+#define D7 7
+#define D8 8
+#define PIN_D4 D4
+#define LED_BUILTIN 13
+#define A0 54
+#define A1 55
+#define A2 56
+#define A3 57
+#define A4 58
+#define A5 59
+#define WIO_KEY_A 70
+#define WIO_KEY_B 71
+#define WIO_KEY_C 72
+#define WIO_5S_UP 73
+#define WIO_5S_DOWN 74
+#define WIO_5S_LEFT 75
+#define WIO_5S_RIGHT 76
+#define WIO_5S_PRESS 77
+#define WIO_BUZZER 78
+#define LCD_BACKLIGHT 79
+#define SDCARD_SS_PIN 80
+#define HAL_PINS 96
+
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(p) ((p) < HAL_PINS ? (int)(p) : NOT_AN_INTERRUPT)
+
+#ifdef __cplusplus
+
+#include <algorithm>
+
+// Templates rather than the AVR core's macros, so standard headers can still be included after Arduino.h
+template<class T, class L>
+auto min(const T & a, const L & b) -> decltype((b < a) ? b : a){
+    return (b < a) ? b : a;
+}
+
+template<class T, class L>
+auto max(const T & a, const L & b) -> decltype((b < a) ? b : a){
+    return (a < b) ? b : a;
+}
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x) * (x))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+void analogReference(uint8_t mode);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+char * dtostrf(double val, signed char width, unsigned char prec, char * sout);
+char * ltoa(long value, char * string, int radix);
+char * ultoa(unsigned long value, char * string, int radix);
+char * itoa(int value, char * string, int radix);
+char * utoa(unsigned int value, char * string, int radix);
+
+#include "WString.h"
+#include "HardwareSerial.h"
+
+// The sketch
+void setup(void);
+void loop(void);
+
+#endif
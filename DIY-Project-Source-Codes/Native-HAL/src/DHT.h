@@ -0,0 +1,28 @@
+#pragma once
+#include <Arduino.h>
+#include "Hal.h"
+
+#define DHT11 11
+#define DHT12 12
+#define DHT21 21
+#define DHT22 22
+#define AM2301 21
+
+// DHT sensor for the native build, the readings are Hal.h's "dht.humidity" / "dht.temperature" values
+class DHT {
+public:
+    DHT(uint8_t, uint8_t, uint8_t = 6) {}
+
+    void begin(uint8_t = 55) {}
+    float readTemperature(bool S = false, bool = false) {
+        float c = halValue("dht.temperature", 25.0f);
+        return S ? c * 1.8f + 32 : c;
+    }
+    float readHumidity(bool = false) { return halValue("dht.humidity", 60.0f); }
+    float convertCtoF(float c) { return c * 1.8f + 32; }
+    float convertFtoC(float f) { return (f - 32) * 0.55555f; }
+    float computeHeatIndex(float temperature, float, bool = true) {
+        return temperature;
+    }
+    bool read(bool = false) { return true; }
+};
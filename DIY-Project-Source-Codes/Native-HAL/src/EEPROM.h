@@ -0,0 +1,35 @@
+#pragma once
+#include <Arduino.h>
+#include <avr/io.h>
+
+// EEPROM for the native build, E2END + 1 bytes, erased (0xFF) or loaded from halEepromFile()
+class EEPROMClass {
+public:
+    uint8_t read(int idx);
+    void write(int idx, uint8_t val);
+    void update(int idx, uint8_t val) {
+        if (read(idx) != val) write(idx, val);
+    }
+    uint16_t length() { return E2END + 1; }
+
+    template<typename T>
+    T & get(int idx, T & t) {
+        uint8_t * p = (uint8_t *)&t;
+        for (size_t i = 0; i < sizeof(T); i++) p[i] = read(idx + i);
+        return t;
+    }
+
+    template<typename T>
+    const T & put(int idx, const T & t) {
+        const uint8_t * p = (const uint8_t *)&t;
+        for (size_t i = 0; i < sizeof(T); i++) update(idx + i, p[i]);
+        return t;
+    }
+
+    // ESP8266 / SAMD emulated EEPROM
+    void begin(size_t) {}
+    bool commit() { return true; }
+    void end() {}
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,341 @@
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+
+#include "Arduino.h"
+#include "HalInternal.h"
+
+// ---- clock
+
+static bool realClock = false;
+static uint32_t tickUs = 10;
+static uint64_t simUs = 0;
+static uint64_t sleptUs = 0;
+static const auto bootTime = std::chrono::steady_clock::now();
+static std::multimap<uint64_t, std::function<void()>> events;
+static bool inEvents = false;
+
+void halClockReal(bool real){
+    realClock = real;
+}
+
+bool halClockIsReal(){
+    return realClock;
+}
+
+void halSetTick(uint32_t us){
+    tickUs = us;
+}
+
+uint64_t halWallMicros(){
+    if (realClock){
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+    }
+    return simUs;
+}
+
+// Function to run the halAt() events that are due, in time order
+static void runEvents(){
+    if (inEvents){
+        return;
+    }
+    inEvents = true;
+    uint64_t now = halWallMicros();
+    while (!events.empty() && events.begin()->first <= now){
+        std::function<void()> fn = std::move(events.begin()->second);
+        events.erase(events.begin());
+        fn();
+    }
+    inEvents = false;
+}
+
+void halAdvance(uint64_t us){
+    if (realClock){
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    } else {
+        simUs += us;
+    }
+    runEvents();
+}
+
+void halTick(){
+    if (!realClock){
+        simUs += tickUs;
+    }
+    runEvents();
+}
+
+void halAddSlept(uint64_t us){
+    sleptUs += us;
+}
+
+uint64_t halNextEventMicros(){
+    return events.empty() ? UINT64_MAX : events.begin()->first;
+}
+
+void halAtMicros(uint64_t us, std::function<void()> fn){
+    events.emplace(us, std::move(fn));
+}
+
+void halAt(uint64_t ms, std::function<void()> fn){
+    halAtMicros(ms * 1000, std::move(fn));
+}
+
+unsigned long millis(){
+    halTick();
+    return (unsigned long)((halWallMicros() - sleptUs) / 1000);
+}
+
+unsigned long micros(){
+    halTick();
+    return (unsigned long)(halWallMicros() - sleptUs);
+}
+
+void delay(unsigned long ms){
+    halAdvance((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us){
+    halAdvance(us);
+}
+
+void yield(){
+    halTick();
+}
+
+// ---- pins and interrupts
+
+static int pinLevel[HAL_PINS];
+static bool pinDriven[HAL_PINS];
+static int analogValue[HAL_PINS];
+static void (*pinIsr[HAL_PINS])(void);
+static int pinIsrMode[HAL_PINS];
+static bool irqEnabled = true;
+static std::vector<uint8_t> irqPending;
+static uint64_t irqCount = 0;
+
+uint64_t halInterruptCount(){
+    return irqCount;
+}
+
+static bool validPin(uint8_t pin){
+    return pin < HAL_PINS;
+}
+
+void pinMode(uint8_t pin, uint8_t mode){
+    if (validPin(pin) && mode == INPUT_PULLUP && !pinDriven[pin]){
+        pinLevel[pin] = HIGH;
+    }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val){
+    if (validPin(pin)){
+        pinLevel[pin] = val ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t pin){
+    return validPin(pin) ? pinLevel[pin] : LOW;
+}
+
+int analogRead(uint8_t pin){
+    halTick();
+    return validPin(pin) ? analogValue[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int val){
+    if (validPin(pin)){
+        analogValue[pin] = val;
+    }
+}
+
+void analogReference(uint8_t){
+}
+
+void halPinSet(uint8_t pin, int level){
+    if (!validPin(pin)){
+        return;
+    }
+    int from = pinLevel[pin];
+    pinLevel[pin] = level ? HIGH : LOW;
+    pinDriven[pin] = true;
+    halPinEdge(pin, from, pinLevel[pin]);
+}
+
+int halPinGet(uint8_t pin){
+    return digitalRead(pin);
+}
+
+void halAnalogSet(uint8_t pin, int value){
+    if (validPin(pin)){
+        analogValue[pin] = value;
+    }
+}
+
+void halPinEdge(uint8_t pin, int from, int to){
+    if (!validPin(pin) || pinIsr[pin] == nullptr){
+        return;
+    }
+    int mode = pinIsrMode[pin];
+    bool fire = (mode == LOW && to == LOW) || (mode == CHANGE && from != to) ||
+                (mode == RISING && from == LOW && to == HIGH) || (mode == FALLING && from == HIGH && to == LOW);
+    if (!fire){
+        return;
+    }
+    if (!irqEnabled){
+        irqPending.push_back(pin);
+        return;
+    }
+    irqCount++;
+    pinIsr[pin]();
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode){
+    if (!validPin(interruptNum)){
+        return;
+    }
+    pinIsr[interruptNum] = userFunc;
+    pinIsrMode[interruptNum] = mode;
+    // a LOW level interrupt fires straight away while the line is held low
+    if (mode == LOW && pinLevel[interruptNum] == LOW){
+        halPinEdge(interruptNum, LOW, LOW);
+    }
+}
+
+void detachInterrupt(uint8_t interruptNum){
+    if (validPin(interruptNum)){
+        pinIsr[interruptNum] = nullptr;
+    }
+}
+
+void cli(void){
+    irqEnabled = false;
+}
+
+void sei(void){
+    irqEnabled = true;
+    std::vector<uint8_t> pending;
+    pending.swap(irqPending);
+    for (uint8_t pin : pending){
+        if (pinIsr[pin]){
+            irqCount++;
+            pinIsr[pin]();
+        }
+    }
+}
+
+void noInterrupts(void){
+    cli();
+}
+
+void interrupts(void){
+    sei();
+}
+
+// ---- sensor values
+
+static std::map<std::string, float> & values(){
+    static std::map<std::string, float> v;
+    return v;
+}
+
+void halValueSet(const char * name, float value){
+    values()[name] = value;
+}
+
+float halValue(const char * name, float fallback){
+    auto it = values().find(name);
+    return it == values().end() ? fallback : it->second;
+}
+
+// ---- random numbers, the same sequence on every run unless randomSeed() changes it
+
+static uint32_t rngState = 0x2545F491;
+
+static uint32_t rngNext(){
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+void randomSeed(unsigned long seed){
+    if (seed != 0){
+        rngState = (uint32_t)seed;
+    }
+}
+
+long random(long howbig){
+    return howbig <= 0 ? 0 : (long)(rngNext() % (uint32_t)howbig);
+}
+
+long random(long howsmall, long howbig){
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max){
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// ---- number formatting the AVR libc has and glibc doesn't
+
+char * dtostrf(double val, signed char width, unsigned char prec, char * sout){
+    sprintf(sout, "%*.*f", width, prec, val);
+    return sout;
+}
+
+char * ultoa(unsigned long value, char * string, int radix){
+    char buf[8 * sizeof(long) + 1];
+    char * p = &buf[sizeof(buf) - 1];
+    *p = 0;
+    if (radix < 2 || radix > 36) radix = 10;
+    do {
+        int d = value % radix;
+        *--p = d < 10 ? '0' + d : 'a' + d - 10;
+        value /= radix;
+    } while (value);
+    return strcpy(string, p);
+}
+
+char * ltoa(long value, char * string, int radix){
+    if (value < 0 && radix == 10){
+        string[0] = '-';
+        ultoa(0UL - (unsigned long)value, string + 1, radix);
+        return string;
+    }
+    return ultoa((unsigned long)value, string, radix);
+}
+
+char * utoa(unsigned int value, char * string, int radix){
+    return ultoa(value, string, radix);
+}
+
+char * itoa(int value, char * string, int radix){
+    if (radix != 10){
+        return ultoa((unsigned int)value, string, radix);
+    }
+    return ltoa(value, string, radix);
+}
+
+// ---- running
+
+static volatile bool running = false;
+static uint32_t loopUs = 1000;
+
+void halSetLoopStep(uint32_t us){
+    loopUs = us;
+}
+
+void halRun(uint64_t ms){
+    running = true;
+    setup();
+    while (running && (ms == 0 || halWallMicros() < ms * 1000)){
+        loop();
+        halAdvance(realClock ? 100 : loopUs);   // a nap keeps a real time run off 100% CPU
+    }
+}
+
+void halStop(){
+    running = false;
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <functional>
+#include <string>
+
+/*
+Native-HAL - runs the Sensor, Gateway and End Node sketches on the PC (PlatformIO
+"native" env) without changing them. It stands in for the Arduino core and the
+board libraries they use: UARTs, millis()/delay(), GPIO/ADC/interrupts, the
+displays, DHT22, ADXL345, EEPROM and the sd card.
+
+The clock is simulated by default: delay() returns at once and moves the time
+on, and every millis()/micros()/yield()/available() call moves it on by a small
+tick, so busy-wait timeouts end too. Runs are deterministic and much faster than
+real time. Use the real clock when a UART is on a pty served by Host-Tools/e5emu,
+which answers in real time.
+
+Everything here is for harnesses and the default main() (see HalMain.cpp),
+the sketches only use the Arduino API.
+
+USAGE:
+
+    halUartOpen("Serial1", "/tmp/e5/sensor");   // UART on a pty / serial port / fifo
+    halUartOnWrite("Serial1", [](uint8_t c){ ... });  // or answer it in-process
+    halAt(60000, []{ halPinSet(2, LOW); });     // inject an input 60 s after boot
+    halUartReplay("Serial1", "AT000.BIN");      // or play the module's side from a captured trace
+    halRun(3600000);                            // setup(), then loop() for 1 simulated hour
+    halDisplayDump("screen.ppm");
+ */
+
+// ---- clock
+
+// Simulated (default) or real time
+void halClockReal(bool real);
+bool halClockIsReal();
+
+// Time moved on by every millis()/micros()/yield()/available() call, microseconds (default 10)
+void halSetTick(uint32_t us);
+
+// Microseconds since boot, including the time spent in sleep_cpu() (millis() is frozen there, like on the AVR)
+uint64_t halWallMicros();
+
+// Moves the simulated clock on (sleeps in real time mode), running the halAt() events that fall due
+void halAdvance(uint64_t us);
+
+// Runs fn once halWallMicros() reaches ms milliseconds
+void halAt(uint64_t ms, std::function<void()> fn);
+
+// ---- pins
+
+// Drives an input pin, firing the interrupt attached to it on a matching edge or level
+void halPinSet(uint8_t pin, int level);
+
+// Level the sketch last wrote to a pin (or the one injected)
+int halPinGet(uint8_t pin);
+
+// Value analogRead() returns for a pin, 0..1023
+void halAnalogSet(uint8_t pin, int value);
+
+// ---- sensors, by name: "dht.humidity", "dht.temperature", "accel.x", "accel.y", "accel.z" (m/s^2)
+
+void halValueSet(const char * name, float value);
+float halValue(const char * name, float fallback);
+
+// ---- UARTs, by the name of their object: "Serial" ... "Serial3", "SoftwareSerial"
+
+// Connects a UART to a serial port, pty or fifo (opened read/write, non-blocking)
+bool halUartOpen(const char * name, const char * path);
+
+// Called for every byte the sketch writes to a UART
+void halUartOnWrite(const char * name, std::function<void(uint8_t)> fn);
+
+// Queues bytes for the sketch to read
+void halUartFeed(const char * name, const void * data, size_t len);
+
+// Bytes the sketch wrote to a UART that has no pty and no handler (Serial goes to stdout instead), emptied
+std::string halUartTake(const char * name);
+
+// ---- AT traffic replay, of a trace captured on a board (the nodes' AtTrace.h)
+
+struct HalReplayStats {
+    uint64_t records;       // trace records played
+    uint64_t rxBytes;       // module bytes fed to the sketch
+    uint64_t txLines;       // lines the sketch wrote to the module
+    uint64_t txDiffers;     // of them, the ones not as in the trace (or missing)
+    std::string expected;   // the first line that differs, as in the trace
+    std::string actual;     // and as the sketch wrote it
+    bool done;              // the whole trace was played
+};
+
+// Plays a trace into a UART: every batch of module bytes is fed once the sketch has written the command
+// lines that came before it, the recorded time after the previous record. Without originalTiming
+// waits are cut to 50 ms (gaps in the trace keep their time). halStop() a couple of seconds after
+// the last record with stopAtEnd
+bool halUartReplay(const char * name, const char * path, bool originalTiming = true, bool stopAtEnd = true);
+const HalReplayStats & halReplayStats();
+
+// ---- storage
+
+// File the EEPROM contents are loaded from and written back to (default none, starts erased)
+void halEepromFile(const char * path);
+
+// Folder that stands in for the sd card (default "sd")
+void halSdRoot(const char * path);
+const char * halSdPath();
+
+// ---- display, every TFT_eSPI / Adafruit_GFX screen draws into one RGB565 frame buffer
+
+struct HalDisplayStats {
+    uint64_t calls;         // drawing calls
+    uint64_t pixels;        // pixels written to the screen
+};
+
+const HalDisplayStats & halDisplayStats();
+
+// Writes the screen to a binary PPM
+bool halDisplayDump(const char * path);
+
+// ---- running
+
+// Simulated time each loop() call takes on top of what it spends itself, microseconds (default 1000)
+void halSetLoopStep(uint32_t us);
+
+// Calls setup(), then loop() until ms milliseconds of wall time have passed (0 = until halStop())
+void halRun(uint64_t ms);
+void halStop();
@@ -0,0 +1,68 @@
+#include "Arduino.h"
+#include <avr/io.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+
+#include "HalInternal.h"
+
+volatile uint8_t MCUSR = 0, WDTCSR = 0, ADCSRA = _BV(ADEN);
+
+// The sketch's watchdog interrupt, if it has one
+extern "C" void WDT_vect(void) __attribute__((weak));
+
+static bool sleepEnabled = false;
+
+void set_sleep_mode(int){
+}
+
+void sleep_enable(void){
+    sleepEnabled = true;
+}
+
+void sleep_disable(void){
+    sleepEnabled = false;
+}
+
+// Function to sleep until the watchdog fires (16 ms << WDP3..0), or a pin interrupt wakes the MCU earlier.
+// millis() is frozen meanwhile, like Timer0 in POWER_DOWN, the halAt() events still run on wall time.
+void sleep_cpu(void){
+    if (!sleepEnabled){
+        return;
+    }
+    uint64_t woken = halInterruptCount();
+    // a level interrupt that is already asserted wakes the MCU straight away
+    for (uint8_t pin = 0; pin < HAL_PINS; pin++){
+        halPinEdge(pin, digitalRead(pin), digitalRead(pin));
+    }
+    if (halInterruptCount() != woken || (WDTCSR & _BV(WDIE)) == 0){
+        return;
+    }
+    uint8_t prescaler = (WDTCSR & 0x07) | ((WDTCSR & _BV(WDP3)) ? 0x08 : 0);
+    uint64_t start = halWallMicros(), end = start + (16000ULL << prescaler);
+    // up to each injected event in turn, it may pull an interrupt line
+    while (halInterruptCount() == woken && halWallMicros() < end){
+        uint64_t now = halWallMicros(), next = halNextEventMicros();
+        halAdvance((next > now && next < end ? next : end) - now);
+    }
+    halAddSlept(halWallMicros() - start);
+    if (halInterruptCount() == woken && WDT_vect){
+        WDT_vect();
+    }
+}
+
+void sleep_mode(void){
+    sleep_enable();
+    sleep_cpu();
+    sleep_disable();
+}
+
+void wdt_enable(uint8_t timeout){
+    WDTCSR = _BV(WDE) | (timeout & 0x07) | ((timeout & 0x08) ? _BV(WDP3) : 0);
+}
+
+void wdt_disable(void){
+    WDTCSR = 0;
+}
+
+void wdt_reset(void){
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "Arduino.h"
+#include "gfxfont.h"
+
+struct HalSurface;
+
+// Text datums (TFT_eSPI)
+#define TL_DATUM 0
+#define TC_DATUM 1
+#define TR_DATUM 2
+#define ML_DATUM 3
+#define CL_DATUM 3
+#define MC_DATUM 4
+#define CC_DATUM 4
+#define MR_DATUM 5
+#define CR_DATUM 5
+#define BL_DATUM 6
+#define BC_DATUM 7
+#define BR_DATUM 8
+#define L_BASELINE 9
+#define C_BASELINE 10
+#define R_BASELINE 11
+
+/*
+Drawing and text for the native display classes (TFT_eSPI, TFT_eSprite,
+Adafruit_GFX). A screen draws into the shared frame buffer Hal.h dumps, a
+sprite into its own. Glyphs are 3x5 pixel blocks stretched to the cell of the
+selected font, so layouts and redraw traffic match the boards, not the looks.
+ */
+class HalCanvas : public Print {
+    friend class TFT_eSprite;
+
+public:
+    HalCanvas(int16_t w, int16_t h);
+    virtual ~HalCanvas();
+
+    size_t write(uint8_t c) override;
+    using Print::write;
+
+    void setRotation(uint8_t r);
+    uint8_t getRotation() const { return rotation; }
+    int16_t width() const;
+    int16_t height() const;
+
+    void fillScreen(uint32_t color);
+    void fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color);
+    void drawPixel(int32_t x, int32_t y, uint32_t color);
+    void drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color);
+    void drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color);
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color);
+    void drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color);
+    void drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    void fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t r, uint32_t color);
+    uint16_t readPixel(int32_t x, int32_t y);
+
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+    void setCursor(int16_t x, int16_t y, uint8_t font) { setTextFont(font); setCursor(x, y); }
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+    void setTextColor(uint16_t c) { textFg = textBg = c; }
+    void setTextColor(uint16_t c, uint16_t b, bool = false) { textFg = c; textBg = b; }
+    void setTextSize(uint8_t s) { textSize = s ? s : 1; }
+    void setTextWrap(bool wrapX, bool = false) { wrap = wrapX; }
+    void setTextFont(uint8_t font) { textFont = font; gfxFont = nullptr; }
+    void setFreeFont(const GFXfont * f = nullptr) { gfxFont = f; if (!f) textFont = 1; }
+    void setTextDatum(uint8_t d) { datum = d; }
+    uint8_t getTextDatum() const { return datum; }
+    void setTextPadding(uint16_t px) { padding = px; }
+
+    int16_t textWidth(const char * s);
+    int16_t textWidth(const String & s) { return textWidth(s.c_str()); }
+    int16_t fontHeight();
+    int16_t fontHeight(int16_t font);
+    int16_t drawString(const char * s, int32_t x, int32_t y);
+    int16_t drawString(const String & s, int32_t x, int32_t y) { return drawString(s.c_str(), x, y); }
+    int16_t drawCentreString(const char * s, int32_t x, int32_t y, uint8_t font);
+    int16_t drawNumber(long n, int32_t x, int32_t y);
+    int16_t drawFloat(float f, uint8_t dp, int32_t x, int32_t y);
+    int16_t drawChar(uint16_t c, int32_t x, int32_t y);
+
+    void setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum = true);
+    void resetViewport();
+
+    static uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+        return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    }
+
+protected:
+    HalSurface * surface;       // the screen, or a sprite's own pixels
+    bool isScreen;
+    int16_t w0, h0;             // panel size at rotation 0
+    uint8_t rotation = 0;
+    int16_t cursorX = 0, cursorY = 0;
+    uint16_t textFg = 0xFFFF, textBg = 0xFFFF;
+    uint8_t textSize = 1;
+    uint8_t textFont = 1;
+    const GFXfont * gfxFont = nullptr;
+    bool wrap = true;
+    uint8_t datum = TL_DATUM;
+    uint16_t padding = 0;
+    int32_t vpX = 0, vpY = 0, vpW = 0, vpH = 0;
+    bool vpOffset = false;
+    // address window of the streaming calls (setAddrWindow + pushColors ...)
+    int32_t winX = 0, winY = 0, winW = 0, winH = 0, winPos = 0;
+
+    void attach(HalSurface * s, bool screen);
+    void panel(int32_t w, int32_t h);
+    void window(int32_t x, int32_t y, int32_t w, int32_t h);
+    // native = the data holds RGB565 values, else they are byte swapped (SPI byte order)
+    void stream(const uint16_t * colors, uint32_t len, bool native);
+    void image(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * data, bool native, int32_t stride,
+               bool transparent = false, uint16_t key = 0);
+    void put(int32_t x, int32_t y, uint16_t color);
+    void count();
+    int32_t glyphBox(uint8_t font, int32_t * cellW, int32_t * cellH) const;
+    int32_t ascent() const;
+    int32_t drawGlyph(char c, int32_t x, int32_t y, bool fillBg);
+};
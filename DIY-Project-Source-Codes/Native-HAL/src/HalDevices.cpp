@@ -0,0 +1,67 @@
+#include <string>
+
+#include "Arduino.h"
+#include "EEPROM.h"
+#include "SPI.h"
+#include "Wire.h"
+#include "HalInternal.h"
+
+SPIClass SPI;
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+static uint8_t eeprom[E2END + 1];
+static bool eepromLoaded = false;
+static std::string eepromPath;
+
+void halEepromFile(const char * path){
+    eepromPath = path;
+    eepromLoaded = false;
+}
+
+// Function to load the EEPROM contents on first use, erased when there is no file (yet)
+static void eepromLoad(){
+    if (eepromLoaded){
+        return;
+    }
+    eepromLoaded = true;
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    if (!eepromPath.empty()){
+        FILE * f = fopen(eepromPath.c_str(), "rb");
+        if (f){
+            size_t n = fread(eeprom, 1, sizeof(eeprom), f);
+            (void)n;
+            fclose(f);
+        }
+    }
+}
+
+uint8_t EEPROMClass::read(int idx){
+    eepromLoad();
+    return (idx >= 0 && idx <= E2END) ? eeprom[idx] : 0xFF;
+}
+
+// Function to write one cell, written through to the file so a killed run keeps it like the chip would
+void EEPROMClass::write(int idx, uint8_t val){
+    eepromLoad();
+    if (idx < 0 || idx > E2END){
+        return;
+    }
+    eeprom[idx] = val;
+    halAdvance(3300);     // 3.3 ms erase + write
+    if (!eepromPath.empty()){
+        FILE * f = fopen(eepromPath.c_str(), "r+b");
+        if (f == nullptr){
+            f = fopen(eepromPath.c_str(), "w+b");
+            if (f){
+                fwrite(eeprom, 1, sizeof(eeprom), f);
+            }
+        } else {
+            fseek(f, idx, SEEK_SET);
+            fputc(val, f);
+        }
+        if (f){
+            fclose(f);
+        }
+    }
+}
@@ -0,0 +1,526 @@
+#include "Arduino.h"
+#include "HalCanvas.h"
+#include "HalInternal.h"
+
+// ---- frame buffer
+
+void HalSurface::resize(int w, int h){
+    width = w;
+    height = h;
+    pixels.assign((size_t)w * h, 0);
+}
+
+void HalSurface::fill(int x, int y, int w, int h, uint16_t color){
+    for (int j = y; j < y + h; j++){
+        for (int i = x; i < x + w; i++){
+            pixel(i, j, color);
+        }
+    }
+}
+
+static HalSurface screen;
+static uint8_t screenRotation = 0;
+static HalDisplayStats stats = { 0, 0 };
+
+HalSurface & halScreen(){
+    return screen;
+}
+
+void halDisplayCount(uint64_t calls, uint64_t pixels){
+    stats.calls += calls;
+    stats.pixels += pixels;
+}
+
+const HalDisplayStats & halDisplayStats(){
+    return stats;
+}
+
+// Function to map a pixel of the rotated screen to the panel
+static void rotate(uint8_t r, int w0, int h0, int32_t & x, int32_t & y){
+    int32_t lx = x, ly = y;
+    switch (r & 3){
+        case 1: x = w0 - 1 - ly; y = lx;          break;
+        case 2: x = w0 - 1 - lx; y = h0 - 1 - ly; break;
+        case 3: x = ly;          y = h0 - 1 - lx; break;
+    }
+}
+
+bool halDisplayDump(const char * path){
+    if (screen.width == 0){
+        return false;
+    }
+    FILE * f = fopen(path, "wb");
+    if (!f){
+        return false;
+    }
+    bool turned = screenRotation & 1;
+    int w = turned ? screen.height : screen.width, h = turned ? screen.width : screen.height;
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    for (int32_t y = 0; y < h; y++){
+        for (int32_t x = 0; x < w; x++){
+            int32_t px = x, py = y;
+            rotate(screenRotation, screen.width, screen.height, px, py);
+            uint16_t c = screen.get(px, py);
+            uint8_t rgb[3] = { (uint8_t)(((c >> 11) & 0x1F) * 255 / 31), (uint8_t)(((c >> 5) & 0x3F) * 255 / 63),
+                               (uint8_t)((c & 0x1F) * 255 / 31) };
+            fwrite(rgb, 1, 3, f);
+        }
+    }
+    return fclose(f) == 0;
+}
+
+// ---- glyphs
+
+// 3x5 pixel ASCII glyphs 0x20..0x7E, lower case drawn as upper case
+static const uint16_t glyphs[] = {
+    0x0000, 0x2482, 0x5A00, 0x5F7D, 0x3C9E, 0x42A1, 0x2AAB, 0x2400,   //  !"#$%&'
+    0x1491, 0x4494, 0x0AA8, 0x05D0, 0x0014, 0x01C0, 0x0002, 0x12A4,   // ()*+,-./
+    0x7B6F, 0x2C97, 0x73E7, 0x72CF, 0x5BC9, 0x79CF, 0x79EF, 0x7252,   // 01234567
+    0x7BEF, 0x7BCF, 0x0410, 0x0414, 0x1511, 0x0E38, 0x4454, 0x72C2,   // 89:;<=>?
+    0x7BE7, 0x2BED, 0x6BAE, 0x3923, 0x6B6E, 0x79A7, 0x79A4, 0x396B,   // @ABCDEFG
+    0x5BED, 0x7497, 0x126A, 0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A,   // HIJKLMNO
+    0x6BA4, 0x2B73, 0x6BAD, 0x388E, 0x7492, 0x5B6F, 0x5B6A, 0x5BFD,   // PQRSTUVW
+    0x5AAD, 0x5A92, 0x72A7, 0x6926, 0x4889, 0x324B, 0x2A00, 0x0007,   // XYZ[\]^_
+    0x4400, 0x3593, 0x2492, 0x64D6, 0x0CC0,                           // `{|}~
+};
+
+uint16_t halGlyph(char c){
+    uint8_t u = (uint8_t)c;
+    if (u >= 'a' && u <= 'z'){
+        u -= 'a' - 'A';
+    } else if (u >= '{' && u <= '~'){
+        u -= '{' - 0x61;
+    }
+    return (u >= 0x20 && u <= 0x64) ? glyphs[u - 0x20] : 0x7FFF;
+}
+
+// ---- free fonts, the 3x5 glyphs scaled by 2 (9pt) .. 5 (24pt)
+
+#define FONT_SCALES 4
+#define FONT_GLYPHS (0x7E - 0x20 + 1)
+#define FONT_BYTES (FONT_GLYPHS * 48)
+
+static uint8_t fontBits[FONT_SCALES][FONT_BYTES];
+static GFXglyph fontGlyphs[FONT_SCALES][FONT_GLYPHS];
+
+// Function to render the glyphs at one scale into the packed GFXfont layout
+static void buildFont(int scale, uint8_t * bits, GFXglyph * out){
+    uint32_t bit = 0;
+    for (int g = 0; g < FONT_GLYPHS; g++){
+        uint16_t art = halGlyph((char)(0x20 + g));
+        bit = (bit + 7) & ~7u;
+        out[g] = { (uint16_t)(bit / 8), (uint8_t)(3 * scale), (uint8_t)(5 * scale), (uint8_t)(4 * scale), 0,
+                   (int8_t)(-5 * scale) };
+        for (int y = 0; y < 5 * scale; y++){
+            for (int x = 0; x < 3 * scale; x++, bit++){
+                if (art & (0x4000 >> ((y / scale) * 3 + x / scale))){
+                    bits[bit / 8] |= 0x80 >> (bit % 8);
+                }
+            }
+        }
+    }
+}
+
+static struct FontBuilder {
+    FontBuilder(){
+        for (int s = 0; s < FONT_SCALES; s++){
+            buildFont(s + 2, fontBits[s], fontGlyphs[s]);
+        }
+    }
+} fontBuilder;
+
+#define HAL_FONT(name, s, yAdvance) const GFXfont name = { fontBits[s], fontGlyphs[s], 0x20, 0x7E, yAdvance };
+#define HAL_FONT_FAMILY(family) \
+    HAL_FONT(family##9pt7b, 0, 22) HAL_FONT(family##12pt7b, 1, 29) HAL_FONT(family##18pt7b, 2, 42) \
+    HAL_FONT(family##24pt7b, 3, 56)
+
+HAL_FONT_FAMILY(FreeMono)
+HAL_FONT_FAMILY(FreeMonoBold)
+HAL_FONT_FAMILY(FreeSans)
+HAL_FONT_FAMILY(FreeSansBold)
+HAL_FONT_FAMILY(FreeSerif)
+HAL_FONT_FAMILY(FreeSerifBold)
+
+// ---- canvas
+
+HalCanvas::HalCanvas(int16_t w, int16_t h) : surface(&screen), isScreen(true), w0(w), h0(h){
+}
+
+HalCanvas::~HalCanvas(){
+}
+
+void HalCanvas::attach(HalSurface * s, bool isPanel){
+    surface = s;
+    isScreen = isPanel;
+}
+
+// Function to size the panel, the screen frame buffer follows the last display begun
+void HalCanvas::panel(int32_t w, int32_t h){
+    w0 = w;
+    h0 = h;
+    if (isScreen && (screen.width != w || screen.height != h)){
+        screen.resize(w, h);
+    }
+}
+
+void HalCanvas::count(){
+    if (isScreen){
+        halDisplayCount(1, 0);
+    }
+}
+
+void HalCanvas::setRotation(uint8_t r){
+    rotation = r & 3;
+    if (isScreen){
+        screenRotation = rotation;
+    }
+    resetViewport();
+}
+
+int16_t HalCanvas::width() const {
+    if (vpW > 0 && vpOffset){
+        return vpW;
+    }
+    return (rotation & 1) ? h0 : w0;
+}
+
+int16_t HalCanvas::height() const {
+    if (vpW > 0 && vpOffset){
+        return vpH;
+    }
+    return (rotation & 1) ? w0 : h0;
+}
+
+// Function to write one pixel, x / y relative to the viewport, clipped to it and to the screen
+void HalCanvas::put(int32_t x, int32_t y, uint16_t color){
+    int32_t lw = (rotation & 1) ? h0 : w0, lh = (rotation & 1) ? w0 : h0;
+    if (surface == nullptr){
+        return;     // sprite not created
+    }
+    if (vpOffset){
+        x += vpX;
+        y += vpY;
+    }
+    if (x < 0 || y < 0 || x >= lw || y >= lh){
+        return;
+    }
+    if (vpW > 0 && (x < vpX || y < vpY || x >= vpX + vpW || y >= vpY + vpH)){
+        return;
+    }
+    rotate(rotation, w0, h0, x, y);
+    surface->pixel(x, y, color);
+    if (isScreen){
+        halDisplayCount(0, 1);
+    }
+}
+
+uint16_t HalCanvas::readPixel(int32_t x, int32_t y){
+    if (vpOffset){
+        x += vpX;
+        y += vpY;
+    }
+    rotate(rotation, w0, h0, x, y);
+    return surface ? surface->get(x, y) : 0;
+}
+
+void HalCanvas::fillScreen(uint32_t color){
+    count();
+    int32_t w = (rotation & 1) ? h0 : w0, h = (rotation & 1) ? w0 : h0;
+    for (int32_t y = 0; y < h; y++){
+        for (int32_t x = 0; x < w; x++){
+            put(x - (vpOffset ? vpX : 0), y - (vpOffset ? vpY : 0), color);
+        }
+    }
+}
+
+void HalCanvas::fillRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color){
+    count();
+    for (int32_t j = y; j < y + h; j++){
+        for (int32_t i = x; i < x + w; i++){
+            put(i, j, color);
+        }
+    }
+}
+
+void HalCanvas::drawRect(int32_t x, int32_t y, int32_t w, int32_t h, uint32_t color){
+    drawFastHLine(x, y, w, color);
+    drawFastHLine(x, y + h - 1, w, color);
+    drawFastVLine(x, y, h, color);
+    drawFastVLine(x + w - 1, y, h, color);
+}
+
+void HalCanvas::drawPixel(int32_t x, int32_t y, uint32_t color){
+    count();
+    put(x, y, color);
+}
+
+void HalCanvas::drawFastHLine(int32_t x, int32_t y, int32_t w, uint32_t color){
+    fillRect(x, y, w, 1, color);
+}
+
+void HalCanvas::drawFastVLine(int32_t x, int32_t y, int32_t h, uint32_t color){
+    fillRect(x, y, 1, h, color);
+}
+
+void HalCanvas::drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color){
+    count();
+    int32_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int32_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int32_t err = dx + dy;
+    while (true){
+        put(x0, y0, color);
+        if (x0 == x1 && y0 == y1) break;
+        int32_t e2 = 2 * err;
+        if (e2 >= dy){ err += dy; x0 += sx; }
+        if (e2 <= dx){ err += dx; y0 += sy; }
+    }
+}
+
+void HalCanvas::drawCircle(int32_t x, int32_t y, int32_t r, uint32_t color){
+    count();
+    for (int32_t j = -r; j <= r; j++){
+        for (int32_t i = -r; i <= r; i++){
+            int32_t d = i * i + j * j;
+            if (d <= r * r && d > (r - 1) * (r - 1)){
+                put(x + i, y + j, color);
+            }
+        }
+    }
+}
+
+void HalCanvas::fillCircle(int32_t x, int32_t y, int32_t r, uint32_t color){
+    count();
+    for (int32_t j = -r; j <= r; j++){
+        for (int32_t i = -r; i <= r; i++){
+            if (i * i + j * j <= r * r){
+                put(x + i, y + j, color);
+            }
+        }
+    }
+}
+
+void HalCanvas::drawRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color){
+    drawRect(x, y, w, h, color);
+}
+
+void HalCanvas::fillRoundRect(int32_t x, int32_t y, int32_t w, int32_t h, int32_t, uint32_t color){
+    fillRect(x, y, w, h, color);
+}
+
+static uint16_t swap16(uint16_t c){
+    return (uint16_t)((c << 8) | (c >> 8));
+}
+
+void HalCanvas::image(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * data, bool native, int32_t stride,
+                      bool transparent, uint16_t key){
+    count();
+    for (int32_t j = 0; j < h; j++){
+        for (int32_t i = 0; i < w; i++){
+            uint16_t c = data[j * stride + i];
+            if (!(transparent && c == key)){
+                put(x + i, y + j, native ? c : swap16(c));
+            }
+        }
+    }
+}
+
+void HalCanvas::window(int32_t x, int32_t y, int32_t w, int32_t h){
+    winX = x;
+    winY = y;
+    winW = w > 0 ? w : 1;
+    winH = h > 0 ? h : 1;
+    winPos = 0;
+}
+
+void HalCanvas::stream(const uint16_t * colors, uint32_t len, bool native){
+    count();
+    for (uint32_t k = 0; k < len; k++){
+        put(winX + winPos % winW, winY + winPos / winW, native ? colors[k] : swap16(colors[k]));
+        winPos = (winPos + 1) % (winW * winH);
+    }
+}
+
+void HalCanvas::setViewport(int32_t x, int32_t y, int32_t w, int32_t h, bool vpDatum){
+    vpX = x;
+    vpY = y;
+    vpW = w;
+    vpH = h;
+    vpOffset = vpDatum;
+}
+
+void HalCanvas::resetViewport(){
+    vpX = vpY = vpW = vpH = 0;
+    vpOffset = false;
+}
+
+// ---- text
+
+// Function to get a built-in font's cell, and return the glyph height within it
+int32_t HalCanvas::glyphBox(uint8_t font, int32_t * cellW, int32_t * cellH) const {
+    static const uint8_t sizes[][2] = { { 6, 8 }, { 6, 8 }, { 8, 16 }, { 8, 16 }, { 14, 26 }, { 14, 26 },
+                                        { 24, 48 }, { 32, 48 }, { 55, 75 } };
+    uint8_t f = font < 9 ? font : 1;
+    *cellW = sizes[f][0] * textSize;
+    *cellH = sizes[f][1] * textSize;
+    return *cellH - (*cellH / 8 > 1 ? *cellH / 8 : 1);
+}
+
+int32_t HalCanvas::ascent() const {
+    int32_t a = 0;
+    for (uint16_t c = gfxFont->first; c <= gfxFont->last; c++){
+        int32_t g = -gfxFont->glyph[c - gfxFont->first].yOffset;
+        a = g > a ? g : a;
+    }
+    return a * textSize;
+}
+
+// Function to draw one character, x / y is the cell's top left (built-in fonts) or the baseline (free fonts).
+// Returns the advance.
+int32_t HalCanvas::drawGlyph(char c, int32_t x, int32_t y, bool fillBg){
+    if (gfxFont){
+        uint8_t u = (uint8_t)c;
+        if (u < gfxFont->first || u > gfxFont->last){
+            return 0;
+        }
+        const GFXglyph & g = gfxFont->glyph[u - gfxFont->first];
+        const uint8_t * bits = gfxFont->bitmap + g.bitmapOffset;
+        uint32_t bit = 0;
+        for (int32_t j = 0; j < g.height; j++){
+            for (int32_t i = 0; i < g.width; i++, bit++){
+                if (bits[bit / 8] & (0x80 >> (bit % 8))){
+                    for (int32_t sy = 0; sy < textSize; sy++){
+                        for (int32_t sx = 0; sx < textSize; sx++){
+                            put(x + (g.xOffset + i) * textSize + sx, y + (g.yOffset + j) * textSize + sy, textFg);
+                        }
+                    }
+                }
+            }
+        }
+        return g.xAdvance * textSize;
+    }
+    int32_t cw, ch;
+    int32_t gh = glyphBox(textFont, &cw, &ch);
+    int32_t gw = cw - (cw / 6 > 1 ? cw / 6 : 1);
+    uint16_t art = halGlyph(c);
+    for (int32_t j = 0; j < ch; j++){
+        for (int32_t i = 0; i < cw; i++){
+            bool on = i < gw && j < gh && (art & (0x4000 >> ((j * 5 / gh) * 3 + i * 3 / gw)));
+            if (on){
+                put(x + i, y + j, textFg);
+            } else if (fillBg){
+                put(x + i, y + j, textBg);
+            }
+        }
+    }
+    return cw;
+}
+
+size_t HalCanvas::write(uint8_t c){
+    count();
+    int32_t cw, ch;
+    glyphBox(textFont, &cw, &ch);
+    int32_t lineH = gfxFont ? gfxFont->yAdvance * textSize : ch;
+    if (c == '\n'){
+        cursorX = 0;
+        cursorY += lineH;
+        return 1;
+    }
+    if (c == '\r'){
+        return 1;
+    }
+    int32_t advance = cw;
+    if (gfxFont){
+        if (c < gfxFont->first || c > gfxFont->last){
+            return 1;
+        }
+        advance = gfxFont->glyph[c - gfxFont->first].xAdvance * textSize;
+    }
+    if (wrap && cursorX + advance > width()){
+        cursorX = 0;
+        cursorY += lineH;
+    }
+    cursorX += drawGlyph((char)c, cursorX, cursorY, !gfxFont && textBg != textFg);
+    return 1;
+}
+
+int16_t HalCanvas::textWidth(const char * s){
+    int32_t w = 0, cw, ch;
+    glyphBox(textFont, &cw, &ch);
+    for (; *s; s++){
+        uint8_t u = (uint8_t)*s;
+        if (!gfxFont){
+            w += cw;
+        } else if (u >= gfxFont->first && u <= gfxFont->last){
+            w += gfxFont->glyph[u - gfxFont->first].xAdvance * textSize;
+        }
+    }
+    return w;
+}
+
+int16_t HalCanvas::fontHeight(){
+    if (gfxFont){
+        return gfxFont->yAdvance * textSize;
+    }
+    return fontHeight(textFont);
+}
+
+int16_t HalCanvas::fontHeight(int16_t font){
+    int32_t cw, ch;
+    glyphBox(font, &cw, &ch);
+    return ch;
+}
+
+int16_t HalCanvas::drawString(const char * s, int32_t x, int32_t y){
+    count();
+    int32_t w = textWidth(s), h = fontHeight();
+    int32_t baseline = gfxFont ? ascent() : h * 7 / 8;
+    int hAlign = 0;     // 0 left, 1 centre, 2 right
+    switch (datum){
+        case TC_DATUM: case MC_DATUM: case BC_DATUM: case C_BASELINE: hAlign = 1; break;
+        case TR_DATUM: case MR_DATUM: case BR_DATUM: case R_BASELINE: hAlign = 2; break;
+    }
+    x -= hAlign * w / 2;
+    switch (datum){
+        case ML_DATUM: case MC_DATUM: case MR_DATUM: y -= h / 2;      break;
+        case BL_DATUM: case BC_DATUM: case BR_DATUM: y -= h;          break;
+        case L_BASELINE: case C_BASELINE: case R_BASELINE: y -= baseline; break;
+    }
+    bool fillBg = textBg != textFg;
+    if (fillBg && padding > w){
+        int32_t extra = padding - w;
+        int32_t before = hAlign == 0 ? 0 : hAlign == 1 ? extra / 2 : extra;
+        for (int32_t j = y; j < y + h; j++){
+            for (int32_t i = 0; i < before; i++) put(x - before + i, j, textBg);
+            for (int32_t i = 0; i < extra - before; i++) put(x + w + i, j, textBg);
+        }
+    }
+    int32_t cx = x;
+    for (const char * p = s; *p; p++){
+        cx += drawGlyph(*p, cx, gfxFont ? y + baseline : y, !gfxFont && fillBg);
+    }
+    return w;
+}
+
+int16_t HalCanvas::drawCentreString(const char * s, int32_t x, int32_t y, uint8_t font){
+    uint8_t d = datum;
+    setTextFont(font);
+    datum = TC_DATUM;
+    int16_t w = drawString(s, x, y);
+    datum = d;
+    return w;
+}
+
+int16_t HalCanvas::drawNumber(long n, int32_t x, int32_t y){
+    char buf[16];
+    return drawString(ltoa(n, buf, 10), x, y);
+}
+
+int16_t HalCanvas::drawFloat(float f, uint8_t dp, int32_t x, int32_t y){
+    char buf[32];
+    return drawString(dtostrf(f, 0, dp, buf), x, y);
+}
+
+int16_t HalCanvas::drawChar(uint16_t c, int32_t x, int32_t y){
+    count();
+    return drawGlyph((char)c, x, y, !gfxFont && textBg != textFg);
+}
@@ -0,0 +1,204 @@
+#include <string>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+#include "SD/Seeed_SD.h"
+#include "HalInternal.h"
+
+SDFS SD;
+
+static std::string sdRoot = "sd";
+
+void halSdRoot(const char * path){
+    sdRoot = path;
+}
+
+const char * halSdPath(){
+    return sdRoot.c_str();
+}
+
+// Function to map a card path to the host folder
+static std::string hostPath(const char * path){
+    while (*path == '/'){
+        path++;
+    }
+    return sdRoot + "/" + path;
+}
+
+struct HalFile {
+    std::string name;
+    FILE * f = nullptr;
+    DIR * dir = nullptr;
+    std::string path;
+
+    ~HalFile(){
+        if (f) fclose(f);
+        if (dir) closedir(dir);
+    }
+};
+
+size_t File::write(uint8_t c){
+    return write(&c, 1);
+}
+
+size_t File::write(const uint8_t * buf, size_t size){
+    if (!handle || !handle->f){
+        return 0;
+    }
+    return fwrite(buf, 1, size, handle->f);
+}
+
+int File::read(){
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::read(void * buf, size_t nbyte){
+    if (!handle || !handle->f){
+        return -1;
+    }
+    return (int)fread(buf, 1, nbyte, handle->f);
+}
+
+int File::peek(){
+    if (!handle || !handle->f){
+        return -1;
+    }
+    int c = fgetc(handle->f);
+    if (c != EOF){
+        ungetc(c, handle->f);
+    }
+    return c == EOF ? -1 : c;
+}
+
+int File::available(){
+    return handle && handle->f ? (int)(size() - position()) : 0;
+}
+
+void File::flush(){
+    if (handle && handle->f){
+        fflush(handle->f);
+    }
+}
+
+bool File::seek(uint32_t pos){
+    if (!handle || !handle->f || pos > size()){
+        return false;
+    }
+    return fseek(handle->f, pos, SEEK_SET) == 0;
+}
+
+uint32_t File::position(){
+    return handle && handle->f ? (uint32_t)ftell(handle->f) : 0;
+}
+
+uint32_t File::size(){
+    if (!handle || !handle->f){
+        return 0;
+    }
+    struct stat st;
+    fflush(handle->f);
+    return fstat(fileno(handle->f), &st) == 0 ? (uint32_t)st.st_size : 0;
+}
+
+void File::close(){
+    handle.reset();
+}
+
+const char * File::name(){
+    return handle ? handle->name.c_str() : "";
+}
+
+bool File::isDirectory(){
+    return handle && handle->dir;
+}
+
+File File::openNextFile(uint8_t mode){
+    File next;
+    if (!isDirectory()){
+        return next;
+    }
+    struct dirent * e;
+    while ((e = readdir(handle->dir)) != nullptr){
+        if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0){
+            return SD.open((handle->path + "/" + e->d_name).c_str(), mode);
+        }
+    }
+    return next;
+}
+
+void File::rewindDirectory(){
+    if (isDirectory()){
+        rewinddir(handle->dir);
+    }
+}
+
+bool SDFS::begin(uint8_t, SPIClass &, int){
+    struct stat st;
+    return stat(sdRoot.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+File SDFS::open(const char * path, uint8_t mode){
+    File file;
+    std::string host = hostPath(path);
+    auto h = std::make_shared<HalFile>();
+    h->path = path;
+    const char * slash = strrchr(path, '/');
+    h->name = slash ? slash + 1 : path;
+    struct stat st;
+    if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)){
+        h->dir = opendir(host.c_str());
+    } else if (mode & FA_WRITE){
+        h->f = fopen(host.c_str(), "r+b");
+        if (h->f == nullptr){
+            h->f = fopen(host.c_str(), "w+b");
+        }
+        if (h->f && (mode & FA_OPEN_APPEND) == FA_OPEN_APPEND){
+            fseek(h->f, 0, SEEK_END);
+        }
+    } else {
+        h->f = fopen(host.c_str(), "rb");
+    }
+    if (h->f || h->dir){
+        file.handle = h;
+    }
+    return file;
+}
+
+bool SDFS::exists(const char * path){
+    struct stat st;
+    return stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool SDFS::remove(const char * path){
+    return unlink(hostPath(path).c_str()) == 0;
+}
+
+bool SDFS::rename(const char * from, const char * to){
+    return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool SDFS::mkdir(const char * path){
+    return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+bool SDFS::rmdir(const char * path){
+    return ::rmdir(hostPath(path).c_str()) == 0;
+}
+
+uint64_t SDFS::cardSize(){
+    return totalBytes();
+}
+
+uint64_t SDFS::totalBytes(){
+    struct statvfs vfs;
+    return statvfs(sdRoot.c_str(), &vfs) == 0 ? (uint64_t)vfs.f_blocks * vfs.f_frsize : 0;
+}
+
+uint64_t SDFS::usedBytes(){
+    struct statvfs vfs;
+    return statvfs(sdRoot.c_str(), &vfs) == 0 ? (uint64_t)(vfs.f_blocks - vfs.f_bfree) * vfs.f_frsize : 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Hal.h"
+
+// Shared between the Native-HAL translation units, not for sketches
+
+struct HalUart {
+    std::string name;
+    std::deque<uint8_t> rx;
+    std::string tx;                             // written bytes nobody else takes, for halUartTake()
+    int fd = -1;                                // pty / serial port / fifo, -1 = none
+    bool console = false;                       // Serial without a pty: stdin / stdout
+    std::function<void(uint8_t)> onWrite;
+    unsigned long baud = 0;
+
+    void poll();
+    void put(const uint8_t * data, size_t len);
+};
+
+HalUart & halUart(const char * name);
+
+// Moves the simulated clock on by one tick (busy-wait progress)
+void halTick();
+
+// Microseconds millis() doesn't count (spent in sleep_cpu())
+void halAddSlept(uint64_t us);
+
+// Fires the interrupt attached to a pin if its mode matches the level change
+void halPinEdge(uint8_t pin, int from, int to);
+
+// Pin interrupts run so far
+uint64_t halInterruptCount();
+
+// Wall time of the next halAt() event, UINT64_MAX when there is none
+uint64_t halNextEventMicros();
+
+// halAt() to the microsecond
+void halAtMicros(uint64_t us, std::function<void()> fn);
+
+// RGB565 frame buffer of the screen, rotation 0
+struct HalSurface {
+    int width = 0, height = 0;
+    std::vector<uint16_t> pixels;
+
+    void resize(int w, int h);
+    void fill(int x, int y, int w, int h, uint16_t color);
+    void pixel(int x, int y, uint16_t color){
+        if (x >= 0 && y >= 0 && x < width && y < height) pixels[y * width + x] = color;
+    }
+    uint16_t get(int x, int y) const {
+        return (x >= 0 && y >= 0 && x < width && y < height) ? pixels[y * width + x] : 0;
+    }
+};
+
+HalSurface & halScreen();
+void halDisplayCount(uint64_t calls, uint64_t pixels);
+
+// 3x5 pixel glyph of an ASCII character, row-major from the top, bit 14 = top left
+uint16_t halGlyph(char c);
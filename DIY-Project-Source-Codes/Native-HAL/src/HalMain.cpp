@@ -0,0 +1,169 @@
+#include <chrono>
+#include <string>
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arduino.h"
+#include "Hal.h"
+
+/*
+Default main() of the native env, a harness with its own main() replaces it (weak).
+
+USAGE: .pio/build/native/program [options]
+    --ms <n>                run for n ms of wall time, 0 = until Ctrl-C         (default 0)
+    --clock sim|real        simulated or real time       (default sim, real when a --uart is given)
+    --tick <us>             simulated time per millis()/available() call        (default 10)
+    --loop-us <us>          simulated time per loop() call                      (default 1000)
+    --uart <NAME>=<path>    connect a UART to a pty / serial port, e.g. Serial1=/tmp/e5/sensor
+    --replay <NAME>=<file>  play a captured AT trace (AtTrace.h) into a UART, stops after its end
+    --replay-timing trace|asap  wait the recorded times, or cut the waits to 50 ms    (default trace)
+    --pin <p>=<v>[@ms]      drive an input pin, now or at a time, e.g. 2=0@60000
+    --analog <p>=<v>[@ms]   analogRead() value of a pin
+    --set <name>=<v>[@ms]   sensor value, e.g. dht.temperature=31.5, accel.z=-9.8
+    --eeprom <file>         EEPROM contents, loaded and written back
+    --sd <dir>              sd card folder                                      (default sd)
+    --display <file.ppm>    dump the screen at the end
+    --seed <n>              random() seed
+
+e.g.    program --ms 3600000 --set dht.humidity=95@600000 --display sensor.ppm
+        program --replay Serial1=AT000.BIN --replay-timing asap
+ */
+
+static void usage(){
+    fprintf(stderr, "usage: program [--ms n] [--clock sim|real] [--tick us] [--loop-us us] [--uart NAME=path]\n"
+                    "               [--replay NAME=file] [--replay-timing trace|asap]\n"
+                    "               [--pin p=v[@ms]] [--analog p=v[@ms]] [--set name=v[@ms]] [--eeprom file]\n"
+                    "               [--sd dir] [--display file.ppm] [--seed n]\n");
+    exit(2);
+}
+
+// Function to split "key=value[@ms]"
+static bool parseAssign(const char * arg, std::string & key, std::string & value, long long & at){
+    const char * eq = strchr(arg, '=');
+    if (eq == nullptr){
+        return false;
+    }
+    key.assign(arg, eq - arg);
+    value = eq + 1;
+    at = -1;
+    size_t pos = value.find('@');
+    if (pos != std::string::npos){
+        at = atoll(value.c_str() + pos + 1);
+        value.erase(pos);
+    }
+    return true;
+}
+
+// Function to apply fn now, or at the given time
+static void schedule(long long at, std::function<void()> fn){
+    if (at < 0){
+        fn();
+    } else {
+        halAt((uint64_t)at, fn);
+    }
+}
+
+static void onSignal(int){
+    halStop();
+}
+
+__attribute__((weak)) int main(int argc, char ** argv){
+    uint64_t ms = 0;
+    const char * clock = nullptr;
+    const char * display = nullptr;
+    bool uartGiven = false;
+    std::string replayUart, replayFile;
+    const char * timing = "trace";
+    for (int i = 1; i < argc; i++){
+        std::string opt = argv[i];
+        if (i + 1 >= argc){
+            usage();
+        }
+        const char * arg = argv[++i];
+        std::string key, value;
+        long long at;
+        if (opt == "--ms"){
+            ms = strtoull(arg, nullptr, 10);
+        } else if (opt == "--clock"){
+            clock = arg;
+        } else if (opt == "--tick"){
+            halSetTick((uint32_t)atol(arg));
+        } else if (opt == "--loop-us"){
+            halSetLoopStep((uint32_t)atol(arg));
+        } else if (opt == "--uart" && parseAssign(arg, key, value, at)){
+            if (!halUartOpen(key.c_str(), value.c_str())){
+                fprintf(stderr, "can't open %s\n", value.c_str());
+                return 1;
+            }
+            uartGiven = true;
+        } else if (opt == "--replay" && parseAssign(arg, key, value, at)){
+            replayUart = key;
+            replayFile = value;
+        } else if (opt == "--replay-timing"){
+            timing = arg;
+        } else if (opt == "--pin" && parseAssign(arg, key, value, at)){
+            uint8_t pin = (uint8_t)atoi(key.c_str());
+            int level = atoi(value.c_str());
+            schedule(at, [pin, level]{ halPinSet(pin, level); });
+        } else if (opt == "--analog" && parseAssign(arg, key, value, at)){
+            uint8_t pin = (uint8_t)atoi(key.c_str());
+            int level = atoi(value.c_str());
+            schedule(at, [pin, level]{ halAnalogSet(pin, level); });
+        } else if (opt == "--set" && parseAssign(arg, key, value, at)){
+            float v = (float)atof(value.c_str());
+            schedule(at, [key, v]{ halValueSet(key.c_str(), v); });
+        } else if (opt == "--eeprom"){
+            halEepromFile(arg);
+        } else if (opt == "--sd"){
+            halSdRoot(arg);
+        } else if (opt == "--display"){
+            display = arg;
+        } else if (opt == "--seed"){
+            randomSeed(strtoul(arg, nullptr, 10));
+        } else {
+            usage();
+        }
+    }
+    if (clock != nullptr && strcmp(clock, "sim") != 0 && strcmp(clock, "real") != 0){
+        usage();
+    }
+    if (strcmp(timing, "trace") != 0 && strcmp(timing, "asap") != 0){
+        usage();
+    }
+    if (!replayFile.empty() && !halUartReplay(replayUart.c_str(), replayFile.c_str(), strcmp(timing, "trace") == 0)){
+        fprintf(stderr, "can't read the trace %s\n", replayFile.c_str());
+        return 1;
+    }
+    // e5emu answers in real time, a simulated clock would time its responses out
+    halClockReal(clock ? strcmp(clock, "real") == 0 : uartGiven);
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    auto start = std::chrono::steady_clock::now();
+    halRun(ms);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (display != nullptr && !halDisplayDump(display)){
+        fprintf(stderr, "can't write %s\n", display);
+    }
+    const HalDisplayStats & stats = halDisplayStats();
+    fprintf(stderr, "\n%llu ms simulated in %.2f s, %llu drawing calls, %llu pixels\n",
+            (unsigned long long)(halWallMicros() / 1000), secs,
+            (unsigned long long)stats.calls, (unsigned long long)stats.pixels);
+    if (!replayFile.empty()){
+        const HalReplayStats & replay = halReplayStats();
+        fprintf(stderr, "replay: %llu records%s, %llu module bytes fed, %llu lines written, %llu differ from the trace\n",
+                (unsigned long long)replay.records, replay.done ? "" : " (not to the end)",
+                (unsigned long long)replay.rxBytes, (unsigned long long)replay.txLines,
+                (unsigned long long)replay.txDiffers);
+        if (replay.txDiffers){
+            fprintf(stderr, "first difference - trace: \"%s\", sketch: \"%s\"\n",
+                    replay.expected.c_str(), replay.actual.c_str());
+        }
+        return replay.done && replay.txDiffers == 0 ? 0 : 3;
+    }
+    return 0;
+}
@@ -0,0 +1,249 @@
+#include <deque>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Arduino.h"
+#include "HalInternal.h"
+
+/*
+Replay of an AtTrace.h trace into a UART. The sketch takes the module's place in the conversation
+again: the trace is cut into segments at its gap markers (lost records), and within a segment a batch
+of received bytes is fed once the sketch has written as many command lines as the trace holds before
+it. The sketch's lines are checked against the trace's by their position in the segment.
+ */
+
+#define REPLAY_TX       0x80
+#define REPLAY_GAP      0xFF
+#define REPLAY_HEADER   12
+#define REPLAY_FROM_BOOT 0x01
+#define REPLAY_TAIL_MS  2000        // run on after the last record, for the sketch to act on it
+#define REPLAY_ASAP_MS  50          // longest wait without the original timing, time for the sketch to
+                                    // be done with the previous answer
+
+struct ReplayRecord {
+    bool tx;
+    bool gap;                       // lost records before this one, it starts a new segment
+    uint64_t gapMs;                 // time from the previous record to the gap marker
+    uint64_t deltaMs;               // from the previous record, or the gap marker
+    std::string bytes;
+};
+
+static std::vector<ReplayRecord> records;
+static HalReplayStats stats;
+static std::string uartName;
+static bool originalTiming = true;
+static bool stopAtEnd = true;
+
+static size_t nextRecord = 0;      // the next record to play
+static bool waiting = false;        // an event is due to play it
+static bool inGap = false;          // waiting out a gap marker, extra lines can't be checked
+static uint64_t lastUs = 0;         // wall time of the previous record
+static uint64_t lines = 0;          // sketch lines that matched up with the trace's, in this segment
+static uint64_t linesNeeded = 0;    // trace lines played, in this segment
+static std::deque<std::string> expected;
+static std::string expectedPart;    // a trace line still being put together
+static std::string actualPart;
+
+// Function to read a LEB128 varint, false at the end of the data
+static bool varint(const std::string & data, size_t & pos, uint64_t & v){
+    v = 0;
+    for (unsigned shift = 0; pos < data.size() && shift < 64; shift += 7){
+        uint8_t b = data[pos++];
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if ((b & 0x80) == 0){
+            return true;
+        }
+    }
+    return false;
+}
+
+// Function to parse a trace file into records
+static bool load(const char * path){
+    FILE * f = fopen(path, "rb");
+    if (f == nullptr){
+        return false;
+    }
+    std::string data;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0){
+        data.append(buf, n);
+    }
+    fclose(f);
+    if (data.size() < REPLAY_HEADER || data.compare(0, 4, "M2AT") != 0 || data[4] != 1){
+        return false;
+    }
+    records.clear();
+    bool gap = (data[6] & REPLAY_FROM_BOOT) == 0;   // started late, nothing to line up with at first
+    uint64_t gapMs = 0;
+    size_t pos = REPLAY_HEADER;
+    while (pos < data.size()){
+        uint8_t tag = data[pos++];
+        uint64_t delta;
+        if (!varint(data, pos, delta)){
+            break;
+        }
+        if (tag == REPLAY_GAP){
+            gap = true;
+            gapMs += delta;
+            continue;
+        }
+        size_t len = (tag & 0x7F) + 1;
+        if (pos + len > data.size()){
+            break;                  // cut short, the last write didn't make it
+        }
+        records.push_back({ (tag & REPLAY_TX) != 0, gap, gapMs, delta, data.substr(pos, len) });
+        pos += len;
+        gap = false;
+        gapMs = 0;
+    }
+    return true;
+}
+
+// Function to note a line that isn't as in the trace
+static void differs(const std::string & want, const std::string & got){
+    if (stats.txDiffers++ == 0){
+        stats.expected = want;
+        stats.actual = got;
+    }
+}
+
+// Function to drop the line ending off a line
+static std::string chomp(std::string s){
+    while (!s.empty() && (s.back() == '\n' || s.back() == '\r')){
+        s.pop_back();
+    }
+    return s;
+}
+
+static void play();
+
+// Function to start a new segment after a gap, what the sketch wrote so far can't be lined up any more
+static void newSegment(){
+    for (const std::string & line : expected){
+        differs(line, "");
+    }
+    expected.clear();
+    expectedPart.clear();
+    actualPart.clear();
+    lines = linesNeeded = 0;
+    inGap = false;
+}
+
+// Function to play the records up to the next one that has to wait for the sketch or the clock
+static void play(){
+    while (!waiting && nextRecord < records.size()){
+        ReplayRecord & r = records[nextRecord];
+        uint64_t now = halWallMicros();
+        if (r.gap){
+            uint64_t at = lastUs + r.gapMs * 1000;
+            r.gap = false;
+            if (at > now){
+                waiting = true;
+                inGap = true;
+                halAtMicros(at, []{
+                    waiting = false;
+                    lastUs = halWallMicros();
+                    newSegment();
+                    play();
+                });
+                return;
+            }
+            lastUs = now;
+            newSegment();
+        }
+        if (r.tx){
+            // the sketch's turn, its lines are matched against these as they come
+            for (char c : r.bytes){
+                expectedPart += c;
+                if (c == '\n'){
+                    expected.push_back(chomp(expectedPart));
+                    expectedPart.clear();
+                    linesNeeded++;
+                }
+            }
+            stats.records++;
+            nextRecord++;
+            continue;
+        }
+        if (lines < linesNeeded){
+            return;                 // the sketch hasn't asked yet
+        }
+        uint64_t delta = originalTiming || r.deltaMs < REPLAY_ASAP_MS ? r.deltaMs : REPLAY_ASAP_MS;
+        uint64_t at = lastUs + delta * 1000;
+        waiting = true;
+        halAtMicros(at > now ? at : now, []{
+            const ReplayRecord & rx = records[nextRecord];
+            halUartFeed(uartName.c_str(), rx.bytes.data(), rx.bytes.size());
+            stats.records++;
+            stats.rxBytes += rx.bytes.size();
+            lastUs = halWallMicros();
+            nextRecord++;
+            waiting = false;
+            play();
+        });
+        return;
+    }
+    if (nextRecord == records.size() && !stats.done){
+        stats.done = true;
+        if (stopAtEnd){
+            halAtMicros(halWallMicros() + REPLAY_TAIL_MS * 1000ULL, []{
+                for (const std::string & line : expected){
+                    differs(line, "");
+                }
+                expected.clear();
+                halStop();
+            });
+        }
+    }
+}
+
+// Function to take a byte the sketch wrote to the module
+static void onWrite(uint8_t c){
+    actualPart += (char)c;
+    if (c != '\n'){
+        return;
+    }
+    std::string line = chomp(actualPart);
+    actualPart.clear();
+    stats.txLines++;
+    if (expected.empty()){
+        if (!inGap){
+            differs("", line);      // not in the trace here, it doesn't count towards the next answer
+        }
+        return;
+    }
+    if (expected.front() != line){
+        differs(expected.front(), line);
+    }
+    expected.pop_front();
+    lines++;
+    if (lines == linesNeeded){
+        lastUs = halWallMicros();   // the time the trace's last command went out
+    }
+    play();
+}
+
+bool halUartReplay(const char * name, const char * path, bool original, bool stop){
+    if (!load(path)){
+        return false;
+    }
+    uartName = name;
+    originalTiming = original;
+    stopAtEnd = stop;
+    stats = HalReplayStats();
+    nextRecord = 0;
+    waiting = false;
+    lastUs = halWallMicros();
+    newSegment();
+    halUartOnWrite(name, onWrite);
+    play();
+    return true;
+}
+
+const HalReplayStats & halReplayStats(){
+    return stats;
+}
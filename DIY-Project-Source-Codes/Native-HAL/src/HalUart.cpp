@@ -0,0 +1,199 @@
+#include <map>
+#include <memory>
+#include <string>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "Arduino.h"
+#include "HalInternal.h"
+
+static std::map<std::string, std::unique_ptr<HalUart>> & uarts(){
+    static std::map<std::string, std::unique_ptr<HalUart>> all;
+    return all;
+}
+
+HalUart & halUart(const char * name){
+    std::unique_ptr<HalUart> & u = uarts()[name];
+    if (!u){
+        u.reset(new HalUart());
+        u->name = name;
+        u->console = u->name == "Serial";
+    }
+    return *u;
+}
+
+// Function to move whatever the pty / stdin has into the receive queue
+void HalUart::poll(){
+    int from = fd >= 0 ? fd : (console ? STDIN_FILENO : -1);
+    if (from < 0){
+        return;
+    }
+    struct pollfd p = { from, POLLIN, 0 };
+    while (::poll(&p, 1, 0) > 0 && (p.revents & POLLIN)){
+        uint8_t buf[256];
+        ssize_t n = ::read(from, buf, sizeof(buf));
+        if (n <= 0){
+            if (n == 0 && from == STDIN_FILENO){
+                console = false;    // stdin closed, stop polling it
+            }
+            return;
+        }
+        rx.insert(rx.end(), buf, buf + n);
+    }
+}
+
+void HalUart::put(const uint8_t * data, size_t len){
+    if (onWrite){
+        for (size_t i = 0; i < len; i++){
+            onWrite(data[i]);
+        }
+    } else if (fd >= 0){
+        while (len > 0){
+            ssize_t n = ::write(fd, data, len);
+            if (n < 0 && errno != EAGAIN && errno != EINTR){
+                return;
+            }
+            if (n > 0){
+                data += n;
+                len -= n;
+            }
+        }
+    } else if (name == "Serial"){
+        fwrite(data, 1, len, stdout);
+        fflush(stdout);
+    } else {
+        tx.append((const char *)data, len);
+        if (tx.size() > (1 << 20)){
+            tx.erase(0, tx.size() - (1 << 19));     // nobody is taking it, keep the newest half
+        }
+    }
+}
+
+bool halUartOpen(const char * name, const char * path){
+    int fd = ::open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0){
+        return false;
+    }
+    struct termios tio;
+    if (tcgetattr(fd, &tio) == 0){
+        cfmakeraw(&tio);
+        tcsetattr(fd, TCSANOW, &tio);
+    }
+    HalUart & u = halUart(name);
+    if (u.fd >= 0){
+        ::close(u.fd);
+    }
+    u.fd = fd;
+    u.console = false;
+    return true;
+}
+
+void halUartOnWrite(const char * name, std::function<void(uint8_t)> fn){
+    halUart(name).onWrite = std::move(fn);
+}
+
+void halUartFeed(const char * name, const void * data, size_t len){
+    HalUart & u = halUart(name);
+    u.rx.insert(u.rx.end(), (const uint8_t *)data, (const uint8_t *)data + len);
+}
+
+std::string halUartTake(const char * name){
+    std::string out;
+    out.swap(halUart(name).tx);
+    return out;
+}
+
+// ---- HardwareSerial
+
+HardwareSerial Serial("Serial");
+HardwareSerial Serial1("Serial1");
+HardwareSerial Serial2("Serial2");
+HardwareSerial Serial3("Serial3");
+
+HardwareSerial::HardwareSerial(const char * portName) : uart(nullptr){
+    snprintf(name, sizeof(name), "%s", portName);
+}
+
+// Looked up on first use, the command line connects the ports after the static constructors ran
+HalUart & HardwareSerial::port(){
+    if (uart == nullptr){
+        uart = &halUart(name);
+    }
+    return *uart;
+}
+
+void HardwareSerial::begin(unsigned long baud){
+    port().baud = baud;
+}
+
+void HardwareSerial::begin(unsigned long baud, uint16_t){
+    begin(baud);
+}
+
+void HardwareSerial::end(){
+}
+
+unsigned long HardwareSerial::baudRate(){
+    return port().baud;
+}
+
+int HardwareSerial::available(){
+    halTick();
+    HalUart & u = port();
+    u.poll();
+    return (int)u.rx.size();
+}
+
+int HardwareSerial::peek(){
+    HalUart & u = port();
+    u.poll();
+    return u.rx.empty() ? -1 : u.rx.front();
+}
+
+int HardwareSerial::read(){
+    HalUart & u = port();
+    if (u.rx.empty()){
+        u.poll();
+    }
+    if (u.rx.empty()){
+        return -1;
+    }
+    int c = u.rx.front();
+    u.rx.pop_front();
+    return c;
+}
+
+size_t HardwareSerial::write(uint8_t c){
+    port().put(&c, 1);
+    return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t * buffer, size_t size){
+    port().put(buffer, size);
+    return size;
+}
+
+int HardwareSerial::availableForWrite(){
+    return 64;
+}
+
+void HardwareSerial::flush(){
+    fflush(stdout);
+}
+
+// ---- SoftwareSerial
+
+#include "SoftwareSerial.h"
+
+static int softwareSerials = 0;
+
+SoftwareSerial::SoftwareSerial(uint8_t, uint8_t, bool) : HardwareSerial("SoftwareSerial"){
+    if (softwareSerials > 0){
+        snprintf(name, sizeof(name), "SoftwareSerial%d", softwareSerials);
+    }
+    softwareSerials++;
+}
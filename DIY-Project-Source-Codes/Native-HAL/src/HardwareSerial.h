@@ -0,0 +1,45 @@
+#pragma once
+#include "Stream.h"
+
+#define SERIAL_8N1 0x06
+#define SERIAL_8E1 0x26
+#define SERIAL_8O1 0x36
+#define SERIAL_8N2 0x0E
+
+struct HalUart;
+
+// A board UART, its bytes go where Hal.h's halUart...() functions send them (Serial: stdin / stdout)
+class HardwareSerial : public Stream {
+public:
+    explicit HardwareSerial(const char * name);
+
+    void begin(unsigned long baud);
+    void begin(unsigned long baud, uint16_t config);
+    void end();
+    int available() override;
+    int peek() override;
+    int read() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t * buffer, size_t size) override;
+    using Print::write;
+    int availableForWrite() override;
+    void flush() override;
+    operator bool() { return true; }
+    unsigned long baudRate();
+
+    // ESP8266 core extras, nothing to do here
+    void swap() {}
+    void setRxBufferSize(size_t) {}
+    void setDebugOutput(bool) {}
+
+protected:
+    char name[32];              // "SoftwareSerial" and the number of the port
+    HalUart * uart;
+
+    HalUart & port();
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+extern HardwareSerial Serial3;
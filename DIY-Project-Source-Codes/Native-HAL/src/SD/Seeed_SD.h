@@ -0,0 +1,30 @@
+#pragma once
+#include <Seeed_FS.h>
+#include <SPI.h>
+
+#define SDCARD_SPI SPI
+
+enum sdcard_type_t { CARD_NONE, CARD_MMC, CARD_SD, CARD_SDHC, CARD_UNKNOWN };
+
+// The sd card, a folder on the PC (halSdRoot(), default "sd")
+class SDFS : public FS {
+public:
+    bool begin(uint8_t ssPin = SDCARD_SS_PIN, SPIClass & spi = SPI, int hz = 4000000);
+    void end() {}
+    File open(const char * path, uint8_t mode = FILE_READ);
+    File open(const String & path, uint8_t mode = FILE_READ) { return open(path.c_str(), mode); }
+    bool exists(const char * path);
+    bool exists(const String & path) { return exists(path.c_str()); }
+    bool remove(const char * path);
+    bool remove(const String & path) { return remove(path.c_str()); }
+    bool rename(const char * from, const char * to);
+    bool mkdir(const char * path);
+    bool mkdir(const String & path) { return mkdir(path.c_str()); }
+    bool rmdir(const char * path);
+    sdcard_type_t cardType() { return CARD_SDHC; }
+    uint64_t cardSize();
+    uint64_t totalBytes();
+    uint64_t usedBytes();
+};
+
+extern SDFS SD;
@@ -0,0 +1,25 @@
+#pragma once
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define MSBFIRST 1
+#define LSBFIRST 0
+
+class SPISettings {
+public:
+    SPISettings(uint32_t = 4000000, uint8_t = MSBFIRST, uint8_t = SPI_MODE0) {}
+};
+
+// Nothing is on the bus in the native build, the device classes talk to Hal.h directly
+class SPIClass {
+public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t) { return 0xFF; }
+    uint16_t transfer16(uint16_t) { return 0xFFFF; }
+    void transfer(void *, size_t) {}
+};
+
+extern SPIClass SPI;
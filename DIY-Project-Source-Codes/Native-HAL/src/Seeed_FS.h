@@ -0,0 +1,48 @@
+#pragma once
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+// FatFs open modes, FILE_WRITE opens (or creates) for reading and writing without truncating
+#define FA_READ 0x01
+#define FA_WRITE 0x02
+#define FA_OPEN_ALWAYS 0x10
+#define FA_OPEN_APPEND 0x30
+#define FILE_READ FA_READ
+#define FILE_WRITE (FA_READ | FA_WRITE | FA_OPEN_ALWAYS)
+#define FILE_APPEND (FA_READ | FA_WRITE | FA_OPEN_APPEND)
+
+struct HalFile;
+
+// Seeed Arduino FS File for the native build, a file or folder under halSdRoot()
+class File : public Stream {
+public:
+    File() {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t * buf, size_t size) override;
+    using Print::write;
+    int read() override;
+    int read(void * buf, size_t nbyte);
+    int peek() override;
+    int available() override;
+    void flush() override;
+    bool seek(uint32_t pos);
+    uint32_t position();
+    uint32_t size();
+    void close();
+    operator bool() const { return handle != nullptr; }
+    const char * name();
+    bool isDirectory();
+    File openNextFile(uint8_t mode = FILE_READ);
+    void rewindDirectory();
+
+private:
+    friend class SDFS;
+    std::shared_ptr<HalFile> handle;
+};
+
+class FS {
+public:
+    virtual ~FS() {}
+};
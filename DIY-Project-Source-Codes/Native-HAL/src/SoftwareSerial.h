@@ -0,0 +1,14 @@
+#pragma once
+#include <Arduino.h>
+
+// SoftwareSerial is one more UART here, the first one is "SoftwareSerial", then "SoftwareSerial1" ...
+class SoftwareSerial : public HardwareSerial {
+public:
+    SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverseLogic = false);
+
+    bool listen() { return true; }
+    bool isListening() { return true; }
+    bool stopListening() { return true; }
+    bool overflow() { return false; }
+    void enableRx(bool) {}
+};
@@ -0,0 +1,127 @@
+#include "Arduino.h"
+
+int Stream::timedRead(){
+    unsigned long start = millis();
+    do {
+        int c = read();
+        if (c >= 0) return c;
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+int Stream::timedPeek(){
+    unsigned long start = millis();
+    do {
+        int c = peek();
+        if (c >= 0) return c;
+    } while (millis() - start < timeout);
+    return -1;
+}
+
+int Stream::peekNextDigit(bool allowDecimal){
+    while (true){
+        int c = timedPeek();
+        if (c < 0 || c == '-' || (c >= '0' && c <= '9') || (allowDecimal && c == '.')) return c;
+        read();
+    }
+}
+
+bool Stream::find(const char * target){
+    return find(target, strlen(target));
+}
+
+bool Stream::find(const char * target, size_t length){
+    if (length == 0) return true;
+    size_t matched = 0;
+    int c;
+    while ((c = timedRead()) >= 0){
+        if (c == target[matched]){
+            if (++matched == length) return true;
+        } else {
+            matched = c == target[0] ? 1 : 0;
+        }
+    }
+    return false;
+}
+
+bool Stream::findUntil(const char * target, const char * terminator){
+    size_t tlen = strlen(target), elen = strlen(terminator), t = 0, e = 0;
+    int c;
+    while ((c = timedRead()) >= 0){
+        t = c == target[t] ? t + 1 : (c == target[0] ? 1 : 0);
+        if (t == tlen) return true;
+        if (elen){
+            e = c == terminator[e] ? e + 1 : (c == terminator[0] ? 1 : 0);
+            if (e == elen) return false;
+        }
+    }
+    return false;
+}
+
+long Stream::parseInt(){
+    bool negative = false;
+    long value = 0;
+    int c = peekNextDigit(false);
+    if (c < 0) return 0;
+    do {
+        if (c == '-') negative = true;
+        else if (c >= '0' && c <= '9') value = value * 10 + c - '0';
+        read();
+        c = timedPeek();
+    } while (c >= '0' && c <= '9');
+    return negative ? -value : value;
+}
+
+float Stream::parseFloat(){
+    bool negative = false, fraction = false;
+    double value = 0, scale = 1;
+    int c = peekNextDigit(true);
+    if (c < 0) return 0;
+    do {
+        if (c == '-') negative = true;
+        else if (c == '.') fraction = true;
+        else {
+            value = value * 10 + c - '0';
+            if (fraction) scale *= 0.1;
+        }
+        read();
+        c = timedPeek();
+    } while ((c >= '0' && c <= '9') || (c == '.' && !fraction));
+    return (float)((negative ? -value : value) * scale);
+}
+
+size_t Stream::readBytes(char * buffer, size_t length){
+    size_t count = 0;
+    while (count < length){
+        int c = timedRead();
+        if (c < 0) break;
+        *buffer++ = (char)c;
+        count++;
+    }
+    return count;
+}
+
+size_t Stream::readBytesUntil(char terminator, char * buffer, size_t length){
+    size_t index = 0;
+    while (index < length){
+        int c = timedRead();
+        if (c < 0 || c == terminator) break;
+        *buffer++ = (char)c;
+        index++;
+    }
+    return index;
+}
+
+String Stream::readString(){
+    String ret;
+    int c;
+    while ((c = timedRead()) >= 0) ret += (char)c;
+    return ret;
+}
+
+String Stream::readStringUntil(char terminator){
+    String ret;
+    int c;
+    while ((c = timedRead()) >= 0 && c != terminator) ret += (char)c;
+    return ret;
+}
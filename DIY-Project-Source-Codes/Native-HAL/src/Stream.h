@@ -0,0 +1,39 @@
+#pragma once
+#include "Print.h"
+
+// Arduino Stream for the native build, the timeouts run on millis() so they follow the simulated clock
+class Stream : public Print {
+public:
+    Stream() : timeout(1000) {}
+
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+
+    void setTimeout(unsigned long ms) { timeout = ms; }
+    unsigned long getTimeout() { return timeout; }
+
+    bool find(const char * target);
+    bool find(const char * target, size_t length);
+    bool find(char target) { return find(&target, 1); }
+    bool findUntil(const char * target, const char * terminator);
+
+    long parseInt();
+    float parseFloat();
+
+    size_t readBytes(char * buffer, size_t length);
+    size_t readBytes(uint8_t * buffer, size_t length) { return readBytes((char *)buffer, length); }
+    size_t readBytesUntil(char terminator, char * buffer, size_t length);
+    size_t readBytesUntil(char terminator, uint8_t * buffer, size_t length) {
+        return readBytesUntil(terminator, (char *)buffer, length);
+    }
+    String readString();
+    String readStringUntil(char terminator);
+
+protected:
+    unsigned long timeout;
+
+    int timedRead();
+    int timedPeek();
+    int peekNextDigit(bool allowDecimal);
+};
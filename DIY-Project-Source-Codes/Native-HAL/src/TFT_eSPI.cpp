@@ -0,0 +1,106 @@
+#include "TFT_eSPI.h"
+#include "HalInternal.h"
+
+void TFT_eSPI::pushBlock(uint16_t color, uint32_t len){
+    count();
+    for (uint32_t k = 0; k < len; k++){
+        put(winX + winPos % winW, winY + winPos / winW, color);
+        winPos = (winPos + 1) % (winW * winH);
+    }
+}
+
+uint16_t TFT_eSPI::color8to16(uint8_t c){
+    static const uint8_t blue[] = { 0, 11, 21, 31 };
+    uint16_t color = (c & 0xE0) << 8;
+    color |= (c & 0xE0) << 5;
+    color |= (c & 0x1C) << 6;
+    color |= (c & 0x1C) << 3;
+    color |= blue[c & 0x03];
+    return color;
+}
+
+uint16_t TFT_eSPI::alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc){
+    uint16_t fgR = ((fgc >> 10) & 0x3E) + 1, fgG = ((fgc >> 4) & 0x7E) + 1, fgB = ((fgc << 1) & 0x3E) + 1;
+    uint16_t bgR = ((bgc >> 10) & 0x3E) + 1, bgG = ((bgc >> 4) & 0x7E) + 1, bgB = ((bgc << 1) & 0x3E) + 1;
+    uint16_t r = (((fgR * alpha) + (bgR * (255 - alpha))) >> 9);
+    uint16_t g = (((fgG * alpha) + (bgG * (255 - alpha))) >> 9);
+    uint16_t b = (((fgB * alpha) + (bgB * (255 - alpha))) >> 9);
+    return (r << 11) | (g << 5) | (b << 0);
+}
+
+void TFT_eSPI::pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t * data, bool bpp8, uint16_t * cmap){
+    count();
+    uint32_t bits = bpp8 ? 8 : (cmap ? 4 : 1);
+    uint32_t rowBytes = (w * bits + 7) / 8;
+    for (int32_t j = 0; j < h; j++){
+        for (int32_t i = 0; i < w; i++){
+            uint32_t bit = i * bits;
+            uint8_t v = data[j * rowBytes + bit / 8];
+            uint16_t c;
+            if (bits == 8){
+                c = color8to16(v);
+            } else if (bits == 4){
+                c = cmap[(bit % 8) ? (v & 0x0F) : (v >> 4)];
+            } else if (v & (0x80 >> (bit % 8))){
+                c = textFg;
+            } else {
+                continue;
+            }
+            put(x + i, y + j, c);
+        }
+    }
+}
+
+void TFT_eSPI::readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t * data){
+    for (int32_t j = 0; j < h; j++){
+        for (int32_t i = 0; i < w; i++){
+            uint16_t c = readPixel(x + i, y + j);
+            *data++ = swapBytes ? c : (uint16_t)((c << 8) | (c >> 8));
+        }
+    }
+}
+
+// ---- TFT_eSprite
+
+TFT_eSprite::TFT_eSprite(TFT_eSPI * tft) : TFT_eSPI(0, 0), parent(tft){
+    attach(nullptr, false);
+}
+
+TFT_eSprite::~TFT_eSprite(){
+    deleteSprite();
+}
+
+void * TFT_eSprite::createSprite(int16_t w, int16_t h, uint8_t){
+    deleteSprite();
+    own = new HalSurface();
+    own->resize(w, h);
+    attach(own, false);
+    w0 = w;
+    h0 = h;
+    rotation = 0;
+    resetViewport();
+    return own->pixels.data();
+}
+
+void TFT_eSprite::deleteSprite(){
+    delete own;
+    own = nullptr;
+    attach(nullptr, false);
+    w0 = h0 = 0;
+}
+
+const uint16_t * TFT_eSprite::ownPixels(){
+    return own->pixels.data();
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y){
+    if (own){
+        parent->image(x, y, own->width, own->height, own->pixels.data(), true, own->width);
+    }
+}
+
+void TFT_eSprite::pushSprite(int32_t x, int32_t y, uint16_t transparent){
+    if (own){
+        parent->image(x, y, own->width, own->height, own->pixels.data(), true, own->width, true, transparent);
+    }
+}
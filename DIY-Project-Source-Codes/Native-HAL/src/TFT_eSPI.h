@@ -0,0 +1,141 @@
+#pragma once
+#include "HalCanvas.h"
+
+/*
+TFT_eSPI for the native build, drawing into Hal.h's frame buffer. The panel is
+TFT_WIDTH x TFT_HEIGHT, set them in build_flags like a TFT_eSPI user setup
+(the Gateway's ST7789 is 240 x 240, the Wio Terminal's ILI9341 240 x 320).
+ */
+
+#ifndef TFT_WIDTH
+#define TFT_WIDTH 240
+#endif
+#ifndef TFT_HEIGHT
+#define TFT_HEIGHT 320
+#endif
+
+// What a user setup loads, Free_Fonts.h checks LOAD_GFXFF
+#define LOAD_GLCD
+#define LOAD_FONT2
+#define LOAD_FONT4
+#define LOAD_FONT6
+#define LOAD_FONT7
+#define LOAD_FONT8
+#define LOAD_GFXFF
+#define SMOOTH_FONT
+
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_DARKGREEN   0x03E0
+#define TFT_DARKCYAN    0x03EF
+#define TFT_MAROON      0x7800
+#define TFT_PURPLE      0x780F
+#define TFT_OLIVE       0x7BE0
+#define TFT_LIGHTGREY   0xD69A
+#define TFT_DARKGREY    0x7BEF
+#define TFT_BLUE        0x001F
+#define TFT_GREEN       0x07E0
+#define TFT_CYAN        0x07FF
+#define TFT_RED         0xF800
+#define TFT_MAGENTA     0xF81F
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+#define TFT_ORANGE      0xFDA0
+#define TFT_GREENYELLOW 0xB7E0
+#define TFT_PINK        0xFE19
+#define TFT_BROWN       0x9A60
+#define TFT_GOLD        0xFEA0
+#define TFT_SILVER      0xC618
+#define TFT_SKYBLUE     0x867D
+#define TFT_VIOLET      0x915C
+#define TFT_TRANSPARENT 0x0120
+
+class TFT_eSPI : public HalCanvas {
+public:
+    TFT_eSPI(int16_t w = TFT_WIDTH, int16_t h = TFT_HEIGHT) : HalCanvas(w, h) {}
+
+    void init(uint8_t = 0) { panel(w0, h0); setRotation(0); }
+    void begin(uint8_t tc = 0) { init(tc); }
+
+    void setSwapBytes(bool swap) { swapBytes = swap; }
+    bool getSwapBytes() { return swapBytes; }
+    void invertDisplay(bool) {}
+    void writecommand(uint8_t) {}
+    void writedata(uint8_t) {}
+    void startWrite() {}
+    void endWrite() {}
+
+    void setAddrWindow(int32_t x, int32_t y, int32_t w, int32_t h) { window(x, y, w, h); }
+    void setWindow(int32_t x0, int32_t y0, int32_t x1, int32_t y1) { window(x0, y0, x1 - x0 + 1, y1 - y0 + 1); }
+    void pushColor(uint16_t color) { stream(&color, 1, true); }
+    void pushColors(uint16_t * data, uint32_t len, bool swap = true) { stream(data, len, swap); }
+    void pushPixels(const void * data, uint32_t len) { stream((const uint16_t *)data, len, swapBytes); }
+    void pushBlock(uint16_t color, uint32_t len);
+
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * data) {
+        image(x, y, w, h, data, swapBytes, w);
+    }
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t * data) {
+        image(x, y, w, h, data, swapBytes, w);
+    }
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint16_t * data, uint16_t transparent) {
+        image(x, y, w, h, data, swapBytes, w, true, transparent);
+    }
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t * data, uint16_t transparent) {
+        image(x, y, w, h, data, swapBytes, w, true, transparent);
+    }
+    // 8 bit RGB332, or 1/4 bit with a colour map
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, const uint8_t * data, bool bpp8 = true,
+                   uint16_t * cmap = nullptr);
+    void pushImage(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t * data, bool bpp8 = true,
+                   uint16_t * cmap = nullptr) {
+        pushImage(x, y, w, h, (const uint8_t *)data, bpp8, cmap);
+    }
+    void readRect(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t * data);
+
+    // DMA finishes at once
+    bool initDMA(bool = false) { return true; }
+    void deInitDMA() {}
+    void pushImageDMA(int32_t x, int32_t y, int32_t w, int32_t h, uint16_t * data, uint16_t * = nullptr) {
+        pushImage(x, y, w, h, data);
+    }
+    void pushPixelsDMA(uint16_t * data, uint32_t len) { pushPixels(data, len); }
+    bool dmaBusy() { return false; }
+    void dmaWait() {}
+
+    void setScrollRect(int32_t, int32_t, int32_t, int32_t, uint16_t = TFT_BLACK) {}
+    void scroll(int16_t, int16_t = 0) {}
+
+    uint16_t color8to16(uint8_t c);
+    uint8_t color16to8(uint16_t c) { return ((c & 0xE000) >> 8) | ((c & 0x0700) >> 6) | ((c & 0x0018) >> 3); }
+    uint16_t alphaBlend(uint8_t alpha, uint16_t fgc, uint16_t bgc);
+
+protected:
+    bool swapBytes = false;
+};
+
+// Sprites keep RGB565 whatever colour depth is asked for
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI * tft);
+    ~TFT_eSprite();
+
+    void * createSprite(int16_t w, int16_t h, uint8_t frames = 1);
+    void deleteSprite();
+    bool created() { return own != nullptr; }
+    void * getPointer() { return created() ? (void *)ownPixels() : nullptr; }
+    void setColorDepth(int8_t b) { depth = b; }
+    int8_t getColorDepth() { return depth; }
+    void setPaletteColor(uint8_t, uint16_t) {}
+    void fillSprite(uint32_t color) { fillScreen(color); }
+    void pushSprite(int32_t x, int32_t y);
+    void pushSprite(int32_t x, int32_t y, uint16_t transparent);
+    uint16_t readPixel(int32_t x, int32_t y) { return HalCanvas::readPixel(x, y); }
+
+private:
+    TFT_eSPI * parent;
+    HalSurface * own = nullptr;
+    int8_t depth = 16;
+
+    const uint16_t * ownPixels();
+};
@@ -0,0 +1,532 @@
+#include "Arduino.h"
+#include <ctype.h>
+#include <string>
+
+String::String(const char * cstr){
+    buffer = nullptr;
+    capacity = len = 0;
+    if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const char * cstr, unsigned int length){
+    buffer = nullptr;
+    capacity = len = 0;
+    if (cstr) copy(cstr, length);
+}
+
+String::String(const String & value){
+    buffer = nullptr;
+    capacity = len = 0;
+    *this = value;
+}
+
+String::String(const __FlashStringHelper * pstr){
+    buffer = nullptr;
+    capacity = len = 0;
+    *this = pstr;
+}
+
+String::String(String && rval){
+    buffer = nullptr;
+    capacity = len = 0;
+    move(rval);
+}
+
+String::String(char c){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[2] = { c, 0 };
+    *this = buf;
+}
+
+String::String(unsigned char value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[1 + 8 * sizeof(unsigned char)];
+    utoa(value, buf, base);
+    *this = buf;
+}
+
+String::String(int value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[2 + 8 * sizeof(int)];
+    itoa(value, buf, base);
+    *this = buf;
+}
+
+String::String(unsigned int value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[1 + 8 * sizeof(unsigned int)];
+    utoa(value, buf, base);
+    *this = buf;
+}
+
+String::String(long value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[2 + 8 * sizeof(long)];
+    ltoa(value, buf, base);
+    *this = buf;
+}
+
+String::String(unsigned long value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[1 + 8 * sizeof(unsigned long)];
+    ultoa(value, buf, base);
+    *this = buf;
+}
+
+String::String(long long value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[2 + 8 * sizeof(long long)];
+    if (base == 10){
+        snprintf(buf, sizeof(buf), "%lld", value);
+    } else {
+        ultoa((unsigned long)value, buf, base);
+    }
+    *this = buf;
+}
+
+String::String(unsigned long long value, unsigned char base){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[1 + 8 * sizeof(unsigned long long)];
+    ultoa((unsigned long)value, buf, base);
+    *this = buf;
+}
+
+String::String(float value, unsigned char decimalPlaces){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[33];
+    *this = dtostrf(value, decimalPlaces + 2, decimalPlaces, buf);
+}
+
+String::String(double value, unsigned char decimalPlaces){
+    buffer = nullptr;
+    capacity = len = 0;
+    char buf[33];
+    *this = dtostrf(value, decimalPlaces + 2, decimalPlaces, buf);
+}
+
+String::~String(){
+    free(buffer);
+}
+
+void String::invalidate(){
+    free(buffer);
+    buffer = nullptr;
+    capacity = len = 0;
+}
+
+bool String::reserve(unsigned int size){
+    if (buffer && capacity >= size) return true;
+    if (changeBuffer(size)){
+        if (len == 0) buffer[0] = 0;
+        return true;
+    }
+    return false;
+}
+
+bool String::changeBuffer(unsigned int maxStrLen){
+    char * newbuffer = (char *)realloc(buffer, maxStrLen + 1);
+    if (newbuffer){
+        buffer = newbuffer;
+        capacity = maxStrLen;
+        return true;
+    }
+    return false;
+}
+
+String & String::copy(const char * cstr, unsigned int length){
+    if (!reserve(length)){
+        invalidate();
+        return *this;
+    }
+    len = length;
+    memmove(buffer, cstr, length);
+    buffer[len] = 0;
+    return *this;
+}
+
+void String::move(String & rhs){
+    if (this != &rhs){
+        free(buffer);
+        buffer = rhs.buffer;
+        len = rhs.len;
+        capacity = rhs.capacity;
+        rhs.buffer = nullptr;
+        rhs.len = rhs.capacity = 0;
+    }
+}
+
+String & String::operator=(const String & rhs){
+    if (this == &rhs) return *this;
+    if (rhs.buffer) copy(rhs.buffer, rhs.len);
+    else invalidate();
+    return *this;
+}
+
+String & String::operator=(String && rval){
+    move(rval);
+    return *this;
+}
+
+String & String::operator=(const char * cstr){
+    if (cstr) copy(cstr, strlen(cstr));
+    else invalidate();
+    return *this;
+}
+
+String & String::operator=(const __FlashStringHelper * pstr){
+    return *this = reinterpret_cast<const char *>(pstr);
+}
+
+bool String::concat(const String & s){
+    return concat(s.buffer, s.len);
+}
+
+bool String::concat(const char * cstr, unsigned int length){
+    unsigned int newlen = len + length;
+    if (!cstr) return false;
+    if (length == 0) return true;
+    if (!reserve(newlen)) return false;
+    memmove(buffer + len, cstr, length);
+    len = newlen;
+    buffer[len] = 0;
+    return true;
+}
+
+bool String::concat(const char * cstr){
+    if (!cstr) return false;
+    return concat(cstr, strlen(cstr));
+}
+
+bool String::concat(const __FlashStringHelper * str){
+    return concat(reinterpret_cast<const char *>(str));
+}
+
+bool String::concat(char c){
+    return concat(&c, 1);
+}
+
+bool String::concat(unsigned char num){
+    char buf[1 + 3 * sizeof(unsigned char)];
+    return concat(utoa(num, buf, 10));
+}
+
+bool String::concat(int num){
+    char buf[2 + 3 * sizeof(int)];
+    return concat(itoa(num, buf, 10));
+}
+
+bool String::concat(unsigned int num){
+    char buf[1 + 3 * sizeof(unsigned int)];
+    return concat(utoa(num, buf, 10));
+}
+
+bool String::concat(long num){
+    char buf[2 + 3 * sizeof(long)];
+    return concat(ltoa(num, buf, 10));
+}
+
+bool String::concat(unsigned long num){
+    char buf[1 + 3 * sizeof(unsigned long)];
+    return concat(ultoa(num, buf, 10));
+}
+
+bool String::concat(long long num){
+    char buf[2 + 3 * sizeof(long long)];
+    snprintf(buf, sizeof(buf), "%lld", num);
+    return concat(buf);
+}
+
+bool String::concat(unsigned long long num){
+    char buf[1 + 3 * sizeof(unsigned long long)];
+    snprintf(buf, sizeof(buf), "%llu", num);
+    return concat(buf);
+}
+
+bool String::concat(float num){
+    char buf[20];
+    return concat(dtostrf(num, 4, 2, buf));
+}
+
+bool String::concat(double num){
+    char buf[20];
+    return concat(dtostrf(num, 4, 2, buf));
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, const String & rhs){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(rhs.buffer, rhs.len)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, const char * cstr){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!cstr || !a.concat(cstr, strlen(cstr))) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, const __FlashStringHelper * rhs){
+    return lhs + reinterpret_cast<const char *>(rhs);
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, char c){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(c)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, unsigned char num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, int num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, unsigned int num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, long num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, unsigned long num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, float num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+StringSumHelper & operator+(const StringSumHelper & lhs, double num){
+    StringSumHelper & a = const_cast<StringSumHelper &>(lhs);
+    if (!a.concat(num)) a.invalidate();
+    return a;
+}
+
+int String::compareTo(const String & s) const {
+    if (!buffer || !s.buffer){
+        if (s.buffer && s.len > 0) return 0 - *(unsigned char *)s.buffer;
+        if (buffer && len > 0) return *(unsigned char *)buffer;
+        return 0;
+    }
+    return strcmp(buffer, s.buffer);
+}
+
+bool String::equals(const String & s2) const {
+    return len == s2.len && compareTo(s2) == 0;
+}
+
+bool String::equals(const char * cstr) const {
+    if (len == 0) return cstr == nullptr || *cstr == 0;
+    if (cstr == nullptr) return buffer[0] == 0;
+    return strcmp(buffer, cstr) == 0;
+}
+
+bool String::equalsIgnoreCase(const String & s2) const {
+    if (this == &s2) return true;
+    if (len != s2.len) return false;
+    for (unsigned int i = 0; i < len; i++){
+        if (tolower((unsigned char)buffer[i]) != tolower((unsigned char)s2.buffer[i])) return false;
+    }
+    return true;
+}
+
+bool String::startsWith(const String & s2) const {
+    if (len < s2.len) return false;
+    return startsWith(s2, 0);
+}
+
+bool String::startsWith(const String & s2, unsigned int offset) const {
+    if (offset > len - s2.len || !buffer || !s2.buffer) return false;
+    return strncmp(&buffer[offset], s2.buffer, s2.len) == 0;
+}
+
+bool String::endsWith(const String & s2) const {
+    if (len < s2.len || !buffer || !s2.buffer) return false;
+    return strcmp(&buffer[len - s2.len], s2.buffer) == 0;
+}
+
+char String::charAt(unsigned int loc) const {
+    return operator[](loc);
+}
+
+void String::setCharAt(unsigned int loc, char c){
+    if (loc < len) buffer[loc] = c;
+}
+
+char & String::operator[](unsigned int index){
+    static char dummy_writable_char;
+    if (index >= len || !buffer){
+        dummy_writable_char = 0;
+        return dummy_writable_char;
+    }
+    return buffer[index];
+}
+
+char String::operator[](unsigned int index) const {
+    if (index >= len || !buffer) return 0;
+    return buffer[index];
+}
+
+void String::getBytes(unsigned char * buf, unsigned int bufsize, unsigned int index) const {
+    if (!bufsize || !buf) return;
+    if (index >= len){
+        buf[0] = 0;
+        return;
+    }
+    unsigned int n = bufsize - 1;
+    if (n > len - index) n = len - index;
+    strncpy((char *)buf, buffer + index, n);
+    buf[n] = 0;
+}
+
+int String::indexOf(char c) const {
+    return indexOf(c, 0);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+    if (fromIndex >= len) return -1;
+    const char * temp = strchr(buffer + fromIndex, ch);
+    if (temp == nullptr) return -1;
+    return temp - buffer;
+}
+
+int String::indexOf(const String & s2) const {
+    return indexOf(s2, 0);
+}
+
+int String::indexOf(const String & s2, unsigned int fromIndex) const {
+    if (fromIndex >= len) return -1;
+    const char * found = strstr(buffer + fromIndex, s2.c_str());
+    if (found == nullptr) return -1;
+    return found - buffer;
+}
+
+int String::lastIndexOf(char theChar) const {
+    return lastIndexOf(theChar, len - 1);
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const {
+    if (fromIndex >= len) return -1;
+    for (int i = fromIndex; i >= 0; i--){
+        if (buffer[i] == ch) return i;
+    }
+    return -1;
+}
+
+int String::lastIndexOf(const String & s2) const {
+    return lastIndexOf(s2, len - s2.len);
+}
+
+int String::lastIndexOf(const String & s2, unsigned int fromIndex) const {
+    if (s2.len == 0 || len == 0 || s2.len > len) return -1;
+    if (fromIndex >= len) fromIndex = len - 1;
+    int found = -1;
+    for (const char * p = buffer; p <= buffer + fromIndex; p++){
+        p = strstr(p, s2.buffer);
+        if (!p) break;
+        if ((unsigned int)(p - buffer) <= fromIndex) found = p - buffer;
+    }
+    return found;
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+    if (left > right){
+        unsigned int temp = right;
+        right = left;
+        left = temp;
+    }
+    String out;
+    if (left >= len) return out;
+    if (right > len) right = len;
+    out.copy(buffer + left, right - left);
+    return out;
+}
+
+void String::replace(char find, char replace){
+    if (!buffer) return;
+    for (char * p = buffer; *p; p++){
+        if (*p == find) *p = replace;
+    }
+}
+
+void String::replace(const String & find, const String & replace){
+    if (len == 0 || find.len == 0) return;
+    std::string s(buffer, len), out;
+    size_t at = 0, hit;
+    while ((hit = s.find(find.c_str(), at, find.len)) != std::string::npos){
+        out.append(s, at, hit - at);
+        out.append(replace.c_str(), replace.len);
+        at = hit + find.len;
+    }
+    out.append(s, at, std::string::npos);
+    copy(out.c_str(), out.size());
+}
+
+void String::remove(unsigned int index){
+    remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count){
+    if (index >= len) return;
+    if (count > len - index) count = len - index;
+    char * writeTo = buffer + index;
+    len = len - count;
+    memmove(writeTo, buffer + index + count, len - index);
+    buffer[len] = 0;
+}
+
+void String::toLowerCase(){
+    if (!buffer) return;
+    for (char * p = buffer; *p; p++) *p = tolower((unsigned char)*p);
+}
+
+void String::toUpperCase(){
+    if (!buffer) return;
+    for (char * p = buffer; *p; p++) *p = toupper((unsigned char)*p);
+}
+
+void String::trim(){
+    if (!buffer || len == 0) return;
+    char * begin = buffer;
+    while (isspace((unsigned char)*begin)) begin++;
+    char * end = buffer + len - 1;
+    while (isspace((unsigned char)*end) && end >= begin) end--;
+    len = end + 1 - begin;
+    if (begin > buffer) memmove(buffer, begin, len);
+    buffer[len] = 0;
+}
+
+long String::toInt() const {
+    return buffer ? atol(buffer) : 0;
+}
+
+float String::toFloat() const {
+    return float(toDouble());
+}
+
+double String::toDouble() const {
+    return buffer ? atof(buffer) : 0;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <Arduino.h>
+
+// Nothing is on the bus in the native build, the device classes talk to Hal.h directly
+class TwoWire : public Stream {
+public:
+    void begin() {}
+    void setClock(uint32_t) {}
+    void beginTransmission(uint8_t) {}
+    uint8_t endTransmission(bool = true) { return 2; }
+    uint8_t requestFrom(uint8_t, uint8_t, bool = true) { return 0; }
+    size_t write(uint8_t) override { return 1; }
+    using Print::write;
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,17 @@
+#pragma once
+
+// Interrupt vectors are plain functions, HalAvr.cpp calls the ones the sketch defines
+#define ISR(vector, ...) extern "C" void vector(void)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void cli(void);
+void sei(void);
+void interrupts(void);
+void noInterrupts(void);
+
+#ifdef __cplusplus
+}
+#endif
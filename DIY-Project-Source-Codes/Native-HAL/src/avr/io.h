@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+
+// The few ATmega2560 registers the Sensor Node's LowPower.h touches, as plain variables (see HalAvr.cpp)
+extern volatile uint8_t MCUSR, WDTCSR, ADCSRA;
+
+#define WDP0 0
+#define WDP1 1
+#define WDP2 2
+#define WDE 3
+#define WDCE 4
+#define WDP3 5
+#define WDIE 6
+#define WDIF 7
+
+#define WDRF 3
+
+#define ADEN 7
+
+#define E2END 0xFFF
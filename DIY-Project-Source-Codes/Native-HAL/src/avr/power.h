@@ -0,0 +1,10 @@
+#pragma once
+
+#define power_adc_disable()
+#define power_adc_enable()
+#define power_spi_disable()
+#define power_spi_enable()
+#define power_twi_disable()
+#define power_twi_enable()
+#define power_all_disable()
+#define power_all_enable()
@@ -0,0 +1,15 @@
+#pragma once
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_ADC 1
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_PWR_SAVE 3
+#define SLEEP_MODE_STANDBY 6
+
+void set_sleep_mode(int mode);
+void sleep_enable(void);
+void sleep_disable(void);
+
+// Sleeps until the watchdog or a pin interrupt would wake the MCU, millis() doesn't move on meanwhile
+void sleep_cpu(void);
+void sleep_mode(void);
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+
+// Adafruit GFX font format, used by Adafruit_GFX and TFT_eSPI alike
+typedef struct {
+    uint16_t bitmapOffset;  // into the font's bitmap
+    uint8_t width;          // bitmap size
+    uint8_t height;
+    uint8_t xAdvance;       // distance to the next character's origin
+    int8_t xOffset;         // from the cursor to the top left of the bitmap
+    int8_t yOffset;
+} GFXglyph;
+
+typedef struct {
+    uint8_t * bitmap;       // glyph bitmaps, MSB first, rows packed without padding
+    GFXglyph * glyph;
+    uint16_t first;         // ASCII range
+    uint16_t last;
+    uint8_t yAdvance;       // line height
+} GFXfont;
+
+// The TFT_eSPI / Adafruit free fonts the sketches use, blocky 3x5 pixel glyphs scaled to roughly the size
+// of the real ones (see HalDisplay.cpp)
+extern const GFXfont FreeMono9pt7b, FreeMono12pt7b, FreeMono18pt7b, FreeMono24pt7b;
+extern const GFXfont FreeMonoBold9pt7b, FreeMonoBold12pt7b, FreeMonoBold18pt7b, FreeMonoBold24pt7b;
+extern const GFXfont FreeSans9pt7b, FreeSans12pt7b, FreeSans18pt7b, FreeSans24pt7b;
+extern const GFXfont FreeSansBold9pt7b, FreeSansBold12pt7b, FreeSansBold18pt7b, FreeSansBold24pt7b;
+extern const GFXfont FreeSerif9pt7b, FreeSerif12pt7b, FreeSerif18pt7b, FreeSerif24pt7b;
+extern const GFXfont FreeSerifBold9pt7b, FreeSerifBold12pt7b, FreeSerifBold18pt7b, FreeSerifBold24pt7b;
@@ -0,0 +1,77 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Program           - Sensor Node hot path micro-benchmarks
+// Software          - C/C++, PlatformIO IDE - pio run -e bench -t upload (board), pio run -e native_bench (PC)
+// -----------------------------------------------------------------------------------------------------------//
+// Builds the Sensor Node sketch with its Wio E5 UART (Serial1) replaced by a BenchModem, then times the code
+// every sample tick runs: the AT command ack matching and the String payload of the live frame. One BENCH,...
+// line per case on the serial monitor (see ../Common/src/Bench.h). at_send_check_response() waits 2 ms per
+// received byte, on the board that is most of its time, on the PC delay() only moves the simulated clock.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <Arduino.h>
+#include "Bench.h"
+
+BenchModem benchModem;
+
+// The sketch, with its own setup() / loop() renamed out of the way
+#define Serial1 benchModem
+#define setup sketchSetup
+#define loop sketchLoop
+#include "../src/main.cpp"
+#undef setup
+#undef loop
+#undef Serial1
+
+#ifdef ARDUINO_ARCH_NATIVE
+#include "Hal.h"
+#endif
+
+// What the Wio E5 answers to a live frame, and the Gateway's ack of it
+static const char txDone[] = "+TEST: TXLRSTR \"47572C3232302C3134382C3235342C36302C32352C302E35372C302C302C3137\"\r\n"
+                             "+TEST: TX DONE\r\n";
+static const char ackRx[] = "+TEST: RXLRPKT\r\n"
+                            "+TEST: LEN:5, RSSI:-70, SNR:9\r\n"
+                            "+TEST: RX \"414B2C3137\"\r\n";
+
+static char txCmd[] = "AT+TEST=TXLRSTR,\"GW,220,148,254,60,25,0.57,0,0,17\"\r\n";
+
+static void atAckOp(){
+    benchSink += at_send_check_response("TX DONE", 6000, txCmd);
+}
+
+static void payloadOp(){
+    String s = LoRa_payload();
+    benchSink += s.length();
+}
+
+#ifdef HISTORY_LOG
+static void waitAckOp(){
+    benchSink += LoRa_wait_ack(17);
+}
+#endif
+
+void setup(){
+    Serial.begin(9600);
+    m1 = 220;
+    m2 = 148;
+    rain_per = 254;
+    humi = 60;
+    temp = 25;
+    disp = 0.57;
+
+    benchBegin(Serial);
+    benchModem.answer(txDone);
+    benchRun("at_send_check_response", atAckOp, 10);
+    benchRun("LoRa_payload", payloadOp, 200);
+#ifdef HISTORY_LOG
+    benchModem.answer(ackRx);
+    benchRun("LoRa_wait_ack", waitAckOp, 10);
+#endif
+}
+
+void loop(){
+#ifdef ARDUINO_ARCH_NATIVE
+    halStop();
+#endif
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "HistoryFormat.h"   // HistoryRecord, shared with the End Node and the host tools
+
+/*
+Circular history log of encoded sensor samples in the Mega 2560's 4 KB EEPROM.
+
+Every record carries its own sequence number and checksum, there is no head
+pointer stored anywhere: at boot the log is scanned and the newest valid
+record is the head. Writes walk round the whole EEPROM, so every cell gets
+the same wear (one write per 372 samples, two for the flags and check bytes).
+
+A delivered record gets its HISTORY_SENT flag set in the EEPROM, so the
+backlog of records still to reach the gateway is rebuilt at boot.
+
+USAGE:
+
+    history.begin();                              // once in setup(), scans the EEPROM
+    uint16_t seq = history.append(rec);           // log a new sample, returns its seq
+    history.markSent(seq);                        // gateway acknowledged the live frame
+    uint8_t n = history.nextBatch(batch, 4);      // oldest pending records for a backfill frame
+    history.ackBatch(batch, n);                   // gateway acknowledged the backfill frame
+ */
+
+#define HISTORY_SLOTS ((E2END + 1) / sizeof(HistoryRecord))
+
+class HistoryLog {
+public:
+    // Function to find the newest record, the next seq and the undelivered records after a reboot
+    void begin(){
+        bool found = false;
+        uint16_t ref = 0;
+        int16_t best = 0;
+        HistoryRecord rec;
+
+        memset(pending, 0, sizeof(pending));
+        for (uint16_t slot = 0; slot < HISTORY_SLOTS; slot++){
+            if (!read(slot, rec)){
+                continue;
+            }
+            setPending(slot, !(rec.flags & HISTORY_SENT));
+            if (!found){
+                found = true;
+                ref = rec.seq;
+                best = 0;
+                head = slot;
+                continue;
+            }
+            // Serial number arithmetic, the live window is far smaller than 2^15
+            int16_t diff = (int16_t)(rec.seq - ref);
+            if (diff > best){
+                best = diff;
+                head = slot;
+            }
+        }
+        if (found){
+            nextSeq = ref + best + 1;
+            head = (head + 1) % HISTORY_SLOTS;
+        } else {
+            nextSeq = 0;
+            head = 0;
+        }
+    }
+
+    // Function to append a sample, overwriting the oldest one. Returns its seq
+    uint16_t append(HistoryRecord & rec){
+        rec.seq = nextSeq++;
+        rec.flags &= ~HISTORY_SENT;
+        rec.check = historyCheck(rec);
+        const uint8_t * p = (const uint8_t *)&rec;
+        int base = head * sizeof(HistoryRecord);
+        for (uint8_t i = 0; i < sizeof(HistoryRecord); i++){
+            EEPROM.update(base + i, p[i]);   // skips bytes that didn't change
+        }
+        setPending(head, true);
+        head = (head + 1) % HISTORY_SLOTS;
+        return rec.seq;
+    }
+
+    // Function to mark a record as delivered by its seq, in RAM and in its EEPROM flags
+    void markSent(uint16_t seq){
+        uint16_t back = (uint16_t)(nextSeq - seq);
+        if (back == 0 || back > HISTORY_SLOTS){
+            return;
+        }
+        uint16_t slot = (head + HISTORY_SLOTS - back) % HISTORY_SLOTS;
+        HistoryRecord rec;
+        setPending(slot, false);
+        if (!read(slot, rec) || rec.seq != seq || (rec.flags & HISTORY_SENT)){
+            return;
+        }
+        rec.flags |= HISTORY_SENT;
+        rec.check = historyCheck(rec);
+        // flags and check are the last two bytes, one write each. A reset between them
+        // leaves a bad checksum, the record is lost rather than sent twice
+        int base = slot * sizeof(HistoryRecord);
+        EEPROM.update(base + offsetof(HistoryRecord, flags), rec.flags);
+        EEPROM.update(base + offsetof(HistoryRecord, check), rec.check);
+    }
+
+    // Function to collect up to max of the oldest undelivered records
+    uint8_t nextBatch(HistoryRecord * out, uint8_t max){
+        uint8_t n = 0;
+        for (uint16_t i = 0; i < HISTORY_SLOTS && n < max; i++){
+            uint16_t slot = (head + i) % HISTORY_SLOTS;   // oldest first
+            if (isPending(slot) && read(slot, out[n])){
+                n++;
+            }
+        }
+        return n;
+    }
+
+    void ackBatch(const HistoryRecord * batch, uint8_t n){
+        for (uint8_t i = 0; i < n; i++){
+            markSent(batch[i].seq);
+        }
+    }
+
+    bool hasBacklog(){
+        for (uint8_t i = 0; i < sizeof(pending); i++){
+            if (pending[i]){
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    uint16_t head = 0;        // slot the next record goes to
+    uint16_t nextSeq = 0;
+    uint8_t  pending[(HISTORY_SLOTS + 7) / 8];
+
+    bool read(uint16_t slot, HistoryRecord & rec){
+        uint8_t * p = (uint8_t *)&rec;
+        int base = slot * sizeof(HistoryRecord);
+        for (uint8_t i = 0; i < sizeof(HistoryRecord); i++){
+            p[i] = EEPROM.read(base + i);
+        }
+        return rec.check == historyCheck(rec);
+    }
+
+    void setPending(uint16_t slot, bool on){
+        if (on) pending[slot >> 3] |= _BV(slot & 7);
+        else    pending[slot >> 3] &= ~_BV(slot & 7);
+    }
+
+    bool isPending(uint16_t slot){
+        return pending[slot >> 3] & _BV(slot & 7);
+    }
+};
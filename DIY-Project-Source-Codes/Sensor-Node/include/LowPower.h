@@ -0,0 +1,149 @@
+#pragma once
+#include <Arduino.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#include <avr/power.h>
+
+/*
+Power management helpers for the Sensor Node (Arduino Mega 2560).
+
+The MCU is put in POWER_DOWN between sample ticks and woken by the watchdog
+timer or by the ADXL345 activity interrupt (INT1 -> ACCEL_INT_PIN).
+
+millis() is frozen while the MCU is powered down, so the time spent asleep is
+accumulated in sleptMillis() and added back by nowMillis(). Use nowMillis()
+for every interval check when LOW_POWER_MODE is enabled.
+
+USAGE:
+
+    lowPowerBegin();                    // once in setup()
+    ...
+    uint8_t src = sleepFor(ms);         // returns WAKE_TIMER or WAKE_ACCEL
+ */
+
+// ADXL345 INT1 is wired to D2 (INT4). INT4..7 can only wake the MCU from
+// POWER_DOWN on a LOW level, so the ADXL345 interrupt output is inverted.
+#ifndef ACCEL_INT_PIN
+#define ACCEL_INT_PIN 2
+#endif
+
+// ADXL345 activity threshold, 62.5 mg/LSB (8 = 0.5 g)
+#ifndef ACCEL_ACT_THRESHOLD
+#define ACCEL_ACT_THRESHOLD 8
+#endif
+
+#define WAKE_TIMER 0
+#define WAKE_ACCEL 1
+
+static volatile bool wdtFired = false;
+static volatile bool accelFired = false;
+static unsigned long sleptMs = 0;
+
+ISR(WDT_vect){
+    wdtFired = true;
+}
+
+static void accelWakeISR(){
+    // LOW level interrupt keeps firing while the line is held, detach until
+    // the ADXL345 INT_SOURCE register has been read and the line released
+    detachInterrupt(digitalPinToInterrupt(ACCEL_INT_PIN));
+    accelFired = true;
+}
+
+// Milliseconds spent in POWER_DOWN since boot
+unsigned long sleptMillis(){
+    return sleptMs;
+}
+
+// millis() corrected for the time spent asleep
+unsigned long nowMillis(){
+    return millis() + sleptMs;
+}
+
+// Function to start the watchdog in interrupt-only mode with the given prescaler
+static void wdtArm(uint8_t prescaler){
+    uint8_t bits = (prescaler & 0x07) | ((prescaler & 0x08) ? _BV(WDP3) : 0);
+    cli();
+    MCUSR &= ~_BV(WDRF);
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = _BV(WDIE) | bits;
+    sei();
+}
+
+static void wdtDisarm(){
+    cli();
+    MCUSR &= ~_BV(WDRF);
+    WDTCSR = _BV(WDCE) | _BV(WDE);
+    WDTCSR = 0;
+    sei();
+}
+
+// Function to configure the ADXL345 activity interrupt (needs accel.begin() first)
+template<class Accel>
+void accelActivityBegin(Accel & accel){
+    accel.writeRegister(ADXL345_REG_THRESH_ACT, ACCEL_ACT_THRESHOLD);
+    // AC-coupled X/Y/Z activity: measured against the reading when it was enabled. DC-coupled, gravity
+    // alone puts >= 0.577 g on some axis in any orientation and the interrupt would never clear
+    accel.writeRegister(ADXL345_REG_ACT_INACT_CTL, 0xF0);
+    accel.writeRegister(ADXL345_REG_INT_MAP, 0x00);        // everything on INT1
+    uint8_t format = accel.readRegister(ADXL345_REG_DATA_FORMAT);
+    accel.writeRegister(ADXL345_REG_DATA_FORMAT, format | 0x20);  // INT_INVERT, active low
+    accel.writeRegister(ADXL345_REG_INT_ENABLE, 0x10);     // Activity
+    accel.readRegister(ADXL345_REG_INT_SOURCE);            // clear anything pending
+}
+
+// Function to acknowledge an ADXL345 interrupt so the INT1 line is released
+template<class Accel>
+void accelActivityClear(Accel & accel){
+    accel.readRegister(ADXL345_REG_INT_SOURCE);
+}
+
+// Function to prepare pins for sleeping
+void lowPowerBegin(){
+    pinMode(ACCEL_INT_PIN, INPUT_PULLUP);
+    wdtDisarm();
+}
+
+// Function to sleep for up to ms milliseconds in POWER_DOWN.
+// The watchdog is re-armed with the largest period that still fits, so long
+// sleeps are made of 8 s, 4 s, 2 s ... 16 ms slices. Returns early on accel activity, the watchdog
+// has no counter to read how much of the cut slice went by, so half of it is counted (error +- half a slice).
+uint8_t sleepFor(unsigned long ms){
+    static const uint16_t periods[] = { 16, 32, 64, 125, 250, 500, 1000, 2000, 4000, 8000 };
+
+    logFlush();
+    Serial.flush();
+    Serial1.flush();
+
+    accelFired = false;
+    attachInterrupt(digitalPinToInterrupt(ACCEL_INT_PIN), accelWakeISR, LOW);
+
+    uint8_t adcsra = ADCSRA;
+    ADCSRA &= ~_BV(ADEN);   // ADC draws ~200 uA even when idle
+
+    while (ms >= periods[0] && !accelFired){
+        int8_t p = 9;
+        while (p > 0 && periods[p] > ms) p--;
+
+        wdtFired = false;
+        wdtArm(p);
+        set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+        cli();
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+        wdtDisarm();
+
+        if (wdtFired){
+            sleptMs += periods[p];
+            ms -= periods[p];
+        } else if (accelFired){
+            sleptMs += periods[p] / 2;
+        }
+    }
+
+    ADCSRA = adcsra;
+    detachInterrupt(digitalPinToInterrupt(ACCEL_INT_PIN));
+    return accelFired ? WAKE_ACCEL : WAKE_TIMER;
+}
@@ -23,6 +23,37 @@
 #include "DHT.h"                // Include DHT Sensors library
 #include <Adafruit_Sensor.h>    // Include Generic Sensor Library
 #include <Adafruit_ADXL345_U.h> // Include MEMS ADXL345 Sensor Library
+#include "Log.h"                // Logging with compile-time levels (LOG_LEVEL) and non-blocking output
+#include "TextField.h"          // Display fields that are only redrawn when their value changes
+#include "HistoryFormat.h"      // SENSOR_SEND_INTERVAL, and the history records of HISTORY_LOG
+
+// Power managed (battery/solar) operation - MCU sleeps between sample ticks, Wio-E5 sleeps between
+// transmits. Uncomment here or add -D LOW_POWER_MODE to build_flags in platformio.ini
+//#define LOW_POWER_MODE
+
+// On-node history of samples in EEPROM, backfilled to the Gateway after a link outage.
+// Needs the Gateway firmware that answers "AK,<seq>". Uncomment here or add -D HISTORY_LOG to build_flags
+//#define HISTORY_LOG
+
+#ifdef HISTORY_LOG
+#include "HistoryLog.h"         // EEPROM circular sample log
+#endif
+
+#ifdef LOW_POWER_MODE
+#include "LowPower.h"           // Watchdog/ADXL345 wake-up sleep helpers
+#else
+// Without sleeping millis() is the wall clock
+static inline unsigned long nowMillis(){ return millis(); }
+#endif
+
+// Capture of the Wio E5 AT traffic in a RAM ring, a "TRACE" line on the serial monitor prints it for
+// Native-HAL replay (see ../Common/src/AtTrace.h). Uncomment here or add -D AT_TRACE to build_flags
+//#define AT_TRACE
+
+#ifdef AT_TRACE
+#define AT_TRACE_CLOCK nowMillis    // keeps counting while the MCU sleeps
+#include "AtTrace.h"
+#endif
 
 // Declare pins for the display:
 #define TFT_CS     53
@@ -36,9 +67,24 @@
 // Invoke Display and Create display Instance 
 Adafruit_ST7735 tft = Adafruit_ST7735(TFT_CS, TFT_DC, TFT_RST);
 
+#ifdef AT_TRACE
+AtTraceRing<AT_TRACE_SIZE> atTrace(AT_TRACE_SENSOR);
+AtTap<HardwareSerial> e5(Serial1, atTrace);     // Wio E5 on Serial1, through the capture
+#else
+auto & e5 = Serial1;                            // Wio E5 on Serial1
+#endif
+
 // LoRa Data receive buffer
 static char recv_buf[512];
 static bool is_exist = false;
+// Module was already configured at boot (see configLoRaModule)
+static bool lora_warm = false;
+// millis() when the first LoRa packet went through, 0 until then
+static unsigned long firstPacketTime = 0;
+
+// Wio-E5 TEST mode radio settings, and how AT+TEST=? reports them back
+#define LORA_RFCFG_CMD  "AT+TEST=RFCFG,866,SF12,125,12,15,14,ON,OFF,OFF\r\n"
+#define LORA_RFCFG_ECHO "+TEST: RFCFG F:866000000, SF12, BW125K, TXPR:12, RXPR:15, POW:14dBm, CRC:ON, IQ:OFF, NET:OFF"
 
 // DHT Sensor Definitions
 #define DHTPIN 9     // Digital pin connected to the DHT sensor 
@@ -72,7 +118,7 @@ const uint16_t noRain = 21;
 const uint16_t FullRain = 1024;
 
 // Readings Update Interval Settings
-const unsigned long sendInterval = 20000;
+const unsigned long sendInterval = SENSOR_SEND_INTERVAL;
 const unsigned long updateInterval = 5000;
 
 unsigned long previousTime = 0;
@@ -81,6 +127,30 @@ unsigned long previousUpdateTime = 0;
 // ADXL345 Accelerometer 
 Adafruit_ADXL345_Unified accel = Adafruit_ADXL345_Unified();
 
+#ifdef HISTORY_LOG
+HistoryLog history;
+
+// Records per backfill frame, 4 x 11 bytes keeps SF12 airtime around 2 s
+#define HISTORY_BATCH 4
+// How long to listen for the Gateway's "AK,<seq>" after a transmit
+const unsigned long ackTimeout = 4000;
+// Wait between the live frame's ack and the backfill frame. The Gateway relays the live frame right
+// after its ack ("EN,..." is ~2 s at SF12) and is half duplex, then reads its sensors and restarts
+// receive - a backfill sent before that is lost and collides with the relay at the End Node
+#ifndef HISTORY_BACKFILL_DELAY
+#define HISTORY_BACKFILL_DELAY 3500
+#endif
+#endif
+
+#ifdef LOW_POWER_MODE
+// Wake cycle instrumentation, reported as "PWR,..." lines for Host-Tools/energy_model
+unsigned long wakeCount = 0;
+unsigned long lastSleepTime = 0;
+uint8_t wakeSource = WAKE_TIMER;
+// Part of this cycle's transmit phase spent listening for acks, the E5 draws RX not TX current then
+unsigned long rxListenTime = 0;
+#endif
+
 
 // Function to check response for AT commands
 static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
@@ -91,10 +161,9 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
     va_list args;
     memset(recv_buf, 0, sizeof(recv_buf));
     va_start(args, p_cmd);
-    Serial1.print(p_cmd);
-    Serial.print(p_cmd);
+    e5.print(p_cmd);
+    LOG_DEBUG_STR(p_cmd);
     va_end(args);
-    delay(200);
     startMillis = millis();
 
     if (p_ack == NULL)
@@ -102,49 +171,81 @@ static int at_send_check_response(char *p_ack, int timeout_ms, char *p_cmd, ...)
 
     do
     {
-        while (Serial1.available() > 0)
+        while (e5.available() > 0)
         {
-            ch = Serial1.read();
+            ch = e5.read();
             recv_buf[index++] = ch;
-            Serial.print((char)ch);
+            LOG_TRACE_CHAR(ch);
             delay(2);
         }
+        logPump();
 
         if (strstr(recv_buf, p_ack) != NULL)
             return 1;
 
     } while (millis() - startMillis < timeout_ms);
-    Serial.println();
     return 0;
 }
 
+// Function to report how long after boot the first LoRa packet went through
+static void reportFirstPacket(){
+  if (firstPacketTime == 0)
+  {
+    firstPacketTime = millis();
+    LOG_INFO("First packet at %lu ms after boot", firstPacketTime);
+  }
+}
+
 // Function to configure Wio-E5 LoRa Dev Board in Test Mode - Check AT commands Specification Guide
 // for more details about these command sequences  
 void configLoRaModule(){
   //Configure LoRa E5 Dev Kit in Test Mode
-  Serial.println("Configuring Wio E5 LoRa Dev Board ...");
-  delay(250);
-  if (at_send_check_response("+AT: OK", 100, "AT\r\n"))
+  LOG_INFO("Configuring Wio E5 LoRa Dev Board ...");
+  if (at_send_check_response("+AT: OK", 300, "AT\r\n"))
   {
     is_exist = true;
-    at_send_check_response("+MODE: TEST", 1500, "AT+MODE=TEST\r\n");
-    at_send_check_response("+TEST: RFCFG", 1500, "AT+TEST=RFCFG,866,SF12,125,12,15,14,ON,OFF,OFF\r\n");
-    delay(500);
+    // Warm boot - the module kept its power (only we were reset) and is still in TEST mode
+    // with our RF settings, AT+TEST=? answers ERROR(-12) when it isn't in TEST mode
+    if (at_send_check_response(LORA_RFCFG_ECHO, 500, "AT+TEST=?\r\n"))
+    {
+      lora_warm = true;
+    }
+    // Cold boot - both commands are sent back to back and the module works through them,
+    // fall back to sending RFCFG again if it got lost while the LoRa chip was resetting
+    else if (!at_send_check_response("+TEST: RFCFG", 3000, "AT+MODE=TEST\r\n" LORA_RFCFG_CMD))
+    {
+      at_send_check_response("+TEST: RFCFG", 1500, LORA_RFCFG_CMD);
+    }
+    LOG_INFO("%s, radio ready at %lu ms", lora_warm ? "Wio E5 warm boot" : "Wio E5 configured", millis());
   }
   else
   {
     is_exist = false;
-    Serial.print("No E5 module found.\r\n");
+    LOG_ERROR("No E5 module found.");
+  }
+}
+
+#ifdef LOW_POWER_MODE
+// Function to put Wio-E5 in sleep mode, it stays asleep until next character on its UART
+void sleepLoRaModule(){
+  at_send_check_response("+LOWPOWER: SLEEP", 500, "AT+LOWPOWER\r\n");
+}
+
+// Function to wake up Wio-E5 from sleep mode - dummy bytes wake the UART, then check it answers
+void wakeLoRaModule(){
+  for (uint8_t i = 0; i < 4; i++){
+    e5.write(0xFF);
   }
-  delay(500);
+  e5.flush();
+  delay(5);
+  at_send_check_response("+AT: OK", 500, "AT\r\n");
 }
+#endif
 
 // Function to Setup Display for Initial Screen
 void setupDisplay(){
   // Display setup:
-  Serial.println("");
-  Serial.println("Setting up Display ...");
-  delay(250);
+  LOG_INFO("Setting up Display ...");
   // Use this initializer if you're using a 1.8" TFT
   tft.initR(INITR_BLACKTAB);  // Initialize a ST7735S chip, black tab
 
@@ -211,8 +312,11 @@ void setupDisplay(){
 
 // Function to Initialise DHT Sensor and Check Readings
 void checkDHT(){
+#ifndef LOW_POWER_MODE
   // Wait a few seconds between measurements.
+  // (Not needed when sleeping, sample ticks are already longer than that)
   delay(2000);
+#endif
 
   // Reading temperature or humidity takes about 250 milliseconds!
   // Sensor readings may also be up to 2 seconds 'old' (its a very slow sensor)
@@ -227,7 +331,7 @@ void checkDHT(){
 
   // Check if any reads failed and exit early (to try again).
   if (isnan(h) || isnan(t) || isnan(f)) {
-    Serial.println(F("Failed to read from DHT sensor!"));
+    LOG_WARN("Failed to read from DHT sensor!");
     return;
   }
 
@@ -243,7 +347,8 @@ void checkDHT(){
 void init_accel(){
   if(!accel.begin())
   {
-    Serial.println("No ADXL345 sensor detected.");
+    LOG_ERROR("No ADXL345 sensor detected.");
+    logFlush();
     while(1);
   }
 }
@@ -277,7 +382,9 @@ void checkRain(){
 // Function to Get All Sensor Readings at a time
 void getReadings(){
   checkDHT();
+#ifndef LOW_POWER_MODE
   init_accel();
+#endif
   getSoilM();
   checkRain();
   getAccel();
@@ -288,70 +395,134 @@ void getReadings(){
 void checkStatus(){
   if((m1 < 60) && (m2 < 60) && (rain_per < 50) && (humi < 60) && (temp > 25) && (disp < 1) && (vib == 0)){
     status = "Normal";
+    stat = 0;
   }
   else if((m1 > 60) && (m2 > 60) && (rain_per > 50) && (humi > 60) && (temp < 25)){
     if ((disp > 1) && (vib == 1)){
       status = "Alert";
       stat = 1;
     }
-  else
-    status = "Normal";
-    stat = 0;
+    else{
+      status = "Normal";
+      stat = 0;
+    }
   }
+  // Readings in neither band leave status and stat as they were
 }
 
+// On-screen value fields, redrawn only when their value changes
+TextField m1Field(70, 28), m2Field(70, 45), rainField(70, 60), humiField(70, 75);
+TextField tempField(70, 90), vibField(70, 105), dispField(70, 120), statusField(70, 148);
+// Status bar colour currently on screen, setupDisplay() draws it blue
+bool statusBarAlert = false;
+
 // Function to Display Readings from Sensors Locally
 void displayReadings(){
 
-  tft.setTextSize(1);  // Set text size. Goes from 0 (the smallest) to 20 (very big)
-  tft.setCursor(70, 28);  // Set position (x,y)
-  tft.setTextColor(ST7735_CYAN, ST7735_BLACK);  // Set color of text. First is the color of text and after is color of background
-  tft.println(m1);  // Print a text or value
-
-  tft.setCursor(70, 45);  // Set position (x,y)
-  tft.println(m2);  // Print a text or value
-
-  tft.setCursor(70, 60);  // Set position (x,y)
-  tft.println(rain_per);  // Print a text or value
-
-  tft.setCursor(70, 75);  // Set position (x,y)
-  tft.println(humi);  // Print a text or value
-
-
-  tft.setCursor(70, 90);  // Set position (x,y)
-  tft.println(temp);  // Print a text or value
+  m1Field.drawNumber(tft, m1, ST7735_CYAN, ST7735_BLACK);
+  m2Field.drawNumber(tft, m2, ST7735_CYAN, ST7735_BLACK);
+  rainField.drawNumber(tft, rain_per, ST7735_CYAN, ST7735_BLACK);
+  humiField.drawNumber(tft, humi, ST7735_CYAN, ST7735_BLACK);
+  tempField.drawNumber(tft, temp, ST7735_CYAN, ST7735_BLACK);
+  vibField.drawNumber(tft, vib, ST7735_CYAN, ST7735_BLACK);
+  dispField.drawFloat(tft, disp, 2, ST7735_CYAN, ST7735_BLACK);
+
+  // Repaint the status bar only when the alert state flips
+  uint16_t barColor = stat == 1 ? ST7735_RED : ST7735_BLUE;
+  if (statusBarAlert != (stat == 1)){
+    statusBarAlert = (stat == 1);
+    tft.fillRect(1,142,127,18, barColor);
+    tft.setCursor(15, 148);  // Set position (x,y)
+    tft.setTextColor(ST7735_WHITE);
+    tft.println("Status : ");  // Print a text or value
+    statusField.invalidate();
+  }
+  statusField.draw(tft, status.c_str(), ST7735_WHITE, barColor);
+}
 
+#ifdef HISTORY_LOG
+// Function to wait for the Gateway's acknowledgement "AK,<seq>" of a frame
+static int LoRa_wait_ack(uint16_t seq)
+{
+  char ack[24] = "414B2C";    // "AK," as reported in hex by +TEST: RX
+  char digits[8];
+  int len = strlen(ack);
+  snprintf(digits, sizeof(digits), "%u", seq);
+  for (char *p = digits; *p; p++) {
+    len += sprintf(ack + len, "%02X", *p);
+  }
+  strcpy(ack + len, "\"");     // closing quote so AK,12 doesn't match AK,123
+#ifdef LOW_POWER_MODE
+  unsigned long listenStart = millis();
+  int ret = at_send_check_response(ack, ackTimeout, "AT+TEST=RXLRPKT\r\n");
+  rxListenTime += millis() - listenStart;
+  return ret;
+#else
+  return at_send_check_response(ack, ackTimeout, "AT+TEST=RXLRPKT\r\n");
+#endif
+}
 
-  tft.setCursor(70, 105);  // Set position (x,y)
-  tft.println(vib);  // Print a text or value
+// Function to log the current readings, returns the record's seq
+static uint16_t logReadings()
+{
+  HistoryRecord rec;
+  rec.m1 = m1;
+  rec.m2 = m2;
+  rec.rain = rain_per;
+  rec.humi = humi;
+  rec.temp = temp;
+  rec.disp = (int16_t)(disp * 100);
+  rec.flags = (vib ? HISTORY_VIB : 0) | (stat ? HISTORY_ALERT : 0);
+  return history.append(rec);
+}
 
+// Function to send one batch of unacknowledged history - at most one per send interval, after the live frame
+// Frame is binary : "HB," <count> <count x HistoryRecord>
+static int LoRa_backfill()
+{
+  HistoryRecord batch[HISTORY_BATCH];
+  char cmd[64 + 2 * (4 + sizeof(batch))] = "";
+  uint8_t n = history.nextBatch(batch, HISTORY_BATCH);
+  if (n == 0)
+    return 0;
 
-  tft.setCursor(70, 120);  // Set position (x,y)
-  tft.println(disp);  // Print a text or value
+  int len = sprintf(cmd, "AT+TEST=TXLRPKT,\"48422C%02X", n);
+  const uint8_t *p = (const uint8_t *)batch;
+  for (uint16_t i = 0; i < n * sizeof(HistoryRecord); i++) {
+    len += sprintf(cmd + len, "%02X", p[i]);
+  }
+  strcpy(cmd + len, "\"\r\n");
 
-  if(stat == 1){
-  tft.fillRect(1,142,127,18, ST7735_RED);
-  tft.setCursor(15, 148);  // Set position (x,y)
-  tft.setTextColor(ST7735_WHITE);
-  tft.println("Status : ");  // Print a text or value    
-  tft.setTextColor(ST7735_WHITE, ST7735_RED); 
-  }else {
-    tft.setTextColor(ST7735_WHITE, ST7735_BLUE); 
+  if (at_send_check_response("TX DONE", 6000, cmd) && LoRa_wait_ack(batch[0].seq)) {
+    history.ackBatch(batch, n);
+    LOG_INFO("Backfilled %u records", n);
+    return 1;
   }
-  
-  tft.setCursor(70, 148);  // Set position (x,y)
-  tft.println(status);  // Print a text or value
+  return 0;
+}
+#endif
+
+// Function for the live frame's payload "m1,m2,rain,humi,temp,disp,vib,stat"
+static String LoRa_payload()
+{
+  String sensorData = "";
+  sensorData = sensorData + String(m1) + "," + String(m2) + "," + String(rain_per) + "," + String(humi) 
+                + "," + String(temp) + "," + String(disp) + "," + String(vib) + "," + String(stat);
+  return sensorData;
 }
 
 // Function for LoRa packet preparation and sending
 static int LoRa_send()
 {
-  String sensorData = "";
+  String sensorData = LoRa_payload();
   char cmd[256] = "";
   char data[128] = "";
   int ret = 0;
-  sensorData = sensorData + String(m1) + "," + String(m2) + "," + String(rain_per) + "," + String(humi) 
-                + "," + String(temp) + "," + String(disp) + "," + String(vib) + "," + String(stat);
+#ifdef HISTORY_LOG
+  // Sequence number goes last so parsers of the first 8 fields are unaffected
+  uint16_t seq = logReadings();
+  sensorData = sensorData + "," + String(seq);
+#endif
   //Serial.print("Printing Sensor Data String : ");
   //Serial.println(sensorData);
 
@@ -365,39 +536,111 @@ static int LoRa_send()
   ret = at_send_check_response("TX DONE", 6000, cmd);
     if (ret == 1)
     {
-      Serial.println("");
-      Serial.print("Sent successfully!\r\n");
+      LOG_INFO("Sent successfully!");
+      reportFirstPacket();
+#ifdef HISTORY_LOG
+      if (LoRa_wait_ack(seq))
+      {
+        history.markSent(seq);
+      }
+      else
+      {
+        ret = 0;
+        LOG_WARN("No ack, kept for backfill");
+      }
+#endif
     }
     else
     {
-      Serial.println("");
-      Serial.print("Send failed!\r\n");
+      LOG_WARN("Send failed!");
     }
   return ret;
 }
 
+// Function to send the live readings first, then one batch of missed history once the link is back
+static void sendReadings()
+{
+#ifdef HISTORY_LOG
+  int ret = LoRa_send();
+  if (ret == 1 && history.hasBacklog())
+  {
+    delay(HISTORY_BACKFILL_DELAY);
+    LoRa_backfill();
+  }
+#else
+  LoRa_send();
+#endif
+}
+
 // Function to Setup the Initializations and Configurations
 void setup() {
   // put your setup code here, to run once:
   //initialize the library
   Serial.begin(9600);
-  Serial1.begin(9600);
-  Serial.println("LandSlide Monitoring - Starting!!");
-  delay(250);
+  e5.begin(9600);
+  logBegin(Serial);
+  LOG_INFO("LandSlide Monitoring - Starting!!");
   pinMode(vibSensor_pin, INPUT);
+#ifdef HISTORY_LOG
+  history.begin();
+#endif
   configLoRaModule();
   setupDisplay();
   dht.begin();
   checkDHT();
-  delay(1000);
-  Serial.println("Setup Completed !!");
-  delay(250);
+#ifdef LOW_POWER_MODE
+  // ADXL345 stays configured across sleeps, its activity interrupt wakes the MCU
+  init_accel();
+  accelActivityBegin(accel);
+  lowPowerBegin();
+  if (is_exist) {
+    sleepLoRaModule();
+  }
+#endif
+  LOG_INFO("Setup Completed !!");
+
+  // Take the first sample and send it straight away instead of a full interval after boot
+  previousUpdateTime = nowMillis() - updateInterval;
+  previousTime = nowMillis() - sendInterval;
 }
 
+#ifdef LOW_POWER_MODE
+// Function to report wake cycle timings and sleep until the next sample or send tick
+void sleepUntilNextTick(unsigned long wakeStart, unsigned long txTime){
+  unsigned long now = nowMillis();
+  unsigned long toUpdate = updateInterval - min(updateInterval, now - previousUpdateTime);
+  unsigned long toSend = sendInterval - min(sendInterval, now - previousTime);
+
+  // PWR,<cycle>,<wake source>,<active ms>,<tx ms>,<slept ms before this cycle>,<of the tx ms, rx listen ms>
+  LOG_INFO("PWR,%lu,%u,%lu,%lu,%lu,%lu", wakeCount, wakeSource, millis() - wakeStart, txTime, lastSleepTime,
+           rxListenTime);
+  rxListenTime = 0;
+
+  unsigned long sleepStart = sleptMillis();
+  wakeSource = sleepFor(min(toUpdate, toSend));
+  lastSleepTime = sleptMillis() - sleepStart;
+  wakeCount++;
+
+  if (wakeSource == WAKE_ACCEL) {
+    // Ground movement - take a fresh sample right away instead of waiting for the tick
+    accelActivityClear(accel);
+    previousUpdateTime = nowMillis() - updateInterval;
+  }
+}
+#endif
+
 // Function main Loop
 void loop() {
   // put your main code here, to run repeatedly:
-  unsigned long currentUpdateTime = millis();
+  logPump();
+#ifdef AT_TRACE
+  atTrace.serve(Serial);
+#endif
+#ifdef LOW_POWER_MODE
+  unsigned long wakeStart = millis();
+  unsigned long txTime = 0;
+#endif
+  unsigned long currentUpdateTime = nowMillis();
   if (currentUpdateTime - previousUpdateTime >= updateInterval) {
     getReadings();
     checkStatus();
@@ -405,10 +648,22 @@ void loop() {
     previousUpdateTime = currentUpdateTime;
   }
 
-  unsigned long currentTime = millis();
+  unsigned long currentTime = nowMillis();
   if (currentTime - previousTime >= sendInterval) {
-    LoRa_send();
+#ifdef LOW_POWER_MODE
+    unsigned long txStart = millis();
+    wakeLoRaModule();
+    sendReadings();
+    sleepLoRaModule();
+    txTime = millis() - txStart;
+#else
+    sendReadings();
+#endif
     previousTime = currentTime;
   }
+
+#ifdef LOW_POWER_MODE
+  sleepUntilNextTick(wakeStart, txTime);
+#endif
 }
 // ---------------------------------- make2explore.com----------------------------------------------------//
\ No newline at end of file
@@ -0,0 +1,127 @@
+// ---------------------------------- make2explore.com -------------------------------------------------------//
+// Project           - Application of LoRa WSN in Landslide Monitoring/Detection/Prevention Systems
+// Program           - Sensor Node unit tests
+// Software          - C/C++, PlatformIO IDE - pio test -e native
+// -----------------------------------------------------------------------------------------------------------//
+// Builds the Sensor Node sketch over Native-HAL and runs its AT command handling and alert logic on the PC.
+// The Wio E5 UART (Serial1) is driven through the HAL, the clock is the simulated one, so timeouts are exact
+// and the tests take no real time.
+// -----------------------------------------------------------------------------------------------------------//
+
+#include <Arduino.h>
+#include <unity.h>
+
+// The sketch, its setup() / loop() stay unused, main() below (Native-HAL's is weak) runs the tests
+#include "../../src/main.cpp"
+
+#include "Hal.h"
+
+static char atCmd[] = "AT\r\n";
+static char atOk[] = "+AT: OK";
+
+// Milliseconds of simulated time since boot
+static uint64_t wallMillis(){ return halWallMicros() / 1000; }
+
+// Readings in the alert band, a test moves one of them out
+static void setAlertReadings(){
+  m1 = 80; m2 = 85; rain_per = 70; humi = 90; temp = 20;
+  disp = 1.5; vib = 1;
+}
+
+void setUp(){
+  while (Serial1.available() > 0) Serial1.read();
+  halUartTake("Serial1");
+  status = "";
+  stat = 0;
+}
+
+void tearDown(){
+}
+
+// ---- at_send_check_response()
+
+static void test_at_ack_in_time(){
+  halUartFeed("Serial1", "+AT: OK\r\n", 9);
+  TEST_ASSERT_EQUAL_INT(1, at_send_check_response(atOk, 300, atCmd));
+  TEST_ASSERT_EQUAL_STRING("AT\r\n", halUartTake("Serial1").c_str());
+}
+
+static void test_at_ack_late(){
+  uint64_t start = wallMillis();
+  halAt(start + 200, []{ halUartFeed("Serial1", "+AT: OK\r\n", 9); });
+  TEST_ASSERT_EQUAL_INT(1, at_send_check_response(atOk, 300, atCmd));
+  uint64_t waited = wallMillis() - start;
+  TEST_ASSERT_GREATER_OR_EQUAL(200, waited);
+  TEST_ASSERT_LESS_THAN(300, waited);
+}
+
+static void test_at_timeout(){
+  uint64_t start = wallMillis();
+  TEST_ASSERT_EQUAL_INT(0, at_send_check_response(atOk, 300, atCmd));
+  uint64_t waited = wallMillis() - start;
+  TEST_ASSERT_GREATER_OR_EQUAL(300, waited);
+  TEST_ASSERT_LESS_THAN(310, waited);
+}
+
+static void test_at_wrong_answer(){
+  halUartFeed("Serial1", "+AT: ERROR(-1)\r\n", 16);
+  TEST_ASSERT_EQUAL_INT(0, at_send_check_response(atOk, 300, atCmd));
+}
+
+// ---- checkStatus()
+
+static void test_status_alert(){
+  setAlertReadings();
+  checkStatus();
+  TEST_ASSERT_EQUAL_INT(1, stat);
+  TEST_ASSERT_EQUAL_STRING("Alert", status.c_str());
+}
+
+static void test_status_high_band_without_movement(){
+  setAlertReadings();
+  vib = 0;
+  checkStatus();
+  TEST_ASSERT_EQUAL_INT(0, stat);
+  TEST_ASSERT_EQUAL_STRING("Normal", status.c_str());
+}
+
+static void test_status_kept_between_bands(){
+  setAlertReadings();
+  checkStatus();
+  humi = 55;      // out of the high band, the rest still out of the low one
+  checkStatus();
+  TEST_ASSERT_EQUAL_INT(1, stat);
+  TEST_ASSERT_EQUAL_STRING("Alert", status.c_str());
+}
+
+static void test_status_back_to_normal(){
+  setAlertReadings();
+  checkStatus();
+  m1 = 30; m2 = 35; rain_per = 10; humi = 40; temp = 30;
+  disp = 0.2; vib = 0;
+  checkStatus();
+  TEST_ASSERT_EQUAL_INT(0, stat);
+  TEST_ASSERT_EQUAL_STRING("Normal", status.c_str());
+}
+
+// ---- LoRa_payload()
+
+static void test_payload(){
+  setAlertReadings();
+  checkStatus();
+  TEST_ASSERT_EQUAL_STRING("80,85,70,90,20,1.50,1,1", LoRa_payload().c_str());
+}
+
+int main(int, char **){
+  UNITY_BEGIN();
+  RUN_TEST(test_at_ack_in_time);
+  RUN_TEST(test_at_ack_late);
+  RUN_TEST(test_at_timeout);
+  RUN_TEST(test_at_wrong_answer);
+  RUN_TEST(test_status_alert);
+  RUN_TEST(test_status_high_band_without_movement);
+  RUN_TEST(test_status_kept_between_bands);
+  RUN_TEST(test_status_back_to_normal);
+  RUN_TEST(test_payload);
+  return UNITY_END();
+}